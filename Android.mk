@@ -82,28 +82,19 @@ LOCAL_SRC_FILES := \
     depends/rtl-sdr/src/tuner_fc2580.c \
     depends/rtl-sdr/src/tuner_r82xx.c \
     depends/sqlite/sqlite3.c \
-    src/fmdsp/demodulator.cpp \
-    src/fmdsp/downconvert.cpp \
-    src/fmdsp/fastfir.cpp \
-    src/fmdsp/fft.cpp \
-    src/fmdsp/fir.cpp \
-    src/fmdsp/fmdemod.cpp \
-    src/fmdsp/fractresampler.cpp \
-    src/fmdsp/iir.cpp \
-    src/fmdsp/wfmdemod.cpp \
     src/addon.cpp \
     src/channeladd.cpp \
     src/channelsettings.cpp \
     src/database.cpp \
-    src/fmstream.cpp \
+    src/dspdouble.cpp \
+    src/dspsingle.cpp \
     src/fmmeter.cpp \
     src/libusb_exception.cpp \
     src/rdsdecoder.cpp \
     src/sqlite_exception.cpp \
     src/uecp.cpp \
     src/usbdevice.cpp \
-    src/tcpdevice.cpp \
-    src/wxstream.cpp
+    src/tcpdevice.cpp
 
 include $(BUILD_SHARED_LIBRARY)
 
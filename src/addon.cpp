@@ -41,6 +41,7 @@
 #include "channeladd.h"
 #include "channelsettings.h"
 #include "dbtypes.h"
+#include "fmdsp/dispatch.h"
 #include "fmstream.h"
 #include "string_exception.h"
 #include "sqlite_exception.h"
@@ -155,6 +156,50 @@ std::string addon::device_connection_to_string(enum device_connection connection
 	return "Unknown";
 }
 
+//---------------------------------------------------------------------------
+// addon::dsp_precision_to_string (private, static)
+//
+// Converts a dsp_precision enumeration value into a string
+//
+// Arguments:
+//
+//	precision		- DSP precision to convert into a string
+
+std::string addon::dsp_precision_to_string(enum dsp_precision precision)
+{
+	switch(precision) {
+
+		case dsp_precision::platformdefault: return "Automatic";
+		case dsp_precision::singleprecision: return "Single";
+		case dsp_precision::doubleprecision: return "Double";
+		case dsp_precision::fixedpoint: return "Fixed";
+	}
+
+	return "Unknown";
+}
+
+//---------------------------------------------------------------------------
+// addon::get_platform_dsp_precision (private, static)
+//
+// Figures out the DSP precision to use on this platform
+//
+// Arguments:
+//
+//	precision		- DSP precision to be converted if applicable
+
+enum dsp_precision addon::get_platform_dsp_precision(enum dsp_precision precision)
+{
+	// If the precision isn't set to automatic, just regurgitate it
+	if(precision != dsp_precision::platformdefault) return precision;
+
+	// The build flags select the precision that performs best on the target CPU
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	return dsp_precision::doubleprecision;
+#else
+	return dsp_precision::singleprecision;
+#endif
+}
+
 //---------------------------------------------------------------------------
 // addon::get_regional_rds_standard (private, static)
 //
@@ -548,6 +593,20 @@ ADDON_STATUS addon::Create(void)
 		// Throw a banner out to the Kodi log indicating that the add-on is being loaded
 		log_info(__func__, ": ", VERSION_PRODUCTNAME_ANSI, " v", VERSION_VERSION3_ANSI, " loading");
 
+		// Probe the CPU once and bind the DSP kernels of both precisions to the best implementations
+		char const* function = __func__;
+		char const* simdlevel = fmdsp_single::InitDspKernels([&](char const* kernel, char const* implementation) -> void {
+
+			log_info(function, ": single precision ", kernel, " kernel: ", implementation);
+		});
+
+		fmdsp_double::InitDspKernels([&](char const* kernel, char const* implementation) -> void {
+
+			log_info(function, ": double precision ", kernel, " kernel: ", implementation);
+		});
+
+		log_info(__func__, ": DSP kernels bound for the ", simdlevel, " instruction set");
+
 		try {
 
 			// The user data path doesn't always exist when an addon has been installed
@@ -565,6 +624,7 @@ ADDON_STATUS addon::Create(void)
 			m_settings.device_connection_tcp_port = kodi::GetSettingInt("device_connection_tcp_port", 1234);
 			m_settings.device_sample_rate = kodi::GetSettingInt("device_sample_rate", (1600 KHz));
 			m_settings.device_frequency_correction = kodi::GetSettingInt("device_frequency_correction", 0);
+			m_settings.device_dsp_precision = kodi::GetSettingEnum("device_dsp_precision", dsp_precision::platformdefault);
 
 			// Load the Interface settings
 			m_settings.interface_prepend_channel_numbers = kodi::GetSettingBoolean("interface_prepend_channel_numbers", false);
@@ -572,6 +632,7 @@ ADDON_STATUS addon::Create(void)
 			// Load the FM Radio settings
 			m_settings.fmradio_enable_rds = kodi::GetSettingBoolean("fmradio_enable_rds", true);
 			m_settings.fmradio_rds_standard = kodi::GetSettingEnum("fmradio_rds_standard", rds_standard::automatic);
+			m_settings.fmradio_force_mono = kodi::GetSettingBoolean("fmradio_force_mono", false);
 			m_settings.fmradio_downsample_quality = kodi::GetSettingEnum("fmradio_downsample_quality", downsample_quality::standard);
 			m_settings.fmradio_output_samplerate = kodi::GetSettingInt("fmradio_output_samplerate", 48000);
 			m_settings.fmradio_output_gain = kodi::GetSettingFloat("fmradio_output_gain", -3.0f);
@@ -585,10 +646,12 @@ ADDON_STATUS addon::Create(void)
 			log_info(__func__, ": m_settings.device_connection_tcp_host        = ", m_settings.device_connection_tcp_host);
 			log_info(__func__, ": m_settings.device_connection_tcp_port        = ", m_settings.device_connection_tcp_port);
 			log_info(__func__, ": m_settings.device_connection_usb_index       = ", m_settings.device_connection_usb_index);
+			log_info(__func__, ": m_settings.device_dsp_precision              = ", static_cast<int>(m_settings.device_dsp_precision));
 			log_info(__func__, ": m_settings.device_frequency_correction       = ", m_settings.device_frequency_correction);
 			log_info(__func__, ": m_settings.device_sample_rate                = ", m_settings.device_sample_rate);
 			log_info(__func__, ": m_settings.fmradio_downsample_quality        = ", static_cast<int>(m_settings.fmradio_downsample_quality));
 			log_info(__func__, ": m_settings.fmradio_enable_rds                = ", m_settings.fmradio_enable_rds);
+			log_info(__func__, ": m_settings.fmradio_force_mono                = ", m_settings.fmradio_force_mono);
 			log_info(__func__, ": m_settings.fmradio_output_gain               = ", m_settings.fmradio_output_gain);
 			log_info(__func__, ": m_settings.fmradio_output_samplerate         = ", m_settings.fmradio_output_samplerate);
 			log_info(__func__, ": m_settings.fmradio_rds_standard              = ", static_cast<int>(m_settings.fmradio_rds_standard));
@@ -751,6 +814,18 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName, kodi::CSettingVal
 		}
 	}
 
+	// device_dsp_precision
+	//
+	else if(settingName == "device_dsp_precision") {
+
+		enum dsp_precision value = settingValue.GetEnum<enum dsp_precision>();
+		if(value != m_settings.device_dsp_precision) {
+
+			m_settings.device_dsp_precision = value;
+			log_info(__func__, ": setting device_dsp_precision changed to ", dsp_precision_to_string(value).c_str());
+		}
+	}
+
 	// interface_prepend_channel_numbers
 	//
 	else if(settingName == "interface_prepend_channel_numbers") {
@@ -790,6 +865,18 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName, kodi::CSettingVal
 		}
 	}
 
+	// fmradio_force_mono
+	//
+	else if(settingName == "fmradio_force_mono") {
+
+		bool bvalue = settingValue.GetBoolean();
+		if(bvalue != m_settings.fmradio_force_mono) {
+
+			m_settings.fmradio_force_mono = bvalue;
+			log_info(__func__, ": setting fmradio_force_mono changed to ", bvalue);
+		}
+	}
+
 	// fmradio_downsample_quality
 	//
 	else if(settingName == "fmradio_downsample_quality") {
@@ -1554,9 +1641,12 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
 			struct fmprops fmprops = {};
 			fmprops.decoderds = settings.fmradio_enable_rds;
 			fmprops.isrbds = (get_regional_rds_standard(settings.fmradio_rds_standard) == rds_standard::rbds);
+			fmprops.forcemono = settings.fmradio_force_mono;
 			fmprops.downsamplequality = static_cast<int>(settings.fmradio_downsample_quality);
 			fmprops.outputrate = settings.fmradio_output_samplerate;
 			fmprops.outputgain = settings.fmradio_output_gain;
+			fmprops.doubleprecision = (get_platform_dsp_precision(settings.device_dsp_precision) == dsp_precision::doubleprecision);
+			fmprops.fixedpoint = (get_platform_dsp_precision(settings.device_dsp_precision) == dsp_precision::fixedpoint);
 
 			// Log information about the stream for diagnostic purposes
 			log_info(__func__, ": Creating fmstream for channel \"", channelprops.name, "\"");
@@ -1564,15 +1654,19 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
 			log_info(__func__, ": tunerprops.freqcorrection = ", tunerprops.freqcorrection, " PPM");
 			log_info(__func__, ": fmprops.decoderds = ", (fmprops.decoderds) ? "true" : "false");
 			log_info(__func__, ": fmprops.isrbds = ", (fmprops.isrbds) ? "true" : "false");
+			log_info(__func__, ": fmprops.forcemono = ", (fmprops.forcemono) ? "true" : "false");
 			log_info(__func__, ": fmprops.downsamplequality = ", downsample_quality_to_string(static_cast<enum downsample_quality>(fmprops.downsamplequality)));
 			log_info(__func__, ": fmprops.outputgain = ", fmprops.outputgain, " dB");
 			log_info(__func__, ": fmprops.outputrate = ", fmprops.outputrate, " Hz");
+			log_info(__func__, ": fmprops.doubleprecision = ", (fmprops.doubleprecision) ? "true" : "false");
+			log_info(__func__, ": fmprops.fixedpoint = ", (fmprops.fixedpoint) ? "true" : "false");
 			log_info(__func__, ": channelprops.frequency = ", channelprops.frequency, " Hz");
 			log_info(__func__, ": channelprops.autogain = ", (channelprops.autogain) ? "true" : "false");
 			log_info(__func__, ": channelprops.manualgain = ", channelprops.manualgain / 10, " dB");
 
-			// Create the FM Radio stream
-			m_pvrstream = fmstream::create(create_device(settings), tunerprops, channelprops, fmprops);
+			// Create the FM Radio stream, the fixed point DSP is part of the single precision build
+			m_pvrstream = (fmprops.doubleprecision) ? fmdsp_double::create_fmstream(create_device(settings), tunerprops, channelprops, fmprops) :
+				fmdsp_single::create_fmstream(create_device(settings), tunerprops, channelprops, fmprops);
 		}
 
 		// Weather Radio
@@ -1583,6 +1677,7 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
 			struct wxprops wxprops = {};
 			wxprops.outputrate = settings.wxradio_output_samplerate;
 			wxprops.outputgain = settings.wxradio_output_gain;
+			wxprops.doubleprecision = (get_platform_dsp_precision(settings.device_dsp_precision) == dsp_precision::doubleprecision);
 
 			// Log information about the stream for diagnostic purposes
 			log_info(__func__, ": Creating wxstream for channel \"", channelprops.name, "\"");
@@ -1590,12 +1685,15 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
 			log_info(__func__, ": tunerprops.freqcorrection = ", tunerprops.freqcorrection, " PPM");
 			log_info(__func__, ": wxprops.outputgain = ", wxprops.outputgain, " dB");
 			log_info(__func__, ": wxprops.outputrate = ", wxprops.outputrate, " Hz");
+			log_info(__func__, ": wxprops.doubleprecision = ", (wxprops.doubleprecision) ? "true" : "false");
 			log_info(__func__, ": channelprops.frequency = ", channelprops.frequency, " Hz");
 			log_info(__func__, ": channelprops.autogain = ", (channelprops.autogain) ? "true" : "false");
 			log_info(__func__, ": channelprops.manualgain = ", channelprops.manualgain / 10, " dB");
 
-			// Create the Weather Radio stream
-			m_pvrstream = wxstream::create(create_device(settings), tunerprops, channelprops, wxprops);
+			// Create the Weather Radio stream, there is no fixed point DSP for Weather Radio so
+			// it falls back to single precision floating point
+			m_pvrstream = (wxprops.doubleprecision) ? fmdsp_double::create_wxstream(create_device(settings), tunerprops, channelprops, wxprops) :
+				fmdsp_single::create_wxstream(create_device(settings), tunerprops, channelprops, wxprops);
 		}
 
 		else throw string_exception("channel ", channel.GetUniqueId(), " (", channel.GetChannelName().c_str(), ") has an unknown modulation type");
@@ -256,12 +256,14 @@ private:
 	// Regional Helpers
 	//
 	enum rds_standard get_regional_rds_standard(enum rds_standard standard) const;
+	static enum dsp_precision get_platform_dsp_precision(enum dsp_precision precision);
 
 	// Settings Helpers
 	//
 	struct settings copy_settings(void) const;
 	static std::string device_connection_to_string(enum device_connection connection);
 	static std::string downsample_quality_to_string(enum downsample_quality quality);
+	static std::string dsp_precision_to_string(enum dsp_precision precision);
 	static std::string rds_standard_to_string(enum rds_standard mode);
 
 	//-------------------------------------------------------------------------
@@ -0,0 +1,264 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef __BLOCKRING_H_
+#define __BLOCKRING_H_
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+
+#include "align.h"
+
+#pragma warning(push, 4)
+
+//-----------------------------------------------------------------------------
+// blockring
+//
+// Implements a fixed-capacity ring of preallocated data blocks that are recycled
+// between a producer and a consumer.  All of the blocks are carved out of a single
+// slab allocated during construction, no heap allocations occur afterwards; this is
+// verified for the whole fmstream pipeline by test/blockring.cpp
+//
+// The ring is lock-free for exactly one producer thread (acquire, commit) and one
+// consumer thread (clear, front, overrun, pop, wait).  The consumer only blocks on
+// the internal condition variable when it has parked itself in wait(), and the 
+// producer only signals it when it has been parked
+
+template <typename _type>
+class blockring
+{
+public:
+
+	// Instance Constructor
+	//
+	blockring(size_t blockcount, size_t blocksize) : m_blockcount(blockcount), m_blocksize(blocksize), 
+		m_stride(align::up(blocksize * sizeof(_type), BLOCK_ALIGNMENT))
+	{
+		if(blockcount == 0) throw std::invalid_argument("blockcount");
+		if(blocksize == 0) throw std::invalid_argument("blocksize");
+
+		// Allocate the slab of blocks with enough padding to align the first block
+		m_slab = std::unique_ptr<uint8_t[]>(new uint8_t[(m_stride * blockcount) + BLOCK_ALIGNMENT]);
+		m_blocks = align::up(m_slab.get(), BLOCK_ALIGNMENT);
+		m_lengths = std::unique_ptr<size_t[]>(new size_t[blockcount]);
+	}
+
+	// Destructor
+	//
+	~blockring()=default;
+
+	//-------------------------------------------------------------------------
+	// Member Functions
+
+	// acquire
+	//
+	// Acquires the next free block to be written by the producer, or nullptr if the ring is full.
+	// A full ring is remembered as an overrun until the consumer calls overrun()
+	_type* acquire(void)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		if(distance(tail, m_head.load(std::memory_order_acquire)) == m_blockcount) {
+
+			m_overrun.store(true, std::memory_order_release);
+			return nullptr;
+		}
+
+		return block(tail % m_blockcount);
+	}
+
+	// blocksize
+	//
+	// Gets the capacity of each block, in elements
+	size_t blocksize(void) const
+	{
+		return m_blocksize;
+	}
+
+	// clear
+	//
+	// Releases all of the committed blocks
+	void clear(void)
+	{
+		m_head.store(m_tail.load(std::memory_order_acquire), std::memory_order_release);
+	}
+
+	// commit
+	//
+	// Commits the block returned by acquire() into the ring; a length of zero indicates
+	// that the block does not contain any valid data and serves as a resynchronization marker
+	void commit(size_t length)
+	{
+		assert(length <= m_blocksize);
+
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		assert(distance(tail, m_head.load(std::memory_order_acquire)) < m_blockcount);
+
+		m_lengths[tail % m_blockcount] = length;
+		m_tail.store(advance(tail), std::memory_order_seq_cst);
+
+		// Only wake the consumer if it has parked itself waiting for a block; the
+		// sequentially consistent store/load pairs with the store and fence in wait()
+		if(m_parked.load(std::memory_order_seq_cst)) notify();
+	}
+
+	// empty
+	//
+	// Determines if there are no committed blocks in the ring
+	bool empty(void) const
+	{
+		return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_relaxed);
+	}
+
+	// front
+	//
+	// Accesses the oldest committed block in the ring and its length
+	_type const* front(size_t& length) const
+	{
+		assert(!empty());
+
+		size_t head = m_head.load(std::memory_order_relaxed) % m_blockcount;
+		length = m_lengths[head];
+		return block(head);
+	}
+
+	// notify
+	//
+	// Unconditionally wakes the consumer if it has been parked in wait()
+	void notify(void)
+	{
+		std::unique_lock<std::mutex> critsec(m_lock);
+		m_cv.notify_all();
+	}
+
+	// overrun
+	//
+	// Tests and resets the overrun condition
+	bool overrun(void)
+	{
+		return m_overrun.exchange(false, std::memory_order_acq_rel);
+	}
+
+	// pop
+	//
+	// Releases the oldest committed block back to the producer
+	void pop(void)
+	{
+		assert(!empty());
+		m_head.store(advance(m_head.load(std::memory_order_relaxed)), std::memory_order_release);
+	}
+
+	// size
+	//
+	// Gets the number of committed blocks in the ring
+	size_t size(void) const
+	{
+		return distance(m_tail.load(std::memory_order_acquire), m_head.load(std::memory_order_acquire));
+	}
+
+	// wait
+	//
+	// Waits until there is a committed block in the ring or the predicate is satisfied; the 
+	// predicate must be made true by another thread before calling notify() to wake this one
+	template <typename _predicate>
+	void wait(_predicate predicate)
+	{
+		// Don't involve the synchronization objects if the wait would be satisfied immediately
+		if((!empty()) || predicate()) return;
+
+		std::unique_lock<std::mutex> critsec(m_lock);
+		m_parked.store(true, std::memory_order_seq_cst);
+
+		// The store above has to be ordered before the acquire load of the tail in empty(),
+		// otherwise the consumer can miss a commit while the producer misses the parked flag
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		m_cv.wait(critsec, [&]() -> bool { return (!empty()) || predicate(); });
+		m_parked.store(false, std::memory_order_relaxed);
+	}
+
+private:
+
+	blockring(blockring const&)=delete;
+	blockring& operator=(blockring const&)=delete;
+
+	// BLOCK_ALIGNMENT
+	//
+	// Alignment of each block within the slab; a cache line satisfies all SIMD loads
+	static unsigned int const BLOCK_ALIGNMENT = 64;
+
+	//-------------------------------------------------------------------------
+	// Private Member Functions
+
+	// advance
+	//
+	// Advances a head or tail position; positions run over twice the number of blocks
+	// so that a full ring can be distinguished from an empty one
+	size_t advance(size_t position) const
+	{
+		return (position + 1) % (m_blockcount * 2);
+	}
+
+	// block
+	//
+	// Gets the address of a block within the slab
+	_type* block(size_t index) const
+	{
+		return reinterpret_cast<_type*>(m_blocks + (index * m_stride));
+	}
+
+	// distance
+	//
+	// Gets the number of blocks between a tail and a head position
+	size_t distance(size_t tail, size_t head) const
+	{
+		return (tail + (m_blockcount * 2) - head) % (m_blockcount * 2);
+	}
+
+	//-------------------------------------------------------------------------
+	// Member Variables
+
+	size_t const					m_blockcount;			// Number of blocks
+	size_t const					m_blocksize;			// Elements per block
+	size_t const					m_stride;				// Bytes between blocks
+	std::unique_ptr<uint8_t[]>		m_slab;					// Allocated slab
+	uint8_t*						m_blocks = nullptr;		// Aligned first block
+	std::unique_ptr<size_t[]>		m_lengths;				// Committed block lengths
+
+	std::atomic<size_t>				m_head{ 0 };			// Release position (consumer)
+	std::atomic<size_t>				m_tail{ 0 };			// Commit position (producer)
+	std::atomic<bool>				m_overrun{ false };		// Producer overrun flag
+	std::atomic<bool>				m_parked{ false };		// Consumer is parked flag
+	std::mutex						m_lock;					// Parking synchronization object
+	std::condition_variable			m_cv;					// Parking condition variable
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif	// __BLOCKRING_H_
@@ -100,6 +100,14 @@ typedef union
  #define TYPECPX	tSComplex
 #endif
 
+//the DSP classes are declared in a namespace per precision so the library
+//can be compiled once for each and both linked into the same binary
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+ #define FMDSP_NAMESPACE fmdsp_double
+#else
+ #define FMDSP_NAMESPACE fmdsp_single
+#endif
+
 #ifdef FMDSP_USE_DOUBLE_PRECISION
  #define MSIN(x) sin(x)
  #define MCOS(x) cos(x)
@@ -40,6 +40,11 @@
 //==========================================================================================
 #include "demodulator.h"
 
+#include <algorithm>
+#include <string.h>
+
+namespace FMDSP_NAMESPACE {
+
 //////////////////////////////////////////////////////////////////
 //	Constructor/Destructor
 //////////////////////////////////////////////////////////////////
@@ -49,6 +54,7 @@ CDemodulator::CDemodulator()
 	m_DemodOutputRate = 48000.0;
 	m_pDemodInBuf = new TYPECPX[MAX_INBUFSIZE];
 	m_pDemodTmpBuf = new TYPECPX[MAX_INBUFSIZE];
+	m_pRawInBuf = new quint8[MAX_INBUFSIZE * 2];
 	m_InBufPos = 0;
 	m_InBufLimit = 1000;
 	m_DemodMode = -1;
@@ -65,6 +71,8 @@ CDemodulator::~CDemodulator()
 		delete m_pDemodInBuf;
 	if(m_pDemodTmpBuf)
 		delete m_pDemodTmpBuf;
+	if(m_pRawInBuf)
+		delete[] m_pRawInBuf;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -136,6 +144,9 @@ void CDemodulator::SetDemod(int Mode, tDemodInfo CurrentDemodInfo)
 			case DEMOD_WFM:
 				m_DownConverterOutputRate = m_DownConvert.SetWfmDataRate(m_InputRate, 100000);
 				m_pWFmDemod = new CWFmDemod(m_DownConverterOutputRate);
+				m_pWFmDemod->SetCompositeSink(m_CompositeSink);
+				m_pWFmDemod->SetRdsEnabled(m_RdsEnabled);
+				m_pWFmDemod->SetAudioFilterEnabled(m_AudioFilterEnabled);
 				m_DemodOutputRate = m_pWFmDemod->GetDemodRate();
 				break;
 		}
@@ -152,6 +163,62 @@ void CDemodulator::SetDemod(int Mode, tDemodInfo CurrentDemodInfo)
 	m_InBufLimit &= 0xFFFFFF00;	//keep modulo 256 since decimation is only in power of 2
 }
 
+//////////////////////////////////////////////////////////////////
+//	Filters and demodulates 'n' down converted samples in
+// m_pDemodInBuf with MONO audio output
+//////////////////////////////////////////////////////////////////
+int CDemodulator::DemodulateBlock(int n, TYPEREAL* pOutData)
+{
+	if(m_DemodMode != DEMOD_WFM)
+	{
+		//perform main bandpass filtering
+		n = m_FastFIR.ProcessData(n, m_pDemodInBuf, m_pDemodTmpBuf);
+		MeasureSignalQuality(n, m_pDemodTmpBuf);
+	}
+	else
+		MeasureSignalQuality(n, m_pDemodInBuf);
+
+	//perform the desired demod action
+	switch(m_DemodMode)
+	{
+		case DEMOD_FM:
+			n = m_pFmDemod->ProcessData(n, m_DemodInfo.HiCut, m_pDemodTmpBuf, pOutData );
+			break;
+		case DEMOD_WFM:
+			n = m_pWFmDemod->ProcessData(n, m_pDemodInBuf, pOutData );
+			break;
+	}
+	return n;
+}
+
+//////////////////////////////////////////////////////////////////
+//	Filters and demodulates 'n' down converted samples in
+// m_pDemodInBuf with STEREO audio output
+//////////////////////////////////////////////////////////////////
+int CDemodulator::DemodulateBlock(int n, TYPECPX* pOutData)
+{
+	if(m_DemodMode != DEMOD_WFM)
+	{
+		//perform main bandpass filtering
+		n = m_FastFIR.ProcessData(n, m_pDemodInBuf, m_pDemodTmpBuf);
+		MeasureSignalQuality(n, m_pDemodTmpBuf);
+	}
+	else
+		MeasureSignalQuality(n, m_pDemodInBuf);
+
+	//perform the desired demod action
+	switch(m_DemodMode)
+	{
+		case DEMOD_FM:
+			n = m_pFmDemod->ProcessData(n, m_DemodInfo.HiCut, m_pDemodTmpBuf, pOutData );
+			break;
+		case DEMOD_WFM:
+			n = m_pWFmDemod->ProcessData(n, m_pDemodInBuf, pOutData );
+			break;
+	}
+	return n;
+}
+
 //////////////////////////////////////////////////////////////////
 //	Called with complex data from radio and performs the demodulation
 // with MONO audio output
@@ -173,27 +240,8 @@ int ret = 0;
 			//perform baseband tuning and decimation
 			int n = m_DownConvert.ProcessData(m_InBufPos, m_pDemodInBuf, m_pDemodInBuf);
 
-			if(m_DemodMode != DEMOD_WFM)
-			{
-				//perform main bandpass filtering
-				n = m_FastFIR.ProcessData(n, m_pDemodInBuf, m_pDemodTmpBuf);
-				MeasureSignalQuality(n, m_pDemodTmpBuf);
-			}
-			else
-				MeasureSignalQuality(n, m_pDemodInBuf);
-
-			//perform the desired demod action
-			switch(m_DemodMode)
-			{
-				case DEMOD_FM:
-					n = m_pFmDemod->ProcessData(n, m_DemodInfo.HiCut, m_pDemodTmpBuf, pOutData );
-					break;
-				case DEMOD_WFM:
-					n = m_pWFmDemod->ProcessData(n, m_pDemodInBuf, pOutData );
-					break;
-			}
 			m_InBufPos = 0;
-			ret += n;
+			ret += DemodulateBlock(n, pOutData);
 		}
 	}
 
@@ -221,27 +269,88 @@ int ret = 0;
 			//perform baseband tuning and decimation
 			int n = m_DownConvert.ProcessData(m_InBufPos, m_pDemodInBuf, m_pDemodInBuf);
 
-			if(m_DemodMode != DEMOD_WFM)
-			{
-				//perform main bandpass filtering
-				n = m_FastFIR.ProcessData(n, m_pDemodInBuf, m_pDemodTmpBuf);
-				MeasureSignalQuality(n, m_pDemodTmpBuf);
-			}
-			else 
-				MeasureSignalQuality(n, m_pDemodInBuf);
-
-			//perform the desired demod action
-			switch(m_DemodMode)
-			{
-				case DEMOD_FM:
-					n = m_pFmDemod->ProcessData(n, m_DemodInfo.HiCut, m_pDemodTmpBuf, pOutData );
-					break;
-				case DEMOD_WFM:
-					n = m_pWFmDemod->ProcessData(n, m_pDemodInBuf, pOutData );
-					break;
-			}
+			m_InBufPos = 0;
+			ret += DemodulateBlock(n, pOutData);
+		}
+	}
+
+	return ret;
+}
 
+//////////////////////////////////////////////////////////////////
+//	Places up to a full block of raw samples in the raw demod buffer,
+// advancing 'InLength' and 'pInData' past the consumed samples.
+// Returns the block to process once m_InBufLimit samples are
+// available, a whole block at the start of the buffer is returned
+// in place without being copied.
+//////////////////////////////////////////////////////////////////
+const quint8* CDemodulator::BufferRawData(int& InLength, const quint8*& pInData)
+{
+	const quint8* pBlock = m_pRawInBuf;
+	int len = std::min(InLength, m_InBufLimit - m_InBufPos);
+	if( (m_InBufPos == 0) && (len == m_InBufLimit) )
+		pBlock = pInData;
+	else
+		memcpy(&m_pRawInBuf[m_InBufPos * 2], pInData, len * 2);
+	m_InBufPos += len;
+	pInData += len * 2;
+	InLength -= len;
+	return pBlock;
+}
+
+//////////////////////////////////////////////////////////////////
+//	Called with raw 8 bit I/Q data from radio and performs the
+// demodulation with MONO audio output
+//////////////////////////////////////////////////////////////////
+int CDemodulator::ProcessData(int InLength, const quint8* pInData, TYPEREAL* pOutData)
+{
+int ret = 0;
+
+#ifdef FMDSP_THREAD_SAFE
+	std::unique_lock<std::mutex> lock(m_Mutex);
+#endif
+
+	while(InLength > 0)
+	{
+		const quint8* pBlock = BufferRawData(InLength, pInData);
+		if(m_InBufPos >= m_InBufLimit)
+		{	//when have enough samples, call demod routine sequence
+
+			//perform baseband tuning and decimation
+			int n = m_DownConvert.ProcessData(m_InBufPos, pBlock, m_pDemodInBuf);
+			m_InBufPos = 0;
+			n = DemodulateBlock(n, pOutData);
+			pOutData += n;
+			ret += n;
+		}
+	}
+
+	return ret;
+}
+
+//////////////////////////////////////////////////////////////////
+//	Called with raw 8 bit I/Q data from radio and performs the
+// demodulation with STEREO audio output
+//////////////////////////////////////////////////////////////////
+int CDemodulator::ProcessData(int InLength, const quint8* pInData, TYPECPX* pOutData)
+{
+int ret = 0;
+
+#ifdef FMDSP_THREAD_SAFE
+	std::unique_lock<std::mutex> lock(m_Mutex);
+#endif
+
+	while(InLength > 0)
+	{
+		const quint8* pBlock = BufferRawData(InLength, pInData);
+		if(m_InBufPos >= m_InBufLimit)
+		{	//when have enough samples, call demod routine sequence
+
+			//perform baseband tuning and decimation
+			int n = m_DownConvert.ProcessData(m_InBufPos, pBlock, m_pDemodInBuf);
 			m_InBufPos = 0;
+			n = DemodulateBlock(n, pOutData);
+			pOutData += n;
 			ret += n;
 		}
 	}
@@ -313,3 +422,5 @@ void CDemodulator::GetSignalLevels(TYPEREAL& quality, TYPEREAL& snr)
 
 	m_smeter_samples = 0;				// Reset statistics on next pass
 }
+
+} // namespace FMDSP_NAMESPACE
@@ -45,6 +45,8 @@
 #include <string>
 #include <mutex>
 
+namespace FMDSP_NAMESPACE {
+
 #define DEMOD_FM 2
 #define DEMOD_WFM 7
 
@@ -82,6 +84,10 @@ public:
 	//overloaded functions to perform demod mono or stereo
 	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
 	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
+	//overloaded functions to perform demod mono or stereo from raw 8 bit I/Q samples,
+	//should not be mixed with the TYPECPX input functions on the same stream
+	int ProcessData(int InLength, const quint8* pInData, TYPEREAL* pOutData);
+	int ProcessData(int InLength, const quint8* pInData, TYPECPX* pOutData);
 
 	void SetUSFmVersion(bool USFm){m_USFm = USFm;}
 	bool GetUSFmVersion(){return m_USFm;}
@@ -98,12 +104,34 @@ public:
 	{
 		if(m_pWFmDemod) return m_pWFmDemod->GetNextRdsGroupData(pGroupData); else return false;
 	}
+	//hands the WFM composite signal to Sink instead of the built in RDS demodulator
+	void SetCompositeSink(tCompositeSink const& Sink)
+	{
+		m_CompositeSink = Sink;
+		if(m_pWFmDemod) m_pWFmDemod->SetCompositeSink(Sink);
+	}
+	TYPEREAL GetCompositeRate(){ if(m_pWFmDemod) return m_pWFmDemod->GetCompositeRate(); else return 0.0;}
+	//enables or bypasses the whole WFM RDS chain
+	void SetRdsEnabled(bool Enabled)
+	{
+		m_RdsEnabled = Enabled;
+		if(m_pWFmDemod) m_pWFmDemod->SetRdsEnabled(Enabled);
+	}
+	//enables or bypasses the WFM audio low pass and pilot notch filters
+	void SetAudioFilterEnabled(bool Enabled)
+	{
+		m_AudioFilterEnabled = Enabled;
+		if(m_pWFmDemod) m_pWFmDemod->SetAudioFilterEnabled(Enabled);
+	}
 
 	// Gets the signal quality values
 	void GetSignalLevels(TYPEREAL& quality, TYPEREAL& snr);
 
 private:
 	void DeleteAllDemods();
+	int DemodulateBlock(int n, TYPEREAL* pOutData);
+	int DemodulateBlock(int n, TYPECPX* pOutData);
+	const quint8* BufferRawData(int& InLength, const quint8*& pInData);
 	CDownConvert m_DownConvert;
 	CFastFIR m_FastFIR;
 #ifdef FMDSP_THREAD_SAFE
@@ -116,6 +144,7 @@ private:
 	TYPEREAL m_DesiredMaxOutputBandwidth;
 	TYPECPX* m_pDemodInBuf;
 	TYPECPX* m_pDemodTmpBuf;
+	quint8* m_pRawInBuf;
 	bool m_USFm;
 	int m_DemodMode;
 	int m_InBufPos;
@@ -123,6 +152,9 @@ private:
 	//pointers to all the various implemented demodulator classes
 	CFmDemod* m_pFmDemod;
 	CWFmDemod* m_pWFmDemod;
+	tCompositeSink m_CompositeSink;
+	bool m_RdsEnabled = true;
+	bool m_AudioFilterEnabled = true;
 
 	// Signal quality calculations
 	void MeasureSignalQuality(int n, TYPECPX* pInData);
@@ -136,4 +168,6 @@ private:
 	TYPEREAL m_smeter_variance_new_s = 0;
 };
 
+} // namespace FMDSP_NAMESPACE
+
 #endif // DEMODULATOR_H
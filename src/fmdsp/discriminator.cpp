@@ -0,0 +1,576 @@
+//////////////////////////////////////////////////////////////////////
+// discriminator.cpp: implementation of the CFmDiscriminator class.
+//
+//  The conjugate product of each sample with the previous one is
+//calculated a vector at a time, the complex samples being split into
+//their I and Q parts as they are loaded.
+//
+//SSE2, AVX2 and NEON implementations of the DISC_POLYATAN2 and DISC_POLAR
+//backends are provided along with scalar fallbacks that also handle any
+//trailing samples
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "discriminator.h"
+#include "simd.h"
+
+namespace FMDSP_NAMESPACE {
+
+//each kernel processes Count samples and requires pInData[-1] to be valid
+typedef void (*tDiscriminate)(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData);
+
+//////////////////////////////////////////////////////////////////////
+// Scalar implementations, also used for any trailing samples the
+// vector implementations don't handle
+//////////////////////////////////////////////////////////////////////
+static void PolyAtan2Scalar(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	for(int i=0; i<Count; i++)
+	{
+		const TYPECPX& d0 = pInData[i];
+		const TYPECPX& d1 = pInData[i-1];
+		pOutData[i] = Scale * PolyAtan2( (d1.re*d0.im - d0.re*d1.im), (d1.re*d0.re + d1.im*d0.im) );
+	}
+}
+
+static void PolarScalar(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	for(int i=0; i<Count; i++)
+	{
+		const TYPECPX& d0 = pInData[i];
+		const TYPECPX& d1 = pInData[i-1];
+		pOutData[i] = Scale * (d1.re*d0.im - d0.re*d1.im);
+	}
+}
+
+#ifdef FMDSP_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 implementations, 4 single or 2 double precision samples per
+// iteration
+//////////////////////////////////////////////////////////////////////
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+
+//loads 2 complex samples split into their I and Q parts
+FMDSP_TARGET_SSE2
+static inline void LoadSplitSse2(const TYPECPX* p, __m128d& re, __m128d& im)
+{
+	__m128d a = _mm_loadu_pd(&p[0].re);
+	__m128d b = _mm_loadu_pd(&p[1].re);
+	re = _mm_unpacklo_pd(a, b);
+	im = _mm_unpackhi_pd(a, b);
+}
+
+FMDSP_TARGET_SSE2
+static inline __m128d SelectSse2(__m128d Mask, __m128d a, __m128d b)
+{
+	return _mm_or_pd(_mm_and_pd(Mask, a), _mm_andnot_pd(Mask, b));
+}
+
+FMDSP_TARGET_SSE2
+static void PolyAtan2Sse2(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const __m128d sign = _mm_set1_pd(-0.0);
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d tiny = _mm_set1_pd(1e-300);
+	const __m128d scale = _mm_set1_pd(Scale);
+	int i = 0;
+	for( ; i<=(Count-2); i+=2)
+	{
+		__m128d re0, im0, re1, im1;
+		LoadSplitSse2(pInData + i, re0, im0);
+		LoadSplitSse2(pInData + i - 1, re1, im1);
+		__m128d y = _mm_sub_pd(_mm_mul_pd(re1, im0), _mm_mul_pd(re0, im1));
+		__m128d x = _mm_add_pd(_mm_mul_pd(re1, re0), _mm_mul_pd(im1, im0));
+		__m128d ax = _mm_andnot_pd(sign, x);
+		__m128d ay = _mm_andnot_pd(sign, y);
+		__m128d t = _mm_div_pd(_mm_min_pd(ax, ay), _mm_max_pd(_mm_max_pd(ax, ay), tiny));
+		__m128d s = _mm_mul_pd(t, t);
+		__m128d p = _mm_add_pd(_mm_set1_pd(ATANPOLY_A9), _mm_mul_pd(s, _mm_set1_pd(ATANPOLY_A11)));
+		p = _mm_add_pd(_mm_set1_pd(ATANPOLY_A7), _mm_mul_pd(s, p));
+		p = _mm_add_pd(_mm_set1_pd(ATANPOLY_A5), _mm_mul_pd(s, p));
+		p = _mm_add_pd(_mm_set1_pd(ATANPOLY_A3), _mm_mul_pd(s, p));
+		p = _mm_add_pd(_mm_set1_pd(ATANPOLY_A1), _mm_mul_pd(s, p));
+		p = _mm_mul_pd(t, p);
+		p = SelectSse2(_mm_cmpgt_pd(ay, ax), _mm_sub_pd(_mm_set1_pd(K_PI2), p), p);
+		p = SelectSse2(_mm_cmplt_pd(x, zero), _mm_sub_pd(_mm_set1_pd(K_PI), p), p);
+		p = _mm_xor_pd(p, _mm_and_pd(_mm_cmplt_pd(y, zero), sign));
+		_mm_storeu_pd(pOutData + i, _mm_mul_pd(p, scale));
+	}
+	PolyAtan2Scalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+FMDSP_TARGET_SSE2
+static void PolarSse2(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const __m128d scale = _mm_set1_pd(Scale);
+	int i = 0;
+	for( ; i<=(Count-2); i+=2)
+	{
+		__m128d re0, im0, re1, im1;
+		LoadSplitSse2(pInData + i, re0, im0);
+		LoadSplitSse2(pInData + i - 1, re1, im1);
+		__m128d y = _mm_sub_pd(_mm_mul_pd(re1, im0), _mm_mul_pd(re0, im1));
+		_mm_storeu_pd(pOutData + i, _mm_mul_pd(y, scale));
+	}
+	PolarScalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+#else
+
+//loads 4 complex samples split into their I and Q parts
+FMDSP_TARGET_SSE2
+static inline void LoadSplitSse2(const TYPECPX* p, __m128& re, __m128& im)
+{
+	__m128 a = _mm_loadu_ps(&p[0].re);
+	__m128 b = _mm_loadu_ps(&p[2].re);
+	re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+	im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+}
+
+FMDSP_TARGET_SSE2
+static inline __m128 SelectSse2(__m128 Mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(Mask, a), _mm_andnot_ps(Mask, b));
+}
+
+FMDSP_TARGET_SSE2
+static void PolyAtan2Sse2(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 tiny = _mm_set1_ps(1e-30f);
+	const __m128 scale = _mm_set1_ps(Scale);
+	int i = 0;
+	for( ; i<=(Count-4); i+=4)
+	{
+		__m128 re0, im0, re1, im1;
+		LoadSplitSse2(pInData + i, re0, im0);
+		LoadSplitSse2(pInData + i - 1, re1, im1);
+		__m128 y = _mm_sub_ps(_mm_mul_ps(re1, im0), _mm_mul_ps(re0, im1));
+		__m128 x = _mm_add_ps(_mm_mul_ps(re1, re0), _mm_mul_ps(im1, im0));
+		__m128 ax = _mm_andnot_ps(sign, x);
+		__m128 ay = _mm_andnot_ps(sign, y);
+		__m128 t = _mm_div_ps(_mm_min_ps(ax, ay), _mm_max_ps(_mm_max_ps(ax, ay), tiny));
+		__m128 s = _mm_mul_ps(t, t);
+		__m128 p = _mm_add_ps(_mm_set1_ps((float)ATANPOLY_A9), _mm_mul_ps(s, _mm_set1_ps((float)ATANPOLY_A11)));
+		p = _mm_add_ps(_mm_set1_ps((float)ATANPOLY_A7), _mm_mul_ps(s, p));
+		p = _mm_add_ps(_mm_set1_ps((float)ATANPOLY_A5), _mm_mul_ps(s, p));
+		p = _mm_add_ps(_mm_set1_ps((float)ATANPOLY_A3), _mm_mul_ps(s, p));
+		p = _mm_add_ps(_mm_set1_ps((float)ATANPOLY_A1), _mm_mul_ps(s, p));
+		p = _mm_mul_ps(t, p);
+		p = SelectSse2(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps((float)K_PI2), p), p);
+		p = SelectSse2(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps((float)K_PI), p), p);
+		p = _mm_xor_ps(p, _mm_and_ps(_mm_cmplt_ps(y, zero), sign));
+		_mm_storeu_ps(pOutData + i, _mm_mul_ps(p, scale));
+	}
+	PolyAtan2Scalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+FMDSP_TARGET_SSE2
+static void PolarSse2(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const __m128 scale = _mm_set1_ps(Scale);
+	int i = 0;
+	for( ; i<=(Count-4); i+=4)
+	{
+		__m128 re0, im0, re1, im1;
+		LoadSplitSse2(pInData + i, re0, im0);
+		LoadSplitSse2(pInData + i - 1, re1, im1);
+		__m128 y = _mm_sub_ps(_mm_mul_ps(re1, im0), _mm_mul_ps(re0, im1));
+		_mm_storeu_ps(pOutData + i, _mm_mul_ps(y, scale));
+	}
+	PolarScalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// AVX2 implementations, 8 single or 4 double precision samples per
+// iteration. The I and Q split leaves the samples in 128 bit lane
+// order, which is restored when the results are stored
+//////////////////////////////////////////////////////////////////////
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+
+//loads 4 complex samples split into their I and Q parts in the order 0 2 1 3
+FMDSP_TARGET_AVX2
+static inline void LoadSplitAvx2(const TYPECPX* p, __m256d& re, __m256d& im)
+{
+	__m256d a = _mm256_loadu_pd(&p[0].re);
+	__m256d b = _mm256_loadu_pd(&p[2].re);
+	re = _mm256_unpacklo_pd(a, b);
+	im = _mm256_unpackhi_pd(a, b);
+}
+
+//stores 4 results that are in the order 0 2 1 3
+FMDSP_TARGET_AVX2
+static inline void StoreOrderedAvx2(TYPEREAL* p, __m256d v)
+{
+	_mm256_storeu_pd(p, _mm256_permute4x64_pd(v, _MM_SHUFFLE(3,1,2,0)));
+}
+
+FMDSP_TARGET_AVX2
+static void PolyAtan2Avx2(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const __m256d sign = _mm256_set1_pd(-0.0);
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d tiny = _mm256_set1_pd(1e-300);
+	const __m256d scale = _mm256_set1_pd(Scale);
+	int i = 0;
+	for( ; i<=(Count-4); i+=4)
+	{
+		__m256d re0, im0, re1, im1;
+		LoadSplitAvx2(pInData + i, re0, im0);
+		LoadSplitAvx2(pInData + i - 1, re1, im1);
+		__m256d y = _mm256_sub_pd(_mm256_mul_pd(re1, im0), _mm256_mul_pd(re0, im1));
+		__m256d x = _mm256_add_pd(_mm256_mul_pd(re1, re0), _mm256_mul_pd(im1, im0));
+		__m256d ax = _mm256_andnot_pd(sign, x);
+		__m256d ay = _mm256_andnot_pd(sign, y);
+		__m256d t = _mm256_div_pd(_mm256_min_pd(ax, ay), _mm256_max_pd(_mm256_max_pd(ax, ay), tiny));
+		__m256d s = _mm256_mul_pd(t, t);
+		__m256d p = _mm256_add_pd(_mm256_set1_pd(ATANPOLY_A9), _mm256_mul_pd(s, _mm256_set1_pd(ATANPOLY_A11)));
+		p = _mm256_add_pd(_mm256_set1_pd(ATANPOLY_A7), _mm256_mul_pd(s, p));
+		p = _mm256_add_pd(_mm256_set1_pd(ATANPOLY_A5), _mm256_mul_pd(s, p));
+		p = _mm256_add_pd(_mm256_set1_pd(ATANPOLY_A3), _mm256_mul_pd(s, p));
+		p = _mm256_add_pd(_mm256_set1_pd(ATANPOLY_A1), _mm256_mul_pd(s, p));
+		p = _mm256_mul_pd(t, p);
+		p = _mm256_blendv_pd(p, _mm256_sub_pd(_mm256_set1_pd(K_PI2), p), _mm256_cmp_pd(ay, ax, _CMP_GT_OQ));
+		p = _mm256_blendv_pd(p, _mm256_sub_pd(_mm256_set1_pd(K_PI), p), _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+		p = _mm256_xor_pd(p, _mm256_and_pd(_mm256_cmp_pd(y, zero, _CMP_LT_OQ), sign));
+		StoreOrderedAvx2(pOutData + i, _mm256_mul_pd(p, scale));
+	}
+	_mm256_zeroupper();	//the tail is SSE code
+	PolyAtan2Scalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+FMDSP_TARGET_AVX2
+static void PolarAvx2(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const __m256d scale = _mm256_set1_pd(Scale);
+	int i = 0;
+	for( ; i<=(Count-4); i+=4)
+	{
+		__m256d re0, im0, re1, im1;
+		LoadSplitAvx2(pInData + i, re0, im0);
+		LoadSplitAvx2(pInData + i - 1, re1, im1);
+		__m256d y = _mm256_sub_pd(_mm256_mul_pd(re1, im0), _mm256_mul_pd(re0, im1));
+		StoreOrderedAvx2(pOutData + i, _mm256_mul_pd(y, scale));
+	}
+	_mm256_zeroupper();	//the tail is SSE code
+	PolarScalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+#else
+
+//loads 8 complex samples split into their I and Q parts in the order 0 1 4 5 2 3 6 7
+FMDSP_TARGET_AVX2
+static inline void LoadSplitAvx2(const TYPECPX* p, __m256& re, __m256& im)
+{
+	__m256 a = _mm256_loadu_ps(&p[0].re);
+	__m256 b = _mm256_loadu_ps(&p[4].re);
+	re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+	im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+}
+
+//stores 8 results that are in the order 0 1 4 5 2 3 6 7
+FMDSP_TARGET_AVX2
+static inline void StoreOrderedAvx2(TYPEREAL* p, __m256 v)
+{
+	_mm256_storeu_ps(p, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), _MM_SHUFFLE(3,1,2,0))));
+}
+
+FMDSP_TARGET_AVX2
+static void PolyAtan2Avx2(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const __m256 sign = _mm256_set1_ps(-0.0f);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 tiny = _mm256_set1_ps(1e-30f);
+	const __m256 scale = _mm256_set1_ps(Scale);
+	int i = 0;
+	for( ; i<=(Count-8); i+=8)
+	{
+		__m256 re0, im0, re1, im1;
+		LoadSplitAvx2(pInData + i, re0, im0);
+		LoadSplitAvx2(pInData + i - 1, re1, im1);
+		__m256 y = _mm256_sub_ps(_mm256_mul_ps(re1, im0), _mm256_mul_ps(re0, im1));
+		__m256 x = _mm256_add_ps(_mm256_mul_ps(re1, re0), _mm256_mul_ps(im1, im0));
+		__m256 ax = _mm256_andnot_ps(sign, x);
+		__m256 ay = _mm256_andnot_ps(sign, y);
+		__m256 t = _mm256_div_ps(_mm256_min_ps(ax, ay), _mm256_max_ps(_mm256_max_ps(ax, ay), tiny));
+		__m256 s = _mm256_mul_ps(t, t);
+		__m256 p = _mm256_add_ps(_mm256_set1_ps((float)ATANPOLY_A9), _mm256_mul_ps(s, _mm256_set1_ps((float)ATANPOLY_A11)));
+		p = _mm256_add_ps(_mm256_set1_ps((float)ATANPOLY_A7), _mm256_mul_ps(s, p));
+		p = _mm256_add_ps(_mm256_set1_ps((float)ATANPOLY_A5), _mm256_mul_ps(s, p));
+		p = _mm256_add_ps(_mm256_set1_ps((float)ATANPOLY_A3), _mm256_mul_ps(s, p));
+		p = _mm256_add_ps(_mm256_set1_ps((float)ATANPOLY_A1), _mm256_mul_ps(s, p));
+		p = _mm256_mul_ps(t, p);
+		p = _mm256_blendv_ps(p, _mm256_sub_ps(_mm256_set1_ps((float)K_PI2), p), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+		p = _mm256_blendv_ps(p, _mm256_sub_ps(_mm256_set1_ps((float)K_PI), p), _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+		p = _mm256_xor_ps(p, _mm256_and_ps(_mm256_cmp_ps(y, zero, _CMP_LT_OQ), sign));
+		StoreOrderedAvx2(pOutData + i, _mm256_mul_ps(p, scale));
+	}
+	_mm256_zeroupper();	//the tail is SSE code
+	PolyAtan2Scalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+FMDSP_TARGET_AVX2
+static void PolarAvx2(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const __m256 scale = _mm256_set1_ps(Scale);
+	int i = 0;
+	for( ; i<=(Count-8); i+=8)
+	{
+		__m256 re0, im0, re1, im1;
+		LoadSplitAvx2(pInData + i, re0, im0);
+		LoadSplitAvx2(pInData + i - 1, re1, im1);
+		__m256 y = _mm256_sub_ps(_mm256_mul_ps(re1, im0), _mm256_mul_ps(re0, im1));
+		StoreOrderedAvx2(pOutData + i, _mm256_mul_ps(y, scale));
+	}
+	_mm256_zeroupper();	//the tail is SSE code
+	PolarScalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+#endif
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+//////////////////////////////////////////////////////////////////////
+// NEON implementations, 4 single or 2 double precision samples per
+// iteration
+//////////////////////////////////////////////////////////////////////
+#if !defined(FMDSP_USE_DOUBLE_PRECISION)
+
+static void PolyAtan2Neon(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const uint32x4_t sign = vdupq_n_u32(0x80000000);
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t tiny = vdupq_n_f32(1e-30f);
+	int i = 0;
+	for( ; i<=(Count-4); i+=4)
+	{
+		float32x4x2_t d0 = vld2q_f32(&pInData[i].re);
+		float32x4x2_t d1 = vld2q_f32(&pInData[i-1].re);
+		float32x4_t y = vsubq_f32(vmulq_f32(d1.val[0], d0.val[1]), vmulq_f32(d0.val[0], d1.val[1]));
+		float32x4_t x = vaddq_f32(vmulq_f32(d1.val[0], d0.val[0]), vmulq_f32(d1.val[1], d0.val[1]));
+		float32x4_t ax = vabsq_f32(x);
+		float32x4_t ay = vabsq_f32(y);
+		float32x4_t mx = vmaxq_f32(vmaxq_f32(ax, ay), tiny);
+		//reciprocal estimate refined with 2 Newton-Raphson steps since ARMv7 has no divide
+		float32x4_t r = vrecpeq_f32(mx);
+		r = vmulq_f32(r, vrecpsq_f32(mx, r));
+		r = vmulq_f32(r, vrecpsq_f32(mx, r));
+		float32x4_t t = vmulq_f32(vminq_f32(ax, ay), r);
+		float32x4_t s = vmulq_f32(t, t);
+		float32x4_t p = vmlaq_n_f32(vdupq_n_f32((float)ATANPOLY_A9), s, (float)ATANPOLY_A11);
+		p = vmlaq_f32(vdupq_n_f32((float)ATANPOLY_A7), s, p);
+		p = vmlaq_f32(vdupq_n_f32((float)ATANPOLY_A5), s, p);
+		p = vmlaq_f32(vdupq_n_f32((float)ATANPOLY_A3), s, p);
+		p = vmlaq_f32(vdupq_n_f32((float)ATANPOLY_A1), s, p);
+		p = vmulq_f32(t, p);
+		p = vbslq_f32(vcgtq_f32(ay, ax), vsubq_f32(vdupq_n_f32((float)K_PI2), p), p);
+		p = vbslq_f32(vcltq_f32(x, zero), vsubq_f32(vdupq_n_f32((float)K_PI), p), p);
+		p = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(p), vandq_u32(vcltq_f32(y, zero), sign)));
+		vst1q_f32(pOutData + i, vmulq_n_f32(p, Scale));
+	}
+	PolyAtan2Scalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+static void PolarNeon(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	int i = 0;
+	for( ; i<=(Count-4); i+=4)
+	{
+		float32x4x2_t d0 = vld2q_f32(&pInData[i].re);
+		float32x4x2_t d1 = vld2q_f32(&pInData[i-1].re);
+		float32x4_t y = vsubq_f32(vmulq_f32(d1.val[0], d0.val[1]), vmulq_f32(d0.val[0], d1.val[1]));
+		vst1q_f32(pOutData + i, vmulq_n_f32(y, Scale));
+	}
+	PolarScalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+#elif defined(FMDSP_SIMD_NEON64)
+
+static void PolyAtan2Neon(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	const uint64x2_t sign = vdupq_n_u64(0x8000000000000000ULL);
+	const float64x2_t zero = vdupq_n_f64(0.0);
+	const float64x2_t tiny = vdupq_n_f64(1e-300);
+	int i = 0;
+	for( ; i<=(Count-2); i+=2)
+	{
+		float64x2x2_t d0 = vld2q_f64(&pInData[i].re);
+		float64x2x2_t d1 = vld2q_f64(&pInData[i-1].re);
+		float64x2_t y = vsubq_f64(vmulq_f64(d1.val[0], d0.val[1]), vmulq_f64(d0.val[0], d1.val[1]));
+		float64x2_t x = vaddq_f64(vmulq_f64(d1.val[0], d0.val[0]), vmulq_f64(d1.val[1], d0.val[1]));
+		float64x2_t ax = vabsq_f64(x);
+		float64x2_t ay = vabsq_f64(y);
+		float64x2_t t = vdivq_f64(vminq_f64(ax, ay), vmaxq_f64(vmaxq_f64(ax, ay), tiny));
+		float64x2_t s = vmulq_f64(t, t);
+		float64x2_t p = vmlaq_n_f64(vdupq_n_f64(ATANPOLY_A9), s, ATANPOLY_A11);
+		p = vmlaq_f64(vdupq_n_f64(ATANPOLY_A7), s, p);
+		p = vmlaq_f64(vdupq_n_f64(ATANPOLY_A5), s, p);
+		p = vmlaq_f64(vdupq_n_f64(ATANPOLY_A3), s, p);
+		p = vmlaq_f64(vdupq_n_f64(ATANPOLY_A1), s, p);
+		p = vmulq_f64(t, p);
+		p = vbslq_f64(vcgtq_f64(ay, ax), vsubq_f64(vdupq_n_f64(K_PI2), p), p);
+		p = vbslq_f64(vcltq_f64(x, zero), vsubq_f64(vdupq_n_f64(K_PI), p), p);
+		p = vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(p), vandq_u64(vcltq_f64(y, zero), sign)));
+		vst1q_f64(pOutData + i, vmulq_n_f64(p, Scale));
+	}
+	PolyAtan2Scalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+static void PolarNeon(int Count, const TYPECPX* pInData, TYPEREAL Scale, TYPEREAL* pOutData)
+{
+	int i = 0;
+	for( ; i<=(Count-2); i+=2)
+	{
+		float64x2x2_t d0 = vld2q_f64(&pInData[i].re);
+		float64x2x2_t d1 = vld2q_f64(&pInData[i-1].re);
+		float64x2_t y = vsubq_f64(vmulq_f64(d1.val[0], d0.val[1]), vmulq_f64(d0.val[0], d1.val[1]));
+		vst1q_f64(pOutData + i, vmulq_n_f64(y, Scale));
+	}
+	PolarScalar(Count - i, pInData + i, Scale, pOutData + i);
+}
+
+#else
+ #define FMDSP_DISC_NO_NEON		//no double precision NEON on ARMv7
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tDiscriminate s_pPolyAtan2 = PolyAtan2Scalar;
+static tDiscriminate s_pPolar = PolarScalar;
+
+//////////////////////////////////////////////////////////////////////
+// Bind the implementations for the instruction set, return their names
+//////////////////////////////////////////////////////////////////////
+const char* BindPolyAtan2(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pPolyAtan2 = PolyAtan2Avx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pPolyAtan2 = PolyAtan2Sse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(FMDSP_DISC_NO_NEON)
+	case SIMD_NEON:
+		s_pPolyAtan2 = PolyAtan2Neon;
+		return "NEON";
+#endif
+	default:
+		s_pPolyAtan2 = PolyAtan2Scalar;
+		return "scalar";
+	}
+}
+
+const char* BindPolar(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pPolar = PolarAvx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pPolar = PolarSse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(FMDSP_DISC_NO_NEON)
+	case SIMD_NEON:
+		s_pPolar = PolarNeon;
+		return "NEON";
+#endif
+	default:
+		s_pPolar = PolarScalar;
+		return "scalar";
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct CFmDiscriminator object
+/////////////////////////////////////////////////////////////////////////////////
+CFmDiscriminator::CFmDiscriminator(int Type)
+{
+	m_Type = Type;
+	Reset();
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Clears the sample delay line
+/////////////////////////////////////////////////////////////////////////////////
+void CFmDiscriminator::Reset()
+{
+	m_Prev.re = 0.0;
+	m_Prev.im = 0.0;
+	m_InvMagnitude = 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Returns the average power of InLength complex samples
+/////////////////////////////////////////////////////////////////////////////////
+TYPEREAL CFmDiscriminator::AveragePower(int InLength, const TYPECPX* pInData)
+{
+TYPEREAL sum = 0.0;
+	for(int i=0; i<InLength; i++)
+		sum += (pInData[i].re*pInData[i].re + pInData[i].im*pInData[i].im);
+	return sum / (TYPEREAL)InLength;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Demodulate InLength pInData[] samples and place in pOutData[]
+// pOutData may not be the same buffer as pInData.
+/////////////////////////////////////////////////////////////////////////////////
+void CFmDiscriminator::ProcessData(int InLength, const TYPECPX* pInData, TYPEREAL Gain, TYPEREAL* pOutData)
+{
+	if(InLength <= 0)
+		return;
+	const TYPECPX& d0 = pInData[0];
+	TYPEREAL y = (m_Prev.re*d0.im - d0.re*m_Prev.im);
+	TYPEREAL x = (m_Prev.re*d0.re + m_Prev.im*d0.im);
+	if(DISC_POLYATAN2 == m_Type)
+	{
+		pOutData[0] = Gain * PolyAtan2(y, x);
+		s_pPolyAtan2(InLength - 1, pInData + 1, Gain, pOutData + 1);
+	}
+	else if(DISC_POLAR == m_Type)
+	{
+		//the cross product scales with the signal power so is normalized once per block
+		TYPEREAL power = AveragePower(InLength, pInData);
+		TYPEREAL scale = (power > 0.0) ? (Gain / power) : 0.0;
+		pOutData[0] = scale * y;
+		s_pPolar(InLength - 1, pInData + 1, scale, pOutData + 1);
+	}
+	else
+	{
+		pOutData[0] = Gain * MATAN2(y, x);
+		for(int i=1; i<InLength; i++)
+		{
+			const TYPECPX& d1 = pInData[i-1];
+			const TYPECPX& d = pInData[i];
+			pOutData[i] = Gain * MATAN2( (d1.re*d.im - d.re*d1.im), (d1.re*d.re + d1.im*d.im) );
+		}
+	}
+	m_Prev = pInData[InLength-1];
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Calculates the per block values needed by PhaseDetector()
+/////////////////////////////////////////////////////////////////////////////////
+void CFmDiscriminator::PreparePhaseDetector(int InLength, const TYPECPX* pInData)
+{
+	if( (DISC_POLAR == m_Type) && (InLength > 0) )
+	{
+		TYPEREAL power = AveragePower(InLength, pInData);
+		m_InvMagnitude = (power > 0.0) ? (1.0 / MSQRT(power)) : 0.0;
+	}
+}
+
+} // namespace FMDSP_NAMESPACE
@@ -0,0 +1,108 @@
+//////////////////////////////////////////////////////////////////////
+// dispatch.cpp: implementation of the runtime DSP kernel dispatch.
+//
+//  Each kernel module provides a Bind function that points its kernel
+//at the implementation for an instruction set and returns the name of
+//that implementation. A kernel without an implementation for the
+//requested instruction set falls back to the next best one it has.
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "dispatch.h"
+#include "simd.h"
+#include "discriminator.h"
+#include "downconvert.h"
+#include "fastfir.h"
+#include "fft.h"
+#include "firkernel.h"
+#include "halfband.h"
+#include "iir.h"
+#include "iqconvert.h"
+#include "polyresampler.h"
+
+namespace FMDSP_NAMESPACE {
+
+typedef const char* (*tBindKernel)(enum SimdLevel Level);
+
+//////////////////////////////////////////////////////////////////////
+// The dispatched kernels in the order of the signal chain
+//////////////////////////////////////////////////////////////////////
+static const struct
+{
+	const char* Name;
+	tBindKernel Bind;
+} DSP_KERNELS[] =
+{
+	{ "u8 to float I/Q conversion", BindConvertIQ8 },
+	{ "NCO mixer", BindNcoMix },
+	{ "half band decimator", BindHalfBandDecBy2 },
+	{ "FIR filter", BindFirFilterBlock },
+	{ "fixed point dot product", BindFixedDotProduct },
+	{ "polynomial atan2 discriminator", BindPolyAtan2 },
+	{ "polar discriminator", BindPolar },
+	{ "biquad filter", BindBiquad },
+	{ "de-emphasis filter", BindOnePole },
+	{ "resampler", BindPolyDot },
+	{ "stereo resampler", BindPolyDotCpx },
+	{ "FFT", BindFft },
+	{ "fast FIR complex multiply", BindCpxMpy },
+};
+
+//////////////////////////////////////////////////////////////////////
+// Returns the best instruction set supported by the running CPU
+//////////////////////////////////////////////////////////////////////
+enum SimdLevel ProbeSimdLevel()
+{
+#ifdef FMDSP_SIMD_X86
+	if( SimdHasAvx2() )
+		return SIMD_AVX2;
+	if( SimdHasSse2() )
+		return SIMD_SSE2;
+#endif
+#ifdef FMDSP_SIMD_NEON
+	if( SimdHasNeon() )
+		return SIMD_NEON;
+#endif
+	return SIMD_SCALAR;
+}
+
+const char* GetSimdLevelName(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+	case SIMD_SSE2:
+		return "SSE2";
+	case SIMD_AVX2:
+		return "AVX2";
+	case SIMD_NEON:
+		return "NEON";
+	default:
+		return "scalar";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Binds every kernel to its implementation for Level
+//////////////////////////////////////////////////////////////////////
+void BindDspKernels(enum SimdLevel Level, tDspKernelCallback const& Callback)
+{
+	for(size_t i=0; i<sizeof(DSP_KERNELS) / sizeof(DSP_KERNELS[0]); i++)
+	{
+		const char* implementation = DSP_KERNELS[i].Bind(Level);
+		if(Callback)
+			Callback(DSP_KERNELS[i].Name, implementation);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Probes the CPU and binds the kernels
+//////////////////////////////////////////////////////////////////////
+const char* InitDspKernels(tDspKernelCallback const& Callback)
+{
+	enum SimdLevel level = ProbeSimdLevel();
+	BindDspKernels(level, Callback);
+	return GetSimdLevelName(level);
+}
+
+} // namespace FMDSP_NAMESPACE
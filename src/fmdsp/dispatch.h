@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////
+// dispatch.h: interface for the runtime DSP kernel dispatch.
+//
+//  The hot DSP kernels have scalar, SSE2, AVX2 and NEON implementations
+//that are called through function pointers. InitDspKernels() probes the
+//running CPU once and binds every pointer to the best implementation,
+//so a single binary per architecture can use AVX2 or NEON without
+//requiring them. Until it is called the scalar implementations are used.
+//The NEON implementations are only compiled when FMDSP_ENABLE_NEON is
+//defined, see simd.h.
+//
+//  The element wise kernels produce the same results whatever they are
+//bound to. The dot product and filter kernels sum in a different order
+//so their outputs differ from the scalar ones by about -140dB in single
+//and -310dB in double precision, test/dispatch.cpp checks each binding
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include "datatypes.h"
+#include <functional>
+
+namespace FMDSP_NAMESPACE {
+
+//instruction sets the kernels are implemented for
+enum SimdLevel
+{
+	SIMD_SCALAR = 0,
+	SIMD_SSE2,
+	SIMD_AVX2,		//implies SSE2
+	SIMD_NEON
+};
+
+//receives the name of each kernel and of the implementation bound to it
+typedef std::function<void(const char* Kernel, const char* Implementation)> tDspKernelCallback;
+
+//returns the best instruction set supported by the running CPU
+enum SimdLevel ProbeSimdLevel();
+const char* GetSimdLevelName(enum SimdLevel Level);
+
+//binds every kernel to its implementation for Level, or the next best one
+//the kernel has, and reports each binding to Callback. Must not be called
+//while any DSP objects are processing data
+void BindDspKernels(enum SimdLevel Level, tDspKernelCallback const& Callback);
+
+//probes the CPU and binds the kernels, returns the name of the instruction set
+const char* InitDspKernels(tDspKernelCallback const& Callback);
+
+} // namespace FMDSP_NAMESPACE
+
+// Both precisions are compiled into the addon, each with its own kernels
+namespace fmdsp_single {
+
+	const char* InitDspKernels(std::function<void(const char* Kernel, const char* Implementation)> const& Callback);
+};
+
+namespace fmdsp_double {
+
+	const char* InitDspKernels(std::function<void(const char* Kernel, const char* Implementation)> const& Callback);
+};
+
+#endif // DISPATCH_H
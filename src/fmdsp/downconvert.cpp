@@ -41,19 +41,206 @@
 //==========================================================================================
 #include "downconvert.h"
 #include "filtercoef.h"
+#include "firkernel.h"
+#include "iqconvert.h"
+#include "simd.h"
 #include <algorithm>
 #include <assert.h>
 #include <string.h>
 
+namespace FMDSP_NAMESPACE {
+
 //pick a method of calculating the NCO
 #define NCO_LIB 0		//normal sin cos library (188nS)
-#define NCO_OSC 1		//quadrature oscillator (25nS)
+#define NCO_OSC 0		//quadrature oscillator (25nS)
+#define NCO_TABLE 1		//phasor table rotated by one sin cos library call per table length
 #define NCO_VCASM 0		//Visual C assembly call to floating point sin/cos instruction
 #define NCO_GCCASM 0	//GCC assembly call to floating point sin/cos instruction (100nS)
 
 #define MIN_OUTPUT_RATE (7900.0*2.0)
 
-#define MAX_HALF_BAND_BUFSIZE 32768
+#define DEC_TILE_SIZE 4096		//samples passed through the decimation chain at a time
+
+#define FS4_TOLERANCE 1.0		//Hz the NCO can be off from fs/4 and still be treated as fs/4
+
+#define RAWHB_COEF_BITS 16		//fractional bits of the integer half band coefficients
+
+//////////////////////////////////////////////////////////////////////
+// NCO mixer kernels. Each sample k is multiplied by the oscillator
+// phasor Phase * pTable[k]; pOut may be the same buffer as pIn.
+// All implementations evaluate the same products in the same order
+// so they produce identical results
+//////////////////////////////////////////////////////////////////////
+typedef void (*tNcoMix)(int Count, TYPECPX Phase, const TYPECPX* pTable, const TYPECPX* pIn, TYPECPX* pOut);
+
+static void NcoMixScalar(int Count, TYPECPX Phase, const TYPECPX* pTable, const TYPECPX* pIn, TYPECPX* pOut)
+{
+TYPECPX dtmp;
+TYPECPX Osc;
+	for(int k=0; k<Count; k++)
+	{
+		dtmp = pIn[k];
+		Osc.re = (Phase.re * pTable[k].re) - (Phase.im * pTable[k].im);
+		Osc.im = (Phase.re * pTable[k].im) + (Phase.im * pTable[k].re);
+		//Cpx multiply by shift frequency
+		pOut[k].re = ((dtmp.re * Osc.re) - (dtmp.im * Osc.im));
+		pOut[k].im = ((dtmp.re * Osc.im) + (dtmp.im * Osc.re));
+	}
+}
+
+#ifdef FMDSP_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 implementation, 2 single or 1 double precision samples per
+// iteration. The products of the imaginary parts are negated in the
+// real lanes by flipping their sign bit
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_SSE2
+static void NcoMixSse2(int Count, TYPECPX Phase, const TYPECPX* pTable, const TYPECPX* pIn, TYPECPX* pOut)
+{
+	int k = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	const __m128d pre = _mm_set1_pd(Phase.re);
+	const __m128d pim = _mm_set1_pd(Phase.im);
+	const __m128d sign = _mm_setr_pd(-0.0, 0.0);
+	for( ; k<Count; k++)
+	{
+		__m128d t = _mm_loadu_pd(&pTable[k].re);
+		__m128d osc = _mm_add_pd(_mm_mul_pd(pre, t), _mm_xor_pd(_mm_mul_pd(pim, _mm_shuffle_pd(t, t, 1)), sign));
+		__m128d x = _mm_loadu_pd(&pIn[k].re);
+		__m128d y = _mm_add_pd(_mm_mul_pd(x, _mm_unpacklo_pd(osc, osc)),
+				_mm_xor_pd(_mm_mul_pd(_mm_shuffle_pd(x, x, 1), _mm_unpackhi_pd(osc, osc)), sign));
+		_mm_storeu_pd(&pOut[k].re, y);
+	}
+#else
+	const __m128 pre = _mm_set1_ps(Phase.re);
+	const __m128 pim = _mm_set1_ps(Phase.im);
+	const __m128 sign = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+	for( ; k<=(Count-2); k+=2)
+	{
+		__m128 t = _mm_loadu_ps(&pTable[k].re);
+		__m128 osc = _mm_add_ps(_mm_mul_ps(pre, t), _mm_xor_ps(_mm_mul_ps(pim, _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 3, 0, 1))), sign));
+		__m128 x = _mm_loadu_ps(&pIn[k].re);
+		__m128 y = _mm_add_ps(_mm_mul_ps(x, _mm_shuffle_ps(osc, osc, _MM_SHUFFLE(2, 2, 0, 0))),
+				_mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(osc, osc, _MM_SHUFFLE(3, 3, 1, 1))), sign));
+		_mm_storeu_ps(&pOut[k].re, y);
+	}
+#endif
+	NcoMixScalar(Count - k, Phase, pTable + k, pIn + k, pOut + k);
+}
+
+//////////////////////////////////////////////////////////////////////
+// AVX2 implementation, 4 single or 2 double precision samples per
+// iteration
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_AVX2
+static void NcoMixAvx2(int Count, TYPECPX Phase, const TYPECPX* pTable, const TYPECPX* pIn, TYPECPX* pOut)
+{
+	int k = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	const __m256d pre = _mm256_set1_pd(Phase.re);
+	const __m256d pim = _mm256_set1_pd(Phase.im);
+	for( ; k<=(Count-2); k+=2)
+	{
+		__m256d t = _mm256_loadu_pd(&pTable[k].re);
+		__m256d osc = _mm256_addsub_pd(_mm256_mul_pd(pre, t), _mm256_mul_pd(pim, _mm256_permute_pd(t, 0x5)));
+		__m256d x = _mm256_loadu_pd(&pIn[k].re);
+		__m256d y = _mm256_addsub_pd(_mm256_mul_pd(x, _mm256_movedup_pd(osc)),
+				_mm256_mul_pd(_mm256_permute_pd(x, 0x5), _mm256_permute_pd(osc, 0xF)));
+		_mm256_storeu_pd(&pOut[k].re, y);
+	}
+#else
+	const __m256 pre = _mm256_set1_ps(Phase.re);
+	const __m256 pim = _mm256_set1_ps(Phase.im);
+	for( ; k<=(Count-4); k+=4)
+	{
+		__m256 t = _mm256_loadu_ps(&pTable[k].re);
+		__m256 osc = _mm256_addsub_ps(_mm256_mul_ps(pre, t), _mm256_mul_ps(pim, _mm256_permute_ps(t, _MM_SHUFFLE(2, 3, 0, 1))));
+		__m256 x = _mm256_loadu_ps(&pIn[k].re);
+		__m256 y = _mm256_addsub_ps(_mm256_mul_ps(x, _mm256_moveldup_ps(osc)),
+				_mm256_mul_ps(_mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_movehdup_ps(osc)));
+		_mm256_storeu_ps(&pOut[k].re, y);
+	}
+#endif
+	_mm256_zeroupper();	//the tail is SSE code
+	NcoMixScalar(Count - k, Phase, pTable + k, pIn + k, pOut + k);
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+#if defined(FMDSP_USE_DOUBLE_PRECISION) && !defined(FMDSP_SIMD_NEON64)
+ #define NCO_NO_NEON		//no double precision NEON on 32 bit ARM
+#else
+
+//////////////////////////////////////////////////////////////////////
+// NEON implementation, 4 single or 2 double precision samples per
+// iteration with the real and imaginary parts loaded into separate
+// vectors
+//////////////////////////////////////////////////////////////////////
+static void NcoMixNeon(int Count, TYPECPX Phase, const TYPECPX* pTable, const TYPECPX* pIn, TYPECPX* pOut)
+{
+	int k = 0;
+#if !defined(FMDSP_USE_DOUBLE_PRECISION)
+	for( ; k<=(Count-4); k+=4)
+	{
+		float32x4x2_t t = vld2q_f32(&pTable[k].re);
+		float32x4_t ore = vsubq_f32(vmulq_n_f32(t.val[0], Phase.re), vmulq_n_f32(t.val[1], Phase.im));
+		float32x4_t oim = vaddq_f32(vmulq_n_f32(t.val[1], Phase.re), vmulq_n_f32(t.val[0], Phase.im));
+		float32x4x2_t x = vld2q_f32(&pIn[k].re);
+		float32x4x2_t y;
+		y.val[0] = vsubq_f32(vmulq_f32(x.val[0], ore), vmulq_f32(x.val[1], oim));
+		y.val[1] = vaddq_f32(vmulq_f32(x.val[0], oim), vmulq_f32(x.val[1], ore));
+		vst2q_f32(&pOut[k].re, y);
+	}
+#else
+	for( ; k<=(Count-2); k+=2)
+	{
+		float64x2x2_t t = vld2q_f64(&pTable[k].re);
+		float64x2_t ore = vsubq_f64(vmulq_n_f64(t.val[0], Phase.re), vmulq_n_f64(t.val[1], Phase.im));
+		float64x2_t oim = vaddq_f64(vmulq_n_f64(t.val[1], Phase.re), vmulq_n_f64(t.val[0], Phase.im));
+		float64x2x2_t x = vld2q_f64(&pIn[k].re);
+		float64x2x2_t y;
+		y.val[0] = vsubq_f64(vmulq_f64(x.val[0], ore), vmulq_f64(x.val[1], oim));
+		y.val[1] = vaddq_f64(vmulq_f64(x.val[0], oim), vmulq_f64(x.val[1], ore));
+		vst2q_f64(&pOut[k].re, y);
+	}
+#endif
+	NcoMixScalar(Count - k, Phase, pTable + k, pIn + k, pOut + k);
+}
+
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tNcoMix s_pNcoMix = NcoMixScalar;
+
+//////////////////////////////////////////////////////////////////////
+// Binds the NCO mixer for the instruction set, returns its name
+//////////////////////////////////////////////////////////////////////
+const char* BindNcoMix(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pNcoMix = NcoMixAvx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pNcoMix = NcoMixSse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(NCO_NO_NEON)
+	case SIMD_NEON:
+		s_pNcoMix = NcoMixNeon;
+		return "NEON";
+#endif
+	default:
+		s_pNcoMix = NcoMixScalar;
+		return "scalar";
+	}
+}
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -68,6 +255,9 @@ int i;
 	m_MaxBW = 10000.0;
 	for(i=0; i<MAX_DECSTAGES; i++)
 		m_pDecimatorPtrs[i] = NULL;
+	m_pRawDecimator = NULL;
+	m_Fs4Direction = 0;
+	m_Fs4Phase = 0;
 	m_Osc1.re = 1.0;	//initialize unit vector that will get rotated
 	m_Osc1.im = 0.0;
 }
@@ -90,6 +280,31 @@ void CDownConvert::DeleteFilters()
 			m_pDecimatorPtrs[i] = NULL;
 		}
 	}
+	if(m_pRawDecimator)
+	{
+		delete m_pRawDecimator;
+		m_pRawDecimator = NULL;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Creates the integer replacement for the first decimate by 2 stage
+// used when processing raw I/Q samples, if the first stage is a half
+// band filter
+//////////////////////////////////////////////////////////////////////
+void CDownConvert::CreateRawDecimator()
+{
+	if(m_pRawDecimator)
+	{
+		delete m_pRawDecimator;
+		m_pRawDecimator = NULL;
+	}
+	if(m_pDecimatorPtrs[0] == NULL)
+		return;
+	const TYPEREAL* pCoef;
+	int len = m_pDecimatorPtrs[0]->GetHalfBandCoef(&pCoef);
+	if( (len > 0) && (len <= MAX_RAWHB_LENGTH) )
+		m_pRawDecimator = new CRawHalfBandDecimateBy2(len, pCoef);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -101,6 +316,19 @@ void CDownConvert::SetFrequency(TYPEREAL NcoFreq)
 	m_NcoInc = K_2PI*m_NcoFreq/m_InRate;
 	m_OscCos = MCOS(m_NcoInc);
 	m_OscSin = MSIN(m_NcoInc);
+	//phasor table of the NCO rotation over NCO_TABLE_SIZE samples
+	for(int i=0; i<NCO_TABLE_SIZE; i++)
+	{
+		m_NcoTable[i].re = MCOS(m_NcoInc * i);
+		m_NcoTable[i].im = MSIN(m_NcoInc * i);
+	}
+	//determine if the NCO is at +/-fs/4, mixing can then be done without multiplies
+	if( MFABS(m_NcoFreq - (m_InRate / 4.0)) < FS4_TOLERANCE )
+		m_Fs4Direction = 1;
+	else if( MFABS(m_NcoFreq + (m_InRate / 4.0)) < FS4_TOLERANCE )
+		m_Fs4Direction = -1;
+	else
+		m_Fs4Direction = 0;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -126,44 +354,46 @@ TYPEREAL f = InRate;
 		//loop until closest output rate is found and list of pointers to decimate by 2 stages is generated
 		while( (f > (m_MaxBW / HB51TAP_MAX) ) && (f > MIN_OUTPUT_RATE) )
 		{
+			int len = DEC_TILE_SIZE >> n;	//maximum input length of this stage
 			if(f >= (m_MaxBW / CIC3_MAX) )		//See if can use CIC order 3
 				m_pDecimatorPtrs[n++] =
-						new CCicN3DecimateBy2;
-			else if(f >= (m_MaxBW / HB11TAP_MAX) )	//See if can use fixed 11 Tap Halfband
+						new CCicN3DecimateBy2(len);
+			else if(f >= (m_MaxBW / HB11TAP_MAX) )	//See if can use Halfband 11 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBand11TapDecimateBy2();
+						new CHalfBandDecimateBy2<HB11TAP_LENGTH>(HB11TAP_H, len);
 			else if(f >= (m_MaxBW / HB15TAP_MAX) )	//See if can use Halfband 15 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB15TAP_LENGTH, HB15TAP_H);
+						new CHalfBandDecimateBy2<HB15TAP_LENGTH>(HB15TAP_H, len);
 			else if(f >= (m_MaxBW / HB19TAP_MAX) )	//See if can use Halfband 19 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB19TAP_LENGTH, HB19TAP_H);
+						new CHalfBandDecimateBy2<HB19TAP_LENGTH>(HB19TAP_H, len);
 			else if(f >= (m_MaxBW / HB23TAP_MAX) )	//See if can use Halfband 23 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB23TAP_LENGTH, HB23TAP_H);
+						new CHalfBandDecimateBy2<HB23TAP_LENGTH>(HB23TAP_H, len);
 			else if(f >= (m_MaxBW / HB27TAP_MAX) )	//See if can use Halfband 27 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB27TAP_LENGTH, HB27TAP_H);
+						new CHalfBandDecimateBy2<HB27TAP_LENGTH>(HB27TAP_H, len);
 			else if(f >= (m_MaxBW / HB31TAP_MAX) )	//See if can use Halfband 31 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB31TAP_LENGTH, HB31TAP_H);
+						new CHalfBandDecimateBy2<HB31TAP_LENGTH>(HB31TAP_H, len);
 			else if(f >= (m_MaxBW / HB35TAP_MAX) )	//See if can use Halfband 35 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB35TAP_LENGTH, HB35TAP_H);
+						new CHalfBandDecimateBy2<HB35TAP_LENGTH>(HB35TAP_H, len);
 			else if(f >= (m_MaxBW / HB39TAP_MAX) )	//See if can use Halfband 39 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB39TAP_LENGTH, HB39TAP_H);
+						new CHalfBandDecimateBy2<HB39TAP_LENGTH>(HB39TAP_H, len);
 			else if(f >= (m_MaxBW / HB43TAP_MAX) )	//See if can use Halfband 43 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB43TAP_LENGTH, HB43TAP_H);
+						new CHalfBandDecimateBy2<HB43TAP_LENGTH>(HB43TAP_H, len);
 			else if(f >= (m_MaxBW / HB47TAP_MAX) )	//See if can use Halfband 47 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
+						new CHalfBandDecimateBy2<HB47TAP_LENGTH>(HB47TAP_H, len);
 			else if(f >= (m_MaxBW / HB51TAP_MAX) )	//See if can use Halfband 51 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
+						new CHalfBandDecimateBy2<HB51TAP_LENGTH>(HB51TAP_H, len);
 			f /= 2.0;
 		}
+		CreateRawDecimator();
 
 	#ifdef FMDSP_THREAD_SAFE
 		lock.unlock();
@@ -199,31 +429,33 @@ TYPEREAL f = InRate;
 		//loop until closest output rate is found and list of pointers to decimate by 2 stages is generated
 		while( (f > 400000.0)  )
 		{
+			int len = DEC_TILE_SIZE >> n;	//maximum input length of this stage
 			switch(m_Quality) {
 
 				// HIGH: 51 tap
 				case DownsampleQuality::High:
-					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
+					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2<HB51TAP_LENGTH>(HB51TAP_H, len);
 					break;
 
 				// MEDIUM: 27 tap
 				case DownsampleQuality::Medium:
-					m_pDecimatorPtrs[n++] = new CHalfBandDecimateBy2(HB27TAP_LENGTH, HB27TAP_H);
+					m_pDecimatorPtrs[n++] = new CHalfBandDecimateBy2<HB27TAP_LENGTH>(HB27TAP_H, len);
 					break;
 
 				// LOW: 11 tap
 				case DownsampleQuality::Low:
-					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBand11TapDecimateBy2();
+					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2<HB11TAP_LENGTH>(HB11TAP_H, len);
 					break;
 
 				// DEFAULT: 51 tap
 				default:
-					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
+					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2<HB51TAP_LENGTH>(HB51TAP_H, len);
 					break;
 			}
 
 			f /= 2.0;
 		}
+		CreateRawDecimator();
 
 		m_OutputRate = f;
 	#ifdef FMDSP_THREAD_SAFE
@@ -244,13 +476,65 @@ TYPEREAL f = InRate;
 // process reduces the number of output samples per block.
 // Also InLength must be a multiple of 2^N where N is the maximum
 // decimation by 2 stages expected.
-// ~50nSec/sample at decimation by 128
+// The samples are processed in tiles of DEC_TILE_SIZE samples that are
+// passed through the whole chain before the next tile is started, each
+// stage writes its output directly into the line buffer of the next
+// stage so no intermediate copies of the full buffer are made.
+// pOutData can be the same buffer as pInData.
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+int CDownConvert::ProcessData(int InLength, const TYPECPX* pInData, TYPECPX* pOutData)
 {
-int i,j;
+int numoutsamples = 0;
+
+#ifdef FMDSP_THREAD_SAFE
+	std::unique_lock<std::mutex> lock(m_Mutex);
+#endif
+
+	for(int i=0; i<InLength; i+=DEC_TILE_SIZE)
+	{
+		int n = std::min(InLength - i, DEC_TILE_SIZE);
+		//perform baseband tuning into the input of the first stage
+		TYPECPX* pStageOut = (m_pDecimatorPtrs[0]) ? m_pDecimatorPtrs[0]->GetInputBuffer() : &pOutData[numoutsamples];
+		if(m_Fs4Direction != 0)
+			MixFs4(n, &pInData[i], pStageOut);	//NCO is at +/-fs/4, so mix without any multiplies
+		else
+			Mix(n, &pInData[i], pStageOut);
+		numoutsamples += DecimateTile(0, n, &pOutData[numoutsamples]);
+	}
+
+	return numoutsamples;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Passes 'InLength' samples that have been placed in the input buffer
+// of stage 'Stage' through the remaining decimate by 2 stages until
+// NULL pointer encountered designating end of chain.
+// The last stage places its output samples in 'pOutData'.
+// Returns number of output samples of the last stage.
+//////////////////////////////////////////////////////////////////////
+int CDownConvert::DecimateTile(int Stage, int InLength, TYPECPX* pOutData)
+{
+int n = InLength;
+	while(m_pDecimatorPtrs[Stage])
+	{
+		TYPECPX* pStageOut = (m_pDecimatorPtrs[Stage + 1]) ? m_pDecimatorPtrs[Stage + 1]->GetInputBuffer() : pOutData;
+		n = m_pDecimatorPtrs[Stage++]->DecBy2(n, pStageOut);
+	}
+	return n;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mixes 'InLength' samples of 'pInData' by the NCO frequency and
+// places them in 'pOutData', which can be the same as 'pInData'.
+// ~50nSec/sample at decimation by 128 including the decimation
+//////////////////////////////////////////////////////////////////////
+void CDownConvert::Mix(int InLength, const TYPECPX* pInData, TYPECPX* pOutData)
+{
+int i;
+#if !NCO_TABLE
 TYPECPX dtmp;
 TYPECPX Osc;
+#endif
 
 #if (NCO_VCASM || NCO_GCCASM)
 TYPEREAL	dPhaseAcc = m_NcoTime;
@@ -260,6 +544,19 @@ TYPEREAL*	pdCosAns  = &dASMCos;
 TYPEREAL*	pdSinAns  = &dASMSin;
 #endif
 
+#if NCO_TABLE
+	//rotate a block of samples at a time by the phasor table, the table is
+	//rotated to the current NCO phase once per block
+	for(i=0; i<InLength; i+=NCO_TABLE_SIZE)
+	{
+		int len = std::min(InLength - i, NCO_TABLE_SIZE);
+		TYPECPX Phase;
+		Phase.re = MCOS(m_NcoTime);
+		Phase.im = MSIN(m_NcoTime);
+		s_pNcoMix(len, Phase, m_NcoTable, &pInData[i], &pOutData[i]);
+		m_NcoTime = MFMOD(m_NcoTime + (m_NcoInc * len), K_2PI);	//keep radian counter bounded
+	}
+#else
 //263uS using sin/cos or 70uS using quadrature osc or 200uS using _asm
 	for(i=0; i<InLength; i++)
 	{
@@ -296,90 +593,204 @@ TYPEREAL*	pdSinAns  = &dASMSin;
 #endif
 
 		//Cpx multiply by shift frequency
-		pInData[i].re = ((dtmp.re * Osc.re) - (dtmp.im * Osc.im));
-		pInData[i].im = ((dtmp.re * Osc.im) + (dtmp.im * Osc.re));
+		pOutData[i].re = ((dtmp.re * Osc.re) - (dtmp.im * Osc.im));
+		pOutData[i].im = ((dtmp.re * Osc.im) + (dtmp.im * Osc.re));
 	}
 #if (NCO_VCASM || NCO_GCCASM)
 	m_NcoTime = dPhaseAcc;
 #elif !NCO_OSC
 	m_NcoTime = MFMOD(m_NcoTime, K_2PI);	//keep radian counter bounded
 #endif
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mixes 'InLength' samples of 'pInData' by +/-fs/4 and places them
+// in 'pOutData', which can be the same as 'pInData'.
+// Sample n is rotated by (Direction * j)^n, which only swaps and
+// negates I and Q. The rotation phase is kept across calls.
+//////////////////////////////////////////////////////////////////////
+void CDownConvert::MixFs4(int InLength, const TYPECPX* pInData, TYPECPX* pOutData)
+{
+TYPECPX dtmp;
+int i = 0;
+	//rotate single samples until the phase is back at 0
+	while( (i < InLength) && (m_Fs4Phase != 0) )
+	{
+		dtmp = pInData[i];
+		switch( (m_Fs4Direction > 0) ? m_Fs4Phase : (4 - m_Fs4Phase) )
+		{
+			case 1: pOutData[i].re = -dtmp.im; pOutData[i].im = dtmp.re; break;	// * j
+			case 2: pOutData[i].re = -dtmp.re; pOutData[i].im = -dtmp.im; break;	// * -1
+			default: pOutData[i].re = dtmp.im; pOutData[i].im = -dtmp.re; break;	// * -j
+		}
+		m_Fs4Phase = (m_Fs4Phase + 1) & 3;
+		i++;
+	}
+	//rotate groups of 4 samples starting at phase 0 by 1, j, -1, -j for +fs/4
+	//or by 1, -j, -1, j for -fs/4
+	int n = i + ((InLength - i) & ~3);
+	if(m_Fs4Direction > 0)
+	{
+		for(; i < n; i += 4)
+		{
+			TYPECPX x0 = pInData[i], x1 = pInData[i + 1], x2 = pInData[i + 2], x3 = pInData[i + 3];
+			pOutData[i] = x0;
+			pOutData[i + 1].re = -x1.im; pOutData[i + 1].im = x1.re;
+			pOutData[i + 2].re = -x2.re; pOutData[i + 2].im = -x2.im;
+			pOutData[i + 3].re = x3.im; pOutData[i + 3].im = -x3.re;
+		}
+	}
+	else
+	{
+		for(; i < n; i += 4)
+		{
+			TYPECPX x0 = pInData[i], x1 = pInData[i + 1], x2 = pInData[i + 2], x3 = pInData[i + 3];
+			pOutData[i] = x0;
+			pOutData[i + 1].re = x1.im; pOutData[i + 1].im = -x1.re;
+			pOutData[i + 2].re = -x2.re; pOutData[i + 2].im = -x2.im;
+			pOutData[i + 3].re = -x3.im; pOutData[i + 3].im = x3.re;
+		}
+	}
+	//rotate the remaining samples
+	for(; i < InLength; i++)
+	{
+		dtmp = pInData[i];
+		switch( (m_Fs4Direction > 0) ? m_Fs4Phase : ((4 - m_Fs4Phase) & 3) )
+		{
+			case 0: pOutData[i] = dtmp; break;										// * 1
+			case 1: pOutData[i].re = -dtmp.im; pOutData[i].im = dtmp.re; break;	// * j
+			case 2: pOutData[i].re = -dtmp.re; pOutData[i].im = -dtmp.im; break;	// * -1
+			default: pOutData[i].re = dtmp.im; pOutData[i].im = -dtmp.re; break;	// * -j
+		}
+		m_Fs4Phase = (m_Fs4Phase + 1) & 3;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Processes 'InLength' raw unsigned 8 bit I/Q samples of 'pInData'
+// buffer and places in 'pOutData' buffer, which must be large enough
+// to hold 'InLength' complex samples.
+// Returns number of samples available in output buffer.
+// If the NCO is at +/-fs/4 and the first decimation stage is a half
+// band filter, the mixing and the first decimation stage are done on
+// the integer samples and only the decimated samples are converted
+// into floating point. Otherwise the samples are converted and then
+// processed normally.
+//////////////////////////////////////////////////////////////////////
+int CDownConvert::ProcessData(int InLength, const quint8* pInData, TYPECPX* pOutData)
+{
+	if( (m_Fs4Direction == 0) || (m_pRawDecimator == NULL) )
+	{
+		ConvertIQ8(InLength, pInData, pOutData);
+		return ProcessData(InLength, pOutData, pOutData);
+	}
 
-	//now perform decimation of pInData by calling decimate by 2 stages
-	//until NULL pointer encountered designating end of chain
-	int n = InLength;
-	j = 0;
+int numoutsamples = 0;
 
 #ifdef FMDSP_THREAD_SAFE
 	std::unique_lock<std::mutex> lock(m_Mutex);
 #endif
 
-	while(m_pDecimatorPtrs[j])
+	for(int i=0; i<InLength; i+=DEC_TILE_SIZE)
 	{
-		n = m_pDecimatorPtrs[j++]->DecBy2(n, pInData, pInData);
-
+		int n = std::min(InLength - i, DEC_TILE_SIZE);
+		//the integer stage replaces the first stage, the remaining decimate by 2
+		//stages process the floating point samples
+		TYPECPX* pStageOut = (m_pDecimatorPtrs[1]) ? m_pDecimatorPtrs[1]->GetInputBuffer() : &pOutData[numoutsamples];
+		n = m_pRawDecimator->DecBy2(n, &pInData[i * 2], m_Fs4Direction, pStageOut);
+		numoutsamples += DecimateTile(1, n, &pOutData[numoutsamples]);
 	}
-#ifdef FMDSP_THREAD_SAFE
-	lock.unlock();
-#endif
-	for(i=0; i<n; i++)
-		pOutData[i] = pInData[i];
 
-	return n;
+	return numoutsamples;
 }
 
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Halfband filter class implementation
+//Decimate by 2 stage base class implementation
+// The line buffer holds 'History' previous input samples followed by
+// room for 'MaxInLength' new input samples
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CHalfBandDecimateBy2::CHalfBandDecimateBy2(int len,const TYPEREAL* pCoef )
-	: m_FirLength(len), m_pCoef(pCoef)
+CDownConvert::CDec2::CDec2(int History, int MaxInLength)
+	: m_History(History)
 {
-	//create buffer for FIR implementation
-	m_pHBFirBuf = new TYPECPX[MAX_HALF_BAND_BUFSIZE];
+	m_pLineBuf = new TYPECPX[History + MaxInLength];
 	TYPECPX CPXZERO = {0.0,0.0};
-	for(int i=0; i<MAX_HALF_BAND_BUFSIZE ;i++)
-		m_pHBFirBuf[i] = CPXZERO;
+	for(int i=0; i<(History + MaxInLength); i++)
+		m_pLineBuf[i] = CPXZERO;
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+//////////////////////////////////////////////////////////////////////
+// Sums the symmetric tap pairs J down to 0 of an N tap Half Band filter,
+// expanded at compile time so the filter loop has no loop overhead
+//////////////////////////////////////////////////////////////////////
+template<int N, int J>
+struct CHalfBandTaps
+{
+	static inline void Accumulate(const TYPECPX* pBuf, const TYPEREAL* pCoef, TYPECPX& acc)
+	{
+		acc.re += ( (pBuf[J * 2].re + pBuf[N - 1 - (J * 2)].re) * pCoef[J] );
+		acc.im += ( (pBuf[J * 2].im + pBuf[N - 1 - (J * 2)].im) * pCoef[J] );
+		CHalfBandTaps<N, J - 1>::Accumulate(pBuf, pCoef, acc);
+	}
+};
+
+template<int N>
+struct CHalfBandTaps<N, -1>
+{
+	static inline void Accumulate(const TYPECPX*, const TYPEREAL*, TYPECPX&){}
+};
+
+//////////////////////////////////////////////////////////////////////
+//Decimate by 2 Halfband filter class implementation
+// The tap count is a template parameter so the filter is fully
+// unrolled for each of the filtercoef.h lengths
+//////////////////////////////////////////////////////////////////////
+template<int N>
+CDownConvert::CHalfBandDecimateBy2<N>::CHalfBandDecimateBy2(const TYPEREAL* pCoef, int MaxInLength)
+	: CDec2(N - 1, MaxInLength), m_pCoef(pCoef)
+{
+	//preload only the taps that are used since every other one is zero
+	//except the center tap, the taps are symmetric so only half are kept
+	for(int i=0; i<HB_PAIRS; i++)
+		m_Coef[i] = pCoef[i * 2];
+	m_CenterCoef = pCoef[(N - 1) / 2];
 }
 
 //////////////////////////////////////////////////////////////////////
 // Half band filter and decimate by 2 function.
-// Two restrictions on this routine:
-// InLength must be larger or equal to the Number of Halfband Taps
+// Filters the 'InLength' samples in the line buffer and places the
+// decimated samples in 'pOutData'.
 // InLength must be an even number  ~37nS
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::CHalfBandDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template<int N>
+int CDownConvert::CHalfBandDecimateBy2<N>::DecBy2(int InLength, TYPECPX* pOutData)
 {
 int i;
-int j;
 int numoutsamples = 0;
-	if(InLength<m_FirLength)	//safety net to make sure InLength is large enough to process
-		return InLength/2;
-	//copy input samples into buffer starting at position m_FirLength-1
-	for(i=0,j = m_FirLength - 1; i<InLength; i++)
-		m_pHBFirBuf[j++] = pInData[i];
+TYPEREAL coef[HB_PAIRS];
+const TYPEREAL center = m_CenterCoef;
+	//local copy of the taps, the output buffer could otherwise alias them
+	for(i=0; i<HB_PAIRS; i++)
+		coef[i] = m_Coef[i];
 	//perform decimation FIR filter on even samples
 	for(i=0; i<InLength; i+=2)
 	{
+		const TYPECPX* pBuf = &m_pLineBuf[i];
 		TYPECPX acc;
-		acc.re = ( m_pHBFirBuf[i].re * m_pCoef[0] );
-		acc.im = ( m_pHBFirBuf[i].im * m_pCoef[0] );
-		for(j=0; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
-		{
-			acc.re += ( m_pHBFirBuf[i+j].re * m_pCoef[j] );
-			acc.im += ( m_pHBFirBuf[i+j].im * m_pCoef[j] );
-		}
-		//now multiply the center coefficient
-		acc.re += ( m_pHBFirBuf[i+(m_FirLength-1)/2].re * m_pCoef[(m_FirLength-1)/2] );
-		acc.im += ( m_pHBFirBuf[i+(m_FirLength-1)/2].im * m_pCoef[(m_FirLength-1)/2] );
+		//start with the center coefficient
+		acc.re = ( pBuf[(N - 1) / 2].re * center );
+		acc.im = ( pBuf[(N - 1) / 2].im * center );
+		//only use even coefficients since odd are zero(except center point)
+		CHalfBandTaps<N, HB_PAIRS - 1>::Accumulate(pBuf, coef, acc);
 		pOutData[numoutsamples++] = acc;	//put output buffer
-
 	}
-	//need to copy last m_FirLength - 1 input samples in buffer to beginning of buffer
+	//need to copy last N - 1 input samples in buffer to beginning of buffer
 	// for FIR wrap around management
-	for(i=0,j = InLength-m_FirLength+1; i<m_FirLength - 1; i++)
-		m_pHBFirBuf[i] = pInData[j++];
+	memmove(m_pLineBuf, &m_pLineBuf[InLength], (N - 1) * sizeof(TYPECPX));
 
 	return numoutsamples;
 }
@@ -387,103 +798,97 @@ int numoutsamples = 0;
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Fixed 11 Tap Halfband filter class implementation
-// Loop unrolled for speed ~9nS /samp
+//Integer Decimate by 2 Halfband filter class implementation
+// The filter is split into its two polyphase branches. The even
+// samples meet the even coefficients, which are kept as Q16 values
+// padded with leading zeros to a multiple of 8 taps for the vector dot
+// product. Of the odd coefficients only the center one is non-zero,
+// so the odd samples are only read at a single position. The center
+// coefficient can reach 0.5, which is 32768 in Q16, so it is the only
+// one kept in a qint32.
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CHalfBand11TapDecimateBy2::CHalfBand11TapDecimateBy2()
+CDownConvert::CRawHalfBandDecimateBy2::CRawHalfBandDecimateBy2(int len, const TYPEREAL* pCoef)
+	: m_Phase(0)
 {
-	//preload only the taps that are used since evey other one is zero
-	//except center tap 5
-	H0 = HB11TAP_H[0]; H2 = HB11TAP_H[2]; H4 = HB11TAP_H[4];
-	H5 = HB11TAP_H[5];
-	H6 = HB11TAP_H[6]; H8 = HB11TAP_H[8]; H10 = HB11TAP_H[10];
-	TYPECPX CPXZERO = {0.0,0.0};
-	d0 = CPXZERO; d1 = CPXZERO;	d2 = CPXZERO; d3 = CPXZERO;
-	d4 = CPXZERO; d5 = CPXZERO;	d6 = CPXZERO; d7 = CPXZERO;
-	d8 = CPXZERO; d9 = CPXZERO;
+	assert(len <= MAX_RAWHB_LENGTH);
+	int evencoefs = (len + 1) / 2;
+	m_NumTaps = ((evencoefs + 7) / 8) * 8;
+	int pad = m_NumTaps - evencoefs;
+	//the center tap of the filter is (len - 1) / 2, which is odd for a half band filter
+	m_CenterOffset = pad + (len - 3) / 4;
+	//the sum of the absolute coefficient values of a half band filter is well under 2.0,
+	//so with 16 fractional bits and samples in the range of +/-255 the accumulator can't overflow.
+	//All the even coefficients are smaller than the 0.5 center coefficient and fit in 16 bits
+	for(int i=0; i<pad; i++)
+		m_Coef[i] = 0;
+	for(int i=0; i<evencoefs; i++)
+		m_Coef[pad + i] = (qint16)floor((pCoef[i * 2] * (1 << RAWHB_COEF_BITS)) + 0.5);
+	m_CenterCoef = (qint32)floor((pCoef[(len - 1) / 2] * (1 << RAWHB_COEF_BITS)) + 0.5);
+	int buflen = (m_NumTaps - 1) + (DEC_TILE_SIZE / 2);
+	m_pEvenI = new qint16[buflen];
+	m_pEvenQ = new qint16[buflen];
+	m_pOddI = new qint16[buflen];
+	m_pOddQ = new qint16[buflen];
+	for(int i=0; i<buflen; i++)
+		m_pEvenI[i] = m_pEvenQ[i] = m_pOddI[i] = m_pOddQ[i] = 0;
+}
+
+CDownConvert::CRawHalfBandDecimateBy2::~CRawHalfBandDecimateBy2()
+{
+	delete [] m_pEvenI;
+	delete [] m_pEvenQ;
+	delete [] m_pOddI;
+	delete [] m_pOddQ;
 }
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Fixed 11 Tap Halfband filter class implementation
-// Two restrictions on this routine:
-// InLength must be larger or equal to the Number of Halfband Taps(11)
+// Mixes raw I/Q samples by +/-fs/4 and performs the half band filter
+// and decimate by 2 function on the integer samples.
+// The samples are centered as 2*x - 255, which is exact and maps onto
+// (x - 127.5) * 2 so the result is scaled by IQ8_SCALE/2 when converted.
+// Sample n is rotated by (Direction * j)^n. For even n that is only a
+// sign flip every other sample, odd samples are swapped as well.
 // InLength must be an even number
-// Loop unrolled for speed ~15nS/samp
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::CHalfBand11TapDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+int CDownConvert::CRawHalfBandDecimateBy2::DecBy2(int InLength, const quint8* pInData, int Direction, TYPECPX* pOutData)
 {
-	//first calculate beginning 10 samples using previous samples in delay buffer
-	TYPECPX tmpout[9];	//use temp buffer so outbuf can be same as inbuf
-	tmpout[0].re = H0*d0.re + H2*d2.re + H4*d4.re + H5*d5.re + H6*d6.re + H8*d8.re
-					 + H10*pInData[0].re;
-	tmpout[0].im = H0*d0.im + H2*d2.im + H4*d4.im + H5*d5.im + H6*d6.im + H8*d8.im
-					 + H10*pInData[0].im;
-
-	tmpout[1].re = H0*d2.re + H2*d4.re + H4*d6.re + H5*d7.re + H6*d8.re
-					 + H8*pInData[0].re + H10*pInData[2].re;
-	tmpout[1].im = H0*d2.im + H2*d4.im + H4*d6.im + H5*d7.im + H6*d8.im
-					 + H8*pInData[0].im + H10*pInData[2].im;
-
-	tmpout[2].re = H0*d4.re + H2*d6.re + H4*d8.re + H5*d9.re
-					 + H6*pInData[0].re + H8*pInData[2].re + H10*pInData[4].re;
-	tmpout[2].im = H0*d4.im + H2*d6.im + H4*d8.im + H5*d9.im
-					 + H6*pInData[0].im + H8*pInData[2].im + H10*pInData[4].im;
-
-	tmpout[3].re = H0*d6.re + H2*d8.re + H4*pInData[0].re + H5*pInData[1].re
-					 + H6*pInData[2].re + H8*pInData[4].re + H10*pInData[6].re;
-	tmpout[3].im = H0*d6.im + H2*d8.im + H4*pInData[0].im + H5*pInData[1].im
-					 + H6*pInData[2].im + H8*pInData[4].im + H10*pInData[6].im;
-
-	tmpout[4].re = H0*d8.re + H2*pInData[0].re + H4*pInData[2].re + H5*pInData[3].re
-					 + H6*pInData[4].re + H8*pInData[6].re + H10*pInData[8].re;
-	tmpout[4].im = H0*d8.im + H2*pInData[0].im + H4*pInData[2].im + H5*pInData[3].im
-					 + H6*pInData[4].im + H8*pInData[6].im + H10*pInData[8].im;
-
-	tmpout[5].re = H0*pInData[0].re + H2*pInData[2].re + H4*pInData[4].re + H5*pInData[5].re
-					 + H6*pInData[6].re + H8*pInData[8].re + H10*pInData[10].re;
-	tmpout[5].im = H0*pInData[0].im + H2*pInData[2].im + H4*pInData[4].im + H5*pInData[5].im
-					 + H6*pInData[6].im + H8*pInData[8].im + H10*pInData[10].im;
-
-	tmpout[6].re = H0*pInData[2].re + H2*pInData[4].re + H4*pInData[6].re + H5*pInData[7].re
-					 + H6*pInData[8].re + H8*pInData[10].re + H10*pInData[12].re;
-	tmpout[6].im = H0*pInData[2].im + H2*pInData[4].im + H4*pInData[6].im + H5*pInData[7].im
-					 + H6*pInData[8].im + H8*pInData[10].im + H10*pInData[12].im;
-
-	tmpout[7].re = H0*pInData[4].re + H2*pInData[6].re + H4*pInData[8].re + H5*pInData[9].re
-					 + H6*pInData[10].re + H8*pInData[12].re + H10*pInData[14].re;
-	tmpout[7].im = H0*pInData[4].im + H2*pInData[6].im + H4*pInData[8].im + H5*pInData[9].im
-					 + H6*pInData[10].im + H8*pInData[12].im + H10*pInData[14].im;
-
-	tmpout[8].re = H0*pInData[6].re + H2*pInData[8].re + H4*pInData[10].re + H5*pInData[11].re
-					 + H6*pInData[12].re + H8*pInData[14].re + H10*pInData[16].re;
-	tmpout[8].im = H0*pInData[6].im + H2*pInData[8].im + H4*pInData[10].im + H5*pInData[11].im
-					 + H6*pInData[12].im + H8*pInData[14].im + H10*pInData[16].im;
-
-	//now loop through remaining input samples
-	TYPECPX* pIn = &pInData[8];
-	TYPECPX* pOut = &pOutData[9];
-	for(int i=0; i<(InLength-11-6 )/2; i++)
+const int hist = m_NumTaps - 1;
+const TYPEREAL scale = IQ8_SCALE / (2.0 * (1 << RAWHB_COEF_BITS));
+int numoutsamples = 0;
+
+	while(InLength > 0)
 	{
-		(*pOut).re   = H0*pIn[0].re + H2*pIn[2].re + H4*pIn[4].re + H5*pIn[5].re
-					  + H6*pIn[6].re + H8*pIn[8].re + H10*pIn[10].re;
-		(*pOut++).im = H0*pIn[0].im + H2*pIn[2].im + H4*pIn[4].im + H5*pIn[5].im
-					  + H6*pIn[6].im + H8*pIn[8].im + H10*pIn[10].im;
-		pIn += 2;
+		int len = std::min(InLength, DEC_TILE_SIZE) / 2;
+		//sign of the first even sample, the odd samples also get the direction
+		int sign = (m_Phase & 2) ? -1 : 1;
+		for(int i=0; i<len; i++)
+		{
+			const quint8* p = &pInData[i * 4];
+			m_pEvenI[hist + i] = sign * ((2 * p[0]) - 255);
+			m_pEvenQ[hist + i] = sign * ((2 * p[1]) - 255);
+			m_pOddI[hist + i] = -Direction * sign * ((2 * p[3]) - 255);
+			m_pOddQ[hist + i] = Direction * sign * ((2 * p[2]) - 255);
+			sign = -sign;
+		}
+		m_Phase = (m_Phase + (len * 2)) & 3;
+		for(int i=0; i<len; i++)
+		{
+			qint32 accI = FixedDotProduct(m_NumTaps, m_Coef, &m_pEvenI[i]) + (m_CenterCoef * m_pOddI[i + m_CenterOffset]);
+			qint32 accQ = FixedDotProduct(m_NumTaps, m_Coef, &m_pEvenQ[i]) + (m_CenterCoef * m_pOddQ[i + m_CenterOffset]);
+			pOutData[numoutsamples].re = accI * scale;
+			pOutData[numoutsamples].im = accQ * scale;
+			numoutsamples++;
+		}
+		//copy last m_NumTaps - 1 samples of each branch to beginning of buffer
+		memmove(m_pEvenI, &m_pEvenI[len], hist * sizeof(qint16));
+		memmove(m_pEvenQ, &m_pEvenQ[len], hist * sizeof(qint16));
+		memmove(m_pOddI, &m_pOddI[len], hist * sizeof(qint16));
+		memmove(m_pOddQ, &m_pOddQ[len], hist * sizeof(qint16));
+		pInData += (len * 4);
+		InLength -= (len * 2);
 	}
-	//copy first outputs back into output array so outbuf can be same as inbuf
-	pOutData[0] = tmpout[0]; pOutData[1] = tmpout[1];
-	pOutData[2] = tmpout[2]; pOutData[3] = tmpout[3];
-	pOutData[4] = tmpout[4]; pOutData[5] = tmpout[5];
-	pOutData[6] = tmpout[6]; pOutData[7] = tmpout[7];
-	pOutData[8] = tmpout[8];
-
-	//copy last 10 input samples into delay buffer for next time
-	pIn = &pInData[InLength-1];
-	d9 = *pIn--; d8 = *pIn--; d7 = *pIn--;
-	d6 = *pIn--; d5 = *pIn--; d4 = *pIn--;
-	d3 = *pIn--; d2 = *pIn--; d1 = *pIn--; d0 = *pIn;
-
-	return InLength/2;
+
+	return numoutsamples;
 }
 
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
@@ -492,7 +897,8 @@ int CDownConvert::CHalfBand11TapDecimateBy2::DecBy2(int InLength, TYPECPX* pInDa
 //Decimate by 2 CIC 3 stage
 // -80dB alias rejection up to Fs * (.5 - .4985)
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CCicN3DecimateBy2::CCicN3DecimateBy2()
+CDownConvert::CCicN3DecimateBy2::CCicN3DecimateBy2(int MaxInLength)
+	: CDec2(0, MaxInLength)
 {
 	m_Xodd.re = 0.0; m_Xodd.im = 0.0;
 	m_Xeven.re = 0.0; m_Xeven.im = 0.0;
@@ -505,15 +911,15 @@ CDownConvert::CCicN3DecimateBy2::CCicN3DecimateBy2()
 //returns number of output samples processed
 // 6nS/sample
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::CCicN3DecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+int CDownConvert::CCicN3DecimateBy2::DecBy2(int InLength, TYPECPX* pOutData)
 {
 int i,j;
 TYPECPX even,odd;
 
 	for(i=0,j=0; i<InLength; i+=2,j++)
 	{	//mag gn=8
-		even = pInData[i];
-		odd = pInData[i+1];
+		even = m_pLineBuf[i];
+		odd = m_pLineBuf[i+1];
 		pOutData[j].re = .125*( odd.re + m_Xeven.re + 3.0*(m_Xodd.re + even.re) );
 		pOutData[j].im = .125*( odd.im + m_Xeven.im + 3.0*(m_Xodd.im + even.im) );
 		m_Xodd = odd;
@@ -522,3 +928,5 @@ TYPECPX even,odd;
 
 	return j;
 }
+
+} // namespace FMDSP_NAMESPACE
@@ -40,10 +40,16 @@
 #define DOWNCONVERT_H
 
 #include "datatypes.h"
+#include "dispatch.h"
 #include <mutex>
 
+namespace FMDSP_NAMESPACE {
+
 
 #define MAX_DECSTAGES 10	//one more than max to make sure is a null at end of list
+#define MAX_RAWHB_LENGTH 51	//longest half band filter usable by the integer stage
+#define MAX_RAWHB_TAPS 32	//its even coefficients padded to a multiple of 8
+#define NCO_TABLE_SIZE 64	//length of the NCO phasor table
 
 enum class DownsampleQuality
 {
@@ -52,6 +58,9 @@ enum class DownsampleQuality
 	High = 2,			// 51 tap
 };
 
+//binds the kernel that mixes each block of samples with the NCO phasor table
+const char* BindNcoMix(enum SimdLevel Level);
+
 //////////////////////////////////////////////////////////////////////////////////
 // Main Downconverter Class
 //////////////////////////////////////////////////////////////////////////////////
@@ -61,7 +70,8 @@ public:
 	CDownConvert();
 	virtual ~CDownConvert();
 	void SetFrequency(TYPEREAL NcoFreq);
-	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
+	int ProcessData(int InLength, const TYPECPX* pInData, TYPECPX* pOutData);
+	int ProcessData(int InLength, const quint8* pInData, TYPECPX* pOutData);
 	TYPEREAL SetDataRate(TYPEREAL InRate, TYPEREAL MaxBW);
 	TYPEREAL SetWfmDataRate(TYPEREAL InRate, TYPEREAL MaxBW);
 	void SetQuality(enum DownsampleQuality Quality) { m_Quality = Quality; }
@@ -70,74 +80,83 @@ private:
 	////////////
 	//pure abstract base class for all the different types of decimate by 2 stages
 	//DecBy2 function is defined in derived classes
+	//each stage owns a line buffer that the previous stage writes its output into,
+	//so a tile of samples passes through the whole chain without extra copies
 	////////////
 	class CDec2
 	{
 	public:
-		CDec2(){}
-		virtual ~CDec2(){}
-		virtual int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData) = 0;
+		CDec2(int History, int MaxInLength);
+		virtual ~CDec2(){if(m_pLineBuf) delete [] m_pLineBuf;}
+		//returns the buffer the input samples of the stage are placed in
+		TYPECPX* GetInputBuffer(){ return &m_pLineBuf[m_History]; }
+		virtual int DecBy2(int InLength, TYPECPX* pOutData) = 0;
+		//half band stages return their coefficients so the first stage can be
+		//replaced by the integer stage when processing raw 8 bit I/Q samples
+		virtual int GetHalfBandCoef(const TYPEREAL** ppCoef){ *ppCoef = NULL; return 0; }
+		TYPECPX* m_pLineBuf;	//previous input samples followed by the new input samples
+		int m_History;
 	};
 
 	////////////
-	//private class for the Half Band decimate by 2 stages
+	//private class template for the N tap Half Band decimate by 2 stages
 	////////////
+	template<int N>
 	class CHalfBandDecimateBy2 : public CDec2
 	{
 	public:
-		CHalfBandDecimateBy2(int len,const TYPEREAL* pCoef);
-		~CHalfBandDecimateBy2(){if(m_pHBFirBuf) delete m_pHBFirBuf;}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPECPX* m_pHBFirBuf;
-		int m_FirLength;
+		CHalfBandDecimateBy2(const TYPEREAL* pCoef, int MaxInLength);
+		~CHalfBandDecimateBy2(){}
+		int DecBy2(int InLength, TYPECPX* pOutData);
+		int GetHalfBandCoef(const TYPEREAL** ppCoef){ *ppCoef = m_pCoef; return N; }
+		enum { HB_PAIRS = (N + 1) / 4 };	//number of symmetric pairs of non-zero taps
+		TYPEREAL m_Coef[HB_PAIRS];
+		TYPEREAL m_CenterCoef;
 		const TYPEREAL* m_pCoef;
 	};
 
-
 	////////////
-	//private class for the fixed 11 tap Half Band decimate by 2 stages
+	//private class for the N=3 CIC decimate by 2 stages
 	////////////
-	class CHalfBand11TapDecimateBy2 : public CDec2
+	class CCicN3DecimateBy2 : public CDec2
 	{
 	public:
-		CHalfBand11TapDecimateBy2();
-		~CHalfBand11TapDecimateBy2(){}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPEREAL H0;	//unwrapped coeeficients
-		TYPEREAL H2;
-		TYPEREAL H4;
-		TYPEREAL H5;
-		TYPEREAL H6;
-		TYPEREAL H8;
-		TYPEREAL H10;
-		TYPECPX d0;		//unwrapped delay buffer
-		TYPECPX d1;
-		TYPECPX d2;
-		TYPECPX d3;
-		TYPECPX d4;
-		TYPECPX d5;
-		TYPECPX d6;
-		TYPECPX d7;
-		TYPECPX d8;
-		TYPECPX d9;
+		CCicN3DecimateBy2(int MaxInLength);
+		~CCicN3DecimateBy2(){}
+		int DecBy2(int InLength, TYPECPX* pOutData);
+		TYPECPX m_Xodd;
+		TYPECPX m_Xeven;
 	};
 
 	////////////
-	//private class for the N=3 CIC decimate by 2 stages
+	//private class for the integer Half Band decimate by 2 stage that mixes raw
+	//unsigned 8 bit I/Q samples by +/-fs/4 and decimates them before they are
+	//converted into floating point samples
 	////////////
-	class CCicN3DecimateBy2 : public CDec2
+	class CRawHalfBandDecimateBy2
 	{
 	public:
-		CCicN3DecimateBy2();
-		~CCicN3DecimateBy2(){}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPECPX m_Xodd;
-		TYPECPX m_Xeven;
+		CRawHalfBandDecimateBy2(int len, const TYPEREAL* pCoef);
+		~CRawHalfBandDecimateBy2();
+		int DecBy2(int InLength, const quint8* pInData, int Direction, TYPECPX* pOutData);
+		qint16* m_pEvenI;	//mixed even I/Q samples, previous samples followed by the new ones
+		qint16* m_pEvenQ;
+		qint16* m_pOddI;	//mixed odd I/Q samples, only used by the center tap
+		qint16* m_pOddQ;
+		qint16 m_Coef[MAX_RAWHB_TAPS];	//Q16 even coefficients padded with leading zeros
+		qint32 m_CenterCoef;	//Q16 center coefficient, 0.5 (32768) does not fit in a qint16
+		int m_NumTaps;		//even coefficients padded to a multiple of 8 for FixedDotProduct()
+		int m_CenterOffset;	//position of the center tap in the odd samples
+		int m_Phase;		//mixer phase (0-3)
 	};
 
 private:
 	//private helper functions
 	void DeleteFilters();
+	void CreateRawDecimator();
+	void Mix(int InLength, const TYPECPX* pInData, TYPECPX* pOutData);
+	void MixFs4(int InLength, const TYPECPX* pInData, TYPECPX* pOutData);
+	int DecimateTile(int Stage, int InLength, TYPECPX* pOutData);
 
 	enum DownsampleQuality m_Quality = DownsampleQuality::High;
 
@@ -150,12 +169,19 @@ private:
 	TYPECPX m_Osc1;
 	TYPEREAL m_OscCos;
 	TYPEREAL m_OscSin;
+	TYPECPX m_NcoTable[NCO_TABLE_SIZE];	//NCO phasors for one block of samples
+	int m_Fs4Direction;		//+1/-1 if NCO is at +fs/4 or -fs/4, otherwise 0
+	int m_Fs4Phase;			//fs/4 mixer phase (0-3)
 #ifdef FMDSP_THREAD_SAFE
 	mutable std::mutex m_Mutex;		//for keeping threads from stomping on each other
 #endif
 	//array of pointers for performing decimate by 2 stages
 	CDec2* m_pDecimatorPtrs[MAX_DECSTAGES];
+	//integer replacement for the first decimate by 2 stage for raw I/Q samples
+	CRawHalfBandDecimateBy2* m_pRawDecimator;
 
 };
 
+} // namespace FMDSP_NAMESPACE
+
 #endif // DOWNCONVERT_H
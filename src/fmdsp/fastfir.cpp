@@ -9,12 +9,17 @@
 //For best performance use FIR size   4*FIR <= FFT <= 8*FIR
 //If need output to be power of 2 then FIR must = 1/2FFT size
 //
+//The input is copied into the FFT buffer a block at a time and every
+//complete frame in a call is filtered before returning. The frequency
+//domain multiply is a dispatched SIMD kernel.
+//
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
 //	2011-11-03  Fixed m_pFFTOverlapBuf initialization bug
 //	2012-08-06	Fixed m_pWindowTbl sizing problem
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-16  Block copies, SIMD complex multiply
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -45,7 +50,11 @@
 //or implied, of Moe Wheatley.
 //==========================================================================================
 #include "fastfir.h"
+#include "simd.h"
 #include <math.h>
+#include <string.h>
+
+namespace FMDSP_NAMESPACE {
 
 
 //////////////////////////////////////////////////////////////////////
@@ -57,6 +66,157 @@
 
 
 #define CONV_INBUF_SIZE (CONV_FFT_SIZE+CONV_FIR_SIZE-1)
+#define CONV_OVERLAP (CONV_FIR_SIZE-1)				//samples each frame shares with the previous one
+#define CONV_FRAME (CONV_FFT_SIZE-CONV_FIR_SIZE+1)	//new samples in each frame
+
+//////////////////////////////////////////////////////////////////////
+// Complex multiply kernels, dest = m * src. src and dest can be the
+// same buffer
+//////////////////////////////////////////////////////////////////////
+typedef void (*tCpxMpy)(int N, const TYPECPX* m, const TYPECPX* src, TYPECPX* dest);
+
+static void CpxMpyScalar(int N, const TYPECPX* m, const TYPECPX* src, TYPECPX* dest)
+{
+	for(int i=0; i<N; i++)
+	{
+		TYPEREAL sr = src[i].re;
+		TYPEREAL si = src[i].im;
+		dest[i].re = m[i].re * sr - m[i].im * si;
+		dest[i].im = m[i].re * si + m[i].im * sr;
+	}
+}
+
+#ifdef FMDSP_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 and AVX2 kernels, the complex samples stay interleaved:
+//  dest = (mr, mr)*(sr, si) +/- (mi, mi)*(si, sr)
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_SSE2
+static void CpxMpySse2(int N, const TYPECPX* m, const TYPECPX* src, TYPECPX* dest)
+{
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	const __m128d sign = _mm_setr_pd(-0.0, 0.0);
+	for(; i<N; i++)
+	{
+		__m128d c = _mm_loadu_pd(&m[i].re);
+		__m128d x = _mm_loadu_pd(&src[i].re);
+		__m128d re = _mm_mul_pd(_mm_unpacklo_pd(c, c), x);
+		__m128d im = _mm_mul_pd(_mm_unpackhi_pd(c, c), _mm_shuffle_pd(x, x, 1));
+		_mm_storeu_pd(&dest[i].re, _mm_add_pd(re, _mm_xor_pd(im, sign)));
+	}
+#else
+	const __m128 sign = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+	for(; i<=N-2; i+=2)
+	{
+		__m128 c = _mm_loadu_ps(&m[i].re);
+		__m128 x = _mm_loadu_ps(&src[i].re);
+		__m128 re = _mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(2,2,0,0)), x);
+		__m128 im = _mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3,3,1,1)), _mm_shuffle_ps(x, x, _MM_SHUFFLE(2,3,0,1)));
+		_mm_storeu_ps(&dest[i].re, _mm_add_ps(re, _mm_xor_ps(im, sign)));
+	}
+#endif
+	CpxMpyScalar(N - i, m + i, src + i, dest + i);
+}
+
+FMDSP_TARGET_AVX2
+static void CpxMpyAvx2(int N, const TYPECPX* m, const TYPECPX* src, TYPECPX* dest)
+{
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	for(; i<=N-2; i+=2)
+	{
+		__m256d c = _mm256_loadu_pd(&m[i].re);
+		__m256d x = _mm256_loadu_pd(&src[i].re);
+		__m256d re = _mm256_mul_pd(_mm256_movedup_pd(c), x);
+		__m256d im = _mm256_mul_pd(_mm256_permute_pd(c, 15), _mm256_permute_pd(x, 5));
+		_mm256_storeu_pd(&dest[i].re, _mm256_addsub_pd(re, im));
+	}
+#else
+	for(; i<=N-4; i+=4)
+	{
+		__m256 c = _mm256_loadu_ps(&m[i].re);
+		__m256 x = _mm256_loadu_ps(&src[i].re);
+		__m256 re = _mm256_mul_ps(_mm256_moveldup_ps(c), x);
+		__m256 im = _mm256_mul_ps(_mm256_movehdup_ps(c), _mm256_permute_ps(x, _MM_SHUFFLE(2,3,0,1)));
+		_mm256_storeu_ps(&dest[i].re, _mm256_addsub_ps(re, im));
+	}
+#endif
+	_mm256_zeroupper();	//the tail is SSE code
+	CpxMpySse2(N - i, m + i, src + i, dest + i);
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+#if defined(FMDSP_USE_DOUBLE_PRECISION) && !defined(FMDSP_SIMD_NEON64)
+ #define CPXMPY_NO_NEON		//no double precision NEON on 32 bit ARM
+#else
+
+//////////////////////////////////////////////////////////////////////
+// NEON kernel, the interleaving loads split the samples into their
+// real and imaginary parts
+//////////////////////////////////////////////////////////////////////
+static void CpxMpyNeon(int N, const TYPECPX* m, const TYPECPX* src, TYPECPX* dest)
+{
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	for(; i<=N-2; i+=2)
+	{
+		float64x2x2_t c = vld2q_f64(&m[i].re);
+		float64x2x2_t x = vld2q_f64(&src[i].re);
+		float64x2x2_t y;
+		y.val[0] = vsubq_f64(vmulq_f64(c.val[0], x.val[0]), vmulq_f64(c.val[1], x.val[1]));
+		y.val[1] = vaddq_f64(vmulq_f64(c.val[0], x.val[1]), vmulq_f64(c.val[1], x.val[0]));
+		vst2q_f64(&dest[i].re, y);
+	}
+#else
+	for(; i<=N-4; i+=4)
+	{
+		float32x4x2_t c = vld2q_f32(&m[i].re);
+		float32x4x2_t x = vld2q_f32(&src[i].re);
+		float32x4x2_t y;
+		y.val[0] = vmlsq_f32(vmulq_f32(c.val[0], x.val[0]), c.val[1], x.val[1]);
+		y.val[1] = vmlaq_f32(vmulq_f32(c.val[0], x.val[1]), c.val[1], x.val[0]);
+		vst2q_f32(&dest[i].re, y);
+	}
+#endif
+	CpxMpyScalar(N - i, m + i, src + i, dest + i);
+}
+
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tCpxMpy s_pCpxMpy = CpxMpyScalar;
+
+//////////////////////////////////////////////////////////////////////
+// Binds the complex multiply for the instruction set, returns its name
+//////////////////////////////////////////////////////////////////////
+const char* BindCpxMpy(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pCpxMpy = CpxMpyAvx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pCpxMpy = CpxMpySse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(CPXMPY_NO_NEON)
+	case SIMD_NEON:
+		s_pCpxMpy = CpxMpyNeon;
+		return "NEON";
+#endif
+	default:
+		s_pCpxMpy = CpxMpyScalar;
+		return "scalar";
+	}
+}
 
 
 //////////////////////////////////////////////////////////////////////
@@ -183,6 +343,14 @@ int i;
 	{
 		return;		//return if no changes
 	}
+	if( (FLoCut+Offset == m_FLoCut+m_Offset) && (FHiCut+Offset == m_FHiCut+m_Offset) &&
+		(SampleRate==m_SampleRate) )
+	{	//the filter only depends on the shifted band, keep the transformed coefficients
+		m_FLoCut = FLoCut;
+		m_FHiCut = FHiCut;
+		m_Offset = Offset;
+		return;
+	}
 	m_FLoCut = FLoCut;
 	m_FHiCut = FHiCut;
 	m_Offset = Offset;
@@ -242,13 +410,10 @@ int i;
 //  returns number of complex samples placed in OutBuf
 //number of samples returned in general will not be equal to the number of
 //input samples due to FFT block size processing.
-//600ns/samp
+//OutBuf must have room for InLength + CONV_FRAME - 1 samples
 ///////////////////////////////////////////////////////////////////////////////
 int CFastFIR::ProcessData(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
 {
-int i = 0;
-int j;
-int len = InLength;
 int outpos = 0;
 	if( !InLength)	//if nothing to do
 		return 0;
@@ -257,30 +422,31 @@ int outpos = 0;
 	std::unique_lock<std::mutex> lock(m_Mutex);
 #endif
 
-	while(len--)
-	{
-		j = m_InBufInPos - (CONV_FFT_SIZE - CONV_FIR_SIZE + 1) ;
-		if(j >= 0 )
-		{	//keep copy of last CONV_FIR_SIZE-1 samples for overlap save
-			m_pFFTOverlapBuf[j] = InBuf[i];
-		}
-		m_pFFTBuf[m_InBufInPos++] = InBuf[i++];
-		if(m_InBufInPos >= CONV_FFT_SIZE)
-		{	//perform FFT -> complexMultiply by FIR coefficients -> inverse FFT on filled FFT input buffer
-			m_Fft.FwdFFT(m_pFFTBuf);
-			CpxMpy(CONV_FFT_SIZE, m_pFilterCoef, m_pFFTBuf, m_pFFTBuf);
-			m_Fft.RevFFT(m_pFFTBuf);
-			for(j=(CONV_FIR_SIZE-1); j<CONV_FFT_SIZE; j++)
-			{	//copy FFT output into OutBuf minus CONV_FIR_SIZE-1 samples at beginning
-				OutBuf[outpos++] = m_pFFTBuf[j];
-			}
-			for(j=0; j<(CONV_FIR_SIZE - 1);j++)
-			{	//copy overlap buffer into start of fft input buffer
-				m_pFFTBuf[j] = m_pFFTOverlapBuf[j];
-			}
-			//reset input position to data start position of fft input buffer
-			m_InBufInPos = CONV_FIR_SIZE - 1;
-		}
+	while(InLength > 0)
+	{	//fill the FFT input buffer as far as the input goes
+		int n = CONV_FFT_SIZE - m_InBufInPos;
+		if(n > InLength)
+			n = InLength;
+		memcpy(&m_pFFTBuf[m_InBufInPos], InBuf, n * sizeof(TYPECPX));
+		m_InBufInPos += n;
+		InBuf += n;
+		InLength -= n;
+		if(m_InBufInPos < CONV_FFT_SIZE)
+			break;
+
+		//keep copy of last CONV_FIR_SIZE-1 samples for overlap save
+		memcpy(m_pFFTOverlapBuf, &m_pFFTBuf[CONV_FRAME], CONV_OVERLAP * sizeof(TYPECPX));
+		//perform FFT -> complexMultiply by FIR coefficients -> inverse FFT on filled FFT input buffer
+		m_Fft.FwdFFT(m_pFFTBuf);
+		CpxMpy(CONV_FFT_SIZE, m_pFilterCoef, m_pFFTBuf, m_pFFTBuf);
+		m_Fft.RevFFT(m_pFFTBuf);
+		//copy FFT output into OutBuf minus CONV_FIR_SIZE-1 samples at beginning
+		memcpy(&OutBuf[outpos], &m_pFFTBuf[CONV_OVERLAP], CONV_FRAME * sizeof(TYPECPX));
+		outpos += CONV_FRAME;
+		//copy overlap buffer into start of fft input buffer
+		memcpy(m_pFFTBuf, m_pFFTOverlapBuf, CONV_OVERLAP * sizeof(TYPECPX));
+		//reset input position to data start position of fft input buffer
+		m_InBufInPos = CONV_OVERLAP;
 	}
 
 	return outpos;	//return number of output samples processed and placed in OutBuf
@@ -292,12 +458,7 @@ int outpos = 0;
 ///////////////////////////////////////////////////////////////////////////////
 inline void CFastFIR::CpxMpy(int N, TYPECPX* m, TYPECPX* src, TYPECPX* dest)
 {
-	for(int i=0; i<N; i++)
-	{
-		TYPEREAL sr = src[i].re;
-		TYPEREAL si = src[i].im;
-		dest[i].re = m[i].re * sr - m[i].im * si;
-		dest[i].im = m[i].re * si + m[i].im * sr;
-	}
+	s_pCpxMpy(N, m, src, dest);
 }
 
+} // namespace FMDSP_NAMESPACE
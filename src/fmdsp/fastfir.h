@@ -8,6 +8,7 @@
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-16  Block copies, SIMD complex multiply
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -41,10 +42,16 @@
 #define FASTFIR_H
 
 #include "datatypes.h"
+#include "dispatch.h"
 #include "fft.h"
 
 #include <mutex>
 
+namespace FMDSP_NAMESPACE {
+
+//binds the complex multiply of the frequency domain filter
+const char* BindCpxMpy(enum SimdLevel Level);
+
 class CFastFIR  
 {
 public:
@@ -73,4 +80,7 @@ private:
 #endif
 	CFft m_Fft;
 };
+
+} // namespace FMDSP_NAMESPACE
+
 #endif // FASTFIR_H
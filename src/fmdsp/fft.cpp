@@ -1,15 +1,26 @@
 // fft.cpp: implementation of the CFft class.
-//  This is a somewhat modified version of Takuya OOURA's
-//     original radix 4 FFT package.
-//Copyright(C) 1996-1998 Takuya OOURA
-//    (email: ooura@mmm.t.u-tokyo.ac.jp).
+//
+//  The transforms are radix 4 decimation in frequency FFTs. Each radix 4
+//butterfly stores its two middle outputs swapped, which makes it a pair
+//of radix 2 stages, so the output is in plain bit reversed order and a
+//single radix 2 stage completes the sizes that are an odd power of 2.
+//
+//  The twiddles and the bit reversal table of each size and direction
+//are kept in a CFftPlan that is built on first use and then shared by
+//every CFft object in the process. The forward transform keeps the sign
+//of the Ooura code it replaces, X(k) = sum x(n)*exp(+j*2PI*n*k/N), and
+//neither direction is scaled.
 //
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-16  Replaced the Ooura transforms with shared radix 4 plans and SIMD kernels
 //////////////////////////////////////////////////////////////////////
 #include <math.h>
 #include "fft.h"
+#include "simd.h"
+
+namespace FMDSP_NAMESPACE {
 
 //////////////////////////////////////////////////////////////////////
 // Local Defines
@@ -21,6 +32,524 @@
 
 #define OVER_LIMIT 32000.0	//limit for detecting over ranging inputs
 
+#define FFT_MAX_LOG2 16		//log2(MAX_FFT_SIZE)
+#define FFT_TILE_BITS 3		//log2 of the tile width of the bit reversal
+
+static const int FFT_TILE_REVERSE[1 << FFT_TILE_BITS] = { 0, 4, 2, 6, 1, 5, 3, 7 };
+
+//////////////////////////////////////////////////////////////////////
+// The twiddles and bit reversal table of one transform size and
+// direction. A plan is never changed after it has been built so it can
+// be used by several threads at once.
+//
+// The twiddles of a radix 4 stage with a span of 4*Q are stored as six
+// arrays of Q values: W^j, W^2j and W^3j, each split into a (re, re) and
+// a (-im, im) array. x*W is then x*(re, re) + swap(x)*(-im, im), which
+// needs only unit stride loads and one shuffle.
+//////////////////////////////////////////////////////////////////////
+class CFftPlan
+{
+public:
+	CFftPlan(qint32 Size, bool Inverse);
+	~CFftPlan();
+	void Transform(TYPECPX* pData) const;
+
+private:
+	qint32 m_Size;
+	int m_Bits;				//log2(m_Size)
+	bool m_Inverse;
+	TYPECPX* m_pTwiddles;	//stages from the largest span down, 6*Q values each
+	quint32* m_pSwaps;		//pairs of indices or tiles exchanged by the bit reversal
+	qint32 m_NumSwaps;
+};
+
+//////////////////////////////////////////////////////////////////////
+// Radix 4 stage kernels. A stage runs the butterflies of span
+// 4*Quarter over all Size samples, Inverse selects -j instead of +j
+// as the rotation of the odd outputs
+//////////////////////////////////////////////////////////////////////
+typedef void (*tFftRadix4)(qint32 Size, qint32 Quarter, const TYPECPX* pTw, bool Inverse, TYPECPX* a);
+
+//y = x*W with W in the split twiddle format
+static inline void FftMulTw(TYPEREAL xr, TYPEREAL xi, const TYPECPX& R, const TYPECPX& I, TYPECPX& y)
+{
+	y.re = xr*R.re + xi*I.re;
+	y.im = xi*R.im + xr*I.im;
+}
+
+static void FftRadix4Scalar(qint32 Size, qint32 Quarter, const TYPECPX* pTw, bool Inverse, TYPECPX* a)
+{
+	const TYPEREAL rot = Inverse ? -1.0 : 1.0;
+	const TYPECPX* pR1 = pTw;
+	const TYPECPX* pI1 = pTw + Quarter;
+	const TYPECPX* pR2 = pTw + 2*Quarter;
+	const TYPECPX* pI2 = pTw + 3*Quarter;
+	const TYPECPX* pR3 = pTw + 4*Quarter;
+	const TYPECPX* pI3 = pTw + 5*Quarter;
+	for(qint32 g=0; g<Size; g+=4*Quarter)
+	{
+		TYPECPX* p0 = a + g;
+		TYPECPX* p1 = p0 + Quarter;
+		TYPECPX* p2 = p1 + Quarter;
+		TYPECPX* p3 = p2 + Quarter;
+		for(qint32 j=0; j<Quarter; j++)
+		{
+			TYPEREAL t0r = p0[j].re + p2[j].re;
+			TYPEREAL t0i = p0[j].im + p2[j].im;
+			TYPEREAL t1r = p0[j].re - p2[j].re;
+			TYPEREAL t1i = p0[j].im - p2[j].im;
+			TYPEREAL t2r = p1[j].re + p3[j].re;
+			TYPEREAL t2i = p1[j].im + p3[j].im;
+			TYPEREAL t3r = -rot*(p1[j].im - p3[j].im);
+			TYPEREAL t3i = rot*(p1[j].re - p3[j].re);
+			p0[j].re = t0r + t2r;
+			p0[j].im = t0i + t2i;
+			//the middle outputs are swapped to keep the bit reversed order
+			FftMulTw(t0r - t2r, t0i - t2i, pR2[j], pI2[j], p1[j]);
+			FftMulTw(t1r + t3r, t1i + t3i, pR1[j], pI1[j], p2[j]);
+			FftMulTw(t1r - t3r, t1i - t3i, pR3[j], pI3[j], p3[j]);
+		}
+	}
+}
+
+#ifdef FMDSP_SIMD_X86
+
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+ #define FFT_SSE2_LANES 1		//complex samples per vector
+ #define FFT_SSE2_LOAD(p) _mm_loadu_pd(&(p)->re)
+ #define FFT_SSE2_STORE(p, v) _mm_storeu_pd(&(p)->re, v)
+ #define FFT_SSE2_ADD _mm_add_pd
+ #define FFT_SSE2_SUB _mm_sub_pd
+ #define FFT_SSE2_MUL _mm_mul_pd
+ #define FFT_SSE2_SWAP(v) _mm_shuffle_pd(v, v, 1)
+ #define FFT_SSE2_ROTATE(v, rot) _mm_xor_pd(FFT_SSE2_SWAP(v), rot)
+ #define FFT_SSE2_SIGNS(re, im) _mm_setr_pd(re, im)
+ typedef __m128d tFftSse2;
+ #define FFT_AVX2_LANES 2
+ #define FFT_AVX2_LOAD(p) _mm256_loadu_pd(&(p)->re)
+ #define FFT_AVX2_STORE(p, v) _mm256_storeu_pd(&(p)->re, v)
+ #define FFT_AVX2_ADD _mm256_add_pd
+ #define FFT_AVX2_SUB _mm256_sub_pd
+ #define FFT_AVX2_MUL _mm256_mul_pd
+ #define FFT_AVX2_SWAP(v) _mm256_permute_pd(v, 5)
+ #define FFT_AVX2_ROTATE(v, rot) _mm256_xor_pd(FFT_AVX2_SWAP(v), rot)
+ #define FFT_AVX2_SIGNS(re, im) _mm256_setr_pd(re, im, re, im)
+ typedef __m256d tFftAvx2;
+#else
+ #define FFT_SSE2_LANES 2
+ #define FFT_SSE2_LOAD(p) _mm_loadu_ps(&(p)->re)
+ #define FFT_SSE2_STORE(p, v) _mm_storeu_ps(&(p)->re, v)
+ #define FFT_SSE2_ADD _mm_add_ps
+ #define FFT_SSE2_SUB _mm_sub_ps
+ #define FFT_SSE2_MUL _mm_mul_ps
+ #define FFT_SSE2_SWAP(v) _mm_shuffle_ps(v, v, _MM_SHUFFLE(2,3,0,1))
+ #define FFT_SSE2_ROTATE(v, rot) _mm_xor_ps(FFT_SSE2_SWAP(v), rot)
+ #define FFT_SSE2_SIGNS(re, im) _mm_setr_ps(re, im, re, im)
+ typedef __m128 tFftSse2;
+ #define FFT_AVX2_LANES 4
+ #define FFT_AVX2_LOAD(p) _mm256_loadu_ps(&(p)->re)
+ #define FFT_AVX2_STORE(p, v) _mm256_storeu_ps(&(p)->re, v)
+ #define FFT_AVX2_ADD _mm256_add_ps
+ #define FFT_AVX2_SUB _mm256_sub_ps
+ #define FFT_AVX2_MUL _mm256_mul_ps
+ #define FFT_AVX2_SWAP(v) _mm256_permute_ps(v, _MM_SHUFFLE(2,3,0,1))
+ #define FFT_AVX2_ROTATE(v, rot) _mm256_xor_ps(FFT_AVX2_SWAP(v), rot)
+ #define FFT_AVX2_SIGNS(re, im) _mm256_setr_ps(re, im, re, im, re, im, re, im)
+ typedef __m256 tFftAvx2;
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 and AVX2 kernels, FFT_xxx_LANES butterflies of a group at a
+// time. Stages with fewer butterflies per group use the scalar kernel.
+// The rotation by +j or -j is a swap and a sign flip
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_SSE2
+static void FftRadix4Sse2(qint32 Size, qint32 Quarter, const TYPECPX* pTw, bool Inverse, TYPECPX* a)
+{
+	if(Quarter < FFT_SSE2_LANES)
+	{
+		FftRadix4Scalar(Size, Quarter, pTw, Inverse, a);
+		return;
+	}
+	const tFftSse2 rot = Inverse ? FFT_SSE2_SIGNS(0.0, -0.0) : FFT_SSE2_SIGNS(-0.0, 0.0);
+	for(qint32 g=0; g<Size; g+=4*Quarter)
+	{
+		TYPECPX* p0 = a + g;
+		TYPECPX* p1 = p0 + Quarter;
+		TYPECPX* p2 = p1 + Quarter;
+		TYPECPX* p3 = p2 + Quarter;
+		for(qint32 j=0; j<Quarter; j+=FFT_SSE2_LANES)
+		{
+			tFftSse2 x0 = FFT_SSE2_LOAD(p0 + j);
+			tFftSse2 x1 = FFT_SSE2_LOAD(p1 + j);
+			tFftSse2 x2 = FFT_SSE2_LOAD(p2 + j);
+			tFftSse2 x3 = FFT_SSE2_LOAD(p3 + j);
+			tFftSse2 t0 = FFT_SSE2_ADD(x0, x2);
+			tFftSse2 t1 = FFT_SSE2_SUB(x0, x2);
+			tFftSse2 t2 = FFT_SSE2_ADD(x1, x3);
+			tFftSse2 t3 = FFT_SSE2_ROTATE(FFT_SSE2_SUB(x1, x3), rot);
+			FFT_SSE2_STORE(p0 + j, FFT_SSE2_ADD(t0, t2));
+			tFftSse2 y = FFT_SSE2_SUB(t0, t2);
+			FFT_SSE2_STORE(p1 + j, FFT_SSE2_ADD(FFT_SSE2_MUL(y, FFT_SSE2_LOAD(pTw + 2*Quarter + j)),
+				FFT_SSE2_MUL(FFT_SSE2_SWAP(y), FFT_SSE2_LOAD(pTw + 3*Quarter + j))));
+			y = FFT_SSE2_ADD(t1, t3);
+			FFT_SSE2_STORE(p2 + j, FFT_SSE2_ADD(FFT_SSE2_MUL(y, FFT_SSE2_LOAD(pTw + j)),
+				FFT_SSE2_MUL(FFT_SSE2_SWAP(y), FFT_SSE2_LOAD(pTw + Quarter + j))));
+			y = FFT_SSE2_SUB(t1, t3);
+			FFT_SSE2_STORE(p3 + j, FFT_SSE2_ADD(FFT_SSE2_MUL(y, FFT_SSE2_LOAD(pTw + 4*Quarter + j)),
+				FFT_SSE2_MUL(FFT_SSE2_SWAP(y), FFT_SSE2_LOAD(pTw + 5*Quarter + j))));
+		}
+	}
+}
+
+FMDSP_TARGET_AVX2
+static void FftRadix4Avx2(qint32 Size, qint32 Quarter, const TYPECPX* pTw, bool Inverse, TYPECPX* a)
+{
+	if(Quarter < FFT_AVX2_LANES)
+	{
+		FftRadix4Sse2(Size, Quarter, pTw, Inverse, a);
+		return;
+	}
+	const tFftAvx2 rot = Inverse ? FFT_AVX2_SIGNS(0.0, -0.0) : FFT_AVX2_SIGNS(-0.0, 0.0);
+	for(qint32 g=0; g<Size; g+=4*Quarter)
+	{
+		TYPECPX* p0 = a + g;
+		TYPECPX* p1 = p0 + Quarter;
+		TYPECPX* p2 = p1 + Quarter;
+		TYPECPX* p3 = p2 + Quarter;
+		for(qint32 j=0; j<Quarter; j+=FFT_AVX2_LANES)
+		{
+			tFftAvx2 x0 = FFT_AVX2_LOAD(p0 + j);
+			tFftAvx2 x1 = FFT_AVX2_LOAD(p1 + j);
+			tFftAvx2 x2 = FFT_AVX2_LOAD(p2 + j);
+			tFftAvx2 x3 = FFT_AVX2_LOAD(p3 + j);
+			tFftAvx2 t0 = FFT_AVX2_ADD(x0, x2);
+			tFftAvx2 t1 = FFT_AVX2_SUB(x0, x2);
+			tFftAvx2 t2 = FFT_AVX2_ADD(x1, x3);
+			tFftAvx2 t3 = FFT_AVX2_ROTATE(FFT_AVX2_SUB(x1, x3), rot);
+			FFT_AVX2_STORE(p0 + j, FFT_AVX2_ADD(t0, t2));
+			tFftAvx2 y = FFT_AVX2_SUB(t0, t2);
+			FFT_AVX2_STORE(p1 + j, FFT_AVX2_ADD(FFT_AVX2_MUL(y, FFT_AVX2_LOAD(pTw + 2*Quarter + j)),
+				FFT_AVX2_MUL(FFT_AVX2_SWAP(y), FFT_AVX2_LOAD(pTw + 3*Quarter + j))));
+			y = FFT_AVX2_ADD(t1, t3);
+			FFT_AVX2_STORE(p2 + j, FFT_AVX2_ADD(FFT_AVX2_MUL(y, FFT_AVX2_LOAD(pTw + j)),
+				FFT_AVX2_MUL(FFT_AVX2_SWAP(y), FFT_AVX2_LOAD(pTw + Quarter + j))));
+			y = FFT_AVX2_SUB(t1, t3);
+			FFT_AVX2_STORE(p3 + j, FFT_AVX2_ADD(FFT_AVX2_MUL(y, FFT_AVX2_LOAD(pTw + 4*Quarter + j)),
+				FFT_AVX2_MUL(FFT_AVX2_SWAP(y), FFT_AVX2_LOAD(pTw + 5*Quarter + j))));
+		}
+	}
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+#if defined(FMDSP_USE_DOUBLE_PRECISION) && !defined(FMDSP_SIMD_NEON64)
+ #define FFT_NO_NEON		//no double precision NEON on 32 bit ARM
+#else
+
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+ #define FFT_NEON_LANES 1
+ #define FFT_NEON_LOAD(p) vld1q_f64(&(p)->re)
+ #define FFT_NEON_STORE(p, v) vst1q_f64(&(p)->re, v)
+ #define FFT_NEON_ADD vaddq_f64
+ #define FFT_NEON_SUB vsubq_f64
+ #define FFT_NEON_MUL vmulq_f64
+ #define FFT_NEON_SWAP(v) vextq_f64(v, v, 1)
+ typedef float64x2_t tFftNeon;
+
+static inline tFftNeon FftNeonSigns(double re, double im)
+{
+	const double signs[2] = {re, im};
+	return vld1q_f64(signs);
+}
+#else
+ #define FFT_NEON_LANES 2
+ #define FFT_NEON_LOAD(p) vld1q_f32(&(p)->re)
+ #define FFT_NEON_STORE(p, v) vst1q_f32(&(p)->re, v)
+ #define FFT_NEON_ADD vaddq_f32
+ #define FFT_NEON_SUB vsubq_f32
+ #define FFT_NEON_MUL vmulq_f32
+ #define FFT_NEON_SWAP(v) vrev64q_f32(v)
+ typedef float32x4_t tFftNeon;
+
+static inline tFftNeon FftNeonSigns(float re, float im)
+{
+	const float signs[4] = {re, im, re, im};
+	return vld1q_f32(signs);
+}
+#endif
+#define FFT_NEON_ROTATE(v, rot) FFT_NEON_MUL(FFT_NEON_SWAP(v), rot)
+
+//////////////////////////////////////////////////////////////////////
+// NEON kernel, the rotation by +j or -j is a swap and a multiply by +/-1
+//////////////////////////////////////////////////////////////////////
+static void FftRadix4Neon(qint32 Size, qint32 Quarter, const TYPECPX* pTw, bool Inverse, TYPECPX* a)
+{
+	if(Quarter < FFT_NEON_LANES)
+	{
+		FftRadix4Scalar(Size, Quarter, pTw, Inverse, a);
+		return;
+	}
+	const tFftNeon rot = Inverse ? FftNeonSigns(1.0, -1.0) : FftNeonSigns(-1.0, 1.0);
+	for(qint32 g=0; g<Size; g+=4*Quarter)
+	{
+		TYPECPX* p0 = a + g;
+		TYPECPX* p1 = p0 + Quarter;
+		TYPECPX* p2 = p1 + Quarter;
+		TYPECPX* p3 = p2 + Quarter;
+		for(qint32 j=0; j<Quarter; j+=FFT_NEON_LANES)
+		{
+			tFftNeon x0 = FFT_NEON_LOAD(p0 + j);
+			tFftNeon x1 = FFT_NEON_LOAD(p1 + j);
+			tFftNeon x2 = FFT_NEON_LOAD(p2 + j);
+			tFftNeon x3 = FFT_NEON_LOAD(p3 + j);
+			tFftNeon t0 = FFT_NEON_ADD(x0, x2);
+			tFftNeon t1 = FFT_NEON_SUB(x0, x2);
+			tFftNeon t2 = FFT_NEON_ADD(x1, x3);
+			tFftNeon t3 = FFT_NEON_ROTATE(FFT_NEON_SUB(x1, x3), rot);
+			FFT_NEON_STORE(p0 + j, FFT_NEON_ADD(t0, t2));
+			tFftNeon y = FFT_NEON_SUB(t0, t2);
+			FFT_NEON_STORE(p1 + j, FFT_NEON_ADD(FFT_NEON_MUL(y, FFT_NEON_LOAD(pTw + 2*Quarter + j)),
+				FFT_NEON_MUL(FFT_NEON_SWAP(y), FFT_NEON_LOAD(pTw + 3*Quarter + j))));
+			y = FFT_NEON_ADD(t1, t3);
+			FFT_NEON_STORE(p2 + j, FFT_NEON_ADD(FFT_NEON_MUL(y, FFT_NEON_LOAD(pTw + j)),
+				FFT_NEON_MUL(FFT_NEON_SWAP(y), FFT_NEON_LOAD(pTw + Quarter + j))));
+			y = FFT_NEON_SUB(t1, t3);
+			FFT_NEON_STORE(p3 + j, FFT_NEON_ADD(FFT_NEON_MUL(y, FFT_NEON_LOAD(pTw + 4*Quarter + j)),
+				FFT_NEON_MUL(FFT_NEON_SWAP(y), FFT_NEON_LOAD(pTw + 5*Quarter + j))));
+		}
+	}
+}
+
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tFftRadix4 s_pFftRadix4 = FftRadix4Scalar;
+
+//////////////////////////////////////////////////////////////////////
+// Binds the radix 4 stage kernel for the instruction set, returns its
+// name
+//////////////////////////////////////////////////////////////////////
+const char* BindFft(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pFftRadix4 = FftRadix4Avx2;
+		return "radix 4 AVX2";
+	case SIMD_SSE2:
+		s_pFftRadix4 = FftRadix4Sse2;
+		return "radix 4 SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(FFT_NO_NEON)
+	case SIMD_NEON:
+		s_pFftRadix4 = FftRadix4Neon;
+		return "radix 4 NEON";
+#endif
+	default:
+		s_pFftRadix4 = FftRadix4Scalar;
+		return "radix 4 (scalar)";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Builds the twiddles and the bit reversal table for Size, which must
+// be a power of 2 of at least 4
+//////////////////////////////////////////////////////////////////////
+CFftPlan::CFftPlan(qint32 Size, bool Inverse)
+{
+qint32 q;
+	m_Size = Size;
+	m_Inverse = Inverse;
+
+	qint32 total = 0;
+	for(q=Size>>2; q>1; q>>=2)
+		total += 6*q;
+	m_pTwiddles = new TYPECPX[total > 0 ? total : 1];
+	TYPECPX* pTw = m_pTwiddles;
+	double sign = Inverse ? -1.0 : 1.0;
+	for(q=Size>>2; q>1; q>>=2)
+	{	//W = exp(+/-j*2PI/(4*q)), the twiddles are calculated in double precision
+		for(int k=1; k<=3; k++)
+		{
+			TYPECPX* pR = pTw + (2*k - 2)*q;
+			TYPECPX* pI = pR + q;
+			for(qint32 j=0; j<q; j++)
+			{
+				double phase = sign*K_2PI*(double)(k*j)/(double)(4*q);
+				pR[j].re = (TYPEREAL)cos(phase);
+				pR[j].im = pR[j].re;
+				pI[j].re = (TYPEREAL)-sin(phase);
+				pI[j].im = (TYPEREAL)sin(phase);
+			}
+		}
+		pTw += 6*q;
+	}
+
+	m_Bits = 0;
+	while( (1 << m_Bits) < Size )
+		m_Bits++;
+	//large sizes are reversed a tile at a time, the pairs are then the middle
+	// index bits of the tiles
+	int bits = m_Bits;
+	if(m_Bits >= 2*FFT_TILE_BITS)
+		bits -= 2*FFT_TILE_BITS;
+	m_NumSwaps = 0;
+	m_pSwaps = new quint32[2 << bits];
+	for(qint32 i=0; i<(1 << bits); i++)
+	{
+		qint32 r = 0;
+		for(int b=0; b<bits; b++)
+			r |= ((i >> b) & 1) << (bits - 1 - b);
+		if( (i < r) || ((i == r) && (bits != m_Bits)) )
+		{
+			m_pSwaps[2*m_NumSwaps] = i;
+			m_pSwaps[2*m_NumSwaps + 1] = r;
+			m_NumSwaps++;
+		}
+	}
+}
+
+CFftPlan::~CFftPlan()
+{
+	delete[] m_pTwiddles;
+	delete[] m_pSwaps;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Transforms m_Size complex samples in place
+//////////////////////////////////////////////////////////////////////
+void CFftPlan::Transform(TYPECPX* a) const
+{
+qint32 i;
+	const TYPECPX* pTw = m_pTwiddles;
+	qint32 quarter = m_Size >> 2;
+	for(; quarter>1; quarter>>=2)
+	{
+		s_pFftRadix4(m_Size, quarter, pTw, m_Inverse, a);
+		pTw += 6*quarter;
+	}
+	if(1 == quarter)
+	{	//last radix 4 stage, all its twiddles are 1
+		const TYPEREAL rot = m_Inverse ? -1.0 : 1.0;
+		for(i=0; i<m_Size; i+=4)
+		{
+			TYPEREAL t0r = a[i].re + a[i+2].re;
+			TYPEREAL t0i = a[i].im + a[i+2].im;
+			TYPEREAL t1r = a[i].re - a[i+2].re;
+			TYPEREAL t1i = a[i].im - a[i+2].im;
+			TYPEREAL t2r = a[i+1].re + a[i+3].re;
+			TYPEREAL t2i = a[i+1].im + a[i+3].im;
+			TYPEREAL t3r = -rot*(a[i+1].im - a[i+3].im);
+			TYPEREAL t3i = rot*(a[i+1].re - a[i+3].re);
+			a[i].re = t0r + t2r;
+			a[i].im = t0i + t2i;
+			a[i+1].re = t0r - t2r;
+			a[i+1].im = t0i - t2i;
+			a[i+2].re = t1r + t3r;
+			a[i+2].im = t1i + t3i;
+			a[i+3].re = t1r - t3r;
+			a[i+3].im = t1i - t3i;
+		}
+	}
+	else
+	{	//odd power of 2, last stage is radix 2
+		for(i=0; i<m_Size; i+=2)
+		{
+			TYPEREAL xr = a[i].re - a[i+1].re;
+			TYPEREAL xi = a[i].im - a[i+1].im;
+			a[i].re += a[i+1].re;
+			a[i].im += a[i+1].im;
+			a[i+1].re = xr;
+			a[i+1].im = xi;
+		}
+	}
+
+	//put the output into natural order
+	if(m_Bits < 2*FFT_TILE_BITS)
+	{
+		for(i=0; i<m_NumSwaps; i++)
+		{
+			TYPECPX* p = a + m_pSwaps[2*i];
+			TYPECPX* q = a + m_pSwaps[2*i + 1];
+			TYPECPX tmp = *p;
+			*p = *q;
+			*q = tmp;
+		}
+		return;
+	}
+	//Swapping single samples thrashes the cache at large sizes. With the index
+	// split into (high, middle, low) bits the reversed index is (rev(low),
+	// rev(middle), rev(high)), so the 8x8 samples of the tiles of a middle index
+	// and its reverse are exchanged together through two buffers
+	const int w = 1 << FFT_TILE_BITS;
+	const int shift = m_Bits - FFT_TILE_BITS;
+	TYPECPX tile0[1 << (2*FFT_TILE_BITS)];
+	TYPECPX tile1[1 << (2*FFT_TILE_BITS)];
+	for(i=0; i<m_NumSwaps; i++)
+	{
+		TYPECPX* p0 = a + (m_pSwaps[2*i] << FFT_TILE_BITS);
+		TYPECPX* p1 = a + (m_pSwaps[2*i + 1] << FFT_TILE_BITS);
+		int h, l;
+		for(h=0; h<w; h++)
+		{
+			for(l=0; l<w; l++)
+			{
+				tile0[FFT_TILE_REVERSE[l]*w + FFT_TILE_REVERSE[h]] = p0[(h << shift) + l];
+				tile1[FFT_TILE_REVERSE[l]*w + FFT_TILE_REVERSE[h]] = p1[(h << shift) + l];
+			}
+		}
+		for(h=0; h<w; h++)
+		{
+			for(l=0; l<w; l++)
+			{
+				p1[(h << shift) + l] = tile0[h*w + l];
+				p0[(h << shift) + l] = tile1[h*w + l];
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// The plans of all sizes and directions, built on first use and kept
+// for the life of the process
+//////////////////////////////////////////////////////////////////////
+static class CFftPlanCache
+{
+public:
+	CFftPlanCache()
+	{
+		for(int i=0; i<=FFT_MAX_LOG2; i++)
+			m_pPlans[0][i] = m_pPlans[1][i] = NULL;
+	}
+	~CFftPlanCache()
+	{
+		for(int i=0; i<=FFT_MAX_LOG2; i++)
+		{
+			delete m_pPlans[0][i];
+			delete m_pPlans[1][i];
+		}
+	}
+	const CFftPlan* GetPlan(qint32 Size, bool Inverse)
+	{
+		int log2 = 2;
+		while( (log2 < FFT_MAX_LOG2) && ((2 << log2) <= Size) )
+			log2++;
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		CFftPlan*& pPlan = m_pPlans[Inverse ? 1 : 0][log2];
+		if(NULL == pPlan)
+			pPlan = new CFftPlan(1 << log2, Inverse);
+		return pPlan;
+	}
+
+private:
+	std::mutex m_Mutex;
+	CFftPlan* m_pPlans[2][FFT_MAX_LOG2 + 1];
+} s_FftPlanCache;
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -34,8 +563,8 @@ CFft::CFft()
 	m_AveCount = 0;
 	m_TotalCount = 0;
 	m_FFTSize = 1024;
-	m_pWorkArea = NULL;
-	m_pSinCosTbl = NULL;
+	m_pFwdPlan = NULL;
+	m_pRevPlan = NULL;
 	m_pWindowTbl = NULL;
 	m_pFFTPwrAveBuf = NULL;
 	m_pFFTAveBuf = NULL;
@@ -54,16 +583,6 @@ CFft::~CFft()
 
 void CFft::FreeMemory()
 {
-	if(m_pWorkArea)
-	{
-		delete m_pWorkArea;
-		m_pWorkArea = NULL;
-	}
-	if(m_pSinCosTbl)
-	{
-		delete m_pSinCosTbl;
-		m_pSinCosTbl = NULL;
-	}
 	if(m_pWindowTbl)
 	{
 		delete m_pWindowTbl;
@@ -152,8 +671,6 @@ qint32 i;
 		m_LastFFTSize = m_FFTSize;
 		FreeMemory();
 		m_pWindowTbl = new TYPEREAL[m_FFTSize];
-		m_pSinCosTbl = new TYPEREAL[m_FFTSize/2];
-		m_pWorkArea = new qint32[ (qint32)MSQRT((TYPEREAL)m_FFTSize)+2];
 		m_pFFTPwrAveBuf = new TYPEREAL[m_FFTSize];
 		m_pFFTAveBuf = new TYPEREAL[m_FFTSize];
 		m_pFFTSumBuf = new TYPEREAL[m_FFTSize];
@@ -163,12 +680,12 @@ qint32 i;
 			m_pFFTAveBuf[i] = 0.0;
 			m_pFFTSumBuf[i] = 0.0;
 		}
-		m_pWorkArea[0] = 0;
 		m_pFFTInBuf = new TYPEREAL[m_FFTSize*2];
 		m_pTranslateTbl = new qint32[m_FFTSize];
 		for(i=0; i<m_FFTSize*2; i++)
 			m_pFFTInBuf[i] = 0.0;
-		makewt(m_FFTSize/2, m_pWorkArea, m_pSinCosTbl);
+		m_pFwdPlan = s_FftPlanCache.GetPlan(m_FFTSize, false);
+		m_pRevPlan = s_FftPlanCache.GetPlan(m_FFTSize, true);
 
 //////////////////////////////////////////////////////////////////////
 // A pure input sin wave ... Asin(wt)... will produce an fft output 
@@ -295,8 +812,7 @@ qint32 i;
 		((TYPECPX*)m_pFFTInBuf)[i].re = dtmp1 * (InBuf[i].im);	//window the Q data
 	}
 	//Calculate the complex FFT
-	bitrv2(m_FFTSize*2, m_pWorkArea + 2, m_pFFTInBuf);
-	CpxFFT(m_FFTSize*2, m_pFFTInBuf, m_pSinCosTbl);
+	CpxFFT(m_FFTSize*2, m_pFFTInBuf);
 
 	return m_TotalCount;
 }
@@ -433,148 +949,28 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 ///////////////////////////////////////////////////////////////////
 void CFft::FwdFFT( TYPECPX* pInOutBuf)
 {
-	bitrv2(m_FFTSize*2, m_pWorkArea + 2, (TYPEREAL*)pInOutBuf);
-	CpxFFT(m_FFTSize*2, (TYPEREAL*)pInOutBuf, m_pSinCosTbl);
+	m_pFwdPlan->Transform(pInOutBuf);
 }
 
 void CFft::RevFFT( TYPECPX* pInOutBuf)
 {
-	bitrv2conj(m_FFTSize*2, m_pWorkArea + 2, (TYPEREAL*)pInOutBuf);
-	cftbsub(m_FFTSize*2, (TYPEREAL*)pInOutBuf, m_pSinCosTbl);
+	m_pRevPlan->Transform(pInOutBuf);
 }
 
-
 ///////////////////////////////////////////////////////////////////
-// Nitty gritty fft routines by Takuya OOURA(Updated to his new version 4-18-02)
-// Routine calculates real FFT
+// Routine calculates complex FFT and averages the power of the bins
+// for the display
 ///////////////////////////////////////////////////////////////////
-void CFft::rftfsub(qint32 n, TYPEREAL *a, qint32 nc, TYPEREAL *c)
+void CFft::CpxFFT(qint32 n, TYPEREAL *a)
 {
-qint32 j, k, kk, ks, m;
-TYPEREAL wkr, wki, xr, xi, yr, yi;
-
-	m_TotalCount++;
- 	if(m_AveCount < m_AveSize)
-		m_AveCount++;
-    m = n >> 1;
-    ks = 2 * nc/m;
-    kk = 0;
-	for (j = 2; j < m; j += 2 ) 
-	{
-		k = n - j;
-		kk += ks;
-		wkr = 0.5 - c[nc - kk];
-		wki = c[kk];
-		xr = a[j] - a[k];
-		xi = a[j + 1] + a[k + 1];
-		yr = wkr * xr - wki * xi;
-		yi = wkr * xi + wki * xr;
-		a[j] -= yr;
-		xi = a[j]*a[j];
-		a[j+1] -= yi;
-		xi += ( a[j+1]*a[j+1]);
-		a[k] += yr;
-		xr = a[k]*a[k];
-		a[k+1] -= yi;
-		xr += (a[k+1]*a[k+1]);
-
-		//xr is real power  xi is imag power terms
-		//perform moving average on power up to m_AveSize then do exponential averaging after that
-		if(m_TotalCount <= m_AveSize)
-		{
-			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] + xi;
-			m_pFFTSumBuf[k] = m_pFFTSumBuf[k] + xr;
-		}
-		else
-		{
-			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] - m_pFFTPwrAveBuf[j] + xi;
-			m_pFFTSumBuf[k] = m_pFFTSumBuf[k] - m_pFFTPwrAveBuf[k] + xr;
-		}
-		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(TYPEREAL)m_AveCount;
-		m_pFFTPwrAveBuf[k] = m_pFFTSumBuf[k]/(TYPEREAL)m_AveCount;
-
-		m_pFFTAveBuf[j] = MLOG10(m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
-		m_pFFTAveBuf[k] = MLOG10(m_pFFTPwrAveBuf[k] + m_K_C) + m_K_B;
-
-	}
-
-	a[0] *= a[0];						//calc DC term
-	xr = a[m]*a[m]+a[m+1]*a[m+1];		//calculate N/4(middle) term
-
-	//xr is real power  a[0] is imag power terms
-	//perform moving average on power up to m_AveSize then do exponential averaging after that
-	if(m_TotalCount <= m_AveSize)
-	{
-		m_pFFTSumBuf[0] = m_pFFTSumBuf[0] + a[0];
-		m_pFFTSumBuf[n/2] = m_pFFTSumBuf[n/2] + xr;
-	}
-	else
-	{
-		m_pFFTSumBuf[0] = m_pFFTSumBuf[0] - m_pFFTPwrAveBuf[0] + a[0];
-		m_pFFTSumBuf[n/2] = m_pFFTSumBuf[n/2] - m_pFFTPwrAveBuf[n/2] + xr;
-	}
-	m_pFFTPwrAveBuf[0] = m_pFFTSumBuf[0]/(TYPEREAL)m_AveCount;
-	m_pFFTPwrAveBuf[n/2] = m_pFFTSumBuf[n/2]/(TYPEREAL)m_AveCount;
-
-	m_pFFTAveBuf[0] = MLOG10(m_pFFTPwrAveBuf[0] + m_K_C) + m_K_B;
-	m_pFFTAveBuf[n/2] = MLOG10(m_pFFTPwrAveBuf[n/2] + m_K_C) + m_K_B;
-
-}
-
-
-///////////////////////////////////////////////////////////////////
-// Routine calculates complex FFT
-///////////////////////////////////////////////////////////////////
-void CFft::CpxFFT(qint32 n, TYPEREAL *a, TYPEREAL *w)
-{
-qint32 j, j1, j2, j3, l;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+qint32 j, l;
+TYPEREAL x0r;
     
 	m_TotalCount++;
  	if(m_AveCount < m_AveSize)
 		m_AveCount++;
-    l = 2;
-    if (n > 8) {
-        cft1st(n, a, w);
-        l = 8;
-        while ((l << 2) < n) {
-            cftmdl(n, l, a, w);
-            l <<= 2;
-        }
-    }
-    if ((l << 2) == n) {
-        for (j = 0; j < l; j += 2) {
-            j1 = j + l;
-            j2 = j1 + l;
-            j3 = j2 + l;
-            x0r = a[j] + a[j1];
-            x0i = a[j + 1] + a[j1 + 1];
-            x1r = a[j] - a[j1];
-            x1i = a[j + 1] - a[j1 + 1];
-            x2r = a[j2] + a[j3];
-            x2i = a[j2 + 1] + a[j3 + 1];
-            x3r = a[j2] - a[j3];
-            x3i = a[j2 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i + x2i;
-            a[j2] = x0r - x2r;
-            a[j2 + 1] = x0i - x2i;
-            a[j1] = x1r - x3i;
-            a[j1 + 1] = x1i + x3r;
-            a[j3] = x1r + x3i;
-            a[j3 + 1] = x1i - x3r;
-        }
-    } else {
-        for (j = 0; j < l; j += 2) {
-            j1 = j + l;
-            x0r = a[j] - a[j1];
-            x0i = a[j + 1] - a[j1 + 1];
-            a[j] += a[j1];
-            a[j + 1] += a[j1 + 1];
-            a[j1] = x0r;
-            a[j1 + 1] = x0i;
-        }
-    }
+	m_pFwdPlan->Transform((TYPECPX*)a);
+
 	//n = 2*FFTSIZE 
 	n = n>>1;
 	//now n = FFTSIZE
@@ -608,595 +1004,4 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
 }
 
-///////////////////////////////////////////////////////////////////
-/* -------- initializing routines -------- */
-///////////////////////////////////////////////////////////////////
-void CFft::makewt(qint32 nw, qint32 *ip, TYPEREAL *w)
-{
-qint32 j, nwh;
-TYPEREAL delta, x, y;
-    
-    ip[0] = nw;
-    ip[1] = 1;
-    if (nw > 2) {
-        nwh = nw >> 1;
-		delta = MATAN(1.0) / nwh;
-        w[0] = 1;
-        w[1] = 0;
-		w[nwh] = MCOS(delta * nwh);
-        w[nwh + 1] = w[nwh];
-        if (nwh > 2) {
-            for (j = 2; j < nwh; j += 2) {
-				x = MCOS(delta * j);
-				y = MSIN(delta * j);
-                w[j] = x;
-                w[j + 1] = y;
-                w[nw - j] = y;
-                w[nw - j + 1] = x;
-            }
-            bitrv2(nw, ip + 2, w);
-        }
-    }
-}
-
-///////////////////////////////////////////////////////////////////
-void CFft::makect(qint32 nc, qint32 *ip, TYPEREAL *c)
-{
-qint32 j, nch;
-TYPEREAL delta;
-    
-	ip[1] = nc;
-    if (nc > 1) {
-        nch = nc >> 1;
-		delta = MATAN(1.0) / nch;
-		c[0] = MCOS(delta * nch);
-        c[nch] = 0.5 * c[0];
-        for (j = 1; j < nch; j++) {
-			c[j] = 0.5 * MCOS(delta * j);
-			c[nc - j] = 0.5 * MSIN(delta * j);
-        }
-    }
-}
-
-///////////////////////////////////////////////////////////////////
-/* -------- child routines -------- */
-///////////////////////////////////////////////////////////////////
-void CFft::bitrv2(qint32 n, qint32 *ip, TYPEREAL *a)
-{
-qint32 j, j1, k, k1, l, m, m2;
-TYPEREAL xr, xi, yr, yi;
-    
-    ip[0] = 0;
-    l = n;
-    m = 1;
-    while ((m << 3) < l) {
-        l >>= 1;
-        for (j = 0; j < m; j++) {
-            ip[m + j] = ip[j] + l;
-        }
-        m <<= 1;
-    }
-    m2 = 2 * m;
-    if ((m << 3) == l) {
-        for (k = 0; k < m; k++) {
-            for (j = 0; j < k; j++) {
-                j1 = 2 * j + ip[k];
-                k1 = 2 * k + ip[j];
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m2;
-                k1 += 2 * m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m2;
-                k1 -= m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m2;
-                k1 += 2 * m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-            }
-            j1 = 2 * k + m2 + ip[k];
-            k1 = j1 + m2;
-            xr = a[j1];
-            xi = a[j1 + 1];
-            yr = a[k1];
-            yi = a[k1 + 1];
-            a[j1] = yr;
-            a[j1 + 1] = yi;
-            a[k1] = xr;
-            a[k1 + 1] = xi;
-        }
-    } else {
-        for (k = 1; k < m; k++) {
-            for (j = 0; j < k; j++) {
-                j1 = 2 * j + ip[k];
-                k1 = 2 * k + ip[j];
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-                j1 += m2;
-                k1 += m2;
-                xr = a[j1];
-                xi = a[j1 + 1];
-                yr = a[k1];
-                yi = a[k1 + 1];
-                a[j1] = yr;
-                a[j1 + 1] = yi;
-                a[k1] = xr;
-                a[k1 + 1] = xi;
-            }
-        }
-    }
-}
-
-///////////////////////////////////////////////////////////////////
-void CFft::cftfsub(qint32 n, TYPEREAL *a, TYPEREAL *w)
-{
-qint32 j, j1, j2, j3, l;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
-    
-    l = 2;
-    if (n > 8) {
-        cft1st(n, a, w);
-        l = 8;
-        while ((l << 2) < n) {
-            cftmdl(n, l, a, w);
-            l <<= 2;
-        }
-    }
-    if ((l << 2) == n) {
-        for (j = 0; j < l; j += 2) {
-            j1 = j + l;
-            j2 = j1 + l;
-            j3 = j2 + l;
-            x0r = a[j] + a[j1];
-            x0i = a[j + 1] + a[j1 + 1];
-            x1r = a[j] - a[j1];
-            x1i = a[j + 1] - a[j1 + 1];
-            x2r = a[j2] + a[j3];
-            x2i = a[j2 + 1] + a[j3 + 1];
-            x3r = a[j2] - a[j3];
-            x3i = a[j2 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i + x2i;
-            a[j2] = x0r - x2r;
-            a[j2 + 1] = x0i - x2i;
-            a[j1] = x1r - x3i;
-            a[j1 + 1] = x1i + x3r;
-            a[j3] = x1r + x3i;
-            a[j3 + 1] = x1i - x3r;
-        }
-    } else {
-        for (j = 0; j < l; j += 2) {
-            j1 = j + l;
-            x0r = a[j] - a[j1];
-            x0i = a[j + 1] - a[j1 + 1];
-            a[j] += a[j1];
-            a[j + 1] += a[j1 + 1];
-            a[j1] = x0r;
-            a[j1 + 1] = x0i;
-        }
-    }
-}
-
-///////////////////////////////////////////////////////////////////
-void CFft::cft1st(qint32 n, TYPEREAL *a, TYPEREAL *w)
-{
-qint32 j, k1, k2;
-TYPEREAL wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
-    
-    x0r = a[0] + a[2];
-    x0i = a[1] + a[3];
-    x1r = a[0] - a[2];
-    x1i = a[1] - a[3];
-    x2r = a[4] + a[6];
-    x2i = a[5] + a[7];
-    x3r = a[4] - a[6];
-    x3i = a[5] - a[7];
-    a[0] = x0r + x2r;
-    a[1] = x0i + x2i;
-    a[4] = x0r - x2r;
-    a[5] = x0i - x2i;
-    a[2] = x1r - x3i;
-    a[3] = x1i + x3r;
-    a[6] = x1r + x3i;
-    a[7] = x1i - x3r;
-    wk1r = w[2];
-    x0r = a[8] + a[10];
-    x0i = a[9] + a[11];
-    x1r = a[8] - a[10];
-    x1i = a[9] - a[11];
-    x2r = a[12] + a[14];
-    x2i = a[13] + a[15];
-    x3r = a[12] - a[14];
-    x3i = a[13] - a[15];
-    a[8] = x0r + x2r;
-    a[9] = x0i + x2i;
-    a[12] = x2i - x0i;
-    a[13] = x0r - x2r;
-    x0r = x1r - x3i;
-    x0i = x1i + x3r;
-    a[10] = wk1r * (x0r - x0i);
-    a[11] = wk1r * (x0r + x0i);
-    x0r = x3i + x1r;
-    x0i = x3r - x1i;
-    a[14] = wk1r * (x0i - x0r);
-    a[15] = wk1r * (x0i + x0r);
-    k1 = 0;
-    for (j = 16; j < n; j += 16) {
-        k1 += 2;
-        k2 = 2 * k1;
-        wk2r = w[k1];
-        wk2i = w[k1 + 1];
-        wk1r = w[k2];
-        wk1i = w[k2 + 1];
-        wk3r = wk1r - 2 * wk2i * wk1i;
-        wk3i = 2 * wk2i * wk1r - wk1i;
-        x0r = a[j] + a[j + 2];
-        x0i = a[j + 1] + a[j + 3];
-        x1r = a[j] - a[j + 2];
-        x1i = a[j + 1] - a[j + 3];
-        x2r = a[j + 4] + a[j + 6];
-        x2i = a[j + 5] + a[j + 7];
-        x3r = a[j + 4] - a[j + 6];
-        x3i = a[j + 5] - a[j + 7];
-        a[j] = x0r + x2r;
-        a[j + 1] = x0i + x2i;
-        x0r -= x2r;
-        x0i -= x2i;
-        a[j + 4] = wk2r * x0r - wk2i * x0i;
-        a[j + 5] = wk2r * x0i + wk2i * x0r;
-        x0r = x1r - x3i;
-        x0i = x1i + x3r;
-        a[j + 2] = wk1r * x0r - wk1i * x0i;
-        a[j + 3] = wk1r * x0i + wk1i * x0r;
-        x0r = x1r + x3i;
-        x0i = x1i - x3r;
-        a[j + 6] = wk3r * x0r - wk3i * x0i;
-        a[j + 7] = wk3r * x0i + wk3i * x0r;
-        wk1r = w[k2 + 2];
-        wk1i = w[k2 + 3];
-        wk3r = wk1r - 2 * wk2r * wk1i;
-        wk3i = 2 * wk2r * wk1r - wk1i;
-        x0r = a[j + 8] + a[j + 10];
-        x0i = a[j + 9] + a[j + 11];
-        x1r = a[j + 8] - a[j + 10];
-        x1i = a[j + 9] - a[j + 11];
-        x2r = a[j + 12] + a[j + 14];
-        x2i = a[j + 13] + a[j + 15];
-        x3r = a[j + 12] - a[j + 14];
-        x3i = a[j + 13] - a[j + 15];
-        a[j + 8] = x0r + x2r;
-        a[j + 9] = x0i + x2i;
-        x0r -= x2r;
-        x0i -= x2i;
-        a[j + 12] = -wk2i * x0r - wk2r * x0i;
-        a[j + 13] = -wk2i * x0i + wk2r * x0r;
-        x0r = x1r - x3i;
-        x0i = x1i + x3r;
-        a[j + 10] = wk1r * x0r - wk1i * x0i;
-        a[j + 11] = wk1r * x0i + wk1i * x0r;
-        x0r = x1r + x3i;
-        x0i = x1i - x3r;
-        a[j + 14] = wk3r * x0r - wk3i * x0i;
-        a[j + 15] = wk3r * x0i + wk3i * x0r;
-    }
-}
-
-///////////////////////////////////////////////////////////////////
-void CFft::cftmdl(qint32 n, qint32 l, TYPEREAL *a, TYPEREAL *w)
-{
-qint32 j, j1, j2, j3, k, k1, k2, m, m2;
-TYPEREAL wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
-    
-    m = l << 2;
-    for (j = 0; j < l; j += 2) {
-        j1 = j + l;
-        j2 = j1 + l;
-        j3 = j2 + l;
-        x0r = a[j] + a[j1];
-        x0i = a[j + 1] + a[j1 + 1];
-        x1r = a[j] - a[j1];
-        x1i = a[j + 1] - a[j1 + 1];
-        x2r = a[j2] + a[j3];
-        x2i = a[j2 + 1] + a[j3 + 1];
-        x3r = a[j2] - a[j3];
-        x3i = a[j2 + 1] - a[j3 + 1];
-        a[j] = x0r + x2r;
-        a[j + 1] = x0i + x2i;
-        a[j2] = x0r - x2r;
-        a[j2 + 1] = x0i - x2i;
-        a[j1] = x1r - x3i;
-        a[j1 + 1] = x1i + x3r;
-        a[j3] = x1r + x3i;
-        a[j3 + 1] = x1i - x3r;
-    }
-    wk1r = w[2];
-    for (j = m; j < l + m; j += 2) {
-        j1 = j + l;
-        j2 = j1 + l;
-        j3 = j2 + l;
-        x0r = a[j] + a[j1];
-        x0i = a[j + 1] + a[j1 + 1];
-        x1r = a[j] - a[j1];
-        x1i = a[j + 1] - a[j1 + 1];
-        x2r = a[j2] + a[j3];
-        x2i = a[j2 + 1] + a[j3 + 1];
-        x3r = a[j2] - a[j3];
-        x3i = a[j2 + 1] - a[j3 + 1];
-        a[j] = x0r + x2r;
-        a[j + 1] = x0i + x2i;
-        a[j2] = x2i - x0i;
-        a[j2 + 1] = x0r - x2r;
-        x0r = x1r - x3i;
-        x0i = x1i + x3r;
-        a[j1] = wk1r * (x0r - x0i);
-        a[j1 + 1] = wk1r * (x0r + x0i);
-        x0r = x3i + x1r;
-        x0i = x3r - x1i;
-        a[j3] = wk1r * (x0i - x0r);
-        a[j3 + 1] = wk1r * (x0i + x0r);
-    }
-    k1 = 0;
-    m2 = 2 * m;
-    for (k = m2; k < n; k += m2) {
-        k1 += 2;
-        k2 = 2 * k1;
-        wk2r = w[k1];
-        wk2i = w[k1 + 1];
-        wk1r = w[k2];
-        wk1i = w[k2 + 1];
-        wk3r = wk1r - 2 * wk2i * wk1i;
-        wk3i = 2 * wk2i * wk1r - wk1i;
-        for (j = k; j < l + k; j += 2) {
-            j1 = j + l;
-            j2 = j1 + l;
-            j3 = j2 + l;
-            x0r = a[j] + a[j1];
-            x0i = a[j + 1] + a[j1 + 1];
-            x1r = a[j] - a[j1];
-            x1i = a[j + 1] - a[j1 + 1];
-            x2r = a[j2] + a[j3];
-            x2i = a[j2 + 1] + a[j3 + 1];
-            x3r = a[j2] - a[j3];
-            x3i = a[j2 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i + x2i;
-            x0r -= x2r;
-            x0i -= x2i;
-            a[j2] = wk2r * x0r - wk2i * x0i;
-            a[j2 + 1] = wk2r * x0i + wk2i * x0r;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j1] = wk1r * x0r - wk1i * x0i;
-            a[j1 + 1] = wk1r * x0i + wk1i * x0r;
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3] = wk3r * x0r - wk3i * x0i;
-            a[j3 + 1] = wk3r * x0i + wk3i * x0r;
-        }
-        wk1r = w[k2 + 2];
-        wk1i = w[k2 + 3];
-        wk3r = wk1r - 2 * wk2r * wk1i;
-        wk3i = 2 * wk2r * wk1r - wk1i;
-        for (j = k + m; j < l + (k + m); j += 2) {
-            j1 = j + l;
-            j2 = j1 + l;
-            j3 = j2 + l;
-            x0r = a[j] + a[j1];
-            x0i = a[j + 1] + a[j1 + 1];
-            x1r = a[j] - a[j1];
-            x1i = a[j + 1] - a[j1 + 1];
-            x2r = a[j2] + a[j3];
-            x2i = a[j2 + 1] + a[j3 + 1];
-            x3r = a[j2] - a[j3];
-            x3i = a[j2 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i + x2i;
-            x0r -= x2r;
-            x0i -= x2i;
-            a[j2] = -wk2i * x0r - wk2r * x0i;
-            a[j2 + 1] = -wk2i * x0i + wk2r * x0r;
-            x0r = x1r - x3i;
-            x0i = x1i + x3r;
-            a[j1] = wk1r * x0r - wk1i * x0i;
-            a[j1 + 1] = wk1r * x0i + wk1i * x0r;
-            x0r = x1r + x3i;
-            x0i = x1i - x3r;
-            a[j3] = wk3r * x0r - wk3i * x0i;
-            a[j3 + 1] = wk3r * x0i + wk3i * x0r;
-        }
-    }
-}
-
-void CFft::bitrv2conj(int n, int *ip, TYPEREAL *a)
-{
-	int j, j1, k, k1, l, m, m2;
-	TYPEREAL xr, xi, yr, yi;
-
-	ip[0] = 0;
-	l = n;
-	m = 1;
-	while ((m << 3) < l) {
-		l >>= 1;
-		for (j = 0; j < m; j++) {
-			ip[m + j] = ip[j] + l;
-		}
-		m <<= 1;
-	}
-	m2 = 2 * m;
-	if ((m << 3) == l) {
-		for (k = 0; k < m; k++) {
-			for (j = 0; j < k; j++) {
-				j1 = 2 * j + ip[k];
-				k1 = 2 * k + ip[j];
-				xr = a[j1];
-				xi = -a[j1 + 1];
-				yr = a[k1];
-				yi = -a[k1 + 1];
-				a[j1] = yr;
-				a[j1 + 1] = yi;
-				a[k1] = xr;
-				a[k1 + 1] = xi;
-				j1 += m2;
-				k1 += 2 * m2;
-				xr = a[j1];
-				xi = -a[j1 + 1];
-				yr = a[k1];
-				yi = -a[k1 + 1];
-				a[j1] = yr;
-				a[j1 + 1] = yi;
-				a[k1] = xr;
-				a[k1 + 1] = xi;
-				j1 += m2;
-				k1 -= m2;
-				xr = a[j1];
-				xi = -a[j1 + 1];
-				yr = a[k1];
-				yi = -a[k1 + 1];
-				a[j1] = yr;
-				a[j1 + 1] = yi;
-				a[k1] = xr;
-				a[k1 + 1] = xi;
-				j1 += m2;
-				k1 += 2 * m2;
-				xr = a[j1];
-				xi = -a[j1 + 1];
-				yr = a[k1];
-				yi = -a[k1 + 1];
-				a[j1] = yr;
-				a[j1 + 1] = yi;
-				a[k1] = xr;
-				a[k1 + 1] = xi;
-			}
-			k1 = 2 * k + ip[k];
-			a[k1 + 1] = -a[k1 + 1];
-			j1 = k1 + m2;
-			k1 = j1 + m2;
-			xr = a[j1];
-			xi = -a[j1 + 1];
-			yr = a[k1];
-			yi = -a[k1 + 1];
-			a[j1] = yr;
-			a[j1 + 1] = yi;
-			a[k1] = xr;
-			a[k1 + 1] = xi;
-			k1 += m2;
-			a[k1 + 1] = -a[k1 + 1];
-		}
-	} else {
-		a[1] = -a[1];
-		a[m2 + 1] = -a[m2 + 1];
-		for (k = 1; k < m; k++) {
-			for (j = 0; j < k; j++) {
-				j1 = 2 * j + ip[k];
-				k1 = 2 * k + ip[j];
-				xr = a[j1];
-				xi = -a[j1 + 1];
-				yr = a[k1];
-				yi = -a[k1 + 1];
-				a[j1] = yr;
-				a[j1 + 1] = yi;
-				a[k1] = xr;
-				a[k1 + 1] = xi;
-				j1 += m2;
-				k1 += m2;
-				xr = a[j1];
-				xi = -a[j1 + 1];
-				yr = a[k1];
-				yi = -a[k1 + 1];
-				a[j1] = yr;
-				a[j1 + 1] = yi;
-				a[k1] = xr;
-				a[k1 + 1] = xi;
-			}
-			k1 = 2 * k + ip[k];
-			a[k1 + 1] = -a[k1 + 1];
-			a[k1 + m2 + 1] = -a[k1 + m2 + 1];
-		}
-	}
-}
-
-void CFft::cftbsub(int n, TYPEREAL *a, TYPEREAL *w)
-{
-	int j, j1, j2, j3, l;
-	TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
-
-	l = 2;
-	if (n > 8) {
-		cft1st(n, a, w);
-		l = 8;
-		while ((l << 2) < n) {
-			cftmdl(n, l, a, w);
-			l <<= 2;
-		}
-	}
-	if ((l << 2) == n) {
-		for (j = 0; j < l; j += 2) {
-			j1 = j + l;
-			j2 = j1 + l;
-			j3 = j2 + l;
-			x0r = a[j] + a[j1];
-			x0i = -a[j + 1] - a[j1 + 1];
-			x1r = a[j] - a[j1];
-			x1i = -a[j + 1] + a[j1 + 1];
-			x2r = a[j2] + a[j3];
-			x2i = a[j2 + 1] + a[j3 + 1];
-			x3r = a[j2] - a[j3];
-			x3i = a[j2 + 1] - a[j3 + 1];
-			a[j] = x0r + x2r;
-			a[j + 1] = x0i - x2i;
-			a[j2] = x0r - x2r;
-			a[j2 + 1] = x0i + x2i;
-			a[j1] = x1r - x3i;
-			a[j1 + 1] = x1i - x3r;
-			a[j3] = x1r + x3i;
-			a[j3 + 1] = x1i + x3r;
-		}
-	} else {
-		for (j = 0; j < l; j += 2) {
-			j1 = j + l;
-			x0r = a[j] - a[j1];
-			x0i = -a[j + 1] + a[j1 + 1];
-			a[j] += a[j1];
-			a[j + 1] = -a[j + 1] - a[j1 + 1];
-			a[j1] = x0r;
-			a[j1 + 1] = x0i;
-		}
-	}
-}
-
-
+} // namespace FMDSP_NAMESPACE
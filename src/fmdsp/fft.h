@@ -1,27 +1,32 @@
 // fft.h: interface for the CFft class.
 //
-//  This is a somewhat modified version of Takuya OOURA's
-//     original radix 4 FFT package.
-// A C++ wrapper around his code plus some specialized methods
-// for displaying power vs frequency
-//
-//Copyright(C) 1996-1998 Takuya OOURA
-//    (email: ooura@mmm.t.u-tokyo.ac.jp).
+//  Complex FFTs for fast convolution plus some specialized methods
+// for displaying power vs frequency. The twiddles of each size and
+// direction are shared by all CFft objects.
 //
 // History:
 //	2010-09-15  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-16  Replaced the Ooura transforms with shared radix 4 plans and SIMD kernels
 //////////////////////////////////////////////////////////////////////
 #ifndef FFT_H
 #define FFT_H
 
 #include "datatypes.h"
+#include "dispatch.h"
 
 #include <mutex>
 
+namespace FMDSP_NAMESPACE {
+
 #define MAX_FFT_SIZE 65536
 #define MIN_FFT_SIZE 512
 
+//binds the stage kernel used by FwdFFT(), RevFFT() and PutInDisplayFFT()
+const char* BindFft(enum SimdLevel Level);
+
+class CFftPlan;
+
 class CFft
 {
 public:
@@ -46,16 +51,7 @@ public:
 
 private:
 	void FreeMemory();
-	void makewt(qint32 nw, qint32 *ip, TYPEREAL *w);
-	void makect(qint32 nc, qint32 *ip, TYPEREAL *c);
-	void bitrv2(qint32 n, qint32 *ip, TYPEREAL *a);
-	void cftfsub(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void rftfsub(qint32 n, TYPEREAL *a, qint32 nc, TYPEREAL *c);
-	void CpxFFT(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void cft1st(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void cftmdl(qint32 n, qint32 l, TYPEREAL *a, TYPEREAL *w);
-	void bitrv2conj(int n, int *ip, TYPEREAL *a);
-	void cftbsub(int n, TYPEREAL *a, TYPEREAL *w);
+	void CpxFFT(qint32 n, TYPEREAL *a);
 
 	bool m_Overload;
 	bool m_Invert;
@@ -74,9 +70,9 @@ private:
 	TYPEREAL m_K_B;
 	TYPEREAL m_dBCompensation;
 	TYPEREAL m_SampleFreq;
-	qint32* m_pWorkArea;
+	const CFftPlan* m_pFwdPlan;	//shared, never freed by CFft
+	const CFftPlan* m_pRevPlan;
 	qint32* m_pTranslateTbl;
-	TYPEREAL* m_pSinCosTbl;
 	TYPEREAL* m_pWindowTbl;
 	TYPEREAL* m_pFFTPwrAveBuf;
 	TYPEREAL* m_pFFTAveBuf;
@@ -87,4 +83,6 @@ private:
 #endif
 };
 
+} // namespace FMDSP_NAMESPACE
+
 #endif // FFT_H
@@ -44,11 +44,17 @@
 //or implied, of Moe Wheatley.
 //==========================================================================================
 #include "fir.h"
+#include "firkernel.h"
+#include <assert.h>
+#include <string.h>
+
+namespace FMDSP_NAMESPACE {
 
 //////////////////////////////////////////////////////////////////////
 // Local Defines
 //////////////////////////////////////////////////////////////////////
 #define MAX_HALF_BAND_BUFSIZE 8192
+#define FIR_BLOCK_SIZE 512		//number of samples filtered per kernel call
 
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -56,118 +62,151 @@
 /////////////////////////////////////////////////////////////////////////////////
 CFir::CFir()
 {
-	m_NumTaps = 1;
-	m_State = 0;
+	m_NumTaps = 0;
+	m_MaxTaps = 0;
+	m_pCoef = NULL;
+	m_pICoef = NULL;
+	m_pQCoef = NULL;
+	m_pRZBuf = NULL;
+	m_pIZBuf = NULL;
+	m_pQZBuf = NULL;
+	m_pIOutBuf = new TYPEREAL[FIR_BLOCK_SIZE];
+	m_pQOutBuf = new TYPEREAL[FIR_BLOCK_SIZE];
+	AllocateBuffers(1);
+	m_pCoef[0] = m_pICoef[0] = m_pQCoef[0] = 0.0;
+}
+
+CFir::~CFir()
+{
+	delete [] m_pCoef;
+	delete [] m_pICoef;
+	delete [] m_pQCoef;
+	delete [] m_pRZBuf;
+	delete [] m_pIZBuf;
+	delete [] m_pQZBuf;
+	delete [] m_pIOutBuf;
+	delete [] m_pQOutBuf;
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+//	Sets the number of filter taps, growing the coefficient and history
+// buffers if required, and clears out the history buffers.
+/////////////////////////////////////////////////////////////////////////////////
+void CFir::AllocateBuffers(int NumTaps)
+{
+	assert(NumTaps >= 1);
+	if(NumTaps > m_MaxTaps)
+	{
+		delete [] m_pCoef;
+		delete [] m_pICoef;
+		delete [] m_pQCoef;
+		delete [] m_pRZBuf;
+		delete [] m_pIZBuf;
+		delete [] m_pQZBuf;
+		m_pCoef = new TYPEREAL[NumTaps];
+		m_pICoef = new TYPEREAL[NumTaps];
+		m_pQCoef = new TYPEREAL[NumTaps];
+		m_pRZBuf = new TYPEREAL[NumTaps - 1 + FIR_BLOCK_SIZE];
+		m_pIZBuf = new TYPEREAL[NumTaps - 1 + FIR_BLOCK_SIZE];
+		m_pQZBuf = new TYPEREAL[NumTaps - 1 + FIR_BLOCK_SIZE];
+		m_MaxTaps = NumTaps;
+	}
+	m_NumTaps = NumTaps;
+	for(int i=0; i<m_NumTaps - 1; i++)
+		m_pRZBuf[i] = m_pIZBuf[i] = m_pQZBuf[i] = 0.0;
+}
 
 /////////////////////////////////////////////////////////////////////////////////
 //	Process InLength InBuf[] samples and place in OutBuf[]
-//  Note the Coefficient array is twice the length and has a duplicated set
-// in order to eliminate testing for buffer wrap in the inner loop
-//  ex: if 3 tap FIR with coefficients{21,-43,15} is made into a array of 6 entries
-//   {21, -43, 15, 21, -43, 15 }
+//  The input samples are copied behind the last NumTaps-1 samples in the
+// history buffer a block at a time so the filter kernel never has to test
+// for buffer wrap around. InBuf and OutBuf may be the same buffer.
 //REAL version
 /////////////////////////////////////////////////////////////////////////////////
 void CFir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
 {
-TYPEREAL acc;
-TYPEREAL* Zptr;
-const TYPEREAL* Hptr;
-
 #ifdef FMDSP_THREAD_SAFE
 	std::unique_lock<std::mutex> lock(m_Mutex);
 #endif
 
-	for(int i=0; i<InLength; i++)
+	const int hist = m_NumTaps - 1;
+	while(InLength > 0)
 	{
-		m_rZBuf[m_State] = InBuf[i];
-		Hptr = &m_Coef[m_NumTaps - m_State];
-		Zptr = m_rZBuf;
-		acc = (*Hptr++ * *Zptr++);	//do the 1st MAC
-		for(int j=1; j<m_NumTaps; j++)
-			acc += (*Hptr++ * *Zptr++);	//do the remaining MACs
-		if(--m_State < 0)
-			m_State += m_NumTaps;
-		OutBuf[i] = acc;
+		int n = (InLength > FIR_BLOCK_SIZE) ? FIR_BLOCK_SIZE : InLength;
+		memcpy(m_pRZBuf + hist, InBuf, n * sizeof(TYPEREAL));
+		FirFilterBlock(n, m_NumTaps, m_pCoef, m_pRZBuf, OutBuf);
+		memmove(m_pRZBuf, m_pRZBuf + n, hist * sizeof(TYPEREAL));
+		InBuf += n;
+		OutBuf += n;
+		InLength -= n;
 	}
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //	Process InLength InBuf[] samples and place in OutBuf[]
-//  Note the Coefficient array is twice the length and has a duplicated set
-// in order to eliminate testing for buffer wrap in the inner loop
-//  ex: if 3 tap FIR with coefficients{21,-43,15} is mae into a array of 6 entries
-//   {21, -43, 15, 21, -43, 15 }
+//  The I and Q input samples are copied into separate history buffers and
+// filtered with the I and Q coefficients. InBuf and OutBuf may be the same
+// buffer.
 //COMPLEX version
 /////////////////////////////////////////////////////////////////////////////////
 void CFir::ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
 {
-TYPECPX acc;
-TYPECPX* Zptr;
-TYPEREAL* HIptr;
-TYPEREAL* HQptr;
-
 #ifdef FMDSP_THREAD_SAFE
 	std::unique_lock<std::mutex> lock(m_Mutex);
 #endif
 
-	for(int i=0; i<InLength; i++)
+	const int hist = m_NumTaps - 1;
+	while(InLength > 0)
 	{
-		m_cZBuf[m_State] = InBuf[i];
-		HIptr = m_ICoef + m_NumTaps - m_State;
-		HQptr = m_QCoef + m_NumTaps - m_State;
-		Zptr = m_cZBuf;
-		acc.re = (*HIptr++ * (*Zptr).re);		//do the first MAC
-		acc.im = (*HQptr++ * (*Zptr++).im);
-		for(int j=1; j<m_NumTaps; j++)
+		int n = (InLength > FIR_BLOCK_SIZE) ? FIR_BLOCK_SIZE : InLength;
+		for(int i=0; i<n; i++)
+		{
+			m_pIZBuf[hist + i] = InBuf[i].re;
+			m_pQZBuf[hist + i] = InBuf[i].im;
+		}
+		FirFilterBlock(n, m_NumTaps, m_pICoef, m_pIZBuf, m_pIOutBuf);
+		FirFilterBlock(n, m_NumTaps, m_pQCoef, m_pQZBuf, m_pQOutBuf);
+		for(int i=0; i<n; i++)
 		{
-			acc.re += (*HIptr++ * (*Zptr).re);		//do the remaining MACs
-			acc.im += (*HQptr++ * (*Zptr++).im);
+			OutBuf[i].re = m_pIOutBuf[i];
+			OutBuf[i].im = m_pQOutBuf[i];
 		}
-		if(--m_State < 0)
-			m_State += m_NumTaps;
-		OutBuf[i] = acc;
+		memmove(m_pIZBuf, m_pIZBuf + n, hist * sizeof(TYPEREAL));
+		memmove(m_pQZBuf, m_pQZBuf + n, hist * sizeof(TYPEREAL));
+		InBuf += n;
+		OutBuf += n;
+		InLength -= n;
 	}
 }
 
-
 /////////////////////////////////////////////////////////////////////////////////
 //	Process InLength InBuf[] samples and place in OutBuf[]
-//  Note the Coefficient array is twice the length and has a duplicated set
-// in order to eliminate testing for buffer wrap in the inner loop
-//  ex: if 3 tap FIR with coefficients{21,-43,15} is mae into a array of 6 entries
-//   {21, -43, 15, 21, -43, 15 }
+//  The same real input history is filtered with both the I and the Q
+// coefficients.
 //REAL in COMPLEX out version (for Hilbert filter pair)
 /////////////////////////////////////////////////////////////////////////////////
 void CFir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPECPX* OutBuf)
 {
-TYPECPX acc;
-TYPECPX* Zptr;
-TYPEREAL* HIptr;
-TYPEREAL* HQptr;
-
 #ifdef FMDSP_THREAD_SAFE
 	std::unique_lock<std::mutex> lock(m_Mutex);
 #endif
 
-	for(int i=0; i<InLength; i++)
+	const int hist = m_NumTaps - 1;
+	while(InLength > 0)
 	{
-		m_cZBuf[m_State].re = InBuf[i];
-		m_cZBuf[m_State].im = InBuf[i];
-		HIptr = m_ICoef + m_NumTaps - m_State;
-		HQptr = m_QCoef + m_NumTaps - m_State;
-		Zptr = m_cZBuf;
-		acc.re = (*HIptr++ * (*Zptr).re);		//do the first MAC
-		acc.im = (*HQptr++ * (*Zptr++).im);
-		for(int j=1; j<m_NumTaps; j++)
+		int n = (InLength > FIR_BLOCK_SIZE) ? FIR_BLOCK_SIZE : InLength;
+		memcpy(m_pRZBuf + hist, InBuf, n * sizeof(TYPEREAL));
+		FirFilterBlock(n, m_NumTaps, m_pICoef, m_pRZBuf, m_pIOutBuf);
+		FirFilterBlock(n, m_NumTaps, m_pQCoef, m_pRZBuf, m_pQOutBuf);
+		for(int i=0; i<n; i++)
 		{
-			acc.re += (*HIptr++ * (*Zptr).re);		//do the remaining MACs
-			acc.im += (*HQptr++ * (*Zptr++).im);
+			OutBuf[i].re = m_pIOutBuf[i];
+			OutBuf[i].im = m_pQOutBuf[i];
 		}
-		if(--m_State < 0)
-			m_State += m_NumTaps;
-		OutBuf[i] = acc;
+		memmove(m_pRZBuf, m_pRZBuf + n, hist * sizeof(TYPEREAL));
+		InBuf += n;
+		OutBuf += n;
+		InLength -= n;
 	}
 }
 
@@ -182,22 +221,13 @@ void CFir::InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate)
 #endif
 
 	m_SampleRate = Fsamprate;
-	if(NumTaps>MAX_NUMCOEF)
-		m_NumTaps = MAX_NUMCOEF;
-	else
-		m_NumTaps = NumTaps;
+	AllocateBuffers(NumTaps);
 	for(int i=0; i<m_NumTaps; i++)
 	{
-		m_Coef[i] = pCoef[i];
-		m_Coef[m_NumTaps+i] = pCoef[i];	//create duplicate for calculation efficiency
-	}
-	for(int i=0; i<m_NumTaps; i++)
-	{	//zero input buffers
-		m_rZBuf[i] = 0.0;
-		m_cZBuf[i].re = 0.0;
-		m_cZBuf[i].im = 0.0;
+		m_pCoef[i] = pCoef[i];
+		m_pICoef[i] = pCoef[i];
+		m_pQCoef[i] = pCoef[i];
 	}
-	m_State = 0;	//zero filter state variable
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -211,24 +241,12 @@ void CFir::InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQ
 #endif
 
 	m_SampleRate = Fsamprate;
-	if(NumTaps>MAX_NUMCOEF)
-		m_NumTaps = MAX_NUMCOEF;
-	else
-		m_NumTaps = NumTaps;
+	AllocateBuffers(NumTaps);
 	for(int i=0; i<m_NumTaps; i++)
 	{
-		m_ICoef[i] = pICoef[i];
-		m_ICoef[m_NumTaps+i] = pICoef[i];	//create duplicate for calculation efficiency
-		m_QCoef[i] = pQCoef[i];
-		m_QCoef[m_NumTaps+i] = pQCoef[i];	//create duplicate for calculation efficiency
+		m_pICoef[i] = pICoef[i];
+		m_pQCoef[i] = pQCoef[i];
 	}
-	for(int i=0; i<m_NumTaps; i++)
-	{	//zero input buffers
-		m_rZBuf[i] = 0.0;
-		m_cZBuf[i].re = 0.0;
-		m_cZBuf[i].im = 0.0;
-	}
-	m_State = 0;	//zero filter state variable
 }
 
 ////////////////////////////////////////////////////////////////////
@@ -283,6 +301,7 @@ TYPEREAL Beta;
 
 	if(NumTaps)	//if need to force to to a number of taps
 		m_NumTaps = NumTaps;
+	AllocateBuffers(m_NumTaps);
 
 	TYPEREAL fCenter = .5*(TYPEREAL)(m_NumTaps-1);
 	TYPEREAL izb = Izero(Beta);		//precalculate denominator since is same for all points
@@ -297,28 +316,15 @@ TYPEREAL Beta;
 			c = MSIN(K_2PI*x*normFcut)/(K_PI*x);
 		//calculate Kaiser window and multiply to get coefficient
 		x = ((TYPEREAL)n - ((TYPEREAL)m_NumTaps-1.0)/2.0 ) / (((TYPEREAL)m_NumTaps-1.0)/2.0);
-		m_Coef[n] = Scale * c * Izero( Beta * MSQRT(1 - (x*x) ) )  / izb;
+		m_pCoef[n] = Scale * c * Izero( Beta * MSQRT(1 - (x*x) ) )  / izb;
 	}
 
-	//make a 2x length array for FIR flat calculation efficiency
-	for (n = 0; n < m_NumTaps; n++)
-		m_Coef[n+m_NumTaps] = m_Coef[n];
-
 	//copy into complex coef buffers
-	for (n = 0; n < m_NumTaps*2; n++)
-	{
-		m_ICoef[n] = m_Coef[n];
-		m_QCoef[n] = m_Coef[n];
-	}
-
-	//Initialize the FIR buffers and state
-	for(int i=0; i<m_NumTaps; i++)
+	for (n = 0; n < m_NumTaps; n++)
 	{
-		m_rZBuf[i] = 0.0;
-		m_cZBuf[i].re = 0.0;
-		m_cZBuf[i].im = 0.0;
+		m_pICoef[n] = m_pCoef[n];
+		m_pQCoef[n] = m_pCoef[n];
 	}
-	m_State = 0;
 
 	return m_NumTaps;
 
@@ -376,6 +382,7 @@ TYPEREAL Beta;
 
 	if(NumTaps)	//if need to force to to a number of taps
 		m_NumTaps = NumTaps;
+	AllocateBuffers(m_NumTaps);
 
 	TYPEREAL izb = Izero(Beta);		//precalculate denominator since is same for all points
 	TYPEREAL fCenter = .5*(TYPEREAL)(m_NumTaps-1);
@@ -391,28 +398,15 @@ TYPEREAL Beta;
 
 		//calculate Kaiser window and multiply to get coefficient
 		x = ((TYPEREAL)n - ((TYPEREAL)m_NumTaps-1.0)/2.0 ) / (((TYPEREAL)m_NumTaps-1.0)/2.0);
-		m_Coef[n] = Scale * c * Izero( Beta * MSQRT(1 - (x*x) ) )  / izb;
+		m_pCoef[n] = Scale * c * Izero( Beta * MSQRT(1 - (x*x) ) )  / izb;
 	}
 
-	//make a 2x length array for FIR flat calculation efficiency
-	for (n = 0; n < m_NumTaps; n++)
-		m_Coef[n+m_NumTaps] = m_Coef[n];
-
 	//copy into complex coef buffers
-	for (n = 0; n < m_NumTaps*2; n++)
-	{
-		m_ICoef[n] = m_Coef[n];
-		m_QCoef[n] = m_Coef[n];
-	}
-
-	//Initialize the FIR buffers and state
-	for(int i=0; i<m_NumTaps; i++)
+	for (n = 0; n < m_NumTaps; n++)
 	{
-		m_rZBuf[i] = 0.0;
-		m_cZBuf[i].re = 0.0;
-		m_cZBuf[i].im = 0.0;
+		m_pICoef[n] = m_pCoef[n];
+		m_pQCoef[n] = m_pCoef[n];
 	}
-	m_State = 0;
 
 	return m_NumTaps;
 }
@@ -428,14 +422,8 @@ int n;
 	for(n=0; n<m_NumTaps; n++)
 	{
 		// apply complex frequency shift transform to low pass filter coefficients
-		m_ICoef[n] = 2.0 * m_Coef[n] * MCOS( (K_2PI*FreqOffset/m_SampleRate)*((TYPEREAL)n - ( (TYPEREAL)(m_NumTaps-1)/2.0 ) ) );
-		m_QCoef[n] = 2.0 * m_Coef[n] * MSIN( (K_2PI*FreqOffset/m_SampleRate)*((TYPEREAL)n - ( (TYPEREAL)(m_NumTaps-1)/2.0 ) ) );
-	}
-	//make a 2x length array for FIR flat calculation efficiency
-	for (n = 0; n < m_NumTaps; n++)
-	{
-		m_ICoef[n+m_NumTaps] = m_ICoef[n];
-		m_QCoef[n+m_NumTaps] = m_QCoef[n];
+		m_pICoef[n] = 2.0 * m_pCoef[n] * MCOS( (K_2PI*FreqOffset/m_SampleRate)*((TYPEREAL)n - ( (TYPEREAL)(m_NumTaps-1)/2.0 ) ) );
+		m_pQCoef[n] = 2.0 * m_pCoef[n] * MSIN( (K_2PI*FreqOffset/m_SampleRate)*((TYPEREAL)n - ( (TYPEREAL)(m_NumTaps-1)/2.0 ) ) );
 	}
 }
 
@@ -475,21 +463,37 @@ TYPEREAL tmp;
 CDecimateBy2::CDecimateBy2(int len,const TYPEREAL* pCoef )
 	: m_FirLength(len), m_pCoef(pCoef)
 {
-	//create buffer for FIR implementation
-	m_pHBFirRBuf = new TYPEREAL[MAX_HALF_BAND_BUFSIZE];
-	m_pHBFirCBuf = new TYPECPX[MAX_HALF_BAND_BUFSIZE];
+	//a half band filter has (4 * TapPairs) - 1 taps
+	m_TapPairs = (len + 1) / 4;
+	assert( (((4 * m_TapPairs) - 1) == len) && (m_TapPairs <= HB_MAX_TAP_PAIRS) );
+	for(int i=0; i<m_TapPairs; i++)
+		m_Coef[i] = pCoef[i * 2];
+	m_CenterCoef = pCoef[(len - 1) / 2];
+	//create buffers for FIR implementation
+	m_pHBEvenRBuf = new TYPEREAL[MAX_HALF_BAND_BUFSIZE / 2];
+	m_pHBOddRBuf = new TYPEREAL[MAX_HALF_BAND_BUFSIZE / 2];
+	m_pHBEvenCBuf = new TYPECPX[MAX_HALF_BAND_BUFSIZE / 2];
+	m_pHBOddCBuf = new TYPECPX[MAX_HALF_BAND_BUFSIZE / 2];
 	TYPECPX CPXZERO = {0.0,0.0};
-	for(int i=0; i<MAX_HALF_BAND_BUFSIZE ;i++)
+	for(int i=0; i<MAX_HALF_BAND_BUFSIZE / 2; i++)
 	{
-		m_pHBFirRBuf[i] = 0.0;
-		m_pHBFirCBuf[i] = CPXZERO;
+		m_pHBEvenRBuf[i] = m_pHBOddRBuf[i] = 0.0;
+		m_pHBEvenCBuf[i] = m_pHBOddCBuf[i] = CPXZERO;
 	}
 }
 
+CDecimateBy2::~CDecimateBy2()
+{
+	delete [] m_pHBEvenRBuf;
+	delete [] m_pHBOddRBuf;
+	delete [] m_pHBEvenCBuf;
+	delete [] m_pHBOddCBuf;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Half band filter and decimate by 2 function.
 // Two restrictions on this routine:
-// InLength must be larger or equal to the Number of Halfband Taps
+// InLength must be smaller than MAX_HALF_BAND_BUFSIZE less the Number of Halfband Taps
 // InLength must be an even number
 //Mono version
 //////////////////////////////////////////////////////////////////////
@@ -497,36 +501,30 @@ int CDecimateBy2::DecBy2(int InLength, TYPEREAL* pInData, TYPEREAL* pOutData)
 {
 int i;
 int j;
-int numoutsamples = 0;
-	if(InLength<m_FirLength)	//safety net to make sure InLength is large enough to process
+const int hist = (2 * m_TapPairs) - 1;
+int numoutsamples = InLength / 2;
+	//split input samples into the even and odd buffers starting at position hist
+	for(i=0,j = hist; i<InLength; i+=2)
 	{
-		return InLength/2;
+		m_pHBEvenRBuf[j] = pInData[i];
+		m_pHBOddRBuf[j++] = pInData[i+1];
 	}
-	//copy input samples into buffer starting at position m_FirLength-1
-	for(i=0,j = m_FirLength - 1; i<InLength; i++)
-		m_pHBFirRBuf[j++] = pInData[i];
 	//perform decimation FIR filter on even samples
-	for(i=0; i<InLength; i+=2)
+	HalfBandDecBy2(numoutsamples, 1, m_TapPairs, m_Coef, m_CenterCoef, m_pHBEvenRBuf, m_pHBOddRBuf, pOutData);
+	//need to copy last hist even and odd samples to beginning of buffers
+	// for FIR wrap around management
+	for(i=0,j = numoutsamples; i<hist; i++,j++)
 	{
-		TYPEREAL acc;
-		acc = ( m_pHBFirRBuf[i] * m_pCoef[0] );
-		for(j=2; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
-			acc += ( m_pHBFirRBuf[i+j] * m_pCoef[j] );
-		//now multiply the center coefficient
-		acc += ( m_pHBFirRBuf[i+(m_FirLength-1)/2] * m_pCoef[(m_FirLength-1)/2] );
-		pOutData[numoutsamples++] = acc;	//put output buffer
+		m_pHBEvenRBuf[i] = m_pHBEvenRBuf[j];
+		m_pHBOddRBuf[i] = m_pHBOddRBuf[j];
 	}
-	//need to copy last m_FirLength - 1 input samples in buffer to beginning of buffer
-	// for FIR wrap around management
-	for(i=0,j = InLength-m_FirLength+1; i<m_FirLength - 1; i++)
-		m_pHBFirRBuf[i] = pInData[j++];
 	return numoutsamples;
 }
 
 //////////////////////////////////////////////////////////////////////
 // Half band filter and decimate by 2 function.
 // Two restrictions on this routine:
-// InLength must be larger or equal to the Number of Halfband Taps
+// InLength must be smaller than MAX_HALF_BAND_BUFSIZE less the Number of Halfband Taps
 // InLength must be an even number  ~37nS
 // complex or stereo version
 //////////////////////////////////////////////////////////////////////
@@ -534,34 +532,25 @@ int CDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
 {
 int i;
 int j;
-int numoutsamples = 0;
-	if( InLength<m_FirLength)	//safety net to make sure InLength is large enough to process
+const int hist = (2 * m_TapPairs) - 1;
+int numoutsamples = InLength / 2;
+	//split input samples into the even and odd buffers starting at position hist
+	for(i=0,j = hist; i<InLength; i+=2)
 	{
-		return InLength/2;
+		m_pHBEvenCBuf[j] = pInData[i];
+		m_pHBOddCBuf[j++] = pInData[i+1];
 	}
-	//copy input samples into buffer starting at position m_FirLength-1
-	for(i=0,j = m_FirLength - 1; i<InLength; i++)
-		m_pHBFirCBuf[j++] = pInData[i];
-	//perform decimation FIR filter on even samples
-	for(i=0; i<InLength; i+=2)
+	//perform decimation FIR filter on even samples, a complex sample is 2 reals wide
+	HalfBandDecBy2(numoutsamples * 2, 2, m_TapPairs, m_Coef, m_CenterCoef,
+		(const TYPEREAL*)m_pHBEvenCBuf, (const TYPEREAL*)m_pHBOddCBuf, (TYPEREAL*)pOutData);
+	//need to copy last hist even and odd samples to beginning of buffers
+	// for FIR wrap around management
+	for(i=0,j = numoutsamples; i<hist; i++,j++)
 	{
-		TYPECPX acc;
-		acc.re = ( m_pHBFirCBuf[i].re * m_pCoef[0] );
-		acc.im = ( m_pHBFirCBuf[i].im * m_pCoef[0] );
-		for(j=2; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
-		{
-			acc.re += ( m_pHBFirCBuf[i+j].re * m_pCoef[j] );
-			acc.im += ( m_pHBFirCBuf[i+j].im * m_pCoef[j] );
-		}
-		//now multiply the center coefficient
-		acc.re += ( m_pHBFirCBuf[i+(m_FirLength-1)/2].re * m_pCoef[(m_FirLength-1)/2] );
-		acc.im += ( m_pHBFirCBuf[i+(m_FirLength-1)/2].im * m_pCoef[(m_FirLength-1)/2] );
-		pOutData[numoutsamples++] = acc;	//put output buffer
-
+		m_pHBEvenCBuf[i] = m_pHBEvenCBuf[j];
+		m_pHBOddCBuf[i] = m_pHBOddCBuf[j];
 	}
-	//need to copy last m_FirLength - 1 input samples in buffer to beginning of buffer
-	// for FIR wrap around management
-	for(i=0,j = InLength-m_FirLength+1; i<m_FirLength - 1; i++)
-		m_pHBFirCBuf[i] = pInData[j++];
 	return numoutsamples;
 }
+
+} // namespace FMDSP_NAMESPACE
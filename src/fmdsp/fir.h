@@ -1,8 +1,8 @@
 //////////////////////////////////////////////////////////////////////
 // fir.h: interface for the CFir class.
 //
-//  This class implements a FIR  filter using a dual flat coefficient
-//array to eliminate testing for buffer wrap around.
+//  This class implements a FIR  filter using linear history buffers
+//so the filter kernels can calculate a vector of outputs at a time.
 //
 //Also a decimate by 3 half band filter class CDecimateBy2 is implemented
 //
@@ -45,10 +45,13 @@
 
 #include "datatypes.h"
 #include "filtercoef.h"
+#include "halfband.h"
 
-#define MAX_NUMCOEF 75
+#define MAX_NUMCOEF 75		//limit for the number of taps estimated by the filter design functions
 #include <mutex>
 
+namespace FMDSP_NAMESPACE {
+
 ////////////
 //class for FIR Filters
 ////////////
@@ -56,6 +59,7 @@ class CFir
 {
 public:
     CFir();
+	~CFir();
 
 	void InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate);
 	void InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQCoef, TYPEREAL Fsamprate);
@@ -66,16 +70,23 @@ public:
 	void ProcessFilter(int InLength, TYPEREAL* InBuf, TYPECPX* OutBuf);
 	void ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
 
+	static TYPEREAL Izero(TYPEREAL x);	//modified Bessel function I0(x) for Kaiser windows
+
 private:
-	TYPEREAL Izero(TYPEREAL x);
+	void AllocateBuffers(int NumTaps);
 	TYPEREAL m_SampleRate;
 	int m_NumTaps;
-	int m_State;
-	TYPEREAL m_Coef[MAX_NUMCOEF*2];
-	TYPEREAL m_ICoef[MAX_NUMCOEF*2];
-	TYPEREAL m_QCoef[MAX_NUMCOEF*2];
-	TYPEREAL m_rZBuf[MAX_NUMCOEF];
-	TYPECPX m_cZBuf[MAX_NUMCOEF];
+	int m_MaxTaps;			//number of taps the buffers are currently allocated for
+	TYPEREAL* m_pCoef;
+	TYPEREAL* m_pICoef;
+	TYPEREAL* m_pQCoef;
+	//the history buffers hold the last NumTaps-1 input samples followed by
+	//the block being filtered, complex samples are kept as separate I and Q
+	TYPEREAL* m_pRZBuf;
+	TYPEREAL* m_pIZBuf;
+	TYPEREAL* m_pQZBuf;
+	TYPEREAL* m_pIOutBuf;
+	TYPEREAL* m_pQOutBuf;
 #ifdef FMDSP_THREAD_SAFE
 	mutable std::mutex m_Mutex;		//for keeping threads from stomping on each other
 #endif
@@ -88,13 +99,21 @@ class CDecimateBy2
 {
 public:
 	CDecimateBy2(int len, const TYPEREAL* pCoef);
-	~CDecimateBy2(){if(m_pHBFirRBuf) delete m_pHBFirRBuf; if(m_pHBFirCBuf) delete m_pHBFirCBuf;}
+	~CDecimateBy2();
 	int DecBy2(int InLength, TYPEREAL* pInData, TYPEREAL* pOutData);
 	int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-	TYPEREAL* m_pHBFirRBuf;
-	TYPECPX* m_pHBFirCBuf;
+	//the input samples are split into even and odd sample buffers
+	TYPEREAL* m_pHBEvenRBuf;
+	TYPEREAL* m_pHBOddRBuf;
+	TYPECPX* m_pHBEvenCBuf;
+	TYPECPX* m_pHBOddCBuf;
 	int m_FirLength;
 	const TYPEREAL* m_pCoef;
+	int m_TapPairs;
+	TYPEREAL m_Coef[HB_MAX_TAP_PAIRS];	//non-zero taps of the symmetric half, less the center tap
+	TYPEREAL m_CenterCoef;
 };
 
+} // namespace FMDSP_NAMESPACE
+
 #endif // FIR_H
@@ -0,0 +1,323 @@
+//////////////////////////////////////////////////////////////////////
+// firkernel.cpp: implementation of the FIR filter kernels.
+//
+//  Each coefficient is broadcast to a vector and multiplied with the
+//input samples of several consecutive outputs at once. Four vector
+//accumulators are kept in flight so the adds are not serialized on a
+//single register.
+//
+//SSE2, AVX2 and NEON implementations are provided along with a scalar
+//fallback that also handles any trailing outputs. The fixed point dot
+//product has SSE2 and NEON implementations, 8 products per instruction
+//is already more than the filter lengths it is used for need
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "firkernel.h"
+#include "simd.h"
+
+namespace FMDSP_NAMESPACE {
+
+typedef void (*tFirFilterBlock)(int Count, int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn, TYPEREAL* pOut);
+typedef qint32 (*tFixedDotProduct)(int NumTaps, const qint16* pCoef, const qint16* pIn);
+
+//////////////////////////////////////////////////////////////////////
+// Scalar implementation, also used for any trailing outputs the
+// vector implementations don't handle
+//////////////////////////////////////////////////////////////////////
+static void FirFilterBlockScalar(int Count, int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	const TYPEREAL* pNewest = pIn + NumTaps - 1;
+	for(int i=0; i<Count; i++)
+	{
+		TYPEREAL acc = pCoef[0] * pNewest[i];
+		for(int k=1; k<NumTaps; k++)
+			acc += pCoef[k] * pNewest[i - k];
+		pOut[i] = acc;
+	}
+}
+
+static qint32 FixedDotProductScalar(int NumTaps, const qint16* pCoef, const qint16* pIn)
+{
+	qint32 acc = 0;
+	for(int k=0; k<NumTaps; k++)
+		acc += (qint32)pCoef[k] * (qint32)pIn[k];
+	return acc;
+}
+
+#ifdef FMDSP_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 fixed point implementation, pairs of products are summed into
+// 32 bit lanes by pmaddwd
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_SSE2
+static qint32 FixedDotProductSse2(int NumTaps, const qint16* pCoef, const qint16* pIn)
+{
+	__m128i acc = _mm_setzero_si128();
+	for(int k=0; k<NumTaps; k+=8)
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(pCoef + k)), _mm_loadu_si128((const __m128i*)(pIn + k))));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(acc);
+}
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 implementation, 16 single or 8 double precision outputs per
+// iteration
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_SSE2
+static void FirFilterBlockSse2(int Count, int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	const TYPEREAL* pNewest = pIn + NumTaps - 1;
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	for( ; i<=(Count-8); i+=8)
+	{
+		__m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+		for(int k=0; k<NumTaps; k++)
+		{
+			const __m128d coef = _mm_set1_pd(pCoef[k]);
+			const TYPEREAL* p = pNewest + i - k;
+			acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(p), coef));
+			acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(p + 2), coef));
+			acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(p + 4), coef));
+			acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_loadu_pd(p + 6), coef));
+		}
+		_mm_storeu_pd(pOut + i, acc0);
+		_mm_storeu_pd(pOut + i + 2, acc1);
+		_mm_storeu_pd(pOut + i + 4, acc2);
+		_mm_storeu_pd(pOut + i + 6, acc3);
+	}
+#else
+	for( ; i<=(Count-16); i+=16)
+	{
+		__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+		for(int k=0; k<NumTaps; k++)
+		{
+			const __m128 coef = _mm_set1_ps(pCoef[k]);
+			const TYPEREAL* p = pNewest + i - k;
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(p), coef));
+			acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(p + 4), coef));
+			acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(p + 8), coef));
+			acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(p + 12), coef));
+		}
+		_mm_storeu_ps(pOut + i, acc0);
+		_mm_storeu_ps(pOut + i + 4, acc1);
+		_mm_storeu_ps(pOut + i + 8, acc2);
+		_mm_storeu_ps(pOut + i + 12, acc3);
+	}
+#endif
+	FirFilterBlockScalar(Count - i, NumTaps, pCoef, pIn + i, pOut + i);
+}
+
+//////////////////////////////////////////////////////////////////////
+// AVX2 implementation, 32 single or 16 double precision outputs per
+// iteration
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_AVX2
+static void FirFilterBlockAvx2(int Count, int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	const TYPEREAL* pNewest = pIn + NumTaps - 1;
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	for( ; i<=(Count-16); i+=16)
+	{
+		__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+		for(int k=0; k<NumTaps; k++)
+		{
+			const __m256d coef = _mm256_set1_pd(pCoef[k]);
+			const TYPEREAL* p = pNewest + i - k;
+			acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_loadu_pd(p), coef));
+			acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_loadu_pd(p + 4), coef));
+			acc2 = _mm256_add_pd(acc2, _mm256_mul_pd(_mm256_loadu_pd(p + 8), coef));
+			acc3 = _mm256_add_pd(acc3, _mm256_mul_pd(_mm256_loadu_pd(p + 12), coef));
+		}
+		_mm256_storeu_pd(pOut + i, acc0);
+		_mm256_storeu_pd(pOut + i + 4, acc1);
+		_mm256_storeu_pd(pOut + i + 8, acc2);
+		_mm256_storeu_pd(pOut + i + 12, acc3);
+	}
+	for( ; i<=(Count-4); i+=4)
+	{
+		__m256d acc = _mm256_setzero_pd();
+		for(int k=0; k<NumTaps; k++)
+			acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(pNewest + i - k), _mm256_set1_pd(pCoef[k])));
+		_mm256_storeu_pd(pOut + i, acc);
+	}
+#else
+	for( ; i<=(Count-32); i+=32)
+	{
+		__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+		for(int k=0; k<NumTaps; k++)
+		{
+			const __m256 coef = _mm256_set1_ps(pCoef[k]);
+			const TYPEREAL* p = pNewest + i - k;
+			acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(p), coef));
+			acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(p + 8), coef));
+			acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(p + 16), coef));
+			acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(_mm256_loadu_ps(p + 24), coef));
+		}
+		_mm256_storeu_ps(pOut + i, acc0);
+		_mm256_storeu_ps(pOut + i + 8, acc1);
+		_mm256_storeu_ps(pOut + i + 16, acc2);
+		_mm256_storeu_ps(pOut + i + 24, acc3);
+	}
+	for( ; i<=(Count-8); i+=8)
+	{
+		__m256 acc = _mm256_setzero_ps();
+		for(int k=0; k<NumTaps; k++)
+			acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(pNewest + i - k), _mm256_set1_ps(pCoef[k])));
+		_mm256_storeu_ps(pOut + i, acc);
+	}
+#endif
+	_mm256_zeroupper();	//the tail is SSE code
+	FirFilterBlockScalar(Count - i, NumTaps, pCoef, pIn + i, pOut + i);
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+//////////////////////////////////////////////////////////////////////
+// NEON fixed point implementation, widening multiply accumulates
+//////////////////////////////////////////////////////////////////////
+static qint32 FixedDotProductNeon(int NumTaps, const qint16* pCoef, const qint16* pIn)
+{
+	int32x4_t acc0 = vdupq_n_s32(0), acc1 = vdupq_n_s32(0);
+	for(int k=0; k<NumTaps; k+=8)
+	{
+		int16x8_t coef = vld1q_s16(pCoef + k);
+		int16x8_t in = vld1q_s16(pIn + k);
+		acc0 = vmlal_s16(acc0, vget_low_s16(coef), vget_low_s16(in));
+		acc1 = vmlal_s16(acc1, vget_high_s16(coef), vget_high_s16(in));
+	}
+	int32x4_t acc = vaddq_s32(acc0, acc1);
+	int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	return vget_lane_s32(vpadd_s32(sum, sum), 0);
+}
+
+#if defined(FMDSP_USE_DOUBLE_PRECISION) && !defined(FMDSP_SIMD_NEON64)
+ #define FIR_NO_NEON		//no double precision NEON on 32 bit ARM
+#else
+
+//////////////////////////////////////////////////////////////////////
+// NEON implementation, 16 single or 8 double precision outputs per
+// iteration
+//////////////////////////////////////////////////////////////////////
+static void FirFilterBlockNeon(int Count, int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	const TYPEREAL* pNewest = pIn + NumTaps - 1;
+	int i = 0;
+#if !defined(FMDSP_USE_DOUBLE_PRECISION)
+	for( ; i<=(Count-16); i+=16)
+	{
+		float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f), acc2 = vdupq_n_f32(0.0f), acc3 = vdupq_n_f32(0.0f);
+		for(int k=0; k<NumTaps; k++)
+		{
+			const float coef = pCoef[k];
+			const TYPEREAL* p = pNewest + i - k;
+			acc0 = vmlaq_n_f32(acc0, vld1q_f32(p), coef);
+			acc1 = vmlaq_n_f32(acc1, vld1q_f32(p + 4), coef);
+			acc2 = vmlaq_n_f32(acc2, vld1q_f32(p + 8), coef);
+			acc3 = vmlaq_n_f32(acc3, vld1q_f32(p + 12), coef);
+		}
+		vst1q_f32(pOut + i, acc0);
+		vst1q_f32(pOut + i + 4, acc1);
+		vst1q_f32(pOut + i + 8, acc2);
+		vst1q_f32(pOut + i + 12, acc3);
+	}
+#else
+	for( ; i<=(Count-8); i+=8)
+	{
+		float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0), acc2 = vdupq_n_f64(0.0), acc3 = vdupq_n_f64(0.0);
+		for(int k=0; k<NumTaps; k++)
+		{
+			const double coef = pCoef[k];
+			const TYPEREAL* p = pNewest + i - k;
+			acc0 = vmlaq_n_f64(acc0, vld1q_f64(p), coef);
+			acc1 = vmlaq_n_f64(acc1, vld1q_f64(p + 2), coef);
+			acc2 = vmlaq_n_f64(acc2, vld1q_f64(p + 4), coef);
+			acc3 = vmlaq_n_f64(acc3, vld1q_f64(p + 6), coef);
+		}
+		vst1q_f64(pOut + i, acc0);
+		vst1q_f64(pOut + i + 2, acc1);
+		vst1q_f64(pOut + i + 4, acc2);
+		vst1q_f64(pOut + i + 6, acc3);
+	}
+#endif
+	FirFilterBlockScalar(Count - i, NumTaps, pCoef, pIn + i, pOut + i);
+}
+
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tFirFilterBlock s_pFirFilterBlock = FirFilterBlockScalar;
+static tFixedDotProduct s_pFixedDotProduct = FixedDotProductScalar;
+
+//////////////////////////////////////////////////////////////////////
+// Bind the implementations for the instruction set, return their names
+//////////////////////////////////////////////////////////////////////
+const char* BindFirFilterBlock(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pFirFilterBlock = FirFilterBlockAvx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pFirFilterBlock = FirFilterBlockSse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(FIR_NO_NEON)
+	case SIMD_NEON:
+		s_pFirFilterBlock = FirFilterBlockNeon;
+		return "NEON";
+#endif
+	default:
+		s_pFirFilterBlock = FirFilterBlockScalar;
+		return "scalar";
+	}
+}
+
+const char* BindFixedDotProduct(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:		//the 16 bit multiply-add gains nothing from wider vectors here
+	case SIMD_SSE2:
+		s_pFixedDotProduct = FixedDotProductSse2;
+		return "SSE2";
+#endif
+#ifdef FMDSP_SIMD_NEON
+	case SIMD_NEON:
+		s_pFixedDotProduct = FixedDotProductNeon;
+		return "NEON";
+#endif
+	default:
+		s_pFixedDotProduct = FixedDotProductScalar;
+		return "scalar";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Performs the FIR filter function
+//////////////////////////////////////////////////////////////////////
+void FirFilterBlock(int Count, int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	s_pFirFilterBlock(Count, NumTaps, pCoef, pIn, pOut);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Performs the fixed point dot product
+//////////////////////////////////////////////////////////////////////
+qint32 FixedDotProduct(int NumTaps, const qint16* pCoef, const qint16* pIn)
+{
+	return s_pFixedDotProduct(NumTaps, pCoef, pIn);
+}
+
+} // namespace FMDSP_NAMESPACE
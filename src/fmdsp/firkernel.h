@@ -0,0 +1,34 @@
+//////////////////////////////////////////////////////////////////////
+// firkernel.h: interface for the FIR filter kernels.
+//
+//  Filters a block of samples that is preceded in memory by the filter
+//history, so the samples needed for consecutive outputs are contiguous
+//and the outputs can be calculated a whole vector at a time
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef FIRKERNEL_H
+#define FIRKERNEL_H
+
+#include "datatypes.h"
+#include "dispatch.h"
+
+namespace FMDSP_NAMESPACE {
+
+//Performs the FIR filter function producing Count output samples using the
+//best SIMD implementation available on the running CPU.
+//pIn holds the NumTaps - 1 samples of history followed by the Count new
+//input samples, so output sample m is
+// sum(k) pCoef[k] * pIn[m + NumTaps - 1 - k]
+void FirFilterBlock(int Count, int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn, TYPEREAL* pOut);
+const char* BindFirFilterBlock(enum SimdLevel Level);
+
+//Returns sum(k) pCoef[k] * pIn[k] of 16 bit samples with 32 bit accumulation
+//for the fixed point filters. NumTaps must be a multiple of 8
+qint32 FixedDotProduct(int NumTaps, const qint16* pCoef, const qint16* pIn);
+const char* BindFixedDotProduct(enum SimdLevel Level);
+
+} // namespace FMDSP_NAMESPACE
+
+#endif // FIRKERNEL_H
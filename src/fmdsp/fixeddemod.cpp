@@ -0,0 +1,523 @@
+//////////////////////////////////////////////////////////////////////
+// fixeddemod.cpp: implementation of the CFixedDemodulator class.
+//
+//  The chain is the same one CDownConvert and CWFmDemod run for mono
+//audio: mix to baseband, half band decimate to 400KHz or less, FM
+//discriminator, half band decimate the audio to 50-100KHz and de-emphasis.
+//A tile of raw samples is passed through the whole chain before the
+//next one is started. The audio low pass filter and pilot notch are left
+//to CFixedResampler, which designs its phase bank as the low pass filter.
+//
+//Filter outputs are rounded and saturated to +/-32767. The half band
+//taps sum to less than 2.0 in magnitude, so the 32 bit accumulators of
+//Q15 taps and 16 bit samples can't overflow.
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "fixeddemod.h"
+#include "filtercoef.h"
+#include "firkernel.h"
+#include <algorithm>
+#include <string.h>
+
+namespace FMDSP_NAMESPACE {
+
+#define FS4_TOLERANCE 1.0		//Hz the NCO can be off from fs/4 and still be treated as fs/4
+
+//rounds a constant into a Q15 fixed point value
+#define FIXED_Q15(x) ((qint32)(((x) * 32768.0) + (((x) < 0.0) ? -0.5 : 0.5)))
+
+//minimax polynomial coefficients for atan(t) over 0 <= t <= 1, the same
+//ones PolyAtan2() uses
+#define FIXED_ATAN_A1 FIXED_Q15(0.99997726)
+#define FIXED_ATAN_A3 FIXED_Q15(-0.33262347)
+#define FIXED_ATAN_A5 FIXED_Q15(0.19354346)
+#define FIXED_ATAN_A7 FIXED_Q15(-0.11643287)
+#define FIXED_ATAN_A9 FIXED_Q15(0.05265332)
+#define FIXED_ATAN_A11 FIXED_Q15(-0.01172120)
+
+//////////////////////////////////////////////////////////////////////
+// Saturates a filter output to the symmetric 16 bit sample range
+//////////////////////////////////////////////////////////////////////
+static inline qint16 Saturate16(qint32 x)
+{
+	return (qint16)( (x > 32767) ? 32767 : ((x < -32767) ? -32767 : x) );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Centers a raw sample as 2*x - 255, which is exact, and scales it by
+// 2^FIXED_IQ8_SHIFT
+//////////////////////////////////////////////////////////////////////
+static inline qint16 CenterIQ8(quint8 x)
+{
+	return (qint16)(((2 * x) - 255) * (1 << FIXED_IQ8_SHIFT));
+}
+
+//////////////////////////////////////////////////////////////////////
+// Returns the index of the highest set bit of x, x must not be zero
+//////////////////////////////////////////////////////////////////////
+static inline int FixedLog2(quint32 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return 31 - __builtin_clz(x);
+#else
+	int n = 0;
+	while(x >>= 1)
+		n++;
+	return n;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// Fixed point atan2(), returns the angle as a binary angle where 32768
+// is PI. The ratio of the smaller and larger magnitude is calculated
+// with one integer division and the first octant angle is evaluated
+// with the PolyAtan2() polynomial in Q15, |error| < 2 LSB
+//////////////////////////////////////////////////////////////////////
+static inline qint16 FixedAtan2(qint32 y, qint32 x)
+{
+	quint32 ax = (x < 0) ? (0u - (quint32)x) : (quint32)x;
+	quint32 ay = (y < 0) ? (0u - (quint32)y) : (quint32)y;
+	quint32 mx = (ay > ax) ? ay : ax;
+	quint32 mn = (ay > ax) ? ax : ay;
+	if(mx == 0)
+		return 0;
+	//scale both so mn << 15 can't overflow, the ratio is unchanged
+	int shift = FixedLog2(mx) - 16;
+	if(shift > 0)
+	{
+		mx >>= shift;
+		mn >>= shift;
+	}
+	qint32 t = (qint32)((mn << 15) / mx);	//0 to 32768
+	qint32 s = (t * t) >> 15;
+	qint32 p = FIXED_ATAN_A9 + ((s * FIXED_ATAN_A11) >> 15);
+	p = FIXED_ATAN_A7 + ((s * p) >> 15);
+	p = FIXED_ATAN_A5 + ((s * p) >> 15);
+	p = FIXED_ATAN_A3 + ((s * p) >> 15);
+	p = FIXED_ATAN_A1 + ((s * p) >> 15);
+	qint32 angle = (t * p + (1 << 14)) >> 15;	//radians in Q15, 0 to PI/4
+	angle = (angle * 20861 + (1 << 15)) >> 16;	//binary angle, 20861 = 65536/PI
+	if(ay > ax)
+		angle = 16384 - angle;
+	if(x < 0)
+		angle = 32768 - angle;
+	if(y < 0)
+		angle = -angle;
+	//PI and -PI are the same angle, only -PI fits the qint16
+	return (qint16)( (angle > 32767) ? (angle - 65536) : angle );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+CFixedDemodulator::CFixedDemodulator()
+{
+	for(int i=0; i<=FIXED_MAX_STAGES; i++)
+		m_pIStages[i] = m_pQStages[i] = m_pAudioStages[i] = NULL;
+	for(int i=0; i<(1 << FIXED_NCO_BITS); i++)
+		m_NcoSinTable[i] = (qint16)floor((32767.0 * MSIN( (K_2PI*i)/(1 << FIXED_NCO_BITS) )) + 0.5);
+	m_NcoFreq = 0.0;
+	m_NcoPhase = 0;
+	m_NcoInc = 0;
+	m_Fs4Direction = 0;
+	m_Fs4Phase = 0;
+	m_PrevI = m_PrevQ = 0;
+	m_DeemphasisAlpha = 0;
+	m_DeemphasisAve = 0;
+	m_LevelSamples = 0;
+	m_LevelSum = m_LevelSumSquares = 0;
+	m_LevelMax = 0;
+	SetSampleRate(1600000.0, DownsampleQuality::High, true);
+}
+
+CFixedDemodulator::~CFixedDemodulator()
+{
+	DeleteStages();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Delete all the decimate by 2 stages
+//////////////////////////////////////////////////////////////////////
+void CFixedDemodulator::DeleteStages()
+{
+	for(int i=0; i<=FIXED_MAX_STAGES; i++)
+	{
+		if(m_pIStages[i])
+			delete m_pIStages[i];
+		if(m_pQStages[i])
+			delete m_pQStages[i];
+		if(m_pAudioStages[i])
+			delete m_pAudioStages[i];
+		m_pIStages[i] = m_pQStages[i] = m_pAudioStages[i] = NULL;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Creates the decimation chains for the input sample rate the same way
+// CDownConvert::SetWfmDataRate() and CWFmDemod::SetSampleRate() do.
+// Returns the audio output rate
+//////////////////////////////////////////////////////////////////////
+TYPEREAL CFixedDemodulator::SetSampleRate(TYPEREAL InputRate, enum DownsampleQuality Quality, bool USFm)
+{
+int n = 0;
+int len = FIXED_TILE_SIZE;
+TYPEREAL f = InputRate;
+	DeleteStages();
+	m_InputRate = InputRate;
+
+	const TYPEREAL* pCoef = HB51TAP_H;
+	int taps = HB51TAP_LENGTH;
+	if(DownsampleQuality::Medium == Quality)
+	{
+		pCoef = HB27TAP_H;
+		taps = HB27TAP_LENGTH;
+	}
+	else if(DownsampleQuality::Low == Quality)
+	{
+		pCoef = HB11TAP_H;
+		taps = HB11TAP_LENGTH;
+	}
+	//decimate the I/Q samples down to 400KHz or less
+	while( (f > 400000.0) && (n < FIXED_MAX_STAGES) )
+	{
+		m_pIStages[n] = new CHalfBandDecimateBy2(taps, pCoef, len);
+		m_pQStages[n++] = new CHalfBandDecimateBy2(taps, pCoef, len);
+		len /= 2;
+		f /= 2.0;
+	}
+	m_CompositeRate = f;
+
+	//decimate the audio down close to 50KHz
+	n = 0;
+	while( (f > 100000.0) && (n < FIXED_MAX_STAGES) )
+	{
+		m_pAudioStages[n++] = new CHalfBandDecimateBy2(HB47TAP_LENGTH, HB47TAP_H, len);
+		len /= 2;
+		f /= 2.0;
+	}
+	m_OutputRate = f;
+
+	//75uSec or 50uSec de-emphasis one pole filter
+	TYPEREAL alpha = 1.0 - MEXP(-1.0/(m_OutputRate * ((USFm) ? 75E-6 : 50E-6)));
+	m_DeemphasisAlpha = FIXED_Q15(alpha);
+	m_DeemphasisAve = 0;
+	m_PrevI = m_PrevQ = 0;
+
+	//process abt .01sec of samples at a time, modulo 256 since decimation is only in power of 2
+	m_InBufLimit = static_cast<int>(m_InputRate/100.0);
+	m_InBufLimit &= 0xFFFFFF00;
+
+	SetDemodFreq(m_NcoFreq);
+	return m_OutputRate;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Sets NCO Frequency parameters
+//////////////////////////////////////////////////////////////////////
+void CFixedDemodulator::SetDemodFreq(TYPEREAL Freq)
+{
+	m_NcoFreq = Freq;
+	//phase increment with 2^32 as 2PI, negative frequencies wrap around
+	m_NcoInc = (quint32)(long long)floor(((m_NcoFreq / m_InputRate) * 4294967296.0) + 0.5);
+	//determine if the NCO is at +/-fs/4, mixing can then be done without multiplies
+	if( MFABS(m_NcoFreq - (m_InputRate / 4.0)) < FS4_TOLERANCE )
+		m_Fs4Direction = 1;
+	else if( MFABS(m_NcoFreq + (m_InputRate / 4.0)) < FS4_TOLERANCE )
+		m_Fs4Direction = -1;
+	else
+		m_Fs4Direction = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Demodulates InLength raw I/Q samples of 'pInData' into mono audio
+// in 'pOutData'. Returns the number of audio samples
+//////////////////////////////////////////////////////////////////////
+int CFixedDemodulator::ProcessData(int InLength, const quint8* pInData, qint16* pOutData)
+{
+int numoutsamples = 0;
+	for(int i=0; i<InLength; i+=FIXED_TILE_SIZE)
+	{
+		int n = std::min(InLength - i, FIXED_TILE_SIZE);
+		//mix into the input of the first stage
+		qint16* pI = (m_pIStages[0]) ? m_pIStages[0]->GetInputBuffer() : m_IBuf;
+		qint16* pQ = (m_pQStages[0]) ? m_pQStages[0]->GetInputBuffer() : m_QBuf;
+		if(m_Fs4Direction != 0)
+			MixFs4(n, &pInData[i * 2], pI, pQ);	//NCO is at +/-fs/4, so mix without any multiplies
+		else
+			Mix(n, &pInData[i * 2], pI, pQ);
+		Decimate(m_pIStages, n, m_IBuf);
+		n = Decimate(m_pQStages, n, m_QBuf);
+		MeasureSignalLevels(n, m_IBuf, m_QBuf);
+
+		//demodulate into the input of the first audio stage
+		qint16* pAudio = (m_pAudioStages[0]) ? m_pAudioStages[0]->GetInputBuffer() : &pOutData[numoutsamples];
+		Discriminate(n, m_IBuf, m_QBuf, pAudio);
+		if(m_CompositeSink)
+			m_CompositeSink(n, pAudio);
+
+		n = Decimate(m_pAudioStages, n, &pOutData[numoutsamples]);
+		ProcessDeemphasis(n, &pOutData[numoutsamples]);
+		numoutsamples += n;
+	}
+	return numoutsamples;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Passes 'InLength' samples that have been placed in the input buffer
+// of the first stage of a NULL terminated chain through the stages.
+// The last stage places its output samples in 'pOutData'.
+// Returns number of output samples of the last stage.
+//////////////////////////////////////////////////////////////////////
+int CFixedDemodulator::Decimate(CHalfBandDecimateBy2** ppStages, int InLength, qint16* pOutData)
+{
+int n = InLength;
+	while(*ppStages)
+	{
+		qint16* pStageOut = (ppStages[1]) ? ppStages[1]->GetInputBuffer() : pOutData;
+		n = (*ppStages++)->DecBy2(n, pStageOut);
+	}
+	return n;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mixes 'InLength' raw samples by the NCO frequency. The NCO phase is
+// a 32 bit accumulator that indexes a Q15 sine table, the products
+// are scaled to the same range as MixFs4()
+//////////////////////////////////////////////////////////////////////
+void CFixedDemodulator::Mix(int InLength, const quint8* pInData, qint16* pI, qint16* pQ)
+{
+const int quarter = (1 << FIXED_NCO_BITS) / 4;
+const int mask = (1 << FIXED_NCO_BITS) - 1;
+quint32 phase = m_NcoPhase;
+	for(int i=0; i<InLength; i++)
+	{
+		qint32 re = (2 * pInData[(i * 2)]) - 255;
+		qint32 im = (2 * pInData[(i * 2) + 1]) - 255;
+		int n = (int)(phase >> (32 - FIXED_NCO_BITS));
+		qint32 s = m_NcoSinTable[n];
+		qint32 c = m_NcoSinTable[(n + quarter) & mask];
+		pI[i] = (qint16)(((re * c) - (im * s)) >> (15 - FIXED_IQ8_SHIFT));
+		pQ[i] = (qint16)(((re * s) + (im * c)) >> (15 - FIXED_IQ8_SHIFT));
+		phase += m_NcoInc;
+	}
+	m_NcoPhase = phase;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Mixes 'InLength' raw samples by +/-fs/4.
+// Sample n is rotated by (Direction * j)^n, which only swaps and
+// negates I and Q. The rotation phase is kept across calls.
+//////////////////////////////////////////////////////////////////////
+void CFixedDemodulator::MixFs4(int InLength, const quint8* pInData, qint16* pI, qint16* pQ)
+{
+int i = 0;
+	//rotate single samples until the phase is back at 0
+	while( (i < InLength) && (m_Fs4Phase != 0) )
+	{
+		qint16 re = CenterIQ8(pInData[(i * 2)]);
+		qint16 im = CenterIQ8(pInData[(i * 2) + 1]);
+		switch( (m_Fs4Direction > 0) ? m_Fs4Phase : ((4 - m_Fs4Phase) & 3) )
+		{
+			case 0: pI[i] = re; pQ[i] = im; break;		// * 1
+			case 1: pI[i] = -im; pQ[i] = re; break;		// * j
+			case 2: pI[i] = -re; pQ[i] = -im; break;	// * -1
+			default: pI[i] = im; pQ[i] = -re; break;	// * -j
+		}
+		m_Fs4Phase = (m_Fs4Phase + 1) & 3;
+		i++;
+	}
+	//rotate groups of 4 samples starting at phase 0 by 1, j, -1, -j for +fs/4
+	//or by 1, -j, -1, j for -fs/4
+	const qint16 dir = (m_Fs4Direction > 0) ? 1 : -1;
+	int n = i + ((InLength - i) & ~3);
+	for(; i < n; i += 4)
+	{
+		const quint8* p = &pInData[i * 2];
+		qint16 r0 = CenterIQ8(p[0]), i0 = CenterIQ8(p[1]);
+		qint16 r1 = CenterIQ8(p[2]), i1 = CenterIQ8(p[3]);
+		qint16 r2 = CenterIQ8(p[4]), i2 = CenterIQ8(p[5]);
+		qint16 r3 = CenterIQ8(p[6]), i3 = CenterIQ8(p[7]);
+		pI[i] = r0; pQ[i] = i0;
+		pI[i + 1] = -dir * i1; pQ[i + 1] = dir * r1;
+		pI[i + 2] = -r2; pQ[i + 2] = -i2;
+		pI[i + 3] = dir * i3; pQ[i + 3] = -dir * r3;
+	}
+	//rotate the remaining samples
+	for(; i < InLength; i++)
+	{
+		qint16 re = CenterIQ8(pInData[(i * 2)]);
+		qint16 im = CenterIQ8(pInData[(i * 2) + 1]);
+		switch( (m_Fs4Direction > 0) ? m_Fs4Phase : ((4 - m_Fs4Phase) & 3) )
+		{
+			case 0: pI[i] = re; pQ[i] = im; break;		// * 1
+			case 1: pI[i] = -im; pQ[i] = re; break;		// * j
+			case 2: pI[i] = -re; pQ[i] = -im; break;	// * -1
+			default: pI[i] = im; pQ[i] = -re; break;	// * -j
+		}
+		m_Fs4Phase = (m_Fs4Phase + 1) & 3;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Demodulates InLength I/Q samples into the phase change per sample
+// as a binary angle. The phase change is the angle of the current
+// sample times the conjugate of the previous sample
+//////////////////////////////////////////////////////////////////////
+void CFixedDemodulator::Discriminate(int InLength, const qint16* pI, const qint16* pQ, qint16* pOutData)
+{
+qint32 pi = m_PrevI;
+qint32 pq = m_PrevQ;
+	for(int i=0; i<InLength; i++)
+	{
+		qint32 ci = pI[i];
+		qint32 cq = pQ[i];
+		//the samples are within +/-32767 so the sums of products fit in 32 bits
+		qint32 y = (pi * cq) - (ci * pq);
+		qint32 x = (pi * ci) + (pq * cq);
+		pOutData[i] = FixedAtan2(y, x);
+		pi = ci;
+		pq = cq;
+	}
+	m_PrevI = (qint16)pi;
+	m_PrevQ = (qint16)pq;
+}
+
+//////////////////////////////////////////////////////////////////////
+// One pole de-emphasis filter in place over InLength samples. The
+// floating point filter doubles its output, that gain is left to the
+// caller so the 16 bit samples can't overflow
+//////////////////////////////////////////////////////////////////////
+void CFixedDemodulator::ProcessDeemphasis(int InLength, qint16* pData)
+{
+const qint32 alpha = m_DeemphasisAlpha;
+qint32 ave = m_DeemphasisAve;	//local copy so it stays in a register
+	for(int i=0; i<InLength; i++)
+	{
+		qint32 diff = ((qint32)pData[i] * (1 << FIXED_DEEMPHASIS_BITS)) - ave;
+		ave += (qint32)(((long long)alpha * diff) >> 15);
+		pData[i] = (qint16)((ave + (1 << (FIXED_DEEMPHASIS_BITS - 1))) >> FIXED_DEEMPHASIS_BITS);
+	}
+	m_DeemphasisAve = ave;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Accumulates the signal level statistics of InLength I/Q samples
+//////////////////////////////////////////////////////////////////////
+void CFixedDemodulator::MeasureSignalLevels(int InLength, const qint16* pI, const qint16* pQ)
+{
+unsigned long long sum = 0;
+unsigned long long sumsquares = 0;
+quint32 max = m_LevelMax;
+	for(int i=0; i<InLength; i++)
+	{
+		quint32 level = (quint32)((qint32)pI[i] * pI[i]) + (quint32)((qint32)pQ[i] * pQ[i]);
+		level >>= FIXED_LEVEL_SHIFT;
+		sum += level;
+		sumsquares += (unsigned long long)level * level;
+		if(level > max)
+			max = level;
+	}
+	m_LevelSum += sum;
+	m_LevelSumSquares += sumsquares;
+	m_LevelMax = max;
+	m_LevelSamples += InLength;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Retrieves the signal levels and resets the statistics, the values
+// are calculated the same way CDemodulator::GetSignalLevels() does
+//////////////////////////////////////////////////////////////////////
+void CFixedDemodulator::GetSignalLevels(TYPEREAL& quality, TYPEREAL& snr)
+{
+	quality = snr = 0;
+	if(m_LevelSamples > 1)
+	{
+		// Signal quality is based on the coefficient of variation
+		double count = (double)m_LevelSamples;
+		double mean = (double)m_LevelSum / count;
+		double variance = ((double)m_LevelSumSquares - ((double)m_LevelSum * mean)) / (count - 1.0);
+		if(variance < 0.0)
+			variance = 0.0;
+		if(mean > 0.0)
+			quality = (TYPEREAL)(1.0 - (sqrt(variance) / mean));
+
+		// SNR is based on ratio of the mean and the maximum power levels
+		if(m_LevelMax > 0)
+			snr = (TYPEREAL)(mean / (double)m_LevelMax);
+	}
+
+	m_LevelSamples = 0;		// Reset statistics on next pass
+	m_LevelSum = m_LevelSumSquares = 0;
+	m_LevelMax = 0;
+}
+
+// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+
+//////////////////////////////////////////////////////////////////////
+//Decimate by 2 Halfband filter class implementation
+// The filter is split into its two polyphase branches. The even input
+// samples meet the even taps, which are kept as Q15 values padded with
+// leading zeros to a multiple of 8 taps for the vector dot product. Of
+// the odd taps only the center one is non-zero, so the odd samples are
+// only read at a single position. Each branch buffer holds the padded
+// length - 1 previous samples followed by room for 'MaxInLength'/2 new
+// samples
+//////////////////////////////////////////////////////////////////////
+CFixedDemodulator::CHalfBandDecimateBy2::CHalfBandDecimateBy2(int Length, const TYPEREAL* pCoef, int MaxInLength)
+{
+	int eventaps = (Length + 1) / 2;
+	m_NumTaps = ((eventaps + 7) / 8) * 8;
+	int pad = m_NumTaps - eventaps;
+	m_History = m_NumTaps - 1;
+	//the center tap of the filter is (Length - 1) / 2, which is odd for a half band filter
+	m_CenterOffset = pad + (Length - 3) / 4;
+	m_CenterCoef = FIXED_Q15(pCoef[(Length - 1) / 2]);
+	for(int i=0; i<pad; i++)
+		m_Coef[i] = 0;
+	for(int i=0; i<eventaps; i++)
+		m_Coef[pad + i] = (qint16)FIXED_Q15(pCoef[i * 2]);
+	m_pInBuf = new qint16[MaxInLength];
+	m_pEvenBuf = new qint16[m_History + (MaxInLength / 2)];
+	m_pOddBuf = new qint16[m_History + (MaxInLength / 2)];
+	for(int i=0; i<MaxInLength; i++)
+		m_pInBuf[i] = 0;
+	for(int i=0; i<(m_History + (MaxInLength / 2)); i++)
+		m_pEvenBuf[i] = m_pOddBuf[i] = 0;
+}
+
+CFixedDemodulator::CHalfBandDecimateBy2::~CHalfBandDecimateBy2()
+{
+	delete [] m_pInBuf;
+	delete [] m_pEvenBuf;
+	delete [] m_pOddBuf;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Half band filter and decimate by 2 function.
+// Filters the 'InLength' samples in the input buffer and places the
+// decimated samples in 'pOutData'.
+// InLength must be an even number
+//////////////////////////////////////////////////////////////////////
+int CFixedDemodulator::CHalfBandDecimateBy2::DecBy2(int InLength, qint16* pOutData)
+{
+int numoutsamples = InLength / 2;
+	for(int i=0; i<numoutsamples; i++)
+	{
+		m_pEvenBuf[m_History + i] = m_pInBuf[(i * 2)];
+		m_pOddBuf[m_History + i] = m_pInBuf[(i * 2) + 1];
+	}
+	for(int i=0; i<numoutsamples; i++)
+	{
+		qint32 acc = FixedDotProduct(m_NumTaps, m_Coef, &m_pEvenBuf[i]) + (m_CenterCoef * m_pOddBuf[i + m_CenterOffset]);
+		pOutData[i] = Saturate16((acc + (1 << (FIXED_COEF_BITS - 1))) >> FIXED_COEF_BITS);
+	}
+	//need to copy last history samples of each branch to beginning of the buffer
+	// for FIR wrap around management
+	memmove(m_pEvenBuf, &m_pEvenBuf[numoutsamples], m_History * sizeof(qint16));
+	memmove(m_pOddBuf, &m_pOddBuf[numoutsamples], m_History * sizeof(qint16));
+	return numoutsamples;
+}
+
+} // namespace FMDSP_NAMESPACE
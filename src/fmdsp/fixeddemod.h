@@ -0,0 +1,141 @@
+//////////////////////////////////////////////////////////////////////
+// fixeddemod.h: interface for the CFixedDemodulator class.
+//
+//  This class implements a fixed point wideband FM demodulator for CPUs
+//without floating point hardware. Raw 8 bit I/Q samples are mixed to
+//baseband, decimated by half band filters, demodulated, decimated to
+//the audio rate and de-emphasized entirely as 16 bit samples with 32 bit
+//accumulators. Floating point is only used to set up the filters and for
+//the once per block signal level statistics.
+//
+//Samples are kept as separate I and Q buffers of qint16. Filter taps
+//are Q15 and the discriminator output is a binary angle where 32768 is
+//PI, so the phase step of consecutive samples wraps with the qint16.
+//Only mono audio is produced, the stereo decoder is not implemented.
+//
+//On a CPU with floating point hardware it is not faster than the single
+//precision path, on x86-64 it is 3-10% slower with vector kernels and
+//about 35% slower with scalar kernels (test/fixedbench.cpp).
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef FIXEDDEMOD_H
+#define FIXEDDEMOD_H
+
+#include "datatypes.h"
+#include "downconvert.h"
+#include "halfband.h"
+#include <functional>
+
+namespace FMDSP_NAMESPACE {
+
+#define FIXED_TILE_SIZE 4096		//raw input samples passed through the whole chain at a time
+#define FIXED_MAX_STAGES 8			//maximum number of decimate by 2 stages in a chain
+#define FIXED_COEF_BITS 15			//fractional bits of the filter coefficients
+#define FIXED_IQ8_SHIFT 6			//the centered raw samples (2 * x - 255) are scaled to +/-16320
+#define FIXED_NCO_BITS 10			//log2 of the NCO sine table length
+#define FIXED_DEEMPHASIS_BITS 8		//extra fractional bits of the de-emphasis filter state
+#define FIXED_LEVEL_SHIFT 15		//signal level (I*I + Q*Q) reduction for the level statistics
+#define FIXED_DEMOD_GAIN 8000.0		//discriminator gain of the floating point demodulator
+
+//receives the real composite signal for RDS processing outside of the demodulator
+typedef std::function<void(int InLength, const qint16* pData)> tFixedCompositeSink;
+
+class CFixedDemodulator
+{
+public:
+	CFixedDemodulator();
+	virtual ~CFixedDemodulator();
+
+	//sets up the chain for the input sample rate, returns the audio output rate
+	TYPEREAL SetSampleRate(TYPEREAL InputRate, enum DownsampleQuality Quality, bool USFm);
+	void SetDemodFreq(TYPEREAL Freq);
+	TYPEREAL GetOutputRate(){return m_OutputRate;}
+	TYPEREAL GetCompositeRate(){return m_CompositeRate;}
+	int GetInputBufferLimit(void) const {return m_InBufLimit;}
+
+	//gains that convert the audio and composite samples to the scale of the
+	//floating point demodulator
+	static TYPEREAL GetOutputScale(){return 2.0 * FIXED_DEMOD_GAIN * K_PI / 32768.0;}
+	static TYPEREAL GetCompositeScale(){return FIXED_DEMOD_GAIN * K_PI / 32768.0;}
+
+	//when a sink is set the composite signal is handed to it for RDS processing
+	void SetCompositeSink(tFixedCompositeSink const& Sink){m_CompositeSink = Sink;}
+
+	//demodulates InLength raw 8 bit I/Q samples into mono audio, pOutData must have room
+	//for InLength samples. InLength must be a multiple of 2^N where N is the number of
+	//decimate by 2 stages, which GetInputBufferLimit() always is
+	int ProcessData(int InLength, const quint8* pInData, qint16* pOutData);
+
+	// Gets the signal quality values
+	void GetSignalLevels(TYPEREAL& quality, TYPEREAL& snr);
+
+private:
+	////////////
+	//private class for a half band decimate by 2 stage of one real channel, the
+	//previous stage writes its output into the input buffer of the stage
+	////////////
+	class CHalfBandDecimateBy2
+	{
+	public:
+		CHalfBandDecimateBy2(int Length, const TYPEREAL* pCoef, int MaxInLength);
+		~CHalfBandDecimateBy2();
+		qint16* GetInputBuffer(){ return m_pInBuf; }
+		int DecBy2(int InLength, qint16* pOutData);
+		qint16* m_pInBuf;		//new input samples
+		qint16* m_pEvenBuf;		//previous even input samples followed by the new even input samples
+		qint16* m_pOddBuf;		//the same for the odd input samples, only read by the center tap
+		int m_History;
+		int m_NumTaps;			//even taps padded to a multiple of 8 for FixedDotProduct()
+		int m_CenterOffset;		//position of the center tap in the odd samples
+		qint32 m_CenterCoef;
+		qint16 m_Coef[2 * HB_MAX_TAP_PAIRS];
+	};
+
+	void DeleteStages();
+	void Mix(int InLength, const quint8* pInData, qint16* pI, qint16* pQ);
+	void MixFs4(int InLength, const quint8* pInData, qint16* pI, qint16* pQ);
+	int Decimate(CHalfBandDecimateBy2** ppStages, int InLength, qint16* pOutData);
+	void Discriminate(int InLength, const qint16* pI, const qint16* pQ, qint16* pOutData);
+	void ProcessDeemphasis(int InLength, qint16* pData);
+	void MeasureSignalLevels(int InLength, const qint16* pI, const qint16* pQ);
+
+	TYPEREAL m_InputRate;
+	TYPEREAL m_CompositeRate;
+	TYPEREAL m_OutputRate;
+	int m_InBufLimit;
+
+	//mixer, at +/-fs/4 the samples are only swapped and negated
+	TYPEREAL m_NcoFreq;
+	quint32 m_NcoPhase;		//phase accumulator, 2^32 is 2PI
+	quint32 m_NcoInc;
+	qint16 m_NcoSinTable[1 << FIXED_NCO_BITS];
+	int m_Fs4Direction;		//+1/-1 if NCO is at +fs/4 or -fs/4, otherwise 0
+	int m_Fs4Phase;			//fs/4 mixer phase (0-3)
+
+	//NULL terminated decimate by 2 chains for the I/Q samples and the audio
+	CHalfBandDecimateBy2* m_pIStages[FIXED_MAX_STAGES + 1];
+	CHalfBandDecimateBy2* m_pQStages[FIXED_MAX_STAGES + 1];
+	CHalfBandDecimateBy2* m_pAudioStages[FIXED_MAX_STAGES + 1];
+	qint16 m_IBuf[FIXED_TILE_SIZE];	//decimated I/Q samples of one tile
+	qint16 m_QBuf[FIXED_TILE_SIZE];
+
+	qint16 m_PrevI;			//last sample of the previous tile for the discriminator
+	qint16 m_PrevQ;
+
+	qint32 m_DeemphasisAlpha;	//Q15
+	qint32 m_DeemphasisAve;		//filter state with FIXED_DEEMPHASIS_BITS extra fractional bits
+
+	tFixedCompositeSink m_CompositeSink;
+
+	// Signal quality statistics
+	long long m_LevelSamples;
+	unsigned long long m_LevelSum;
+	unsigned long long m_LevelSumSquares;
+	quint32 m_LevelMax;
+};
+
+} // namespace FMDSP_NAMESPACE
+
+#endif // FIXEDDEMOD_H
@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////
+// fixedresampler.cpp: implementation of the CFixedResampler class.
+//
+//  The coefficients are Q15 unless the sum of the magnitudes of a phase
+//could overflow the 32 bit accumulator with full scale input, then the
+//number of fractional bits is reduced until it can't. The sample and
+//phase stepping is the same as CPolyResampler's, whose phases are already
+//padded to a multiple of 8 taps as FixedDotProduct() needs.
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "fixedresampler.h"
+#include "firkernel.h"
+#include "polyresampler.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace FMDSP_NAMESPACE {
+
+//////////////////////////////////////////////////////////////////////
+// Local defines
+//////////////////////////////////////////////////////////////////////
+#define FIXED_MAX_OUTVAL 32767
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+CFixedResampler::CFixedResampler()
+{
+	m_Interpolation = 1;
+	m_Decimation = 1;
+	m_NumTaps = 0;
+	m_CoefBits = 15;
+	m_Index = 0;
+	m_Phase = 0;
+	m_pBank = NULL;
+	m_pHistory = NULL;
+}
+
+CFixedResampler::~CFixedResampler()
+{
+	DeleteBuffers();
+}
+
+void CFixedResampler::DeleteBuffers()
+{
+	if(m_pBank)
+		delete[] m_pBank;
+	if(m_pHistory)
+		delete[] m_pHistory;
+	m_pBank = NULL;
+	m_pHistory = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Design the bank with CPolyResampler and quantize it
+//////////////////////////////////////////////////////////////////////
+bool CFixedResampler::InitLowPass(TYPEREAL InRate, TYPEREAL OutRate, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop)
+{
+int i;
+	DeleteBuffers();
+	CPolyResampler design;
+	if(!design.InitLowPass(InRate, OutRate, Astop, Fpass, Fstop))
+		return false;
+	const TYPEREAL* pBank = design.GetPhaseBank(m_Interpolation, m_Decimation, m_NumTaps);
+	if( (NULL == pBank) || (0 == m_NumTaps) )
+		return false;
+
+	//find the phase with the largest gain, full scale input times its gain
+	// has to fit into the accumulator
+	double maxsum = 0.0;
+	double maxcoef = 0.0;
+	for(int p=0; p<m_Interpolation; p++)
+	{
+		double sum = 0.0;
+		for(i=0; i<m_NumTaps; i++)
+		{
+			double c = MFABS(pBank[p*m_NumTaps + i]);
+			sum += c;
+			if(c > maxcoef)
+				maxcoef = c;
+		}
+		if(sum > maxsum)
+			maxsum = sum;
+	}
+	m_CoefBits = 15;
+	while( (m_CoefBits > 8) && ( (maxsum * (double)(1 << m_CoefBits) >= 65536.0) ||
+			(maxcoef * (double)(1 << m_CoefBits) >= 32767.0) ) )
+		m_CoefBits--;
+
+	m_pBank = new qint16[m_Interpolation * m_NumTaps];
+	for(i=0; i<m_Interpolation * m_NumTaps; i++)
+		m_pBank[i] = (qint16)floor(pBank[i] * (double)(1 << m_CoefBits) + 0.5);
+
+	int hist = m_NumTaps - 1;
+	m_pHistory = new qint16[2*hist];
+	for(i=0; i<2*hist; i++)
+		m_pHistory[i] = 0;
+	m_Index = 0;
+	m_Phase = 0;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Returns the largest number of output samples InLength input samples
+// can produce
+//////////////////////////////////////////////////////////////////////
+int CFixedResampler::GetMaxOutputLength(int InLength)
+{
+	return (int)(((long long)InLength * m_Interpolation) / m_Decimation) + 1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Resample InLength samples in pInBuf and place into pOutBuf
+//   !!!! Make sure pOutBuf from caller can hold GetMaxOutputLength(InLength)
+//  samples  !!!!!
+//////////////////////////////////////////////////////////////////////
+int CFixedResampler::Resample( int InLength, const qint16* pInBuf, TYPEMONO16* pOutBuf, TYPEREAL gain)
+{
+	if(NULL == m_pBank)
+		return 0;
+	int const hist = m_NumTaps - 1;
+	int const head = (InLength < hist) ? InLength : hist;
+	int const step = m_Decimation / m_Interpolation;
+	int const phasestep = m_Decimation % m_Interpolation;
+	int const shift = m_CoefBits + FIXED_GAIN_BITS;
+	long long const gainq = (long long)floor(gain * (double)(1 << FIXED_GAIN_BITS) + 0.5);
+	long long const half = 1LL << (shift - 1);
+	int outsamples = 0;
+
+	memcpy(m_pHistory + hist, pInBuf, head * sizeof(qint16));
+	while(m_Index < InLength)
+	{	//the taps end at input sample m_Index, the first outputs of the block reach
+		// back into the previous block and are read from the history
+		const qint16* pIn = (m_Index < hist) ? (m_pHistory + m_Index) : (pInBuf + m_Index - hist);
+		qint32 acc = FixedDotProduct(m_NumTaps, m_pBank + m_Phase*m_NumTaps, pIn);
+		long long tmp = ((long long)acc * gainq + half) >> shift;
+		if(tmp > FIXED_MAX_OUTVAL)
+			tmp = FIXED_MAX_OUTVAL;
+		if(tmp < -FIXED_MAX_OUTVAL)
+			tmp = -FIXED_MAX_OUTVAL;
+		pOutBuf[outsamples++] = (TYPEMONO16)tmp;
+
+		m_Index += step;
+		m_Phase += phasestep;
+		if(m_Phase >= m_Interpolation)
+		{
+			m_Phase -= m_Interpolation;
+			m_Index++;
+		}
+	}
+	m_Index -= InLength;	//move position back for next call
+
+	//keep the last hist input samples for the next block
+	if(InLength >= hist)
+		memcpy(m_pHistory, pInBuf + InLength - hist, hist * sizeof(qint16));
+	else
+		memmove(m_pHistory, m_pHistory + InLength, hist * sizeof(qint16));
+	return outsamples;
+}
+
+} // namespace FMDSP_NAMESPACE
@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////
+// fixedresampler.h: interface for the CFixedResampler class.
+//
+//  This class implements the fixed point counterpart of the low pass
+//CPolyResampler for the output of CFixedDemodulator. The phase bank is
+//designed by CPolyResampler and quantized to 16 bit coefficients, each
+//output sample is an integer dot product with 32 bit accumulation.
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef FIXEDRESAMPLER_H
+#define FIXEDRESAMPLER_H
+
+#include "datatypes.h"
+
+namespace FMDSP_NAMESPACE {
+
+#define FIXED_GAIN_BITS 16		//fractional bits of the output gain
+
+class CFixedResampler
+{
+public:
+	CFixedResampler();
+	virtual ~CFixedResampler();
+
+	//creates the quantized phase bank, see CPolyResampler::InitLowPass(). Equal
+	//rates create a single phase low pass filter. Returns false if CPolyResampler
+	//can't create a bank for the rates
+	bool InitLowPass(TYPEREAL InRate, TYPEREAL OutRate, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop);
+	//largest number of output samples produced from InLength input samples
+	int GetMaxOutputLength(int InLength);
+	int Resample( int InLength, const qint16* pInBuf, TYPEMONO16* pOutBuf, TYPEREAL gain);
+
+private:
+	void DeleteBuffers();
+
+	int m_Interpolation;	//L, number of phases in the bank
+	int m_Decimation;		//M, input samples consumed per L output samples
+	int m_NumTaps;			//taps per phase
+	int m_CoefBits;			//fractional bits of the coefficients
+	int m_Index;			//input sample index of the next output relative to the next input block
+	int m_Phase;			//phase of the next output
+	qint16* m_pBank;		//m_Interpolation phases of m_NumTaps coefficients
+	qint16* m_pHistory;		//last m_NumTaps-1 input samples followed by the start of the input block
+};
+
+} // namespace FMDSP_NAMESPACE
+
+#endif // FIXEDRESAMPLER_H
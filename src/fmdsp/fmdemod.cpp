@@ -3,11 +3,17 @@
 //  This class takes I/Q baseband data and performs
 // FM demodulation and squelch
 //
+//  The default demodulator runs the block discriminator and then filters its
+//output with the linearized PLL loop response and the DC removal filter as
+//one IIR cascade, giving the audio of the PLL without its per sample NCO.
+//The PLL demodulator can still be selected with SetDemodType(FMDEMOD_PLL).
+//
 // History:
 //	2011-01-17  Initial creation MSW
 //	2011-03-27  Initial release
 //	2011-08-07  Modified FIR filter initialization to force fixed size
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-16  Added block discriminator demodulation, block squelch average
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -41,6 +47,8 @@
 #include "fmdemod.h"
 #include "datatypes.h"
 
+namespace FMDSP_NAMESPACE {
+
 
 #define FMPLL_RANGE 15000.0	//maximum deviation limit of PLL
 #define VOICE_BANDWIDTH 2500.0 //3000.0
@@ -61,8 +69,10 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct FM demod object
 /////////////////////////////////////////////////////////////////////////////////
-CFmDemod::CFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
+CFmDemod::CFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate),
+	m_Discriminator(DEFAULT_FM_DISCRIMINATOR)
 {
+	m_DemodType = DEFAULT_FMDEMOD;
 	m_FreqErrorDC = 0.0;
 	m_NcoPhase = 0.0;
 	m_NcoFreq = 0.0;
@@ -91,6 +101,14 @@ void CFmDemod::SetSampleRate(TYPEREAL samplerate)
 	//DC removal filter time constant
 	m_DcAlpha = (1.0 - MEXP(-1.0/(m_SampleRate*FMDC_ALPHA)) );
 
+	//the PLL NCO frequency follows the discriminator frequency through
+	//		H(z) = Beta/(1 + (Alpha+Beta-2)z^-1 + (1-Alpha)z^-2)
+	//followed by the DC removal filter Out = In - LP(In)
+	CIir dcfilter;
+	dcfilter.InitSection(1.0-m_DcAlpha, -(1.0-m_DcAlpha), 0.0, -(1.0-m_DcAlpha), 0.0);
+	m_AudioIir.InitSection(m_PllBeta, 0.0, 0.0, m_PllAlpha + m_PllBeta - 2.0, 1.0 - m_PllAlpha);
+	m_AudioIir.AppendFilter(dcfilter);
+
 	//initialize some noise squelch items
 	m_SquelchHPFreq = VOICE_BANDWIDTH;
 	m_SquelchAve = 0.0;
@@ -133,15 +151,12 @@ void CFmDemod::PerformNoiseSquelch(int InLength, TYPEREAL* pOutData)
 {
 	if(InLength>MAX_SQBUF_SIZE)
 		return;
-	TYPEREAL sqbuf[MAX_SQBUF_SIZE];
 	//high pass filter to get the high frequency noise above the voice
-	m_HpFir.ProcessFilter(InLength, pOutData, sqbuf);
+	m_HpFir.ProcessFilter(InLength, pOutData, m_TmpBuf);
 	for(int i=0; i<InLength; i++)
-	{
-		TYPEREAL mag = MFABS( sqbuf[i] );	//get magnitude of High pass filtered data
-		// exponential filter squelch magnitude
-		m_SquelchAve = (1.0-m_SquelchAlpha)*m_SquelchAve + m_SquelchAlpha*mag;
-	}
+		m_TmpBuf[i] = MFABS( m_TmpBuf[i] );	//get magnitude of High pass filtered data
+	// exponential filter squelch magnitude
+	OnePoleLowPass(InLength, m_SquelchAlpha, 1.0, m_SquelchAve, m_TmpBuf, m_TmpBuf);
 	//perform squelch compare to threshold using some Hysteresis
 	if(0==m_SquelchThreshold)
 	{	//force squelch if zero(strong signal threshold)
@@ -175,37 +190,19 @@ void CFmDemod::PerformNoiseSquelch(int InLength, TYPEREAL* pOutData)
 /////////////////////////////////////////////////////////////////////////////////
 int CFmDemod::ProcessData(int InLength, TYPEREAL FmBW, TYPECPX* pInData, TYPEREAL* pOutData)
 {
-TYPECPX tmp;
 	if(m_SquelchHPFreq != FmBW)
 	{	//update squelch HP filter cutoff from main filter BW
 		m_SquelchHPFreq = FmBW;
 		InitNoiseSquelch();
 	}
-	for(int i=0; i<InLength; i++)
+	for(int i=0; i<InLength; i+=MAX_SQBUF_SIZE)
 	{
-		TYPEREAL Sin = MSIN(m_NcoPhase);
-		TYPEREAL Cos = MCOS(m_NcoPhase);
-		//complex multiply input sample by NCO's  sin and cos
-		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
-		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
-		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -MATAN2(tmp.im, tmp.re);
-		//create new NCO frequency term
-		m_NcoFreq += (m_PllBeta * phzerror);		//  radians per sampletime
-		//clamp NCO frequency so doesn't get out of lock range
-		if(m_NcoFreq > m_NcoHLimit)
-			m_NcoFreq = m_NcoHLimit;
-		else if(m_NcoFreq < m_NcoLLimit)
-			m_NcoFreq = m_NcoLLimit;
-		//update NCO phase with new value
-		m_NcoPhase += (m_NcoFreq + m_PllAlpha * phzerror);
-		//LP filter the NCO frequency term to get DC offset value
-		m_FreqErrorDC = (1.0-m_DcAlpha)*m_FreqErrorDC + m_DcAlpha*m_NcoFreq;
-		//subtract out DC term to get FM audio
-		pOutData[i] = (m_NcoFreq-m_FreqErrorDC)*m_OutGain;
+		int n = InLength - i;
+		if(n > MAX_SQBUF_SIZE)
+			n = MAX_SQBUF_SIZE;
+		Demodulate(n, &pInData[i], &pOutData[i]);
+		PerformNoiseSquelch(n, &pOutData[i]);	//calculate squelch
 	}
-	m_NcoPhase = MFMOD(m_NcoPhase, K_2PI);	//keep radian counter bounded
-	PerformNoiseSquelch(InLength, pOutData);	//calculate squelch
 	return InLength;
 }
 
@@ -214,12 +211,51 @@ TYPECPX tmp;
 /////////////////////////////////////////////////////////////////////////////////
 int CFmDemod::ProcessData(int InLength, TYPEREAL FmBW, TYPECPX* pInData, TYPECPX* pOutData)
 {
-TYPECPX tmp;
 	if(m_SquelchHPFreq != FmBW)
 	{	//update Squelch HP filter cutoff from main filter BW
 		m_SquelchHPFreq = FmBW;
 		InitNoiseSquelch();
 	}
+	for(int i=0; i<InLength; i+=MAX_SQBUF_SIZE)
+	{
+		int n = InLength - i;
+		if(n > MAX_SQBUF_SIZE)
+			n = MAX_SQBUF_SIZE;
+		Demodulate(n, &pInData[i], m_OutBuf);
+		PerformNoiseSquelch(n, m_OutBuf);
+		for(int j=0; j<n; j++)
+		{	//copy audio stream into both output channels for stereo version
+			pOutData[i+j].re = m_OutBuf[j];
+			pOutData[i+j].im = m_OutBuf[j];
+		}
+	}
+	return InLength;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Demodulates InLength(<= MAX_SQBUF_SIZE) samples into DC free audio
+/////////////////////////////////////////////////////////////////////////////////
+void CFmDemod::Demodulate(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
+{
+	if(FMDEMOD_PLL == m_DemodType)
+	{
+		ProcessPll(InLength, pInData, pOutData);
+		return;
+	}
+	//the phase change per sample is the frequency the PLL NCO would track,
+	// the NCO runs at minus that frequency so the gain is negated to give
+	// the audio the same polarity as the PLL output
+	m_Discriminator.ProcessData(InLength, pInData, -m_OutGain, pOutData);
+	m_AudioIir.ProcessFilter(InLength, pOutData, pOutData);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	PLL demodulator, tracks the input with a NCO and outputs its frequency
+/////////////////////////////////////////////////////////////////////////////////
+void CFmDemod::ProcessPll(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
+{
+TYPECPX tmp;
+	m_Discriminator.PreparePhaseDetector(InLength, pInData);
 	for(int i=0; i<InLength; i++)
 	{
 		TYPEREAL Sin = MSIN(m_NcoPhase);
@@ -228,10 +264,10 @@ TYPECPX tmp;
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -MATAN2(tmp.im, tmp.re);
-
+		TYPEREAL phzerror = -m_Discriminator.PhaseDetector(tmp.im, tmp.re);
+		//create new NCO frequency term
 		m_NcoFreq += (m_PllBeta * phzerror);		//  radians per sampletime
-		//clamp NCO frequency so doesn't drift out of lock range
+		//clamp NCO frequency so doesn't get out of lock range
 		if(m_NcoFreq > m_NcoHLimit)
 			m_NcoFreq = m_NcoHLimit;
 		else if(m_NcoFreq < m_NcoLLimit)
@@ -241,16 +277,9 @@ TYPECPX tmp;
 		//LP filter the NCO frequency term to get DC offset value
 		m_FreqErrorDC = (1.0-m_DcAlpha)*m_FreqErrorDC + m_DcAlpha*m_NcoFreq;
 		//subtract out DC term to get FM audio
-		m_OutBuf[i] = (m_NcoFreq-m_FreqErrorDC)*m_OutGain;
+		pOutData[i] = (m_NcoFreq-m_FreqErrorDC)*m_OutGain;
 	}
 	m_NcoPhase = MFMOD(m_NcoPhase, K_2PI);	//keep radian counter bounded
-	PerformNoiseSquelch(InLength, m_OutBuf);
-	for(int i=0; i<InLength; i++)
-	{	//copy audio stream into both output channels for stereo version
-		pOutData[i].re = m_OutBuf[i];
-		pOutData[i].im = m_OutBuf[i];
-	}
-	return InLength;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -266,3 +295,4 @@ void CFmDemod::ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL*
 	}
 }
 
+} // namespace FMDSP_NAMESPACE
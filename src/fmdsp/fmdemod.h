@@ -4,6 +4,7 @@
 // History:
 //	2011-01-17  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-16  Added block discriminator demodulation
 /////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -38,9 +39,18 @@
 #include "datatypes.h"
 #include "fir.h"
 #include "iir.h"
+#include "discriminator.h"
+
+namespace FMDSP_NAMESPACE {
 
 #define MAX_SQBUF_SIZE 16384
 
+//demodulator types
+#define FMDEMOD_DISCRIMINATOR 0		//block discriminator
+#define FMDEMOD_PLL 1				//per sample PLL, slightly better near threshold but much slower
+
+#define DEFAULT_FMDEMOD FMDEMOD_DISCRIMINATOR
+
 class CFmDemod
 {
 public:
@@ -51,13 +61,18 @@ public:
 
 	void SetSampleRate(TYPEREAL samplerate);
 	void SetSquelch(int Value);		//call with range of -160 to 0 to set squelch threshold
+	void SetDiscriminator(int Type){m_Discriminator.SetType(Type);}	//DISC_ATAN2, DISC_POLYATAN2 or DISC_POLAR
+	void SetDemodType(int Type){m_DemodType = Type;}	//FMDEMOD_DISCRIMINATOR or FMDEMOD_PLL
 
 private:
 	
+	void Demodulate(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
+	void ProcessPll(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
 	void PerformNoiseSquelch(int InLength, TYPEREAL* pOutData);
 	void InitNoiseSquelch();
 	void ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf);
 
+	int m_DemodType;
 	bool m_SquelchState;
 	TYPEREAL m_SampleRate;
 	TYPEREAL m_SquelchHPFreq;
@@ -76,13 +91,18 @@ private:
 	TYPEREAL m_SquelchAlpha;
 
 	TYPEREAL m_OutBuf[MAX_SQBUF_SIZE];
+	TYPEREAL m_TmpBuf[MAX_SQBUF_SIZE];	//squelch filter work buffer
 
 	TYPEREAL m_DeemphasisAve;
 	TYPEREAL m_DeemphasisAlpha;
 
 	CFir m_HpFir;
 	CFir m_LpFir;
+	CIir m_AudioIir;	//PLL loop response and DC removal for the discriminator output
+	CFmDiscriminator m_Discriminator;	//demodulator or PLL phase detector
 
 };
 
+} // namespace FMDSP_NAMESPACE
+
 #endif // FMDEMOD_H
@@ -44,6 +44,8 @@
 
 #include <cstring>
 
+namespace FMDSP_NAMESPACE {
+
 //////////////////////////////////////////////////////////////////////
 // Local defines
 //////////////////////////////////////////////////////////////////////
@@ -334,3 +336,5 @@ TYPEREAL acc;
 		m_pInputBuf[i].re = m_pInputBuf[j++].re;
 	return outsamples;
 }
+
+} // namespace FMDSP_NAMESPACE
@@ -43,6 +43,8 @@
 
 #include "datatypes.h"
 
+namespace FMDSP_NAMESPACE {
+
 class CFractResampler  
 {
 public:
@@ -62,4 +64,6 @@ private:
 	TYPECPX* m_pInputBuf;	//internal working input sample buffer
 };
 
+} // namespace FMDSP_NAMESPACE
+
 #endif // FRACTRESAMPLER_H
@@ -0,0 +1,218 @@
+//////////////////////////////////////////////////////////////////////
+// halfband.cpp: implementation of the half band decimate by 2 kernels.
+//
+//  The even and odd samples are kept in separate buffers, so the
+//samples needed for consecutive outputs are contiguous and the outputs
+//can be calculated a whole vector at a time. Real and complex samples
+//use the same kernels, a complex sample simply being 2 reals wide.
+//
+//SSE2, AVX2 and NEON implementations are provided along with a scalar
+//fallback that also handles any trailing outputs
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "halfband.h"
+#include "simd.h"
+
+namespace FMDSP_NAMESPACE {
+
+typedef void (*tHalfBandDecBy2)(int Count, int Width, int TapPairs, const TYPEREAL* pCoef, TYPEREAL CenterCoef,
+	const TYPEREAL* pEven, const TYPEREAL* pOdd, TYPEREAL* pOut);
+
+//////////////////////////////////////////////////////////////////////
+// Scalar implementation, also used for any trailing outputs the
+// vector implementations don't handle
+//////////////////////////////////////////////////////////////////////
+static void HalfBandDecBy2Scalar(int Count, int Width, int TapPairs, const TYPEREAL* pCoef, TYPEREAL CenterCoef,
+	const TYPEREAL* pEven, const TYPEREAL* pOdd, TYPEREAL* pOut)
+{
+	const int last = ((2 * TapPairs) - 1) * Width;
+	for(int i=0; i<Count; i++)
+	{
+		TYPEREAL acc = pOdd[i + ((TapPairs - 1) * Width)] * CenterCoef;
+		for(int k=0; k<TapPairs; k++)
+			acc += (pEven[i + (k * Width)] + pEven[i + last - (k * Width)]) * pCoef[k];
+		pOut[i] = acc;
+	}
+}
+
+#ifdef FMDSP_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 implementation, 4 single or 2 double precision outputs per
+// iteration
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_SSE2
+static void HalfBandDecBy2Sse2(int Count, int Width, int TapPairs, const TYPEREAL* pCoef, TYPEREAL CenterCoef,
+	const TYPEREAL* pEven, const TYPEREAL* pOdd, TYPEREAL* pOut)
+{
+	const int last = ((2 * TapPairs) - 1) * Width;
+	const TYPEREAL* pCenter = pOdd + ((TapPairs - 1) * Width);
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	__m128d coef[HB_MAX_TAP_PAIRS];
+	for(int k=0; k<TapPairs; k++)
+		coef[k] = _mm_set1_pd(pCoef[k]);
+	const __m128d center = _mm_set1_pd(CenterCoef);
+	for( ; i<=(Count-2); i+=2)
+	{
+		__m128d acc = _mm_mul_pd(_mm_loadu_pd(pCenter + i), center);
+		for(int k=0; k<TapPairs; k++)
+		{
+			__m128d pair = _mm_add_pd(_mm_loadu_pd(pEven + i + (k * Width)), _mm_loadu_pd(pEven + i + last - (k * Width)));
+			acc = _mm_add_pd(acc, _mm_mul_pd(pair, coef[k]));
+		}
+		_mm_storeu_pd(pOut + i, acc);
+	}
+#else
+	__m128 coef[HB_MAX_TAP_PAIRS];
+	for(int k=0; k<TapPairs; k++)
+		coef[k] = _mm_set1_ps(pCoef[k]);
+	const __m128 center = _mm_set1_ps(CenterCoef);
+	for( ; i<=(Count-4); i+=4)
+	{
+		__m128 acc = _mm_mul_ps(_mm_loadu_ps(pCenter + i), center);
+		for(int k=0; k<TapPairs; k++)
+		{
+			__m128 pair = _mm_add_ps(_mm_loadu_ps(pEven + i + (k * Width)), _mm_loadu_ps(pEven + i + last - (k * Width)));
+			acc = _mm_add_ps(acc, _mm_mul_ps(pair, coef[k]));
+		}
+		_mm_storeu_ps(pOut + i, acc);
+	}
+#endif
+	HalfBandDecBy2Scalar(Count - i, Width, TapPairs, pCoef, CenterCoef, pEven + i, pOdd + i, pOut + i);
+}
+
+//////////////////////////////////////////////////////////////////////
+// AVX2 implementation, 8 single or 4 double precision outputs per
+// iteration
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_AVX2
+static void HalfBandDecBy2Avx2(int Count, int Width, int TapPairs, const TYPEREAL* pCoef, TYPEREAL CenterCoef,
+	const TYPEREAL* pEven, const TYPEREAL* pOdd, TYPEREAL* pOut)
+{
+	const int last = ((2 * TapPairs) - 1) * Width;
+	const TYPEREAL* pCenter = pOdd + ((TapPairs - 1) * Width);
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	__m256d coef[HB_MAX_TAP_PAIRS];
+	for(int k=0; k<TapPairs; k++)
+		coef[k] = _mm256_set1_pd(pCoef[k]);
+	const __m256d center = _mm256_set1_pd(CenterCoef);
+	for( ; i<=(Count-4); i+=4)
+	{
+		__m256d acc = _mm256_mul_pd(_mm256_loadu_pd(pCenter + i), center);
+		for(int k=0; k<TapPairs; k++)
+		{
+			__m256d pair = _mm256_add_pd(_mm256_loadu_pd(pEven + i + (k * Width)), _mm256_loadu_pd(pEven + i + last - (k * Width)));
+			acc = _mm256_add_pd(acc, _mm256_mul_pd(pair, coef[k]));
+		}
+		_mm256_storeu_pd(pOut + i, acc);
+	}
+#else
+	__m256 coef[HB_MAX_TAP_PAIRS];
+	for(int k=0; k<TapPairs; k++)
+		coef[k] = _mm256_set1_ps(pCoef[k]);
+	const __m256 center = _mm256_set1_ps(CenterCoef);
+	for( ; i<=(Count-8); i+=8)
+	{
+		__m256 acc = _mm256_mul_ps(_mm256_loadu_ps(pCenter + i), center);
+		for(int k=0; k<TapPairs; k++)
+		{
+			__m256 pair = _mm256_add_ps(_mm256_loadu_ps(pEven + i + (k * Width)), _mm256_loadu_ps(pEven + i + last - (k * Width)));
+			acc = _mm256_add_ps(acc, _mm256_mul_ps(pair, coef[k]));
+		}
+		_mm256_storeu_ps(pOut + i, acc);
+	}
+#endif
+	_mm256_zeroupper();	//the tail is SSE code
+	HalfBandDecBy2Scalar(Count - i, Width, TapPairs, pCoef, CenterCoef, pEven + i, pOdd + i, pOut + i);
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+#if defined(FMDSP_USE_DOUBLE_PRECISION) && !defined(FMDSP_SIMD_NEON64)
+ #define HALFBAND_NO_NEON		//no double precision NEON on 32 bit ARM
+#else
+
+//////////////////////////////////////////////////////////////////////
+// NEON implementation, 4 single or 2 double precision outputs per
+// iteration
+//////////////////////////////////////////////////////////////////////
+static void HalfBandDecBy2Neon(int Count, int Width, int TapPairs, const TYPEREAL* pCoef, TYPEREAL CenterCoef,
+	const TYPEREAL* pEven, const TYPEREAL* pOdd, TYPEREAL* pOut)
+{
+	const int last = ((2 * TapPairs) - 1) * Width;
+	const TYPEREAL* pCenter = pOdd + ((TapPairs - 1) * Width);
+	int i = 0;
+#if !defined(FMDSP_USE_DOUBLE_PRECISION)
+	for( ; i<=(Count-4); i+=4)
+	{
+		float32x4_t acc = vmulq_n_f32(vld1q_f32(pCenter + i), CenterCoef);
+		for(int k=0; k<TapPairs; k++)
+		{
+			float32x4_t pair = vaddq_f32(vld1q_f32(pEven + i + (k * Width)), vld1q_f32(pEven + i + last - (k * Width)));
+			acc = vaddq_f32(acc, vmulq_n_f32(pair, pCoef[k]));
+		}
+		vst1q_f32(pOut + i, acc);
+	}
+#else
+	for( ; i<=(Count-2); i+=2)
+	{
+		float64x2_t acc = vmulq_n_f64(vld1q_f64(pCenter + i), CenterCoef);
+		for(int k=0; k<TapPairs; k++)
+		{
+			float64x2_t pair = vaddq_f64(vld1q_f64(pEven + i + (k * Width)), vld1q_f64(pEven + i + last - (k * Width)));
+			acc = vaddq_f64(acc, vmulq_n_f64(pair, pCoef[k]));
+		}
+		vst1q_f64(pOut + i, acc);
+	}
+#endif
+	HalfBandDecBy2Scalar(Count - i, Width, TapPairs, pCoef, CenterCoef, pEven + i, pOdd + i, pOut + i);
+}
+
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tHalfBandDecBy2 s_pHalfBandDecBy2 = HalfBandDecBy2Scalar;
+
+//////////////////////////////////////////////////////////////////////
+// Binds the implementation for the instruction set, returns its name
+//////////////////////////////////////////////////////////////////////
+const char* BindHalfBandDecBy2(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pHalfBandDecBy2 = HalfBandDecBy2Avx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pHalfBandDecBy2 = HalfBandDecBy2Sse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(HALFBAND_NO_NEON)
+	case SIMD_NEON:
+		s_pHalfBandDecBy2 = HalfBandDecBy2Neon;
+		return "NEON";
+#endif
+	default:
+		s_pHalfBandDecBy2 = HalfBandDecBy2Scalar;
+		return "scalar";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Performs the half band filter and decimate by 2 function
+//////////////////////////////////////////////////////////////////////
+void HalfBandDecBy2(int Count, int Width, int TapPairs, const TYPEREAL* pCoef, TYPEREAL CenterCoef,
+	const TYPEREAL* pEven, const TYPEREAL* pOdd, TYPEREAL* pOut)
+{
+	s_pHalfBandDecBy2(Count, Width, TapPairs, pCoef, CenterCoef, pEven, pOdd, pOut);
+}
+
+} // namespace FMDSP_NAMESPACE
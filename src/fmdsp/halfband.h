@@ -0,0 +1,38 @@
+//////////////////////////////////////////////////////////////////////
+// halfband.h: interface for the half band decimate by 2 kernels.
+//
+//  Filters and decimates by 2 a signal that has been split into its
+//even and odd samples. Only the even taps and the center tap of a half
+//band filter are non-zero and the taps are symmetric, so each output
+//is the center tap times one odd sample plus the sums of pairs of even
+//samples times the folded taps
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef HALFBAND_H
+#define HALFBAND_H
+
+#include "datatypes.h"
+#include "dispatch.h"
+
+namespace FMDSP_NAMESPACE {
+
+#define HB_MAX_TAP_PAIRS 16		//supports half band filters up to 63 taps
+
+//Performs the half band filter and decimate by 2 function producing Count
+//output reals using the best SIMD implementation available on the running CPU.
+//Each sample is Width reals wide (1 for real, 2 for complex samples).
+//pCoef holds the TapPairs non-zero taps h[0], h[2] ... h[N/2 - 1] of an
+//N = (4 * TapPairs) - 1 tap filter. pEven and pOdd hold the even and odd input
+//samples, starting with the (2 * TapPairs) - 1 samples of history, so output
+//sample m is
+// CenterCoef * pOdd[m + TapPairs - 1]
+//  + sum(k) pCoef[k] * (pEven[m + k] + pEven[m + (2 * TapPairs) - 1 - k])
+void HalfBandDecBy2(int Count, int Width, int TapPairs, const TYPEREAL* pCoef, TYPEREAL CenterCoef,
+	const TYPEREAL* pEven, const TYPEREAL* pOdd, TYPEREAL* pOut);
+const char* BindHalfBandDecBy2(enum SimdLevel Level);
+
+} // namespace FMDSP_NAMESPACE
+
+#endif // HALFBAND_H
@@ -32,6 +32,13 @@
 //		w(n) = in - A1*w(n-1) - A2*w(n-2)
 //		out = B0*w(n) + B1*w(n-1) + B2*w(n-2)
 //		w(n-2) = w(n-1)       w(n-1) = w(n)
+//
+//  The transposed direct 2 form, used by default, computes
+//		out = B0*in + s1
+//		s1 = B1*in - A1*out + s2
+//		s2 = B2*in - A2*out
+//  Up to IIR_MAX_SECTIONS sections can be cascaded. The two channels of
+//  complex samples are filtered together in a SIMD lane pair
 //*=========================================================================================
 //  The filter design equations came from a paper by Robert Bristow-Johnson
 //		"Cookbook formulae for audio EQ biquad filter coefficients"
@@ -40,6 +47,7 @@
 //	2011-02-05  Initial creation MSW
 //	2011-03-27  Initial release
 //	2013-07-28  Added single/double precision math macros
+//	2026-10-16  Added transposed form, cascades and SIMD kernels
 //////////////////////////////////////////////////////////////////////
 
 //==========================================================================================
@@ -71,15 +79,622 @@
 //or implied, of Moe Wheatley.
 //==========================================================================================
 #include "iir.h"
+#include "simd.h"
+
+namespace FMDSP_NAMESPACE {
+
+//filters Count samples of Width interleaved channels with one biquad section,
+//pCoef holds B0, B1, B2, A1, A2 and pState the two delay values of each channel
+typedef void (*tBiquadBlock)(int Count, int Width, const TYPEREAL* pCoef, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut);
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Scalar block kernels, the state is kept in registers. Two channels are
+// interleaved so their recursions overlap, any other width is run through the
+// block a channel at a time. pOut may be the same buffer as pIn
+/////////////////////////////////////////////////////////////////////////////////
+static void BiquadDf2Scalar(int Count, int Width, const TYPEREAL* pCoef, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	const TYPEREAL b0 = pCoef[0];
+	const TYPEREAL b1 = pCoef[1];
+	const TYPEREAL b2 = pCoef[2];
+	const TYPEREAL a1 = pCoef[3];
+	const TYPEREAL a2 = pCoef[4];
+	if(2 == Width)
+	{
+		TYPEREAL w1a = pState[0];
+		TYPEREAL w2a = pState[1];
+		TYPEREAL w1b = pState[2];
+		TYPEREAL w2b = pState[3];
+		for(int i=0; i<Count; i++)
+		{
+			TYPEREAL w0a = pIn[2*i] - a1*w1a - a2*w2a;
+			TYPEREAL w0b = pIn[2*i + 1] - a1*w1b - a2*w2b;
+			pOut[2*i] = b0*w0a + b1*w1a + b2*w2a;
+			pOut[2*i + 1] = b0*w0b + b1*w1b + b2*w2b;
+			w2a = w1a;
+			w1a = w0a;
+			w2b = w1b;
+			w1b = w0b;
+		}
+		pState[0] = w1a;
+		pState[1] = w2a;
+		pState[2] = w1b;
+		pState[3] = w2b;
+		return;
+	}
+	for(int c=0; c<Width; c++)
+	{
+		TYPEREAL w1 = pState[2*c];
+		TYPEREAL w2 = pState[2*c + 1];
+		for(int i=0; i<Count; i++)
+		{
+			TYPEREAL w0 = pIn[i*Width + c] - a1*w1 - a2*w2;
+			pOut[i*Width + c] = b0*w0 + b1*w1 + b2*w2;
+			w2 = w1;
+			w1 = w0;
+		}
+		pState[2*c] = w1;
+		pState[2*c + 1] = w2;
+	}
+}
+
+//	The output is substituted into the state updates, which makes them
+//		s1 = (B1 - A1*B0)*in + s2 - A1*s1
+//		s2 = (B2 - A2*B0)*in - A2*s1
+// so the recursion is one multiply and subtract long instead of also going
+// through the output
+static void BiquadTdf2Scalar(int Count, int Width, const TYPEREAL* pCoef, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	const TYPEREAL b0 = pCoef[0];
+	const TYPEREAL a1 = pCoef[3];
+	const TYPEREAL a2 = pCoef[4];
+	const TYPEREAL c1 = pCoef[1] - a1*b0;
+	const TYPEREAL c2 = pCoef[2] - a2*b0;
+	if(2 == Width)
+	{
+		TYPEREAL s1a = pState[0];
+		TYPEREAL s2a = pState[1];
+		TYPEREAL s1b = pState[2];
+		TYPEREAL s2b = pState[3];
+		for(int i=0; i<Count; i++)
+		{
+			TYPEREAL xa = pIn[2*i];
+			TYPEREAL xb = pIn[2*i + 1];
+			pOut[2*i] = b0*xa + s1a;
+			pOut[2*i + 1] = b0*xb + s1b;
+			TYPEREAL t1a = (c1*xa + s2a) - a1*s1a;
+			TYPEREAL t1b = (c1*xb + s2b) - a1*s1b;
+			s2a = c2*xa - a2*s1a;
+			s2b = c2*xb - a2*s1b;
+			s1a = t1a;
+			s1b = t1b;
+		}
+		pState[0] = s1a;
+		pState[1] = s2a;
+		pState[2] = s1b;
+		pState[3] = s2b;
+		return;
+	}
+	for(int c=0; c<Width; c++)
+	{
+		TYPEREAL s1 = pState[2*c];
+		TYPEREAL s2 = pState[2*c + 1];
+		for(int i=0; i<Count; i++)
+		{
+			TYPEREAL x = pIn[i*Width + c];
+			pOut[i*Width + c] = b0*x + s1;
+			TYPEREAL t1 = (c1*x + s2) - a1*s1;
+			s2 = c2*x - a2*s1;
+			s1 = t1;
+		}
+		pState[2*c] = s1;
+		pState[2*c + 1] = s2;
+	}
+}
+
+#ifdef FMDSP_SIMD_X86
+
+/////////////////////////////////////////////////////////////////////////////////
+//	SSE2 kernels, the two channels of a complex sample are filtered in a lane
+// pair. Single channel blocks use the scalar kernels
+/////////////////////////////////////////////////////////////////////////////////
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+ #define IIR_SET1 _mm_set1_pd
+ #define IIR_SETR(a, b) _mm_setr_pd(a, b)
+ #define IIR_LOAD(p) _mm_loadu_pd(p)
+ #define IIR_STORE(p, v) _mm_storeu_pd(p, v)
+ #define IIR_ADD _mm_add_pd
+ #define IIR_SUB _mm_sub_pd
+ #define IIR_MUL _mm_mul_pd
+ typedef __m128d tIirPair;
+#else
+ //the pair is kept in the low half of the vector
+ #define IIR_SET1 _mm_set1_ps
+ #define IIR_SETR(a, b) _mm_setr_ps(a, b, 0.0f, 0.0f)
+ #define IIR_LOAD(p) _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(p))
+ #define IIR_STORE(p, v) _mm_storel_pi((__m64*)(p), v)
+ #define IIR_ADD _mm_add_ps
+ #define IIR_SUB _mm_sub_ps
+ #define IIR_MUL _mm_mul_ps
+ typedef __m128 tIirPair;
+#endif
+
+FMDSP_TARGET_SSE2
+static void BiquadDf2Sse2(int Count, int Width, const TYPEREAL* pCoef, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	if(2 != Width)
+	{
+		BiquadDf2Scalar(Count, Width, pCoef, pState, pIn, pOut);
+		return;
+	}
+	const tIirPair b0 = IIR_SET1(pCoef[0]);
+	const tIirPair b1 = IIR_SET1(pCoef[1]);
+	const tIirPair b2 = IIR_SET1(pCoef[2]);
+	const tIirPair a1 = IIR_SET1(pCoef[3]);
+	const tIirPair a2 = IIR_SET1(pCoef[4]);
+	tIirPair w1 = IIR_SETR(pState[0], pState[2]);
+	tIirPair w2 = IIR_SETR(pState[1], pState[3]);
+	for(int i=0; i<Count; i++)
+	{
+		tIirPair w0 = IIR_SUB(IIR_SUB(IIR_LOAD(pIn + 2*i), IIR_MUL(a1, w1)), IIR_MUL(a2, w2));
+		IIR_STORE(pOut + 2*i, IIR_ADD(IIR_ADD(IIR_MUL(b0, w0), IIR_MUL(b1, w1)), IIR_MUL(b2, w2)));
+		w2 = w1;
+		w1 = w0;
+	}
+	TYPEREAL state[4];
+	IIR_STORE(state, w1);
+	IIR_STORE(state + 2, w2);
+	pState[0] = state[0];
+	pState[1] = state[2];
+	pState[2] = state[1];
+	pState[3] = state[3];
+}
+
+FMDSP_TARGET_SSE2
+static void BiquadTdf2Sse2(int Count, int Width, const TYPEREAL* pCoef, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	if(2 != Width)
+	{
+		BiquadTdf2Scalar(Count, Width, pCoef, pState, pIn, pOut);
+		return;
+	}
+	const tIirPair b0 = IIR_SET1(pCoef[0]);
+	const tIirPair a1 = IIR_SET1(pCoef[3]);
+	const tIirPair a2 = IIR_SET1(pCoef[4]);
+	const tIirPair c1 = IIR_SET1(pCoef[1] - pCoef[3]*pCoef[0]);
+	const tIirPair c2 = IIR_SET1(pCoef[2] - pCoef[4]*pCoef[0]);
+	tIirPair s1 = IIR_SETR(pState[0], pState[2]);
+	tIirPair s2 = IIR_SETR(pState[1], pState[3]);
+	for(int i=0; i<Count; i++)
+	{
+		tIirPair x = IIR_LOAD(pIn + 2*i);
+		IIR_STORE(pOut + 2*i, IIR_ADD(IIR_MUL(b0, x), s1));
+		tIirPair t1 = IIR_SUB(IIR_ADD(IIR_MUL(c1, x), s2), IIR_MUL(a1, s1));
+		s2 = IIR_SUB(IIR_MUL(c2, x), IIR_MUL(a2, s1));
+		s1 = t1;
+	}
+	TYPEREAL state[4];
+	IIR_STORE(state, s1);
+	IIR_STORE(state + 2, s2);
+	pState[0] = state[0];
+	pState[1] = state[2];
+	pState[2] = state[1];
+	pState[3] = state[3];
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+#if defined(FMDSP_USE_DOUBLE_PRECISION) && !defined(FMDSP_SIMD_NEON64)
+ #define IIR_NO_NEON		//no double precision NEON on 32 bit ARM
+#else
+
+/////////////////////////////////////////////////////////////////////////////////
+//	NEON kernels, the two channels of a complex sample are filtered in a lane
+// pair. Single channel blocks use the scalar kernels
+/////////////////////////////////////////////////////////////////////////////////
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+ #define IIR_SET1 vdupq_n_f64
+ #define IIR_LOAD vld1q_f64
+ #define IIR_STORE vst1q_f64
+ #define IIR_ADD vaddq_f64
+ #define IIR_SUB vsubq_f64
+ #define IIR_MUL vmulq_f64
+ typedef float64x2_t tIirPair;
+#else
+ #define IIR_SET1 vdup_n_f32
+ #define IIR_LOAD vld1_f32
+ #define IIR_STORE vst1_f32
+ #define IIR_ADD vadd_f32
+ #define IIR_SUB vsub_f32
+ #define IIR_MUL vmul_f32
+ typedef float32x2_t tIirPair;
+#endif
+
+static void BiquadDf2Neon(int Count, int Width, const TYPEREAL* pCoef, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	if(2 != Width)
+	{
+		BiquadDf2Scalar(Count, Width, pCoef, pState, pIn, pOut);
+		return;
+	}
+	const TYPEREAL w1init[2] = { pState[0], pState[2] };
+	const TYPEREAL w2init[2] = { pState[1], pState[3] };
+	const tIirPair b0 = IIR_SET1(pCoef[0]);
+	const tIirPair b1 = IIR_SET1(pCoef[1]);
+	const tIirPair b2 = IIR_SET1(pCoef[2]);
+	const tIirPair a1 = IIR_SET1(pCoef[3]);
+	const tIirPair a2 = IIR_SET1(pCoef[4]);
+	tIirPair w1 = IIR_LOAD(w1init);
+	tIirPair w2 = IIR_LOAD(w2init);
+	for(int i=0; i<Count; i++)
+	{
+		tIirPair w0 = IIR_SUB(IIR_SUB(IIR_LOAD(pIn + 2*i), IIR_MUL(a1, w1)), IIR_MUL(a2, w2));
+		IIR_STORE(pOut + 2*i, IIR_ADD(IIR_ADD(IIR_MUL(b0, w0), IIR_MUL(b1, w1)), IIR_MUL(b2, w2)));
+		w2 = w1;
+		w1 = w0;
+	}
+	TYPEREAL state[4];
+	IIR_STORE(state, w1);
+	IIR_STORE(state + 2, w2);
+	pState[0] = state[0];
+	pState[1] = state[2];
+	pState[2] = state[1];
+	pState[3] = state[3];
+}
+
+static void BiquadTdf2Neon(int Count, int Width, const TYPEREAL* pCoef, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	if(2 != Width)
+	{
+		BiquadTdf2Scalar(Count, Width, pCoef, pState, pIn, pOut);
+		return;
+	}
+	const TYPEREAL s1init[2] = { pState[0], pState[2] };
+	const TYPEREAL s2init[2] = { pState[1], pState[3] };
+	const tIirPair b0 = IIR_SET1(pCoef[0]);
+	const tIirPair a1 = IIR_SET1(pCoef[3]);
+	const tIirPair a2 = IIR_SET1(pCoef[4]);
+	const tIirPair c1 = IIR_SET1(pCoef[1] - pCoef[3]*pCoef[0]);
+	const tIirPair c2 = IIR_SET1(pCoef[2] - pCoef[4]*pCoef[0]);
+	tIirPair s1 = IIR_LOAD(s1init);
+	tIirPair s2 = IIR_LOAD(s2init);
+	for(int i=0; i<Count; i++)
+	{
+		tIirPair x = IIR_LOAD(pIn + 2*i);
+		IIR_STORE(pOut + 2*i, IIR_ADD(IIR_MUL(b0, x), s1));
+		tIirPair t1 = IIR_SUB(IIR_ADD(IIR_MUL(c1, x), s2), IIR_MUL(a1, s1));
+		s2 = IIR_SUB(IIR_MUL(c2, x), IIR_MUL(a2, s1));
+		s1 = t1;
+	}
+	TYPEREAL state[4];
+	IIR_STORE(state, s1);
+	IIR_STORE(state + 2, s2);
+	pState[0] = state[0];
+	pState[1] = state[2];
+	pState[2] = state[1];
+	pState[3] = state[3];
+}
+
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tBiquadBlock s_pBiquadDf2 = BiquadDf2Scalar;
+static tBiquadBlock s_pBiquadTdf2 = BiquadTdf2Scalar;
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Binds the block kernels for the instruction set, returns their name.
+// A lane pair gains nothing from wider vectors so AVX2 uses the SSE2 kernels
+/////////////////////////////////////////////////////////////////////////////////
+const char* BindBiquad(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE2:
+		s_pBiquadDf2 = BiquadDf2Sse2;
+		s_pBiquadTdf2 = BiquadTdf2Sse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(IIR_NO_NEON)
+	case SIMD_NEON:
+		s_pBiquadDf2 = BiquadDf2Neon;
+		s_pBiquadTdf2 = BiquadTdf2Neon;
+		return "NEON";
+#endif
+	default:
+		s_pBiquadDf2 = BiquadDf2Scalar;
+		s_pBiquadTdf2 = BiquadTdf2Scalar;
+		return "scalar";
+	}
+}
 
 /////////////////////////////////////////////////////////////////////////////////
+//	One pole low pass kernels
+//
+//  The recurrence s(n) = p*s(n-1) + Alpha*x(n), p = 1 - Alpha, is split
+//into a prefix scan inside a vector, which does not depend on the
+//previous output, and a carry of the last output into all lanes:
+//		s(n+k) = scan(n+k) + p^(k+1) * s(n-1)
+//Two vectors are scanned per carry so only one multiply and add per
+//2 vectors is on the critical path instead of one per sample.
+/////////////////////////////////////////////////////////////////////////////////
+typedef void (*tOnePole)(int Count, TYPEREAL Alpha, TYPEREAL Gain, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut);
+
+static void OnePoleScalar(int Count, TYPEREAL Alpha, TYPEREAL Gain, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	TYPEREAL ave = *pState;	//local copy so it stays in a register
+	for(int i=0; i<Count; i++)
+	{
+		ave = (1.0-Alpha)*ave + Alpha*pIn[i];
+		pOut[i] = ave*Gain;
+	}
+	*pState = ave;
+}
+
+#ifdef FMDSP_SIMD_X86
+
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+ #define ONEPOLE_LANES 2
+ #define ONEPOLE_SET1 _mm_set1_pd
+ #define ONEPOLE_LOAD(p) _mm_loadu_pd(p)
+ #define ONEPOLE_STORE(p, v) _mm_storeu_pd(p, v)
+ #define ONEPOLE_ADD _mm_add_pd
+ #define ONEPOLE_MUL _mm_mul_pd
+ typedef __m128d tOnePoleVec;
+
+//prefix scan of the lanes, P1 holds p in every lane
+FMDSP_TARGET_SSE2
+static inline __m128d OnePoleScanSse2(__m128d v, __m128d P1, __m128d)
+{
+	return _mm_add_pd(v, _mm_mul_pd(P1, _mm_unpacklo_pd(_mm_setzero_pd(), v)));
+}
+
+//last lane in every lane
+FMDSP_TARGET_SSE2
+static inline __m128d OnePoleLastSse2(__m128d v)
+{
+	return _mm_unpackhi_pd(v, v);
+}
+#else
+ #define ONEPOLE_LANES 4
+ #define ONEPOLE_SET1 _mm_set1_ps
+ #define ONEPOLE_LOAD(p) _mm_loadu_ps(p)
+ #define ONEPOLE_STORE(p, v) _mm_storeu_ps(p, v)
+ #define ONEPOLE_ADD _mm_add_ps
+ #define ONEPOLE_MUL _mm_mul_ps
+ typedef __m128 tOnePoleVec;
+
+//prefix scan of the lanes, P1 and P2 hold p and p^2 in every lane
+FMDSP_TARGET_SSE2
+static inline __m128 OnePoleScanSse2(__m128 v, __m128 P1, __m128 P2)
+{
+	v = _mm_add_ps(v, _mm_mul_ps(P1, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4))));
+	return _mm_add_ps(v, _mm_mul_ps(P2, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 8))));
+}
+
+//last lane in every lane
+FMDSP_TARGET_SSE2
+static inline __m128 OnePoleLastSse2(__m128 v)
+{
+	return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3,3,3,3));
+}
+#endif
+
+FMDSP_TARGET_SSE2
+static void OnePoleSse2(int Count, TYPEREAL Alpha, TYPEREAL Gain, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	TYPEREAL powers[2*ONEPOLE_LANES];	//p^1 to p^(2*lanes)
+	TYPEREAL p = 1.0 - Alpha;
+	powers[0] = p;
+	for(int k=1; k<2*ONEPOLE_LANES; k++)
+		powers[k] = powers[k-1]*p;
+	const tOnePoleVec alpha = ONEPOLE_SET1(Alpha);
+	const tOnePoleVec gain = ONEPOLE_SET1(Gain);
+	const tOnePoleVec p1 = ONEPOLE_SET1(powers[0]);
+	const tOnePoleVec p2 = ONEPOLE_SET1(powers[1]);
+	const tOnePoleVec pa = ONEPOLE_LOAD(powers);
+	const tOnePoleVec pb = ONEPOLE_LOAD(powers + ONEPOLE_LANES);
+	tOnePoleVec carry = ONEPOLE_SET1(*pState);
+	int i = 0;
+	for(; i<=Count-2*ONEPOLE_LANES; i+=2*ONEPOLE_LANES)
+	{
+		tOnePoleVec a = OnePoleScanSse2(ONEPOLE_MUL(alpha, ONEPOLE_LOAD(pIn + i)), p1, p2);
+		tOnePoleVec b = OnePoleScanSse2(ONEPOLE_MUL(alpha, ONEPOLE_LOAD(pIn + i + ONEPOLE_LANES)), p1, p2);
+		b = ONEPOLE_ADD(b, ONEPOLE_MUL(pa, OnePoleLastSse2(a)));
+		a = ONEPOLE_ADD(a, ONEPOLE_MUL(pa, carry));
+		b = ONEPOLE_ADD(b, ONEPOLE_MUL(pb, carry));
+		carry = OnePoleLastSse2(b);
+		ONEPOLE_STORE(pOut + i, ONEPOLE_MUL(gain, a));
+		ONEPOLE_STORE(pOut + i + ONEPOLE_LANES, ONEPOLE_MUL(gain, b));
+	}
+	TYPEREAL state[ONEPOLE_LANES];
+	ONEPOLE_STORE(state, carry);
+	*pState = state[0];
+	OnePoleScalar(Count - i, Alpha, Gain, pState, pIn + i, pOut + i);
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+#if !defined(IIR_NO_NEON)
+
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+ #define ONEPOLE_LANES 2
+ #define ONEPOLE_SET1 vdupq_n_f64
+ #define ONEPOLE_LOAD(p) vld1q_f64(p)
+ #define ONEPOLE_STORE(p, v) vst1q_f64(p, v)
+ #define ONEPOLE_ADD vaddq_f64
+ #define ONEPOLE_MUL vmulq_f64
+ typedef float64x2_t tOnePoleVec;
+
+static inline float64x2_t OnePoleScanNeon(float64x2_t v, float64x2_t P1, float64x2_t)
+{
+	return vaddq_f64(v, vmulq_f64(P1, vextq_f64(vdupq_n_f64(0.0), v, 1)));
+}
+
+static inline float64x2_t OnePoleLastNeon(float64x2_t v)
+{
+	return vdupq_laneq_f64(v, 1);
+}
+#else
+ #define ONEPOLE_LANES 4
+ #define ONEPOLE_SET1 vdupq_n_f32
+ #define ONEPOLE_LOAD(p) vld1q_f32(p)
+ #define ONEPOLE_STORE(p, v) vst1q_f32(p, v)
+ #define ONEPOLE_ADD vaddq_f32
+ #define ONEPOLE_MUL vmulq_f32
+ typedef float32x4_t tOnePoleVec;
+
+static inline float32x4_t OnePoleScanNeon(float32x4_t v, float32x4_t P1, float32x4_t P2)
+{
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	v = vaddq_f32(v, vmulq_f32(P1, vextq_f32(zero, v, 3)));
+	return vaddq_f32(v, vmulq_f32(P2, vextq_f32(zero, v, 2)));
+}
+
+static inline float32x4_t OnePoleLastNeon(float32x4_t v)
+{
+	return vdupq_lane_f32(vget_high_f32(v), 1);
+}
+#endif
+
+static void OnePoleNeon(int Count, TYPEREAL Alpha, TYPEREAL Gain, TYPEREAL* pState,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	TYPEREAL powers[2*ONEPOLE_LANES];	//p^1 to p^(2*lanes)
+	TYPEREAL p = 1.0 - Alpha;
+	powers[0] = p;
+	for(int k=1; k<2*ONEPOLE_LANES; k++)
+		powers[k] = powers[k-1]*p;
+	const tOnePoleVec alpha = ONEPOLE_SET1(Alpha);
+	const tOnePoleVec gain = ONEPOLE_SET1(Gain);
+	const tOnePoleVec p1 = ONEPOLE_SET1(powers[0]);
+	const tOnePoleVec p2 = ONEPOLE_SET1(powers[1]);
+	const tOnePoleVec pa = ONEPOLE_LOAD(powers);
+	const tOnePoleVec pb = ONEPOLE_LOAD(powers + ONEPOLE_LANES);
+	tOnePoleVec carry = ONEPOLE_SET1(*pState);
+	int i = 0;
+	for(; i<=Count-2*ONEPOLE_LANES; i+=2*ONEPOLE_LANES)
+	{
+		tOnePoleVec a = OnePoleScanNeon(ONEPOLE_MUL(alpha, ONEPOLE_LOAD(pIn + i)), p1, p2);
+		tOnePoleVec b = OnePoleScanNeon(ONEPOLE_MUL(alpha, ONEPOLE_LOAD(pIn + i + ONEPOLE_LANES)), p1, p2);
+		b = ONEPOLE_ADD(b, ONEPOLE_MUL(pa, OnePoleLastNeon(a)));
+		a = ONEPOLE_ADD(a, ONEPOLE_MUL(pa, carry));
+		b = ONEPOLE_ADD(b, ONEPOLE_MUL(pb, carry));
+		carry = OnePoleLastNeon(b);
+		ONEPOLE_STORE(pOut + i, ONEPOLE_MUL(gain, a));
+		ONEPOLE_STORE(pOut + i + ONEPOLE_LANES, ONEPOLE_MUL(gain, b));
+	}
+	TYPEREAL state[ONEPOLE_LANES];
+	ONEPOLE_STORE(state, carry);
+	*pState = state[0];
+	OnePoleScalar(Count - i, Alpha, Gain, pState, pIn + i, pOut + i);
+}
+
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tOnePole s_pOnePole = OnePoleScalar;
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Binds the one pole kernel for the instruction set, returns its name.
+// The carry between vectors is the critical path so AVX2 uses the SSE2
+// kernel
+/////////////////////////////////////////////////////////////////////////////////
+const char* BindOnePole(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+	case SIMD_SSE2:
+		s_pOnePole = OnePoleSse2;
+		return "SSE2 scan";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(IIR_NO_NEON)
+	case SIMD_NEON:
+		s_pOnePole = OnePoleNeon;
+		return "NEON scan";
+#endif
+	default:
+		s_pOnePole = OnePoleScalar;
+		return "scalar";
+	}
+}
+
+void OnePoleLowPass(int Count, TYPEREAL Alpha, TYPEREAL Gain, TYPEREAL& State,
+	const TYPEREAL* pIn, TYPEREAL* pOut)
+{
+	s_pOnePole(Count, Alpha, Gain, &State, pIn, pOut);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
 //	Construct CIir object
 /////////////////////////////////////////////////////////////////////////////////
 CIir::CIir()
 {
+	m_Form = IIR_TDF2;
 	InitBR( 25000, 1000.0, 100000);
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+//	Replaces the filter with a single section
+/////////////////////////////////////////////////////////////////////////////////
+void CIir::InitSection(TYPEREAL B0, TYPEREAL B1, TYPEREAL B2, TYPEREAL A1, TYPEREAL A2)
+{
+	m_NumSections = 1;
+	m_Coef[0][0] = B0;
+	m_Coef[0][1] = B1;
+	m_Coef[0][2] = B2;
+	m_Coef[0][3] = A1;
+	m_Coef[0][4] = A2;
+	ResetState();
+}
+
+void CIir::ResetState()
+{
+	for(int s=0; s<IIR_MAX_SECTIONS; s++)
+		for(int i=0; i<4; i++)
+			m_State[s][i] = 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Appends the sections of Filter to the cascade
+/////////////////////////////////////////////////////////////////////////////////
+bool CIir::AppendFilter(const CIir& Filter)
+{
+	if(m_NumSections + Filter.m_NumSections > IIR_MAX_SECTIONS)
+		return false;
+	for(int s=0; s<Filter.m_NumSections; s++)
+		for(int i=0; i<5; i++)
+			m_Coef[m_NumSections + s][i] = Filter.m_Coef[s][i];
+	m_NumSections += Filter.m_NumSections;
+	ResetState();
+	return true;
+}
+
+void CIir::SetForm(enum IirForm Form)
+{
+	m_Form = Form;
+	ResetState();
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 //	Iniitalize IIR variables for Low Pass IIR filter.
 // analog prototype == H(s) = 1 / (s^2 + s/Q + 1)
@@ -89,16 +704,11 @@ void CIir::InitLP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
 	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
 	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
-	m_B0 = A*( (1.0 - MCOS(w0))/2.0);
-	m_B1 = A*( 1.0 - MCOS(w0));
-	m_B2 = A*( (1.0 - MCOS(w0))/2.0);
-	m_A1 = A*( -2.0*MCOS(w0));
-	m_A2 = A*( 1.0 - alpha);
-
-	m_w1a = 0.0;
-	m_w2a = 0.0;
-	m_w1b = 0.0;
-	m_w2b = 0.0;
+	InitSection( A*( (1.0 - MCOS(w0))/2.0),	//B0
+			A*( 1.0 - MCOS(w0)),	//B1
+			A*( (1.0 - MCOS(w0))/2.0),	//B2
+			A*( -2.0*MCOS(w0)),	//A1
+			A*( 1.0 - alpha));	//A2
 }
 
 
@@ -111,16 +721,11 @@ void CIir::InitHP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
 	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
 	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
-	m_B0 = A*( (1.0 + MCOS(w0))/2.0);
-	m_B1 = -A*( 1.0 + MCOS(w0));
-	m_B2 = A*( (1.0 + MCOS(w0))/2.0);
-	m_A1 = A*( -2.0*MCOS(w0));
-	m_A2 = A*( 1.0 - alpha);
-
-	m_w1a = 0.0;
-	m_w2a = 0.0;
-	m_w1b = 0.0;
-	m_w2b = 0.0;
+	InitSection( A*( (1.0 + MCOS(w0))/2.0),	//B0
+			-A*( 1.0 + MCOS(w0)),	//B1
+			A*( (1.0 + MCOS(w0))/2.0),	//B2
+			A*( -2.0*MCOS(w0)),	//A1
+			A*( 1.0 - alpha));	//A2
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -132,16 +737,11 @@ void CIir::InitBP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
 	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
 	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
-	m_B0 = A * alpha;
-	m_B1 = 0.0;
-	m_B2 = A * -alpha;
-	m_A1 = A*( -2.0*MCOS(w0));
-	m_A2 = A*( 1.0 - alpha);
-
-	m_w1a = 0.0;
-	m_w2a = 0.0;
-	m_w1b = 0.0;
-	m_w2b = 0.0;
+	InitSection( A * alpha,	//B0
+			0.0,	//B1
+			A * -alpha,	//B2
+			A*( -2.0*MCOS(w0)),	//A1
+			A*( 1.0 - alpha));	//A2
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -153,52 +753,42 @@ void CIir::InitBR( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
 	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
 	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
-	m_B0 = A*1.0;
-	m_B1 = A*( -2.0*MCOS(w0));
-	m_B2 = A*1.0;
-	m_A1 = A*( -2.0*MCOS(w0));
-	m_A2 = A*( 1.0 - alpha);
-
-	m_w1a = 0.0;
-	m_w2a = 0.0;
-	m_w1b = 0.0;
-	m_w2b = 0.0;
+	InitSection( A*1.0,	//B0
+			A*( -2.0*MCOS(w0)),	//B1
+			A*1.0,	//B2
+			A*( -2.0*MCOS(w0)),	//A1
+			A*( 1.0 - alpha));	//A2
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //	Process InLength InBuf[] samples and place in OutBuf[]
+// Each section filters the whole block in turn
 //REAL version
 /////////////////////////////////////////////////////////////////////////////////
 void CIir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
 {
-	for(int i=0; i<InLength; i++)
+	const tBiquadBlock pBlock = (IIR_TDF2 == m_Form) ? s_pBiquadTdf2 : s_pBiquadDf2;
+	const TYPEREAL* pIn = InBuf;
+	for(int s=0; s<m_NumSections; s++)
 	{
-		TYPEREAL w0 = InBuf[i] - m_A1*m_w1a - m_A2*m_w2a;
-		OutBuf[i] =m_B0*w0 + m_B1*m_w1a + m_B2*m_w2a;
-		m_w2a = m_w1a;
-		m_w1a = w0;
+		pBlock(InLength, 1, m_Coef[s], m_State[s], pIn, OutBuf);
+		pIn = OutBuf;
 	}
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //	Process InLength InBuf[] samples and place in OutBuf[]
-//Complex version
+//Complex version, re and im are filtered as two channels
 /////////////////////////////////////////////////////////////////////////////////
 void CIir::ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
 {
-	for(int i=0; i<InLength; i++)
+	const tBiquadBlock pBlock = (IIR_TDF2 == m_Form) ? s_pBiquadTdf2 : s_pBiquadDf2;
+	const TYPEREAL* pIn = (const TYPEREAL*)InBuf;
+	for(int s=0; s<m_NumSections; s++)
 	{
-		TYPEREAL w0a = InBuf[i].re - m_A1*m_w1a - m_A2*m_w2a;
-		OutBuf[i].re =m_B0*w0a + m_B1*m_w1a + m_B2*m_w2a;
-		m_w2a = m_w1a;
-		m_w1a = w0a;
-
-		TYPEREAL w0b = InBuf[i].im - m_A1*m_w1b - m_A2*m_w2b;
-		OutBuf[i].im =m_B0*w0b + m_B1*m_w1b + m_B2*m_w2b;
-		m_w2b = m_w1b;
-		m_w1b = w0b;
-
+		pBlock(InLength, 2, m_Coef[s], m_State[s], pIn, (TYPEREAL*)OutBuf);
+		pIn = (const TYPEREAL*)OutBuf;
 	}
 }
 
-
+} // namespace FMDSP_NAMESPACE
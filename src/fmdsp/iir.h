@@ -6,6 +6,7 @@
 // History:
 //	2011-02-05  Initial creation MSW
 //	2011-03-27  Initial release
+//	2026-10-16  Added transposed form and cascades
 //////////////////////////////////////////////////////////////////////
 //==========================================================================================
 // + + +   This Software is released under the "Simplified BSD License"  + + +
@@ -39,31 +40,59 @@
 #define IIR_H
 
 #include "datatypes.h"
+#include "dispatch.h"
 
+namespace FMDSP_NAMESPACE {
+
+#define IIR_MAX_SECTIONS 4		//longest cascade of biquad sections
+
+//structure the sections are implemented in
+enum IirForm
+{
+	IIR_DF2 = 0,		//direct form 2
+	IIR_TDF2			//transposed direct form 2, less round off noise with float samples
+};
+
+//binds the block kernels used by CIir::ProcessFilter()
+const char* BindBiquad(enum SimdLevel Level);
+
+//one pole low pass filter used for de-emphasis, pIn may be the same buffer as pOut
+//		State = (1 - Alpha)*State + Alpha*In
+//		Out = Gain*State
+void OnePoleLowPass(int Count, TYPEREAL Alpha, TYPEREAL Gain, TYPEREAL& State,
+	const TYPEREAL* pIn, TYPEREAL* pOut);
+const char* BindOnePole(enum SimdLevel Level);
 
 class CIir
 {
 public:
 	CIir();
 
+	//the Init functions replace the filter with a single section
 	void InitLP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate);	//create Low Pass
 	void InitHP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate);	//create High Pass
 	void InitBP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate);	//create Band Pass
 	void InitBR( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate);	//create Band Reject
+	//create a section from coefficients normalized to A0 = 1
+	//		y[n] = B0*x[n] + B1*x[n-1] + B2*x[n-2] - A1*y[n-1] - A2*y[n-2]
+	void InitSection(TYPEREAL B0, TYPEREAL B1, TYPEREAL B2, TYPEREAL A1, TYPEREAL A2);
+	//appends the sections of Filter to the cascade, returns false if the cascade
+	//would be longer than IIR_MAX_SECTIONS
+	bool AppendFilter(const CIir& Filter);
+	//selects the structure of the sections(IIR_TDF2 by default), clears the filter state
+	void SetForm(enum IirForm Form);
 	void ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf);
 	void ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
 
 private:
-	TYPEREAL m_A1;		//direct form 2 coefficients
-	TYPEREAL m_A2;
-	TYPEREAL m_B0;
-	TYPEREAL m_B1;
-	TYPEREAL m_B2;
+	void ResetState();
 
-	TYPEREAL m_w1a;		//biquad delay storage
-	TYPEREAL m_w2a;
-	TYPEREAL m_w1b;		//biquad delay storage
-	TYPEREAL m_w2b;
+	enum IirForm m_Form;
+	int m_NumSections;
+	TYPEREAL m_Coef[IIR_MAX_SECTIONS][5];	//B0, B1, B2, A1, A2 of each section
+	TYPEREAL m_State[IIR_MAX_SECTIONS][4];	//biquad delay storage, two values for each channel
 };
 
+} // namespace FMDSP_NAMESPACE
+
 #endif // IIR_H
@@ -0,0 +1,231 @@
+//////////////////////////////////////////////////////////////////////
+// iqconvert.cpp: implementation of the 8 bit I/Q sample conversion.
+//
+//  Converts the unsigned 8 bit interleaved I/Q samples produced by the
+//RTL-SDR device into the complex samples expected by the demodulator.
+//Each byte maps independently onto one TYPEREAL value so the complex
+//output can be treated as a flat array of 2*Length reals.
+//
+//SSE2, AVX2 and NEON implementations are provided along with a 256
+//entry lookup table fallback; all of them produce results identical
+//to evaluating (x - IQ8_OFFSET) * IQ8_SCALE per byte
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "iqconvert.h"
+#include "simd.h"
+
+namespace FMDSP_NAMESPACE {
+
+typedef void (*tConvertIQ8)(int Count, const quint8* pIn, TYPEREAL* pOut);
+
+//////////////////////////////////////////////////////////////////////
+// Lookup table fallback, also used for any trailing values the
+// vector implementations don't handle
+//////////////////////////////////////////////////////////////////////
+class CIQ8Table
+{
+public:
+	CIQ8Table()
+	{
+		for(int i=0; i<256; i++)
+			m_Table[i] = ((TYPEREAL)i - IQ8_OFFSET) * IQ8_SCALE;
+	}
+	TYPEREAL m_Table[256];
+};
+
+static const CIQ8Table& IQ8Table()
+{
+	static const CIQ8Table Table;
+	return Table;
+}
+
+static void ConvertIQ8Table(int Count, const quint8* pIn, TYPEREAL* pOut)
+{
+	const TYPEREAL* pTable = IQ8Table().m_Table;
+	for(int i=0; i<Count; i++)
+		pOut[i] = pTable[pIn[i]];
+}
+
+#ifdef FMDSP_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 implementation, 16 values per iteration
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_SSE2
+static void ConvertIQ8Sse2(int Count, const quint8* pIn, TYPEREAL* pOut)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	const __m128d offset = _mm_set1_pd(IQ8_OFFSET);
+	const __m128d scale = _mm_set1_pd(IQ8_SCALE);
+	for( ; i<=(Count-16); i+=16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(pIn + i));
+		__m128i words[2] = { _mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero) };
+		for(int w=0; w<2; w++)
+		{
+			__m128i dwords[2] = { _mm_unpacklo_epi16(words[w], zero), _mm_unpackhi_epi16(words[w], zero) };
+			for(int d=0; d<2; d++)
+			{
+				TYPEREAL* pDest = pOut + i + (w * 8) + (d * 4);
+				__m128d lo = _mm_cvtepi32_pd(dwords[d]);
+				__m128d hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(dwords[d], _MM_SHUFFLE(1, 0, 3, 2)));
+				_mm_storeu_pd(pDest, _mm_mul_pd(_mm_sub_pd(lo, offset), scale));
+				_mm_storeu_pd(pDest + 2, _mm_mul_pd(_mm_sub_pd(hi, offset), scale));
+			}
+		}
+	}
+#else
+	const __m128 offset = _mm_set1_ps(IQ8_OFFSET);
+	const __m128 scale = _mm_set1_ps(IQ8_SCALE);
+	for( ; i<=(Count-16); i+=16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(pIn + i));
+		__m128i words[2] = { _mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero) };
+		for(int w=0; w<2; w++)
+		{
+			__m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(words[w], zero));
+			__m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(words[w], zero));
+			_mm_storeu_ps(pOut + i + (w * 8), _mm_mul_ps(_mm_sub_ps(lo, offset), scale));
+			_mm_storeu_ps(pOut + i + (w * 8) + 4, _mm_mul_ps(_mm_sub_ps(hi, offset), scale));
+		}
+	}
+#endif
+	ConvertIQ8Table(Count - i, pIn + i, pOut + i);
+}
+
+//////////////////////////////////////////////////////////////////////
+// AVX2 implementation, 16 values per iteration
+//////////////////////////////////////////////////////////////////////
+FMDSP_TARGET_AVX2
+static void ConvertIQ8Avx2(int Count, const quint8* pIn, TYPEREAL* pOut)
+{
+	int i = 0;
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+	const __m256d offset = _mm256_set1_pd(IQ8_OFFSET);
+	const __m256d scale = _mm256_set1_pd(IQ8_SCALE);
+	for( ; i<=(Count-16); i+=16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(pIn + i));
+		__m256d v0 = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(bytes));
+		__m256d v1 = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_srli_si128(bytes, 4)));
+		__m256d v2 = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+		__m256d v3 = _mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_srli_si128(bytes, 12)));
+		_mm256_storeu_pd(pOut + i, _mm256_mul_pd(_mm256_sub_pd(v0, offset), scale));
+		_mm256_storeu_pd(pOut + i + 4, _mm256_mul_pd(_mm256_sub_pd(v1, offset), scale));
+		_mm256_storeu_pd(pOut + i + 8, _mm256_mul_pd(_mm256_sub_pd(v2, offset), scale));
+		_mm256_storeu_pd(pOut + i + 12, _mm256_mul_pd(_mm256_sub_pd(v3, offset), scale));
+	}
+#else
+	const __m256 offset = _mm256_set1_ps(IQ8_OFFSET);
+	const __m256 scale = _mm256_set1_ps(IQ8_SCALE);
+	for( ; i<=(Count-16); i+=16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(pIn + i));
+		__m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+		__m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+		_mm256_storeu_ps(pOut + i, _mm256_mul_ps(_mm256_sub_ps(lo, offset), scale));
+		_mm256_storeu_ps(pOut + i + 8, _mm256_mul_ps(_mm256_sub_ps(hi, offset), scale));
+	}
+#endif
+	_mm256_zeroupper();	//the tail is SSE code
+	ConvertIQ8Table(Count - i, pIn + i, pOut + i);
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+#if defined(FMDSP_USE_DOUBLE_PRECISION) && !defined(FMDSP_SIMD_NEON64)
+ #define IQ8_NO_NEON		//no double precision NEON on 32 bit ARM
+#else
+
+//////////////////////////////////////////////////////////////////////
+// NEON implementation, 16 values per iteration
+//////////////////////////////////////////////////////////////////////
+static void ConvertIQ8Neon(int Count, const quint8* pIn, TYPEREAL* pOut)
+{
+	int i = 0;
+#if !defined(FMDSP_USE_DOUBLE_PRECISION)
+	const float32x4_t offset = vdupq_n_f32(IQ8_OFFSET);
+	const float32x4_t scale = vdupq_n_f32(IQ8_SCALE);
+	for( ; i<=(Count-16); i+=16)
+	{
+		uint8x16_t bytes = vld1q_u8(pIn + i);
+		uint16x8_t words[2] = { vmovl_u8(vget_low_u8(bytes)), vmovl_u8(vget_high_u8(bytes)) };
+		for(int w=0; w<2; w++)
+		{
+			float32x4_t lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(words[w])));
+			float32x4_t hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(words[w])));
+			vst1q_f32(pOut + i + (w * 8), vmulq_f32(vsubq_f32(lo, offset), scale));
+			vst1q_f32(pOut + i + (w * 8) + 4, vmulq_f32(vsubq_f32(hi, offset), scale));
+		}
+	}
+#else
+	const float64x2_t offset = vdupq_n_f64(IQ8_OFFSET);
+	const float64x2_t scale = vdupq_n_f64(IQ8_SCALE);
+	for( ; i<=(Count-16); i+=16)
+	{
+		uint8x16_t bytes = vld1q_u8(pIn + i);
+		uint16x8_t words[2] = { vmovl_u8(vget_low_u8(bytes)), vmovl_u8(vget_high_u8(bytes)) };
+		for(int w=0; w<2; w++)
+		{
+			uint32x4_t dwords[2] = { vmovl_u16(vget_low_u16(words[w])), vmovl_u16(vget_high_u16(words[w])) };
+			for(int d=0; d<2; d++)
+			{
+				TYPEREAL* pDest = pOut + i + (w * 8) + (d * 4);
+				float64x2_t lo = vcvtq_f64_u64(vmovl_u32(vget_low_u32(dwords[d])));
+				float64x2_t hi = vcvtq_f64_u64(vmovl_u32(vget_high_u32(dwords[d])));
+				vst1q_f64(pDest, vmulq_f64(vsubq_f64(lo, offset), scale));
+				vst1q_f64(pDest + 2, vmulq_f64(vsubq_f64(hi, offset), scale));
+			}
+		}
+	}
+#endif
+	ConvertIQ8Table(Count - i, pIn + i, pOut + i);
+}
+
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tConvertIQ8 s_pConvertIQ8 = ConvertIQ8Table;
+
+//////////////////////////////////////////////////////////////////////
+// Binds the implementation for the instruction set, returns its name
+//////////////////////////////////////////////////////////////////////
+const char* BindConvertIQ8(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pConvertIQ8 = ConvertIQ8Avx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pConvertIQ8 = ConvertIQ8Sse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(IQ8_NO_NEON)
+	case SIMD_NEON:
+		s_pConvertIQ8 = ConvertIQ8Neon;
+		return "NEON";
+#endif
+	default:
+		s_pConvertIQ8 = ConvertIQ8Table;
+		return "lookup table";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Converts Length unsigned 8 bit I/Q sample pairs into complex samples
+//////////////////////////////////////////////////////////////////////
+void ConvertIQ8(int Length, const quint8* pInData, TYPECPX* pOutData)
+{
+	s_pConvertIQ8(Length * 2, pInData, (TYPEREAL*)pOutData);
+}
+
+} // namespace FMDSP_NAMESPACE
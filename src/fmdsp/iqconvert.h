@@ -0,0 +1,35 @@
+//////////////////////////////////////////////////////////////////////
+// iqconvert.h: interface for the 8 bit I/Q sample conversion.
+//
+//  Converts the unsigned 8 bit interleaved I/Q samples produced by the
+//RTL-SDR device into the complex samples expected by the demodulator
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef IQCONVERT_H
+#define IQCONVERT_H
+
+#include "datatypes.h"
+#include "dispatch.h"
+
+namespace FMDSP_NAMESPACE {
+
+//The demodulator expects the I/Q samples in the range of -32767.0 through +32767.0
+// (32767.0 / 127.5) = 256.9960784313725
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+ #define IQ8_OFFSET 127.5
+ #define IQ8_SCALE 256.9960784313725
+#else
+ #define IQ8_OFFSET 127.5f
+ #define IQ8_SCALE 256.9960784313725f
+#endif
+
+//Converts Length unsigned 8 bit I/Q sample pairs into complex samples using
+//the best SIMD implementation available on the running CPU
+void ConvertIQ8(int Length, const quint8* pInData, TYPECPX* pOutData);
+const char* BindConvertIQ8(enum SimdLevel Level);
+
+} // namespace FMDSP_NAMESPACE
+
+#endif // IQCONVERT_H
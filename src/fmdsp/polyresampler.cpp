@@ -0,0 +1,680 @@
+//////////////////////////////////////////////////////////////////////
+// polyresampler.cpp: implementation of the CPolyResampler class.
+//
+//  Output sample n is centered at input time n*M/L. Its integer part
+//selects the newest input sample used and its fractional part p/L selects
+//the phase, so no interpolation of the sinc table is needed. Only the
+//outputs that reach back into the previous block read from the history
+//buffer, the rest read the callers input directly.
+//
+//SSE2, AVX2 and NEON dot product kernels are provided along with a scalar
+//fallback. The phases are padded to a multiple of 8 taps so the kernels
+//have no trailing samples to handle.
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "polyresampler.h"
+#include "fir.h"
+#include "simd.h"
+
+#include <cstring>
+
+namespace FMDSP_NAMESPACE {
+
+//////////////////////////////////////////////////////////////////////
+// Local defines
+//////////////////////////////////////////////////////////////////////
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+#define POLY_SINC_PERIODS 28	//number of input sample periods in the sinc function, same as CFractResampler
+#else
+#define POLY_SINC_PERIODS 10
+#endif
+
+#define POLY_TAP_ALIGN 8		//phases are padded to a multiple of this many taps
+
+#define MAX_SOUNDCARDVAL 32767.0
+
+typedef TYPEREAL (*tPolyDot)(int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn);
+typedef TYPECPX (*tPolyDotCpx)(int NumTaps, const TYPEREAL* pCoef, const TYPECPX* pIn);
+
+//////////////////////////////////////////////////////////////////////
+// Scalar implementations
+//////////////////////////////////////////////////////////////////////
+static TYPEREAL PolyDotScalar(int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn)
+{
+	TYPEREAL acc = 0.0;
+	for(int k=0; k<NumTaps; k++)
+		acc += pCoef[k] * pIn[k];
+	return acc;
+}
+
+static TYPECPX PolyDotCpxScalar(int NumTaps, const TYPEREAL* pCoef, const TYPECPX* pIn)
+{
+	TYPECPX acc;
+	acc.re = 0.0; acc.im = 0.0;
+	for(int k=0; k<NumTaps; k++)
+	{
+		acc.re += pCoef[k] * pIn[k].re;
+		acc.im += pCoef[k] * pIn[k].im;
+	}
+	return acc;
+}
+
+#ifdef FMDSP_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////
+// SSE2 implementations, 8 taps per iteration
+//////////////////////////////////////////////////////////////////////
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+
+FMDSP_TARGET_SSE2
+static TYPEREAL PolyDotSse2(int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn)
+{
+	__m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+	for(int k=0; k<NumTaps; k+=8)
+	{
+		acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(pCoef + k), _mm_loadu_pd(pIn + k)));
+		acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(pCoef + k + 2), _mm_loadu_pd(pIn + k + 2)));
+		acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(pCoef + k + 4), _mm_loadu_pd(pIn + k + 4)));
+		acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_loadu_pd(pCoef + k + 6), _mm_loadu_pd(pIn + k + 6)));
+	}
+	__m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+	return _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+}
+
+FMDSP_TARGET_SSE2
+static TYPECPX PolyDotCpxSse2(int NumTaps, const TYPEREAL* pCoef, const TYPECPX* pIn)
+{
+	//one complex sample per vector, the coefficient is broadcast to both parts
+	const TYPEREAL* p = &pIn[0].re;
+	__m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+	for(int k=0; k<NumTaps; k+=4)
+	{
+		acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_set1_pd(pCoef[k]), _mm_loadu_pd(p + 2*k)));
+		acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_set1_pd(pCoef[k + 1]), _mm_loadu_pd(p + 2*k + 2)));
+		acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_set1_pd(pCoef[k + 2]), _mm_loadu_pd(p + 2*k + 4)));
+		acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_set1_pd(pCoef[k + 3]), _mm_loadu_pd(p + 2*k + 6)));
+	}
+	__m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+	TYPECPX out;
+	out.re = _mm_cvtsd_f64(acc);
+	out.im = _mm_cvtsd_f64(_mm_unpackhi_pd(acc, acc));
+	return out;
+}
+
+#else
+
+FMDSP_TARGET_SSE2
+static TYPEREAL PolyDotSse2(int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn)
+{
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+	for(int k=0; k<NumTaps; k+=8)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(pCoef + k), _mm_loadu_ps(pIn + k)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(pCoef + k + 4), _mm_loadu_ps(pIn + k + 4)));
+	}
+	__m128 acc = _mm_add_ps(acc0, acc1);
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(acc);
+}
+
+FMDSP_TARGET_SSE2
+static TYPECPX PolyDotCpxSse2(int NumTaps, const TYPEREAL* pCoef, const TYPECPX* pIn)
+{
+	//two complex samples per vector, each coefficient is duplicated for both parts
+	const TYPEREAL* p = &pIn[0].re;
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+	for(int k=0; k<NumTaps; k+=4)
+	{
+		__m128 coef = _mm_loadu_ps(pCoef + k);
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_unpacklo_ps(coef, coef), _mm_loadu_ps(p + 2*k)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_unpackhi_ps(coef, coef), _mm_loadu_ps(p + 2*k + 4)));
+	}
+	__m128 acc = _mm_add_ps(acc0, acc1);
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));		//re, im in the low two lanes
+	TYPECPX out;
+	out.re = _mm_cvtss_f32(acc);
+	out.im = _mm_cvtss_f32(_mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+	return out;
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// AVX2 implementations, 8 taps per iteration
+//////////////////////////////////////////////////////////////////////
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+
+FMDSP_TARGET_AVX2
+static TYPEREAL PolyDotAvx2(int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn)
+{
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	for(int k=0; k<NumTaps; k+=8)
+	{
+		acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_loadu_pd(pCoef + k), _mm256_loadu_pd(pIn + k)));
+		acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_loadu_pd(pCoef + k + 4), _mm256_loadu_pd(pIn + k + 4)));
+	}
+	__m256d acc256 = _mm256_add_pd(acc0, acc1);
+	__m128d acc = _mm_add_pd(_mm256_castpd256_pd128(acc256), _mm256_extractf128_pd(acc256, 1));
+	return _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+}
+
+FMDSP_TARGET_AVX2
+static TYPECPX PolyDotCpxAvx2(int NumTaps, const TYPEREAL* pCoef, const TYPECPX* pIn)
+{
+	//two complex samples per vector, each coefficient is duplicated for both parts
+	const TYPEREAL* p = &pIn[0].re;
+	__m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+	for(int k=0; k<NumTaps; k+=4)
+	{
+		__m256d coef0 = _mm256_permute4x64_pd(_mm256_castpd128_pd256(_mm_loadu_pd(pCoef + k)), 0x50);
+		__m256d coef1 = _mm256_permute4x64_pd(_mm256_castpd128_pd256(_mm_loadu_pd(pCoef + k + 2)), 0x50);
+		acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(coef0, _mm256_loadu_pd(p + 2*k)));
+		acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(coef1, _mm256_loadu_pd(p + 2*k + 4)));
+	}
+	__m256d acc256 = _mm256_add_pd(acc0, acc1);
+	__m128d acc = _mm_add_pd(_mm256_castpd256_pd128(acc256), _mm256_extractf128_pd(acc256, 1));
+	TYPECPX out;
+	out.re = _mm_cvtsd_f64(acc);
+	out.im = _mm_cvtsd_f64(_mm_unpackhi_pd(acc, acc));
+	return out;
+}
+
+#else
+
+FMDSP_TARGET_AVX2
+static TYPEREAL PolyDotAvx2(int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn)
+{
+	__m256 acc256 = _mm256_setzero_ps();
+	for(int k=0; k<NumTaps; k+=8)
+		acc256 = _mm256_add_ps(acc256, _mm256_mul_ps(_mm256_loadu_ps(pCoef + k), _mm256_loadu_ps(pIn + k)));
+	__m128 acc = _mm_add_ps(_mm256_castps256_ps128(acc256), _mm256_extractf128_ps(acc256, 1));
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(acc);
+}
+
+FMDSP_TARGET_AVX2
+static TYPECPX PolyDotCpxAvx2(int NumTaps, const TYPEREAL* pCoef, const TYPECPX* pIn)
+{
+	//four complex samples per vector, each coefficient is duplicated for both parts
+	const TYPEREAL* p = &pIn[0].re;
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	for(int k=0; k<NumTaps; k+=8)
+	{
+		__m128 coef = _mm_loadu_ps(pCoef + k);
+		__m256 coef0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(coef, coef)), _mm_unpackhi_ps(coef, coef), 1);
+		coef = _mm_loadu_ps(pCoef + k + 4);
+		__m256 coef1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(coef, coef)), _mm_unpackhi_ps(coef, coef), 1);
+		acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(coef0, _mm256_loadu_ps(p + 2*k)));
+		acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(coef1, _mm256_loadu_ps(p + 2*k + 8)));
+	}
+	__m256 acc256 = _mm256_add_ps(acc0, acc1);
+	__m128 acc = _mm_add_ps(_mm256_castps256_ps128(acc256), _mm256_extractf128_ps(acc256, 1));
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));		//re, im in the low two lanes
+	TYPECPX out;
+	out.re = _mm_cvtss_f32(acc);
+	out.im = _mm_cvtss_f32(_mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+	return out;
+}
+
+#endif
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+//////////////////////////////////////////////////////////////////////
+// NEON implementations, 8 taps per iteration. The complex samples are
+// split into their I and Q parts as they are loaded
+//////////////////////////////////////////////////////////////////////
+#if !defined(FMDSP_USE_DOUBLE_PRECISION)
+
+static TYPEREAL PolyDotNeon(int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn)
+{
+	float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+	for(int k=0; k<NumTaps; k+=8)
+	{
+		acc0 = vmlaq_f32(acc0, vld1q_f32(pCoef + k), vld1q_f32(pIn + k));
+		acc1 = vmlaq_f32(acc1, vld1q_f32(pCoef + k + 4), vld1q_f32(pIn + k + 4));
+	}
+	float32x4_t acc = vaddq_f32(acc0, acc1);
+	float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+	return vget_lane_f32(vpadd_f32(sum, sum), 0);
+}
+
+static TYPECPX PolyDotCpxNeon(int NumTaps, const TYPEREAL* pCoef, const TYPECPX* pIn)
+{
+	const TYPEREAL* p = &pIn[0].re;
+	float32x4_t accre = vdupq_n_f32(0.0f), accim = vdupq_n_f32(0.0f);
+	for(int k=0; k<NumTaps; k+=4)
+	{
+		float32x4_t coef = vld1q_f32(pCoef + k);
+		float32x4x2_t in = vld2q_f32(p + 2*k);
+		accre = vmlaq_f32(accre, coef, in.val[0]);
+		accim = vmlaq_f32(accim, coef, in.val[1]);
+	}
+	float32x2_t sum = vpadd_f32(vadd_f32(vget_low_f32(accre), vget_high_f32(accre)),
+		vadd_f32(vget_low_f32(accim), vget_high_f32(accim)));
+	TYPECPX out;
+	out.re = vget_lane_f32(sum, 0);
+	out.im = vget_lane_f32(sum, 1);
+	return out;
+}
+
+#elif defined(FMDSP_SIMD_NEON64)
+
+static TYPEREAL PolyDotNeon(int NumTaps, const TYPEREAL* pCoef, const TYPEREAL* pIn)
+{
+	float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0), acc2 = vdupq_n_f64(0.0), acc3 = vdupq_n_f64(0.0);
+	for(int k=0; k<NumTaps; k+=8)
+	{
+		acc0 = vmlaq_f64(acc0, vld1q_f64(pCoef + k), vld1q_f64(pIn + k));
+		acc1 = vmlaq_f64(acc1, vld1q_f64(pCoef + k + 2), vld1q_f64(pIn + k + 2));
+		acc2 = vmlaq_f64(acc2, vld1q_f64(pCoef + k + 4), vld1q_f64(pIn + k + 4));
+		acc3 = vmlaq_f64(acc3, vld1q_f64(pCoef + k + 6), vld1q_f64(pIn + k + 6));
+	}
+	return vaddvq_f64(vaddq_f64(vaddq_f64(acc0, acc1), vaddq_f64(acc2, acc3)));
+}
+
+static TYPECPX PolyDotCpxNeon(int NumTaps, const TYPEREAL* pCoef, const TYPECPX* pIn)
+{
+	const TYPEREAL* p = &pIn[0].re;
+	float64x2_t accre = vdupq_n_f64(0.0), accim = vdupq_n_f64(0.0);
+	for(int k=0; k<NumTaps; k+=2)
+	{
+		float64x2_t coef = vld1q_f64(pCoef + k);
+		float64x2x2_t in = vld2q_f64(p + 2*k);
+		accre = vmlaq_f64(accre, coef, in.val[0]);
+		accim = vmlaq_f64(accim, coef, in.val[1]);
+	}
+	TYPECPX out;
+	out.re = vaddvq_f64(accre);
+	out.im = vaddvq_f64(accim);
+	return out;
+}
+
+#else
+ #define POLY_NO_NEON		//no double precision NEON on 32 bit ARM
+#endif
+
+#endif // FMDSP_SIMD_NEON
+
+static tPolyDot s_pPolyDot = PolyDotScalar;
+static tPolyDotCpx s_pPolyDotCpx = PolyDotCpxScalar;
+
+//////////////////////////////////////////////////////////////////////
+// Bind the implementations for the instruction set, return their names
+//////////////////////////////////////////////////////////////////////
+const char* BindPolyDot(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pPolyDot = PolyDotAvx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pPolyDot = PolyDotSse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(POLY_NO_NEON)
+	case SIMD_NEON:
+		s_pPolyDot = PolyDotNeon;
+		return "NEON";
+#endif
+	default:
+		s_pPolyDot = PolyDotScalar;
+		return "scalar";
+	}
+}
+
+const char* BindPolyDotCpx(enum SimdLevel Level)
+{
+	switch(Level)
+	{
+#ifdef FMDSP_SIMD_X86
+	case SIMD_AVX2:
+		s_pPolyDotCpx = PolyDotCpxAvx2;
+		return "AVX2";
+	case SIMD_SSE2:
+		s_pPolyDotCpx = PolyDotCpxSse2;
+		return "SSE2";
+#endif
+#if defined(FMDSP_SIMD_NEON) && !defined(POLY_NO_NEON)
+	case SIMD_NEON:
+		s_pPolyDotCpx = PolyDotCpxNeon;
+		return "NEON";
+#endif
+	default:
+		s_pPolyDotCpx = PolyDotCpxScalar;
+		return "scalar";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////
+CPolyResampler::CPolyResampler()
+{
+	m_Interpolation = 1;
+	m_Decimation = 1;
+	m_NumTaps = 0;
+	m_Index = 0;
+	m_Phase = 0;
+	m_pBank = NULL;
+	m_pMonoHistory = NULL;
+	m_pHistory = NULL;
+}
+
+CPolyResampler::~CPolyResampler()
+{
+	DeleteBuffers();
+}
+
+void CPolyResampler::DeleteBuffers()
+{
+	if(m_pBank)
+		delete[] m_pBank;
+	if(m_pMonoHistory)
+		delete[] m_pMonoHistory;
+	if(m_pHistory)
+		delete[] m_pHistory;
+	m_pBank = NULL;
+	m_pMonoHistory = NULL;
+	m_pHistory = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Reduce the rate ratio to L/M, returns false if the rates are not whole
+// numbers or L is too large
+//////////////////////////////////////////////////////////////////////
+bool CPolyResampler::SetRatio(TYPEREAL InRate, TYPEREAL OutRate)
+{
+	DeleteBuffers();
+	int inrate = (int)(InRate + 0.5);
+	int outrate = (int)(OutRate + 0.5);
+	if( (inrate <= 0) || (outrate <= 0) || (MFABS(InRate - inrate) > 0.001) || (MFABS(OutRate - outrate) > 0.001) )
+		return false;
+	int a = inrate;
+	int b = outrate;
+	while(b != 0)
+	{	//greatest common divisor
+		int t = a % b;
+		a = b;
+		b = t;
+	}
+	m_Interpolation = outrate / a;
+	m_Decimation = inrate / a;
+	return (m_Interpolation <= POLY_MAX_PHASES);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Allocate a zeroed phase bank for a filter Length input samples long
+// and the history buffers. Returns the number of leading zero taps each
+// phase is padded with
+//////////////////////////////////////////////////////////////////////
+int CPolyResampler::AllocateBuffers(int Length)
+{
+int i;
+	m_NumTaps = ((Length + POLY_TAP_ALIGN - 1) / POLY_TAP_ALIGN) * POLY_TAP_ALIGN;
+	m_pBank = new TYPEREAL[m_Interpolation * m_NumTaps];
+	for(i=0; i<m_Interpolation * m_NumTaps; i++)
+		m_pBank[i] = 0.0;
+
+	//the history holds the last m_NumTaps-1 input samples followed by as many
+	// samples from the start of the block being processed
+	int hist = m_NumTaps - 1;
+	m_pMonoHistory = new TYPEREAL[2*hist];
+	m_pHistory = new TYPECPX[2*hist];
+	for(i=0; i<2*hist; i++)
+	{
+		m_pMonoHistory[i] = 0.0;
+		m_pHistory[i].re = 0.0;
+		m_pHistory[i].im = 0.0;
+	}
+	m_Index = 0;
+	m_Phase = 0;
+	return m_NumTaps - Length;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Create the windowed sinc phase bank
+//////////////////////////////////////////////////////////////////////
+bool CPolyResampler::Init(TYPEREAL InRate, TYPEREAL OutRate)
+{
+	if(!SetRatio(InRate, OutRate))
+		return false;
+	if( (1 == m_Interpolation) && (1 == m_Decimation) )
+	{	//passthrough
+		m_NumTaps = 0;
+		return true;
+	}
+	int pad = AllocateBuffers(POLY_SINC_PERIODS);
+	for(int p=0; p<m_Interpolation; p++)
+	{
+		TYPEREAL frac = (TYPEREAL)p / (TYPEREAL)m_Interpolation;
+		TYPEREAL* pCoef = m_pBank + p*m_NumTaps + pad;
+		for(int i=1; i<=POLY_SINC_PERIODS; i++)
+		{	//tap i is applied to the input sample POLY_SINC_PERIODS-i before the newest one,
+			// x is the position of the output in the sinc function measured from tap i
+			TYPEREAL x = (TYPEREAL)i - frac;
+			TYPEREAL w = x / (TYPEREAL)POLY_SINC_PERIODS;
+			//calc Blackman-Harris window point
+			TYPEREAL window = (0.35875
+					- 0.48829*MCOS( K_2PI*w )
+					+ 0.14128*MCOS( 2.0*K_2PI*w )
+					- 0.01168*MCOS( 3.0*K_2PI*w ) );
+			//calculate sin(x)/x    sinc point * window
+			TYPEREAL fi = K_PI*(x - (TYPEREAL)(POLY_SINC_PERIODS/2));
+			if(MFABS(fi) > 1e-6)
+				pCoef[i - 1] = window * MSIN(fi)/fi;
+			else
+				pCoef[i - 1] = 1.0;
+		}
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Create a Kaiser windowed low pass phase bank, the filter length is
+// estimated from the specs the same way CFir::InitLPFilter() does
+//////////////////////////////////////////////////////////////////////
+bool CPolyResampler::InitLowPass(TYPEREAL InRate, TYPEREAL OutRate, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop)
+{
+TYPEREAL Beta;
+	if(!SetRatio(InRate, OutRate))
+		return false;
+	TYPEREAL normFpass = Fpass/InRate;
+	TYPEREAL normFstop = Fstop/InRate;
+	TYPEREAL normFcut = (normFstop + normFpass)/2.0;	//low pass filter 6dB cutoff
+
+	//calculate Kaiser-Bessel window shape factor, Beta, from stopband attenuation
+	if(Astop < 20.96)
+		Beta = 0;
+	else if(Astop >= 50.0)
+		Beta = .1102 * (Astop - 8.71);
+	else
+		Beta = .5842 * MPOW( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
+
+	//the filter is Length input samples long, even so the delay is a whole number of samples
+	int Length = static_cast<int>((Astop - 8.0) / (2.285*K_2PI*(normFstop - normFpass) ) + 1);
+	Length += (Length & 1);
+	TYPEREAL fCenter = .5*(TYPEREAL)Length;
+	TYPEREAL izb = CFir::Izero(Beta);		//precalculate denominator since is same for all points
+
+	int pad = AllocateBuffers(Length);
+	for(int p=0; p<m_Interpolation; p++)
+	{
+		TYPEREAL frac = (TYPEREAL)p / (TYPEREAL)m_Interpolation;
+		TYPEREAL* pCoef = m_pBank + p*m_NumTaps + pad;
+		for(int i=1; i<=Length; i++)
+		{	//x is the position of tap i relative to the center of the filter
+			TYPEREAL x = (TYPEREAL)i - frac - fCenter;
+			TYPEREAL c;
+			// create ideal Sinc() LP filter with normFcut
+			if( MFABS(x) < 1e-6 )
+				c = 2.0 * normFcut;
+			else
+				c = MSIN(K_2PI*x*normFcut)/(K_PI*x);
+			//calculate Kaiser window and multiply to get coefficient
+			TYPEREAL t = x / fCenter;
+			pCoef[i - 1] = c * CFir::Izero( Beta * MSQRT(1 - (t*t) ) )  / izb;
+		}
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Returns the largest number of output samples InLength input samples
+// can produce
+//////////////////////////////////////////////////////////////////////
+int CPolyResampler::GetMaxOutputLength(int InLength)
+{
+	return (int)(((long long)InLength * m_Interpolation) / m_Decimation) + 1;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Returns the phase bank along with its dimensions
+//////////////////////////////////////////////////////////////////////
+const TYPEREAL* CPolyResampler::GetPhaseBank(int& Interpolation, int& Decimation, int& NumTaps) const
+{
+	Interpolation = m_Interpolation;
+	Decimation = m_Decimation;
+	NumTaps = m_NumTaps;
+	return m_pBank;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Resample InLength samples in pInBuf and place into pOutBuf
+//   !!!! Make sure pOutBuf from caller can hold GetMaxOutputLength(InLength)
+//  samples  !!!!!
+// short Integer version
+//////////////////////////////////////////////////////////////////////
+int CPolyResampler::Resample( int InLength, const TYPEREAL* pInBuf, TYPEMONO16* pOutBuf, TYPEREAL gain)
+{
+	const tPolyDot pDot = s_pPolyDot;
+	if(0 == m_NumTaps)
+	{	//passthrough, scale and convert only
+		for(int i=0; i<InLength; i++)
+		{
+			TYPEREAL tmp = pInBuf[i] * gain;
+			if(tmp > MAX_SOUNDCARDVAL)
+				tmp = MAX_SOUNDCARDVAL;
+			if(tmp < -MAX_SOUNDCARDVAL)
+				tmp = -MAX_SOUNDCARDVAL;
+			pOutBuf[i] = (TYPEMONO16)tmp;
+		}
+		return InLength;
+	}
+	int const hist = m_NumTaps - 1;
+	int const head = (InLength < hist) ? InLength : hist;
+	int const step = m_Decimation / m_Interpolation;
+	int const phasestep = m_Decimation % m_Interpolation;
+	int outsamples = 0;
+
+	memcpy(m_pMonoHistory + hist, pInBuf, head * sizeof(TYPEREAL));
+	while(m_Index < InLength)
+	{	//the taps end at input sample m_Index, the first outputs of the block reach
+		// back into the previous block and are read from the history
+		const TYPEREAL* pIn = (m_Index < hist) ? (m_pMonoHistory + m_Index) : (pInBuf + m_Index - hist);
+		TYPEREAL tmp = pDot(m_NumTaps, m_pBank + m_Phase*m_NumTaps, pIn) * gain;
+		if(tmp > MAX_SOUNDCARDVAL)
+			tmp = MAX_SOUNDCARDVAL;
+		if(tmp < -MAX_SOUNDCARDVAL)
+			tmp = -MAX_SOUNDCARDVAL;
+		pOutBuf[outsamples++] = (TYPEMONO16)tmp;
+
+		m_Index += step;
+		m_Phase += phasestep;
+		if(m_Phase >= m_Interpolation)
+		{
+			m_Phase -= m_Interpolation;
+			m_Index++;
+		}
+	}
+	m_Index -= InLength;	//move position back for next call
+
+	//keep the last hist input samples for the next block
+	if(InLength >= hist)
+		memcpy(m_pMonoHistory, pInBuf + InLength - hist, hist * sizeof(TYPEREAL));
+	else
+		memmove(m_pMonoHistory, m_pMonoHistory + InLength, hist * sizeof(TYPEREAL));
+	return outsamples;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Resample InLength samples in pInBuf and place into pOutBuf
+//   !!!! Make sure pOutBuf from caller can hold GetMaxOutputLength(InLength)
+//  samples  !!!!!
+// stereo Integer version
+//////////////////////////////////////////////////////////////////////
+int CPolyResampler::Resample( int InLength, const TYPECPX* pInBuf, TYPESTEREO16* pOutBuf, TYPEREAL gain)
+{
+	const tPolyDotCpx pDot = s_pPolyDotCpx;
+	if(0 == m_NumTaps)
+	{	//passthrough, scale and convert only
+		for(int i=0; i<InLength; i++)
+		{
+			TYPECPX tmp;
+			tmp.re = pInBuf[i].re * gain;
+			tmp.im = pInBuf[i].im * gain;
+			if(tmp.re > MAX_SOUNDCARDVAL)
+				tmp.re = MAX_SOUNDCARDVAL;
+			if(tmp.re < -MAX_SOUNDCARDVAL)
+				tmp.re = -MAX_SOUNDCARDVAL;
+			if(tmp.im > MAX_SOUNDCARDVAL)
+				tmp.im = MAX_SOUNDCARDVAL;
+			if(tmp.im < -MAX_SOUNDCARDVAL)
+				tmp.im = -MAX_SOUNDCARDVAL;
+			pOutBuf[i].re = (qint16)tmp.re;
+			pOutBuf[i].im = (qint16)tmp.im;
+		}
+		return InLength;
+	}
+	int const hist = m_NumTaps - 1;
+	int const head = (InLength < hist) ? InLength : hist;
+	int const step = m_Decimation / m_Interpolation;
+	int const phasestep = m_Decimation % m_Interpolation;
+	int outsamples = 0;
+
+	memcpy(m_pHistory + hist, pInBuf, head * sizeof(TYPECPX));
+	while(m_Index < InLength)
+	{	//the taps end at input sample m_Index, the first outputs of the block reach
+		// back into the previous block and are read from the history
+		const TYPECPX* pIn = (m_Index < hist) ? (m_pHistory + m_Index) : (pInBuf + m_Index - hist);
+		TYPECPX tmp = pDot(m_NumTaps, m_pBank + m_Phase*m_NumTaps, pIn);
+		tmp.re *= gain;
+		tmp.im *= gain;
+		if(tmp.re > MAX_SOUNDCARDVAL)
+			tmp.re = MAX_SOUNDCARDVAL;
+		if(tmp.re < -MAX_SOUNDCARDVAL)
+			tmp.re = -MAX_SOUNDCARDVAL;
+		if(tmp.im > MAX_SOUNDCARDVAL)
+			tmp.im = MAX_SOUNDCARDVAL;
+		if(tmp.im < -MAX_SOUNDCARDVAL)
+			tmp.im = -MAX_SOUNDCARDVAL;
+		pOutBuf[outsamples].re = (qint16)tmp.re;
+		pOutBuf[outsamples++].im = (qint16)tmp.im;
+
+		m_Index += step;
+		m_Phase += phasestep;
+		if(m_Phase >= m_Interpolation)
+		{
+			m_Phase -= m_Interpolation;
+			m_Index++;
+		}
+	}
+	m_Index -= InLength;	//move position back for next call
+
+	//keep the last hist input samples for the next block
+	if(InLength >= hist)
+		memcpy(m_pHistory, pInBuf + InLength - hist, hist * sizeof(TYPECPX));
+	else
+		memmove(m_pHistory, m_pHistory + InLength, hist * sizeof(TYPECPX));
+	return outsamples;
+}
+
+} // namespace FMDSP_NAMESPACE
@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////
+// polyresampler.h: interface for the CPolyResampler class.
+//
+//  This class implements a rational polyphase resampler for converting
+//between two fixed sample rates. The ratio is reduced to OutRate/InRate
+//= L/M and a bank of L windowed sinc phases is calculated once, so each
+//output sample is a single dot product of one phase with the input.
+//The windowed sinc is the same one CFractResampler uses, which remains
+//the fallback for rates that don't reduce to a small enough L. The bank
+//can also be designed as a low pass filter narrower than the input rate
+//so a separate audio filter pass isn't needed.
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef POLYRESAMPLER_H
+#define POLYRESAMPLER_H
+
+#include "datatypes.h"
+#include "dispatch.h"
+
+namespace FMDSP_NAMESPACE {
+
+#define POLY_MAX_PHASES 1024	//largest interpolation factor L a phase bank is created for
+
+//bind the dot product kernels of the mono and stereo Resample() functions
+const char* BindPolyDot(enum SimdLevel Level);
+const char* BindPolyDotCpx(enum SimdLevel Level);
+
+class CPolyResampler
+{
+public:
+	CPolyResampler();
+	virtual ~CPolyResampler();
+
+	//creates the phase bank for converting InRate to OutRate, returns false if
+	//the rates are not whole numbers or the ratio needs more than POLY_MAX_PHASES phases.
+	//When the rates are equal there is no bank and the samples are only scaled and converted
+	bool Init(TYPEREAL InRate, TYPEREAL OutRate);
+	//same as Init() but the phase bank is a Kaiser low pass filter with Astop dB
+	//attenuation above Fstop, so the resampler also does the callers audio filtering
+	bool InitLowPass(TYPEREAL InRate, TYPEREAL OutRate, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop);
+	//largest number of output samples produced from InLength input samples
+	int GetMaxOutputLength(int InLength);
+	//overloaded functions for processing different data types
+	int Resample( int InLength, const TYPEREAL* pInBuf, TYPEMONO16* pOutBuf, TYPEREAL gain);
+	int Resample( int InLength, const TYPECPX* pInBuf, TYPESTEREO16* pOutBuf, TYPEREAL gain);
+	//phase bank for other resamplers (CFixedResampler) to derive their coefficients from,
+	//NULL if there is no bank. Phase p starts at index p*NumTaps
+	const TYPEREAL* GetPhaseBank(int& Interpolation, int& Decimation, int& NumTaps) const;
+
+private:
+	bool SetRatio(TYPEREAL InRate, TYPEREAL OutRate);
+	int AllocateBuffers(int Length);
+	void DeleteBuffers();
+
+	int m_Interpolation;	//L, number of phases in the bank
+	int m_Decimation;		//M, input samples consumed per L output samples
+	int m_NumTaps;			//taps per phase, padded with leading zeros for the vector kernels
+	int m_Index;			//input sample index of the next output relative to the next input block
+	int m_Phase;			//phase of the next output
+	TYPEREAL* m_pBank;		//m_Interpolation phases of m_NumTaps coefficients
+	TYPEREAL* m_pMonoHistory;	//last m_NumTaps-1 input samples followed by the start of the input block
+	TYPECPX* m_pHistory;
+};
+
+} // namespace FMDSP_NAMESPACE
+
+#endif // POLYRESAMPLER_H
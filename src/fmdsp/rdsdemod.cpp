@@ -0,0 +1,442 @@
+//////////////////////////////////////////////////////////////////////
+// rdsdemod.cpp: implementation of the CRdsDemod class.
+//
+//  This class recovers the RDS data groups from the complex composite
+//baseband signal of the wideband FM demodulator. The RDS chain was
+//split out of CWFmDemod so it can run on its own thread.
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#include "rdsdemod.h"
+
+namespace FMDSP_NAMESPACE {
+
+//bunch of RDS constants
+#define USE_FEC 1	//set to zero to disable FEC correction
+
+#define RDSPLL_RANGE 12.0	//maximum deviation limit of PLL
+#define RDSPLL_BW 1.0	//natural frequency ~loop bandwidth
+#define RDSPLL_ZETA .707	//PLL Loop damping factor
+
+//RDS decoder states
+#define STATE_BITSYNC 0		//looking for initial bit position in Block 1
+#define STATE_BLOCKSYNC 1	//looking for initial correct block order
+#define STATE_GROUPDECODE 2	//decode groups after achieving bit  and block sync
+#define STATE_GROUPRESYNC 3	//waiting for beginning of new group after getting a block error
+
+#define BLOCK_ERROR_LIMIT 5		//number of bad blocks before trying to resync at the bit level
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Construct RDS demod object
+/////////////////////////////////////////////////////////////////////////////////
+CRdsDemod::CRdsDemod()
+{
+	m_InBitStream = 0;
+	m_BlockErrors = 0;
+	SetSampleRate(250000.0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Sets up the RDS chain for the composite signal sample rate
+// returns the sample rate of the RDS baseband signal
+/////////////////////////////////////////////////////////////////////////////////
+TYPEREAL CRdsDemod::SetSampleRate(TYPEREAL SampleRate)
+{
+	m_RdsOutputRate = m_RdsDownConvert.SetDataRate(SampleRate, 8000.0);
+	m_RdsDownConvert.SetFrequency(-RDS_FREQUENCY);	//set up to shift 57KHz RDS down to baseband and decimate
+
+	InitRds(m_RdsOutputRate);
+	return m_RdsOutputRate;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Process the complex composite signal from the FM demodulator
+// Shift the 57KHz RDS signal to baseband and decimate its sample rate down.
+// PLL the DSB RDS signal and recover the RDS DSB signal.
+// Run the RDS signal through a matched filter to recover the  biphase data.
+// Use a IIR resonator to recover the bit clock and sample the RDS data.
+// Call the RDS decoder routine with each new bit to recover the RDS data groups.
+//
+//		InLength == number of complex composite samples in pInData
+//		pInData == pointer to the complex composite signal
+/////////////////////////////////////////////////////////////////////////////////
+void CRdsDemod::ProcessData(int InLength, const TYPECPX* pInData)
+{
+	//translate 57KHz RDS signal to baseband and decimate RDS complex signal
+	int length = m_RdsDownConvert.ProcessData(InLength, pInData, m_RdsRaw);
+
+	//filter baseband RDS signal
+	m_RdsBPFilter.ProcessFilter(length, m_RdsRaw, m_RdsRaw);
+
+	//PLL to remove any rotation since may not be phase locked to 19KHz Pilot or may not even have pilot
+	ProcessRdsPll(length, m_RdsRaw, m_RdsMag);
+
+	//run matched filter correlator to extract the bi-phase data bits
+	m_RdsMatchedFilter.ProcessFilter(length,m_RdsMag,m_RdsData);
+	//create bit sync signal in m_RdsMag[] by squaring data
+	for(int i=0; i<length; i++)
+		m_RdsMag[i] = m_RdsData[i]* m_RdsData[i];	//has high energy at the bit clock rate and 2x bit rate
+
+	//run Hi-Q resonator filter that create a sin wave that will lock to BitRate clock and not 2X rate
+	m_RdsBitSyncFilter.ProcessFilter(length, m_RdsMag, m_RdsMag);
+	//now loop through samples to determine where bit position is and extract binary digital data
+	for(int i=0; i<length; i++)
+	{
+		TYPEREAL Data = m_RdsData[i];
+		TYPEREAL SyncVal = m_RdsMag[i];
+		//the best bit sync position is at the positive peak of the sync sine wave
+		TYPEREAL Slope = SyncVal - m_RdsLastSync;	//current slope
+		m_RdsLastSync = SyncVal;
+		//see if at the top of the sine wave
+		if( (Slope<0.0) && (m_RdsLastSyncSlope*Slope)<0.0 )
+		{	//are at sample time so read previous bit time since we are one sample behind in sync position
+			int bit;
+			if(m_RdsLastData>=0)
+			{
+				bit = 1;
+				m_RdsRaw[i].re = m_RdsLastData;
+			}
+			else
+			{
+				bit = 0;
+				m_RdsRaw[i].re = m_RdsLastData;
+			}
+			//need to XOR with previous bit to get actual data bit value
+			ProcessNewRdsBit(bit^m_RdsLastBit);		//go process new RDS Bit
+			m_RdsLastBit = bit;
+		}
+		else
+		{
+			m_RdsRaw[i].re = 0;
+		}
+
+		m_RdsLastData = Data;		//keep last bit since is differential data
+		m_RdsLastSyncSlope = Slope;
+		m_RdsRaw[i].im = Data;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Initialize variables for RDS PLL and matched filter
+/////////////////////////////////////////////////////////////////////////////////
+void CRdsDemod::InitRds( TYPEREAL SampleRate )
+{
+	m_RdsNcoPhase = 0.0;
+	m_RdsNcoFreq = 0.0;	//freq offset to bring to baseband
+
+	//Create complex LP filter of RDS signal with 2400Hz passband
+	m_RdsBPFilter.InitLPFilter(0, 1.0,40.0, 2400.0,1.3*2400.0, m_RdsOutputRate);
+
+	TYPEREAL norm = K_2PI/SampleRate;	//to normalize Hz to radians
+	//initialize the PLL that is used to de-rotate the rds DSB signal
+	m_RdsNcoLLimit = (m_RdsNcoFreq-RDSPLL_RANGE) * norm;		//clamp RDS PLL NCO
+	m_RdsNcoHLimit = (m_RdsNcoFreq+RDSPLL_RANGE) * norm;
+	m_RdsPllAlpha = 2.0*RDSPLL_ZETA*RDSPLL_BW * norm;
+	m_RdsPllBeta = (m_RdsPllAlpha * m_RdsPllAlpha)/(4.0*RDSPLL_ZETA*RDSPLL_ZETA);
+	//create matched filter to extract bi-phase bits
+	// This is basically the time domain shape of a single bi-phase bit
+	// as defined for RDS and is close to a single cycle sine wave in shape
+	m_MatchCoefLength = static_cast<int>(SampleRate / RDS_BITRATE);
+	for(int i= 0; i<=m_MatchCoefLength; i++)
+	{
+		TYPEREAL t = (TYPEREAL)i/(SampleRate);
+		TYPEREAL x = t*RDS_BITRATE;
+		TYPEREAL x64 = 64.0*x;
+		m_RdsMatchCoef[i+m_MatchCoefLength] = .75*MCOS(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
+								(1.0/(9.0/x-x64)) );
+		m_RdsMatchCoef[m_MatchCoefLength-i] = -.75*MCOS(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
+								(1.0/(9.0/x-x64)) );
+	}
+	m_MatchCoefLength *= 2;
+	//load the matched filter coef into FIR filter
+	m_RdsMatchedFilter.InitConstFir(m_MatchCoefLength, m_RdsMatchCoef, SampleRate);
+	//create Hi-Q resonator at the bit rate to recover bit sync position Q==500
+	m_RdsBitSyncFilter.InitBP(RDS_BITRATE, 500, SampleRate);
+	//initialize a bunch of variables pertaining to the rds decoder
+	m_RdsLastSync = 0.0;
+	m_RdsLastSyncSlope = 0.0;
+	m_RdsQHead = 0;
+	m_RdsQTail = 0;
+	m_RdsLastBit = 0;
+	m_CurrentBitPosition = 0;
+	m_CurrentBlock = BLOCK_A;
+	m_DecodeState = STATE_BITSYNC;
+	m_BGroupOffset = 0;
+	m_LastRdsGroup.BlockA = 0;
+	m_LastRdsGroup.BlockB = 0;
+	m_LastRdsGroup.BlockC = 0;
+	m_LastRdsGroup.BlockD = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Process I/Q RDS baseband stream to lock PLL
+/////////////////////////////////////////////////////////////////////////////////
+void CRdsDemod::ProcessRdsPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData )
+{
+TYPEREAL Sin;
+TYPEREAL Cos;
+TYPECPX tmp;
+	for(int i=0; i<InLength; i++)
+	{
+		Sin = MSIN(m_RdsNcoPhase);		//178ns for sin/cos calc
+		Cos = MCOS(m_RdsNcoPhase);
+		//complex multiply input sample by NCO's  sin and cos
+		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
+		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
+		//find current sample phase after being shifted by NCO frequency
+		TYPEREAL phzerror = -arctan2(tmp.im, tmp.re);
+		//create new NCO frequency term
+		m_RdsNcoFreq += (m_RdsPllBeta * phzerror);		//  radians per sampletime
+		//clamp NCO frequency so doesn't get out of lock range
+		if(m_RdsNcoFreq > m_RdsNcoHLimit)
+			m_RdsNcoFreq = m_RdsNcoHLimit;
+		else if(m_RdsNcoFreq < m_RdsNcoLLimit)
+			m_RdsNcoFreq = m_RdsNcoLLimit;
+		//update NCO phase with new value
+		m_RdsNcoPhase += (m_RdsNcoFreq + m_RdsPllAlpha * phzerror);
+		pOutData[i] = tmp.im;
+	}
+	m_RdsNcoPhase = MFMOD(m_RdsNcoPhase, K_2PI);	//keep radian counter bounded
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Process one new bit from RDS data stream.
+//	Manages state machine to find block data bit position, runs chksum and FEC on
+// each block, recovers good groups of 4 data blocks and places in data queue
+// for further upper level GUI processing depending on the application
+/////////////////////////////////////////////////////////////////////////////////
+void CRdsDemod::ProcessNewRdsBit(int bit)
+{
+	m_InBitStream =	(m_InBitStream<<1) | bit;	//shift in new bit
+	switch(m_DecodeState)
+	{
+		case STATE_BITSYNC:		//looking at each bit position till we find a "good" block A
+            if( 0 == CheckBlock(OFFSET_SYNDROME_BLOCK_A, false) )
+			{	//got initial good chkword on Block A not using FEC
+				m_CurrentBitPosition = 0;
+				m_BGroupOffset = 0;
+				m_BlockData[BLOCK_A] = m_InBitStream>>NUMBITS_CRC;
+				m_CurrentBlock = BLOCK_B;
+				m_DecodeState = STATE_BLOCKSYNC;	//next state is looking for blocks B,C, and D in sequence
+			}
+			break;
+		case STATE_BLOCKSYNC:	//Looking for 4 blocks in correct sequence to have good probability bit position is good
+			m_CurrentBitPosition++;
+			if(m_CurrentBitPosition >= NUMBITS_BLOCK)
+			{
+				m_CurrentBitPosition = 0;
+                if( CheckBlock(BLK_OFFSET_TBL[m_CurrentBlock+m_BGroupOffset], false ) )
+				{	//bad chkword so go look for bit sync again
+					m_DecodeState = STATE_BITSYNC;
+				}
+				else
+				{	//good chkword so save data and setup for next block
+					m_BlockData[m_CurrentBlock] = m_InBitStream>>NUMBITS_CRC;	//save msg data
+					//see if is group A or Group B
+					if( (BLOCK_B == m_CurrentBlock) && (m_BlockData[m_CurrentBlock] & GROUPB_BIT) )
+						m_BGroupOffset = 4;
+					else
+						m_BGroupOffset = 0;
+					if(m_CurrentBlock >= BLOCK_D)
+					{	//good chkword on all 4 blocks in correct sequence so are sure of bit position
+						//Place all group data into data queue
+						m_RdsGroupQueue[m_RdsQHead].BlockA = m_BlockData[BLOCK_A];
+						m_RdsGroupQueue[m_RdsQHead].BlockB = m_BlockData[BLOCK_B];
+						m_RdsGroupQueue[m_RdsQHead].BlockC = m_BlockData[BLOCK_C];
+						m_RdsGroupQueue[m_RdsQHead++].BlockD = m_BlockData[BLOCK_D];
+						if(m_RdsQHead >= RDS_Q_SIZE )
+							m_RdsQHead = 0;
+						m_CurrentBlock = BLOCK_A;
+						m_BlockErrors = 0;
+						m_DecodeState = STATE_GROUPDECODE;
+					}
+					else
+						m_CurrentBlock++;
+				}
+			}
+			break;
+		case STATE_GROUPDECODE:		//here after getting a good sequence of blocks
+			m_CurrentBitPosition++;
+			if(m_CurrentBitPosition>=NUMBITS_BLOCK)
+			{
+				m_CurrentBitPosition = 0;
+				if( CheckBlock(BLK_OFFSET_TBL[m_CurrentBlock+m_BGroupOffset], USE_FEC ) )
+				{
+					m_BlockErrors++;
+					if( m_BlockErrors > BLOCK_ERROR_LIMIT  )
+					{
+						m_RdsQHead = m_RdsQTail = 0;	//clear data queue
+						m_RdsGroupQueue[m_RdsQHead].BlockA = 0;	//stuff all zeros in que to indicate
+						m_RdsGroupQueue[m_RdsQHead].BlockB = 0;	//loss of signal
+						m_RdsGroupQueue[m_RdsQHead].BlockC = 0;
+						m_RdsGroupQueue[m_RdsQHead++].BlockD = 0;
+						m_DecodeState = STATE_BITSYNC;
+					}
+					else
+					{
+						m_CurrentBlock++;
+						if(m_CurrentBlock>BLOCK_D)
+							m_CurrentBlock = BLOCK_A;
+						if( BLOCK_A != m_CurrentBlock )	//skip remaining blocks of this group if error
+							m_DecodeState = STATE_GROUPRESYNC;
+					}
+				}
+				else
+				{	//good block so save and get ready for next one
+					m_BlockData[m_CurrentBlock] = m_InBitStream>>NUMBITS_CRC;	//save msg data
+					//see if is group A or Group B
+					if( (BLOCK_B == m_CurrentBlock) && (m_BlockData[m_CurrentBlock] & GROUPB_BIT) )
+						m_BGroupOffset = 4;
+					else
+						m_BGroupOffset = 0;
+					m_CurrentBlock++;
+					if(m_CurrentBlock>BLOCK_D)
+					{
+						//Place all group data into data queue
+						m_RdsGroupQueue[m_RdsQHead].BlockA = m_BlockData[BLOCK_A];
+						m_RdsGroupQueue[m_RdsQHead].BlockB = m_BlockData[BLOCK_B];
+						m_RdsGroupQueue[m_RdsQHead].BlockC = m_BlockData[BLOCK_C];
+						m_RdsGroupQueue[m_RdsQHead++].BlockD = m_BlockData[BLOCK_D];
+						if(m_RdsQHead >= RDS_Q_SIZE )
+							m_RdsQHead = 0;
+						m_CurrentBlock = BLOCK_A;
+						m_BlockErrors = 0;
+						//here with complete good group
+					}
+				}
+			}
+			break;
+		case STATE_GROUPRESYNC:		//ignor blocks until start of next group
+			m_CurrentBitPosition++;
+			if(m_CurrentBitPosition>=NUMBITS_BLOCK)
+			{
+				m_CurrentBitPosition = 0;
+				m_CurrentBlock++;
+				if(m_CurrentBlock>BLOCK_D)
+				{
+					m_CurrentBlock = BLOCK_A;
+					m_DecodeState = STATE_GROUPDECODE;
+				}
+			}
+			break;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Check block 'm_InBitStream' with 'BlockOffset' for errors.
+// if UseFec is false then no FEC is done else correct up to 5 bits.
+// Returns zero if no remaining errors if FEC is specified.
+/////////////////////////////////////////////////////////////////////////////////
+quint32 CRdsDemod::CheckBlock(quint32 SyndromeOffset, int UseFec)
+{
+	//First calculate syndrome for current 26 m_InBitStream bits
+	quint32 testblock = (0x3FFFFFF & m_InBitStream);	//isolate bottom 26 bits
+	//copy top 10 bits of block into 10 syndrome bits since first 10 rows
+	//of the check matrix is just an identity matrix(diagonal one's)
+	quint32 syndrome = testblock>>16;
+	for(int i=0; i<NUMBITS_MSG; i++)
+	{	//do the 16 remaining bits of the check matrix multiply
+		if(testblock&0x8000)
+			syndrome ^= PARCKH[i];
+		testblock <<= 1;
+	}
+	syndrome ^= SyndromeOffset;		//add depending on desired block
+
+	if(syndrome && UseFec)	//if errors and can use FEC
+	{
+		quint32 correctedbits = 0;
+		quint32 correctmask = (1<<(NUMBITS_BLOCK-1));	//start pointing to msg msb
+		//Run Meggitt FEC algorithm to correct up to 5 consecutive burst errors
+		for(int i=0; i<NUMBITS_MSG; i++)
+		{
+			if(syndrome & 0x200)	//chk msbit of syndrome for error state
+			{	//is possible bit error at current position
+				if(0 == (syndrome & 0x1F) ) //bottom 5 bits == 0 tell it is correctable
+				{	// Correct i-th bit
+					m_InBitStream ^= correctmask;
+					correctedbits++;
+					syndrome <<= 1;		//shift syndrome to next msb
+				}
+				else
+				{
+					syndrome <<= 1;	//shift syndrome to next msb
+					syndrome ^= CRC_POLY;	//recalculate new syndrome if bottom 5 bits not zero
+				}							//and syndrome msb bit was a one
+			}
+			else
+			{	//no error at this bit position so just shift to next position
+				syndrome <<= 1;	//shift syndrome to next msb
+			}
+			correctmask >>= 1;	//advance correctable bit position
+		}
+		syndrome &= 0x3FF;	//isolate syndrome bits if non-zero then still an error
+	}
+	return syndrome;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+// Get next group data from RDS data queue.
+// Returns zero if queue is empty or null pointer passed or data has not changed
+/////////////////////////////////////////////////////////////////////////////////
+bool CRdsDemod::GetNextRdsGroupData(tRDS_GROUPS* pGroupData)
+{
+	if( (m_RdsQHead == m_RdsQTail) || (NULL == pGroupData) )
+	{
+		return false;
+	}
+	pGroupData->BlockA = m_RdsGroupQueue[m_RdsQTail].BlockA;
+	pGroupData->BlockB = m_RdsGroupQueue[m_RdsQTail].BlockB;
+	pGroupData->BlockC = m_RdsGroupQueue[m_RdsQTail].BlockC;
+	pGroupData->BlockD = m_RdsGroupQueue[m_RdsQTail++].BlockD;
+	if(m_RdsQTail >= RDS_Q_SIZE )
+		m_RdsQTail = 0;
+	if( (m_LastRdsGroup.BlockA != pGroupData->BlockA) ||
+		(m_LastRdsGroup.BlockB != pGroupData->BlockB) ||
+		(m_LastRdsGroup.BlockC != pGroupData->BlockC) ||
+		(m_LastRdsGroup.BlockD != pGroupData->BlockD) )
+	{
+		m_LastRdsGroup = *pGroupData;
+		return true;
+	}
+	else
+        return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+// Less acurate but somewhat faster atan2() function
+// |error| < 0.005
+// Useful for plls but not for main FM demod if best audio quality desired.
+/////////////////////////////////////////////////////////////////////////////////
+inline TYPEREAL CRdsDemod::arctan2(TYPEREAL y, TYPEREAL x)
+{
+TYPEREAL angle;
+	if( x == 0.0 )
+	{	//avoid divide by zero and just return angle
+		if( y > 0.0 ) return K_PI2;
+		if( y == 0.0 ) return 0.0;
+		return -K_PI2;
+	}
+	TYPEREAL z = y/x;
+	if( MFABS( z ) < 1.0 )
+	{
+		angle = z/(1.0 + 0.2854*z*z);
+		if( x < 0.0 )
+		{
+			if( y < 0.0 )
+				return angle - K_PI;
+			return angle + K_PI;
+		}
+	}
+	else
+	{
+		angle = K_PI2 - z/(z*z + 0.2854);
+		if( y < 0.0 )
+			return angle - K_PI;
+	}
+	return angle;
+}
+
+} // namespace FMDSP_NAMESPACE
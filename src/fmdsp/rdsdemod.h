@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////
+// rdsdemod.h: interface for the CRdsDemod class.
+//
+//  This class takes the complex composite baseband signal from the
+//wideband FM demodulator and recovers the RDS data groups. It holds all
+//of its own state so it can run on a different thread than the audio
+//demodulation, the caller is responsible for handing it the composite
+//samples in order.
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef RDSDEMOD_H
+#define RDSDEMOD_H
+#include "datatypes.h"
+#include "fir.h"
+#include "iir.h"
+#include "downconvert.h"
+#include "rbdsconstants.h"
+
+namespace FMDSP_NAMESPACE {
+
+#define RDS_BUF_SIZE 16384	//maximum number of composite samples per ProcessData() call
+#define RDS_Q_SIZE 100
+
+class CRdsDemod
+{
+public:
+	CRdsDemod();
+
+	//sets up the RDS chain for the composite sample rate, returns the RDS baseband rate
+	TYPEREAL SetSampleRate(TYPEREAL SampleRate);
+	//processes InLength composite samples, InLength must not exceed RDS_BUF_SIZE
+	void ProcessData(int InLength, const TYPECPX* pInData);
+	bool GetNextRdsGroupData(tRDS_GROUPS* pGroupData);
+
+private:
+	void InitRds( TYPEREAL SampleRate );
+	void ProcessRdsPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData );
+	inline TYPEREAL arctan2(TYPEREAL y, TYPEREAL x);
+
+	void ProcessNewRdsBit(int bit);
+	quint32 CheckBlock(quint32 BlockOffset, int UseFec);
+
+	TYPEREAL m_RdsNcoPhase;		//variables for RDS PLL
+	TYPEREAL m_RdsNcoFreq;
+	TYPEREAL m_RdsNcoLLimit;
+	TYPEREAL m_RdsNcoHLimit;
+	TYPEREAL m_RdsPllAlpha;
+	TYPEREAL m_RdsPllBeta;
+
+	TYPECPX m_RdsRaw[RDS_BUF_SIZE];	//variables for RDS processing
+	TYPEREAL m_RdsMag[RDS_BUF_SIZE];
+	TYPEREAL m_RdsData[RDS_BUF_SIZE];
+	TYPEREAL m_RdsMatchCoef[RDS_BUF_SIZE];
+	TYPEREAL m_RdsLastSync;
+	TYPEREAL m_RdsLastSyncSlope;
+	TYPEREAL m_RdsLastData;
+	int m_MatchCoefLength;
+	CDownConvert m_RdsDownConvert;
+	CFir m_RdsBPFilter;
+	CFir m_RdsMatchedFilter;
+	CIir m_RdsBitSyncFilter;
+	TYPEREAL m_RdsOutputRate;
+	int m_RdsLastBit;
+	tRDS_GROUPS m_RdsGroupQueue[RDS_Q_SIZE];
+	int m_RdsQHead;
+	int m_RdsQTail;
+	tRDS_GROUPS m_LastRdsGroup;
+	quint32 m_InBitStream;	//input shift register for incoming raw data
+	int m_CurrentBlock;
+	int m_CurrentBitPosition;
+	int m_DecodeState;
+	int m_BGroupOffset;
+	int m_BlockErrors;
+	quint16 m_BlockData[4];
+};
+
+} // namespace FMDSP_NAMESPACE
+
+#endif // RDSDEMOD_H
@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////
+// simd.h: SIMD instruction set selection and CPU feature detection
+//
+//  Determines which SIMD instruction sets can be compiled for the target
+//architecture and provides the runtime checks required before calling
+//a kernel built for an instruction set that is not part of the baseline
+//
+// History:
+//	2026-10-16  Initial creation
+//////////////////////////////////////////////////////////////////////
+#ifndef SIMD_H
+#define SIMD_H
+
+// x86 / x64: SSE2 and AVX2 kernels are always compiled, the GCC/Clang
+// target attribute allows that without changing the project CXXFLAGS
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+ #define FMDSP_SIMD_X86
+ #include <immintrin.h>
+ #if defined(_MSC_VER) && !defined(__clang__)
+  #include <intrin.h>
+  #define FMDSP_TARGET_SSE2
+  #define FMDSP_TARGET_AVX2
+ #else
+  #include <cpuid.h>
+  #define FMDSP_TARGET_SSE2 __attribute__((target("sse2")))
+  #define FMDSP_TARGET_AVX2 __attribute__((target("avx2")))
+ #endif
+#endif
+
+// ARM / AArch64: NEON kernels are compiled only when FMDSP_ENABLE_NEON is
+// defined and NEON is part of the baseline instruction set; double precision
+// vectors require AArch64. They have not been run on ARM hardware yet, so
+// ARM builds use the scalar kernels unless the option is set
+#if defined(FMDSP_ENABLE_NEON) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+ #define FMDSP_SIMD_NEON
+ #include <arm_neon.h>
+ #if defined(__aarch64__)
+  #define FMDSP_SIMD_NEON64
+ #elif defined(__linux__)
+  #include <sys/auxv.h>
+  #include <asm/hwcap.h>
+ #endif
+#endif
+
+#ifdef FMDSP_SIMD_X86
+
+//////////////////////////////////////////////////////////////////
+// Returns the CPUID register values for a leaf/subleaf
+//////////////////////////////////////////////////////////////////
+inline void SimdCpuid(unsigned int Leaf, unsigned int SubLeaf, unsigned int Regs[4])
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int r[4];
+	__cpuidex(r, (int)Leaf, (int)SubLeaf);
+	for(int i=0; i<4; i++)
+		Regs[i] = (unsigned int)r[i];
+#else
+	Regs[0] = Regs[1] = Regs[2] = Regs[3] = 0;
+	if( Leaf <= __get_cpuid_max(Leaf & 0x80000000, 0) )
+		__cpuid_count(Leaf, SubLeaf, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+// Returns true if the CPU supports SSE2
+//////////////////////////////////////////////////////////////////
+inline bool SimdHasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+	return true;		//SSE2 is part of the x64 baseline
+#else
+	unsigned int regs[4];
+	SimdCpuid(1, 0, regs);
+	return (regs[3] & (1u << 26)) != 0;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+// Returns true if the CPU and the operating system support AVX2
+//////////////////////////////////////////////////////////////////
+inline bool SimdHasAvx2()
+{
+	unsigned int regs[4];
+	SimdCpuid(1, 0, regs);
+	//OSXSAVE and AVX must both be present
+	if( (regs[2] & ((1u << 27) | (1u << 28))) != ((1u << 27) | (1u << 28)) )
+		return false;
+	//the OS must preserve the XMM and YMM register state
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long long xcr0 = _xgetbv(0);
+#else
+	unsigned int eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	unsigned long long xcr0 = ((unsigned long long)edx << 32) | eax;
+#endif
+	if( (xcr0 & 0x6) != 0x6 )
+		return false;
+	SimdCpuid(7, 0, regs);
+	return (regs[1] & (1u << 5)) != 0;
+}
+
+#endif // FMDSP_SIMD_X86
+
+#ifdef FMDSP_SIMD_NEON
+
+//////////////////////////////////////////////////////////////////
+// Returns true if the CPU supports NEON. It is part of the AArch64
+// baseline, 32 bit ARM builds that enable it still need to check
+// the kernel reported capabilities
+//////////////////////////////////////////////////////////////////
+inline bool SimdHasNeon()
+{
+#if defined(__aarch64__) || !defined(__linux__)
+	return true;
+#else
+	return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#endif
+}
+
+#endif // FMDSP_SIMD_NEON
+
+#endif // SIMD_H
@@ -43,6 +43,8 @@
 #include "datatypes.h"
 #include "filtercoef.h"
 
+namespace FMDSP_NAMESPACE {
+
 #define FMDEMOD_GAIN 8000.0
 
 #define PILOTPLL_RANGE 20.0	//maximum deviation limit of PLL
@@ -55,23 +57,6 @@
 #define PHASE_ADJ_M -7.267e-6	//fudge factor slope to compensate for PLL delay
 #define PHASE_ADJ_B 3.677		//fudge factor intercept to compensate for PLL delay
 
-//bunch of RDS constants
-#define USE_FEC 1	//set to zero to disable FEC correction
-
-#define RDS_FREQUENCY 57000.0
-#define RDS_BITRATE (RDS_FREQUENCY/48.0) //1187.5 bps bitrate
-#define RDSPLL_RANGE 12.0	//maximum deviation limit of PLL
-#define RDSPLL_BW 1.0	//natural frequency ~loop bandwidth
-#define RDSPLL_ZETA .707	//PLL Loop damping factor
-
-//RDS decoder states
-#define STATE_BITSYNC 0		//looking for initial bit position in Block 1
-#define STATE_BLOCKSYNC 1	//looking for initial correct block order
-#define STATE_GROUPDECODE 2	//decode groups after achieving bit  and block sync
-#define STATE_GROUPRESYNC 3	//waiting for beginning of new group after getting a block error
-
-#define BLOCK_ERROR_LIMIT 5		//number of bad blocks before trying to resync at the bit level
-
 #define HILB_LENGTH 61
 const TYPEREAL HILBLP_H[HILB_LENGTH] =
 {	//LowPass filter prototype that is shifted and "hilbertized" to get 90 deg phase shift
@@ -164,31 +149,35 @@ const TYPEREAL HILBLP_H[HILB_LENGTH] = {	//test wideband hilbert
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct/destruct WFM demod object
 /////////////////////////////////////////////////////////////////////////////////
-CWFmDemod::CWFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
+CWFmDemod::CWFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate),
+	m_Discriminator(DEFAULT_WFM_DISCRIMINATOR)
 {
-	m_pDecBy2A = NULL;
-	m_pDecBy2B = NULL;
-	m_pDecBy2C = NULL;
+	m_RdsEnabled = true;
+	m_AudioFilterEnabled = true;
+	m_MidChain.pDecBy2A = m_MidChain.pDecBy2B = m_MidChain.pDecBy2C = NULL;
+	m_SideChain.pDecBy2A = m_SideChain.pDecBy2B = m_SideChain.pDecBy2C = NULL;
 	m_PilotPhaseAdjust = 0.0;
 	SetSampleRate(samplerate, true);
-	m_InBitStream = 0;
-	m_CurrentBitPosition = 0;
-	m_CurrentBlock = BLOCK_A;
-	m_DecodeState = STATE_BITSYNC;
-	m_BGroupOffset = 0;
     m_PilotLocked = false;
 	m_LastPilotLocked = !m_PilotLocked;
-	m_BlockErrors = 0;
 }
 
 CWFmDemod::~CWFmDemod()
 {	//destroy resources
-	if(m_pDecBy2A)
-		delete m_pDecBy2A;
-	if(m_pDecBy2B)
-		delete m_pDecBy2B;
-	if(m_pDecBy2C)
-		delete m_pDecBy2C;
+	DeleteAudioChain(m_MidChain);
+	DeleteAudioChain(m_SideChain);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Selects the discriminator backend. DISC_POLAR is rejected, it is only
+// linear for small phase steps and gives -15dB THD at 75KHz deviation
+/////////////////////////////////////////////////////////////////////////////////
+bool CWFmDemod::SetDiscriminator(int Type)
+{
+	if( (DISC_ATAN2 != Type) && (DISC_POLYATAN2 != Type) )
+		return false;
+	m_Discriminator.SetType(Type);
+	return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -199,35 +188,15 @@ CWFmDemod::~CWFmDemod()
 /////////////////////////////////////////////////////////////////////////////////
 TYPEREAL CWFmDemod::SetSampleRate(TYPEREAL samplerate, bool USver)
 {
-	//delete any resources that may still exist
-	if(m_pDecBy2A)
-		delete m_pDecBy2A;
-	if(m_pDecBy2B)
-		delete m_pDecBy2B;
-	if(m_pDecBy2C)
-		delete m_pDecBy2C;
-	m_pDecBy2A = NULL;
-	m_pDecBy2B = NULL;
-	m_pDecBy2C = NULL;
-
 	m_OutRate = m_SampleRate = samplerate;
 	//Determine post demod decimation rate based on input sample rate range
 	// try to get down to close to 50khz
 	if(m_SampleRate>400000)//need dec by 8
-	{
-		m_pDecBy2C = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
 		m_OutRate /= 2.0;
-	}
 	if(m_SampleRate>200000)//need dec by 4
-	{
-		m_pDecBy2B = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
 		m_OutRate /= 2.0;
-	}
 	if(m_SampleRate>100000)//need dec by 2
-	{
-		m_pDecBy2A = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
 		m_OutRate /= 2.0;
-	}
 
 	//set Stereo Pilot phase adjustment values based on sample rate
 	// compensation function is a straight line approximation with
@@ -244,29 +213,62 @@ TYPEREAL CWFmDemod::SetSampleRate(TYPEREAL samplerate, bool USver)
 	m_PilotBPFilter.InitBP(PILOTPLL_FREQ, 500, m_SampleRate);
 	InitPilotPll(m_SampleRate);
 
-	//create LP filter to roll off audio
-	m_LPFilter.InitLPFilter(0, 1.0,60.0, 15000.0,1.4*15000.0, m_OutRate);
-
-	//create 19KHz pilot notch filter with Q=5
-	m_NotchFilter.InitBR(PILOTPLL_FREQ, 5, m_OutRate);
+	//create the decimators and audio filters for the mid and side signals
+	InitAudioChain(m_MidChain);
+	InitAudioChain(m_SideChain);
+	m_SideFlush = 0;
 	//create deemphasis filter with 75uSec or 50uSec LP corner
 	if(USver)
 		InitDeemphasis(75E-6, m_OutRate);
 	else
 		InitDeemphasis(50E-6, m_OutRate);
 
-	m_RdsOutputRate = m_RdsDownConvert.SetDataRate(m_SampleRate, 8000.0);
-	m_RdsDownConvert.SetFrequency(-RDS_FREQUENCY);	//set up to shift 57KHz RDS down to baseband and decimate
-
-	InitRds(m_RdsOutputRate);
+	m_RdsDemod.SetSampleRate(m_SampleRate);
     m_PilotLocked = false;
 	m_LastPilotLocked = !m_PilotLocked;
 	return m_OutRate;
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+//	Creates the decimators and audio filters of one audio chain for the
+// current sample rate
+/////////////////////////////////////////////////////////////////////////////////
+void CWFmDemod::InitAudioChain(tAudioChain& Chain)
+{
+	//delete any resources that may still exist
+	DeleteAudioChain(Chain);
+	if(m_SampleRate>400000)
+		Chain.pDecBy2C = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
+	if(m_SampleRate>200000)
+		Chain.pDecBy2B = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
+	if(m_SampleRate>100000)
+		Chain.pDecBy2A = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
+
+	//create LP filter to roll off audio
+	Chain.LPFilter.InitLPFilter(0, 1.0,WFM_AUDIO_ASTOP, WFM_AUDIO_FPASS,WFM_AUDIO_FSTOP, m_OutRate);
+
+	//create 19KHz pilot notch filter with Q=5
+	Chain.NotchFilter.InitBR(PILOTPLL_FREQ, 5, m_OutRate);
+	Chain.DeemphasisAve = 0.0;
+}
+
+void CWFmDemod::DeleteAudioChain(tAudioChain& Chain)
+{
+	if(Chain.pDecBy2A)
+		delete Chain.pDecBy2A;
+	if(Chain.pDecBy2B)
+		delete Chain.pDecBy2B;
+	if(Chain.pDecBy2C)
+		delete Chain.pDecBy2C;
+	Chain.pDecBy2A = NULL;
+	Chain.pDecBy2B = NULL;
+	Chain.pDecBy2C = NULL;
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 //					Process WFM demod MONO version
-// Simple demod without stereo or RDS decoding
+// Simple demod without stereo decoding, the composite signal is only created
+// when RDS is enabled
 //
 //		InLength == number of complex input samples in complex array pInData
 //		pInData == pointer to callers complex input array (users input data is overwriten!!)
@@ -277,31 +279,52 @@ int CWFmDemod::ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
 {
 	m_MonoLPFilter.ProcessFilter(InLength,pInData, pInData);
 
-	for(int i=0; i<InLength; i++)
-	{
-		m_D0 = pInData[i];
-	#ifdef FMDSP_USE_DOUBLE_PRECISION
-		pOutData[i] = FMDEMOD_GAIN*MATAN2( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
-	#else
-		pOutData[i] = FMDEMOD_GAIN*arctan2((m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
-	#endif
-		m_D1 = m_D0;
+	m_Discriminator.ProcessData(InLength, pInData, FMDEMOD_GAIN, pOutData);
+
+	if(m_RdsEnabled)
+	{	//the composite signal is only needed for RDS
+		m_HilbertFilter.ProcessFilter(InLength, pOutData, m_CpxRawFm);
+		ProcessComposite(InLength);
 	}
-	//decimate down close to final audio rate by dividing by 2's
-	if(m_pDecBy2A)
-		InLength = m_pDecBy2A->DecBy2(InLength, pOutData, pOutData);
-	if(m_pDecBy2B)
-		InLength = m_pDecBy2B->DecBy2(InLength, pOutData, pOutData);
-	if(m_pDecBy2C)
-		InLength = m_pDecBy2C->DecBy2(InLength, pOutData, pOutData);
-
-	m_LPFilter.ProcessFilter( InLength, pOutData, pOutData);	//rolloff audio above 15KHz
-	ProcessDeemphasisFilter(InLength, pOutData, pOutData);		//50 or 75uSec de-emphasis one pole filter
-	m_NotchFilter.ProcessFilter( InLength, pOutData, pOutData);	//notch out 19KHz pilot
+
     m_PilotLocked = false;
+	return ProcessAudioChain(m_MidChain, InLength, pOutData);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Runs a post demod audio chain in place over InLength samples
+// returns the number of audio samples
+/////////////////////////////////////////////////////////////////////////////////
+int CWFmDemod::ProcessAudioChain(tAudioChain& Chain, int InLength, TYPEREAL* pData)
+{
+	//decimate down close to final audio rate by dividing by 2's
+	if(Chain.pDecBy2A)
+		InLength = Chain.pDecBy2A->DecBy2(InLength, pData, pData);
+	if(Chain.pDecBy2B)
+		InLength = Chain.pDecBy2B->DecBy2(InLength, pData, pData);
+	if(Chain.pDecBy2C)
+		InLength = Chain.pDecBy2C->DecBy2(InLength, pData, pData);
+
+	if(m_AudioFilterEnabled)
+		Chain.LPFilter.ProcessFilter( InLength, pData, pData);	//rolloff audio above 15KHz
+	ProcessDeemphasisFilter(InLength, pData, pData, Chain.DeemphasisAve);	//50 or 75uSec de-emphasis one pole filter
+	if(m_AudioFilterEnabled)
+		Chain.NotchFilter.ProcessFilter( InLength, pData, pData);	//notch out 19KHz pilot
 	return InLength;
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+//	Hands InLength samples of the composite signal in m_CpxRawFm to the RDS
+// demodulator or to the sink that runs it elsewhere
+/////////////////////////////////////////////////////////////////////////////////
+void CWFmDemod::ProcessComposite(int InLength)
+{
+	if(m_CompositeSink)
+		m_CompositeSink(InLength, m_CpxRawFm);
+	else
+		m_RdsDemod.ProcessData(InLength, m_CpxRawFm);
+}
+
 
 /////////////////////////////////////////////////////////////////////////////////
 //						Process WFM demod STEREO version
@@ -325,110 +348,58 @@ int CWFmDemod::ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
 /////////////////////////////////////////////////////////////////////////////////
 int CWFmDemod::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
 {
-TYPEREAL LminusR;
-	for(int i=0; i<InLength; i++)
-	{
-		m_D0 = pInData[i];
-	#ifdef FMDSP_USE_DOUBLE_PRECISION
-		m_RawFm[i] = FMDEMOD_GAIN*MATAN2( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
-	#else
-		m_RawFm[i] = FMDEMOD_GAIN*arctan2( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
-	#endif
-
-		m_D1 = m_D0;
-	}
+	m_Discriminator.ProcessData(InLength, pInData, FMDEMOD_GAIN, m_RawFm);
 
 	//create complex data from demodulator real data
 	m_HilbertFilter.ProcessFilter(InLength, m_RawFm, m_CpxRawFm);	//~173 nSec/sample
 
 	m_PilotBPFilter.ProcessFilter(InLength, m_CpxRawFm, pInData);//~173 nSec/sample, use input buffer for complex output storage
-	if(ProcessPilotPll(InLength, pInData) )
-	{	//if pilot tone present, do stereo demuxing
+	m_PilotLocked = ProcessPilotPll(InLength, pInData);
+
+	if(m_RdsEnabled)
+		ProcessComposite(InLength);
+
+	//the audio filters are linear so the L+R and L-R signals are filtered separately
+	// and matrixed into left and right afterwards. The L+R chain always runs and the
+	// L-R chain only has to run while there is a pilot, it keeps running on silence
+	// for a while after the pilot is lost so it switches back in without a click
+	bool side = true;
+	if(m_PilotLocked)
+	{
 		for(int i=0; i<InLength; i++)
-		{
-			TYPEREAL in = m_RawFm[i];
-			//Left minus Right signal is created by multiplying by 38KHz recovered pilot
+		{	//Left minus Right signal is created by multiplying by 38KHz recovered pilot
 			// scale by 2 since DSB amplitude is half of the Right plus Left signal
-			LminusR = 2.0 * in * MSIN( m_PilotPhase[i]*2.0);
-			pOutData[i].re = in + LminusR;		//extract left and right signals
-			pOutData[i].im = in - LminusR;
+			m_Pilot38[i] = 2.0 * m_RawFm[i] * m_Pilot38[i];
 		}
-		m_PilotLocked = true;
+		m_SideFlush = (int)(m_SampleRate*SIDE_FLUSH_TIME);
 	}
-	else
-	{	//no pilot so is mono. Just copy real fm demod into both right and left channels
+	else if(m_SideFlush > 0)
+	{
 		for(int i=0; i<InLength; i++)
+			m_Pilot38[i] = 0.0;
+		m_SideFlush -= InLength;
+	}
+	else
+		side = false;
+
+	int OutLength = ProcessAudioChain(m_MidChain, InLength, m_RawFm);
+	if(!side)
+	{	//no pilot so is mono, copy into both right and left channels
+		for(int i=0; i<OutLength; i++)
 		{
 			pOutData[i].re = m_RawFm[i];
 			pOutData[i].im = m_RawFm[i];
 		}
-        m_PilotLocked = false;
+		return OutLength;
 	}
-	//translate 57KHz RDS signal to baseband and decimate RDS complex signal
-	int length = m_RdsDownConvert.ProcessData(InLength, m_CpxRawFm, m_RdsRaw);
-
-	//filter baseband RDS signal
-	m_RdsBPFilter.ProcessFilter(length, m_RdsRaw, m_RdsRaw);
-
-	//PLL to remove any rotation since may not be phase locked to 19KHz Pilot or may not even have pilot
-	ProcessRdsPll(length, m_RdsRaw, m_RdsMag);
-
-	//run matched filter correlator to extract the bi-phase data bits
-	m_RdsMatchedFilter.ProcessFilter(length,m_RdsMag,m_RdsData);
-	//create bit sync signal in m_RdsMag[] by squaring data
-	for(int i=0; i<length; i++)
-		m_RdsMag[i] = m_RdsData[i]* m_RdsData[i];	//has high energy at the bit clock rate and 2x bit rate
-
-	//run Hi-Q resonator filter that create a sin wave that will lock to BitRate clock and not 2X rate
-	m_RdsBitSyncFilter.ProcessFilter(length, m_RdsMag, m_RdsMag);
-	//now loop through samples to determine where bit position is and extract binary digital data
-	for(int i=0; i<length; i++)
-	{
-		TYPEREAL Data = m_RdsData[i];
-		TYPEREAL SyncVal = m_RdsMag[i];
-		//the best bit sync position is at the positive peak of the sync sine wave
-		TYPEREAL Slope = SyncVal - m_RdsLastSync;	//current slope
-		m_RdsLastSync = SyncVal;
-		//see if at the top of the sine wave
-		if( (Slope<0.0) && (m_RdsLastSyncSlope*Slope)<0.0 )
-		{	//are at sample time so read previous bit time since we are one sample behind in sync position
-			int bit;
-			if(m_RdsLastData>=0)
-			{
-				bit = 1;
-				m_RdsRaw[i].re = m_RdsLastData;
-			}
-			else
-			{
-				bit = 0;
-				m_RdsRaw[i].re = m_RdsLastData;
-			}
-			//need to XOR with previous bit to get actual data bit value
-			ProcessNewRdsBit(bit^m_RdsLastBit);		//go process new RDS Bit
-			m_RdsLastBit = bit;
-		}
-		else
-		{
-			m_RdsRaw[i].re = 0;
-		}
 
-		m_RdsLastData = Data;		//keep last bit since is differential data
-		m_RdsLastSyncSlope = Slope;
-		m_RdsRaw[i].im = Data;
+	ProcessAudioChain(m_SideChain, InLength, m_Pilot38);
+	for(int i=0; i<OutLength; i++)
+	{	//extract left and right signals
+		pOutData[i].re = m_RawFm[i] + m_Pilot38[i];
+		pOutData[i].im = m_RawFm[i] - m_Pilot38[i];
 	}
-
-	//decimate by 2's down close to final audio rate
-	if(m_pDecBy2A)
-		InLength = m_pDecBy2A->DecBy2(InLength, pOutData, pOutData);
-	if(m_pDecBy2B)
-		InLength = m_pDecBy2B->DecBy2(InLength, pOutData, pOutData);
-	if(m_pDecBy2C)
-		InLength = m_pDecBy2C->DecBy2(InLength, pOutData, pOutData);
-
-	m_LPFilter.ProcessFilter( InLength, pOutData, pOutData);	//rolloff audio above 15KHz
-	ProcessDeemphasisFilter(InLength, pOutData, pOutData);		//50 or 75uSec de-emphasis one pole filter
-	m_NotchFilter.ProcessFilter( InLength, pOutData, pOutData);	//notch out 19KHz pilot
-	return InLength;
+	return OutLength;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -448,21 +419,52 @@ void CWFmDemod::InitPilotPll( TYPEREAL SampleRate )
 	m_PilotPllBeta = (m_PilotPllAlpha * m_PilotPllAlpha)/(4.0*PILOTPLL_ZETA*PILOTPLL_ZETA);
 	m_PhaseErrorMagAve = 0.0;
 	m_PhaseErrorMagAlpha = (1.0-MEXP(-1.0/(m_SampleRate*LOCK_TIMECONST)) );
+
+	//one cycle sine table for the NCO phase accumulator
+	for(int i=0; i<PILOT_TABLE_SIZE; i++)
+		m_PilotSinTable[i] = MSIN( (K_2PI*i)/PILOT_TABLE_SIZE );
+	//the 38KHz subcarrier is shifted by twice the pilot phase adjustment
+	m_Pilot38AdjustSin = MSIN(2.0*m_PilotPhaseAdjust);
+	m_Pilot38AdjustCos = MCOS(2.0*m_PilotPhaseAdjust);
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+//	Returns the pilot NCO sin and cos of Phase, which must not be negative.
+// The nearest table entry is corrected with a 2nd order Taylor series
+// of the remaining phase offset, |error| < 5e-9
+/////////////////////////////////////////////////////////////////////////////////
+inline void CWFmDemod::PilotNcoSinCos(TYPEREAL Phase, TYPEREAL* pSin, TYPEREAL* pCos)
+{
+	int n = (int)(Phase * (PILOT_TABLE_SIZE/K_2PI) + 0.5);
+	TYPEREAL e = Phase - n * (K_2PI/PILOT_TABLE_SIZE);
+	TYPEREAL e2 = 1.0 - 0.5*e*e;
+	TYPEREAL s = m_PilotSinTable[n & (PILOT_TABLE_SIZE-1)];
+	TYPEREAL c = m_PilotSinTable[(n + PILOT_TABLE_SIZE/4) & (PILOT_TABLE_SIZE-1)];
+	*pSin = s*e2 + c*e;
+	*pCos = c*e2 - s*e;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //	Process IQ wide FM data to lock Pilot PLL
-//returns true if Locked.  Fills m_PilotPhase[] with locked 19KHz NCO phase data
+//returns true if Locked.  Fills m_Pilot38[] with the 38KHz subcarrier that is
+// locked to the pilot.
+//  The NCO sin and cos come from a table lookup of the phase accumulator. The
+// subcarrier for each sample uses the NCO phase after that sample's update,
+// which is the phase looked up for the next sample, so it is created from
+// those values by the double angle formulas and the phase adjustment.
 /////////////////////////////////////////////////////////////////////////////////
 bool CWFmDemod::ProcessPilotPll( int InLength, TYPECPX* pInData )
 {
 TYPEREAL Sin;
 TYPEREAL Cos;
 TYPECPX tmp;
-	for(int i=0; i<InLength; i++)	//175 nSec
+	for(int i=0; i<InLength; i++)
 	{
-		Sin = MSIN(m_PilotNcoPhase);		//178ns for sin/cos calc
-		Cos = MCOS(m_PilotNcoPhase);
+		PilotNcoSinCos(m_PilotNcoPhase, &Sin, &Cos);
+		if(i > 0)
+		{	//sin(2*(phase + adjust)) for the previous sample
+			m_Pilot38[i-1] = (2.0*Sin*Cos)*m_Pilot38AdjustCos + ((Cos-Sin)*(Cos+Sin))*m_Pilot38AdjustSin;
+		}
 		//complex multiply input sample by NCO's  sin and cos
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
@@ -476,13 +478,20 @@ TYPECPX tmp;
 			m_PilotNcoFreq = m_PilotNcoHLimit;
 		else if(m_PilotNcoFreq < m_PilotNcoLLimit)
 			m_PilotNcoFreq = m_PilotNcoLLimit;
-		//update NCO phase with new value
+		//update NCO phase with new value and keep it within 0 to 2PI
 		m_PilotNcoPhase += (m_PilotNcoFreq + m_PilotPllAlpha * phzerror);
-		m_PilotPhase[i] = m_PilotNcoPhase + m_PilotPhaseAdjust;	//phase fudge for exact phase delay
+		if(m_PilotNcoPhase < 0.0)
+			m_PilotNcoPhase += K_2PI;
+		else if(m_PilotNcoPhase >= K_2PI)
+			m_PilotNcoPhase -= K_2PI;
 		//create long average of error magnitude for lock detection
 		m_PhaseErrorMagAve = (1.0-m_PhaseErrorMagAlpha)*m_PhaseErrorMagAve + m_PhaseErrorMagAlpha*phzerror*phzerror;
 	}
-	m_PilotNcoPhase = MFMOD(m_PilotNcoPhase, K_2PI);	//keep radian counter bounded
+	if(InLength > 0)
+	{
+		PilotNcoSinCos(m_PilotNcoPhase, &Sin, &Cos);
+		m_Pilot38[InLength-1] = (2.0*Sin*Cos)*m_Pilot38AdjustCos + ((Cos-Sin)*(Cos+Sin))*m_Pilot38AdjustSin;
+	}
 	if(m_PhaseErrorMagAve < LOCK_MAG_THRESHOLD)
         return true;
 	else
@@ -512,324 +521,17 @@ int CWFmDemod::GetStereoLock(int* pPilotLock)
 void CWFmDemod::InitDeemphasis( TYPEREAL Time, TYPEREAL SampleRate)	//create De-emphasis LP filter
 {
 	m_DeemphasisAlpha = (1.0-MEXP(-1.0/(SampleRate*Time)) );
-	m_DeemphasisAveRe = 0.0;
-	m_DeemphasisAveIm = 0.0;
-}
-
-/////////////////////////////////////////////////////////////////////////////////
-//	Process InLength InBuf[] samples and place in OutBuf[]
-//REAL version
-/////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
-{
-	for(int i=0; i<InLength; i++)
-	{
-		m_DeemphasisAveRe = (1.0-m_DeemphasisAlpha)*m_DeemphasisAveRe + m_DeemphasisAlpha*InBuf[i];
-		OutBuf[i] = m_DeemphasisAveRe*2.0;
-	}
+	m_MidChain.DeemphasisAve = 0.0;
+	m_SideChain.DeemphasisAve = 0.0;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //	Process InLength InBuf[] samples and place in OutBuf[]
-//complex (stereo) version
-/////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::ProcessDeemphasisFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
-{
-	for(int i=0; i<InLength; i++)
-	{
-		m_DeemphasisAveRe = (1.0-m_DeemphasisAlpha)*m_DeemphasisAveRe + m_DeemphasisAlpha*InBuf[i].re;
-		m_DeemphasisAveIm = (1.0-m_DeemphasisAlpha)*m_DeemphasisAveIm + m_DeemphasisAlpha*InBuf[i].im;
-		OutBuf[i].re = m_DeemphasisAveRe*2.0;
-		OutBuf[i].im = m_DeemphasisAveIm*2.0;
-	}
-}
-
-/////////////////////////////////////////////////////////////////////////////////
-//	Initialize variables for RDS PLL and matched filter
+// Ave holds the filter state of the channel
 /////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::InitRds( TYPEREAL SampleRate )
+void CWFmDemod::ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf, TYPEREAL& Ave)
 {
-	m_RdsNcoPhase = 0.0;
-	m_RdsNcoFreq = 0.0;	//freq offset to bring to baseband
-
-	//Create complex LP filter of RDS signal with 2400Hz passband
-	m_RdsBPFilter.InitLPFilter(0, 1.0,40.0, 2400.0,1.3*2400.0, m_RdsOutputRate);
-
-	TYPEREAL norm = K_2PI/SampleRate;	//to normalize Hz to radians
-	//initialize the PLL that is used to de-rotate the rds DSB signal
-	m_RdsNcoLLimit = (m_RdsNcoFreq-RDSPLL_RANGE) * norm;		//clamp RDS PLL NCO
-	m_RdsNcoHLimit = (m_RdsNcoFreq+RDSPLL_RANGE) * norm;
-	m_RdsPllAlpha = 2.0*RDSPLL_ZETA*RDSPLL_BW * norm;
-	m_RdsPllBeta = (m_RdsPllAlpha * m_RdsPllAlpha)/(4.0*RDSPLL_ZETA*RDSPLL_ZETA);
-	//create matched filter to extract bi-phase bits
-	// This is basically the time domain shape of a single bi-phase bit
-	// as defined for RDS and is close to a single cycle sine wave in shape
-	m_MatchCoefLength = static_cast<int>(SampleRate / RDS_BITRATE);
-	for(int i= 0; i<=m_MatchCoefLength; i++)
-	{
-		TYPEREAL t = (TYPEREAL)i/(SampleRate);
-		TYPEREAL x = t*RDS_BITRATE;
-		TYPEREAL x64 = 64.0*x;
-		m_RdsMatchCoef[i+m_MatchCoefLength] = .75*MCOS(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
-								(1.0/(9.0/x-x64)) );
-		m_RdsMatchCoef[m_MatchCoefLength-i] = -.75*MCOS(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
-								(1.0/(9.0/x-x64)) );
-	}
-	m_MatchCoefLength *= 2;
-	//load the matched filter coef into FIR filter
-	m_RdsMatchedFilter.InitConstFir(m_MatchCoefLength, m_RdsMatchCoef, SampleRate);
-	//create Hi-Q resonator at the bit rate to recover bit sync position Q==500
-	m_RdsBitSyncFilter.InitBP(RDS_BITRATE, 500, SampleRate);
-	//initialize a bunch of variables pertaining to the rds decoder
-	m_RdsLastSync = 0.0;
-	m_RdsLastSyncSlope = 0.0;
-	m_RdsQHead = 0;
-	m_RdsQTail = 0;
-	m_RdsLastBit = 0;
-	m_CurrentBitPosition = 0;
-	m_CurrentBlock = BLOCK_A;
-	m_DecodeState = STATE_BITSYNC;
-	m_BGroupOffset = 0;
-	m_LastRdsGroup.BlockA = 0;
-	m_LastRdsGroup.BlockB = 0;
-	m_LastRdsGroup.BlockC = 0;
-	m_LastRdsGroup.BlockD = 0;
-}
-
-/////////////////////////////////////////////////////////////////////////////////
-//	Process I/Q RDS baseband stream to lock PLL
-/////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::ProcessRdsPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData )
-{
-TYPEREAL Sin;
-TYPEREAL Cos;
-TYPECPX tmp;
-	for(int i=0; i<InLength; i++)
-	{
-		Sin = MSIN(m_RdsNcoPhase);		//178ns for sin/cos calc
-		Cos = MCOS(m_RdsNcoPhase);
-		//complex multiply input sample by NCO's  sin and cos
-		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
-		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
-		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -arctan2(tmp.im, tmp.re);
-		//create new NCO frequency term
-		m_RdsNcoFreq += (m_RdsPllBeta * phzerror);		//  radians per sampletime
-		//clamp NCO frequency so doesn't get out of lock range
-		if(m_RdsNcoFreq > m_RdsNcoHLimit)
-			m_RdsNcoFreq = m_RdsNcoHLimit;
-		else if(m_RdsNcoFreq < m_RdsNcoLLimit)
-			m_RdsNcoFreq = m_RdsNcoLLimit;
-		//update NCO phase with new value
-		m_RdsNcoPhase += (m_RdsNcoFreq + m_RdsPllAlpha * phzerror);
-		pOutData[i] = tmp.im;
-	}
-	m_RdsNcoPhase = MFMOD(m_RdsNcoPhase, K_2PI);	//keep radian counter bounded
-}
-
-
-
-/////////////////////////////////////////////////////////////////////////////////
-//	Process one new bit from RDS data stream.
-//	Manages state machine to find block data bit position, runs chksum and FEC on
-// each block, recovers good groups of 4 data blocks and places in data queue
-// for further upper level GUI processing depending on the application
-/////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::ProcessNewRdsBit(int bit)
-{
-	m_InBitStream =	(m_InBitStream<<1) | bit;	//shift in new bit
-	switch(m_DecodeState)
-	{
-		case STATE_BITSYNC:		//looking at each bit position till we find a "good" block A
-            if( 0 == CheckBlock(OFFSET_SYNDROME_BLOCK_A, false) )
-			{	//got initial good chkword on Block A not using FEC
-				m_CurrentBitPosition = 0;
-				m_BGroupOffset = 0;
-				m_BlockData[BLOCK_A] = m_InBitStream>>NUMBITS_CRC;
-				m_CurrentBlock = BLOCK_B;
-				m_DecodeState = STATE_BLOCKSYNC;	//next state is looking for blocks B,C, and D in sequence
-			}
-			break;
-		case STATE_BLOCKSYNC:	//Looking for 4 blocks in correct sequence to have good probability bit position is good
-			m_CurrentBitPosition++;
-			if(m_CurrentBitPosition >= NUMBITS_BLOCK)
-			{
-				m_CurrentBitPosition = 0;
-                if( CheckBlock(BLK_OFFSET_TBL[m_CurrentBlock+m_BGroupOffset], false ) )
-				{	//bad chkword so go look for bit sync again
-					m_DecodeState = STATE_BITSYNC;
-				}
-				else
-				{	//good chkword so save data and setup for next block
-					m_BlockData[m_CurrentBlock] = m_InBitStream>>NUMBITS_CRC;	//save msg data
-					//see if is group A or Group B
-					if( (BLOCK_B == m_CurrentBlock) && (m_BlockData[m_CurrentBlock] & GROUPB_BIT) )
-						m_BGroupOffset = 4;
-					else
-						m_BGroupOffset = 0;
-					if(m_CurrentBlock >= BLOCK_D)
-					{	//good chkword on all 4 blocks in correct sequence so are sure of bit position
-						//Place all group data into data queue
-						m_RdsGroupQueue[m_RdsQHead].BlockA = m_BlockData[BLOCK_A];
-						m_RdsGroupQueue[m_RdsQHead].BlockB = m_BlockData[BLOCK_B];
-						m_RdsGroupQueue[m_RdsQHead].BlockC = m_BlockData[BLOCK_C];
-						m_RdsGroupQueue[m_RdsQHead++].BlockD = m_BlockData[BLOCK_D];
-						if(m_RdsQHead >= RDS_Q_SIZE )
-							m_RdsQHead = 0;
-						m_CurrentBlock = BLOCK_A;
-						m_BlockErrors = 0;
-						m_DecodeState = STATE_GROUPDECODE;
-					}
-					else
-						m_CurrentBlock++;
-				}
-			}
-			break;
-		case STATE_GROUPDECODE:		//here after getting a good sequence of blocks
-			m_CurrentBitPosition++;
-			if(m_CurrentBitPosition>=NUMBITS_BLOCK)
-			{
-				m_CurrentBitPosition = 0;
-				if( CheckBlock(BLK_OFFSET_TBL[m_CurrentBlock+m_BGroupOffset], USE_FEC ) )
-				{
-					m_BlockErrors++;
-					if( m_BlockErrors > BLOCK_ERROR_LIMIT  )
-					{
-						m_RdsQHead = m_RdsQTail = 0;	//clear data queue
-						m_RdsGroupQueue[m_RdsQHead].BlockA = 0;	//stuff all zeros in que to indicate
-						m_RdsGroupQueue[m_RdsQHead].BlockB = 0;	//loss of signal
-						m_RdsGroupQueue[m_RdsQHead].BlockC = 0;
-						m_RdsGroupQueue[m_RdsQHead++].BlockD = 0;
-						m_DecodeState = STATE_BITSYNC;
-					}
-					else
-					{
-						m_CurrentBlock++;
-						if(m_CurrentBlock>BLOCK_D)
-							m_CurrentBlock = BLOCK_A;
-						if( BLOCK_A != m_CurrentBlock )	//skip remaining blocks of this group if error
-							m_DecodeState = STATE_GROUPRESYNC;
-					}
-				}
-				else
-				{	//good block so save and get ready for next one
-					m_BlockData[m_CurrentBlock] = m_InBitStream>>NUMBITS_CRC;	//save msg data
-					//see if is group A or Group B
-					if( (BLOCK_B == m_CurrentBlock) && (m_BlockData[m_CurrentBlock] & GROUPB_BIT) )
-						m_BGroupOffset = 4;
-					else
-						m_BGroupOffset = 0;
-					m_CurrentBlock++;
-					if(m_CurrentBlock>BLOCK_D)
-					{
-						//Place all group data into data queue
-						m_RdsGroupQueue[m_RdsQHead].BlockA = m_BlockData[BLOCK_A];
-						m_RdsGroupQueue[m_RdsQHead].BlockB = m_BlockData[BLOCK_B];
-						m_RdsGroupQueue[m_RdsQHead].BlockC = m_BlockData[BLOCK_C];
-						m_RdsGroupQueue[m_RdsQHead++].BlockD = m_BlockData[BLOCK_D];
-						if(m_RdsQHead >= RDS_Q_SIZE )
-							m_RdsQHead = 0;
-						m_CurrentBlock = BLOCK_A;
-						m_BlockErrors = 0;
-						//here with complete good group
-					}
-				}
-			}
-			break;
-		case STATE_GROUPRESYNC:		//ignor blocks until start of next group
-			m_CurrentBitPosition++;
-			if(m_CurrentBitPosition>=NUMBITS_BLOCK)
-			{
-				m_CurrentBitPosition = 0;
-				m_CurrentBlock++;
-				if(m_CurrentBlock>BLOCK_D)
-				{
-					m_CurrentBlock = BLOCK_A;
-					m_DecodeState = STATE_GROUPDECODE;
-				}
-			}
-			break;
-	}
-}
-
-/////////////////////////////////////////////////////////////////////////////////
-//	Check block 'm_InBitStream' with 'BlockOffset' for errors.
-// if UseFec is false then no FEC is done else correct up to 5 bits.
-// Returns zero if no remaining errors if FEC is specified.
-/////////////////////////////////////////////////////////////////////////////////
-quint32 CWFmDemod::CheckBlock(quint32 SyndromeOffset, int UseFec)
-{
-	//First calculate syndrome for current 26 m_InBitStream bits
-	quint32 testblock = (0x3FFFFFF & m_InBitStream);	//isolate bottom 26 bits
-	//copy top 10 bits of block into 10 syndrome bits since first 10 rows
-	//of the check matrix is just an identity matrix(diagonal one's)
-	quint32 syndrome = testblock>>16;
-	for(int i=0; i<NUMBITS_MSG; i++)
-	{	//do the 16 remaining bits of the check matrix multiply
-		if(testblock&0x8000)
-			syndrome ^= PARCKH[i];
-		testblock <<= 1;
-	}
-	syndrome ^= SyndromeOffset;		//add depending on desired block
-
-	if(syndrome && UseFec)	//if errors and can use FEC
-	{
-		quint32 correctedbits = 0;
-		quint32 correctmask = (1<<(NUMBITS_BLOCK-1));	//start pointing to msg msb
-		//Run Meggitt FEC algorithm to correct up to 5 consecutive burst errors
-		for(int i=0; i<NUMBITS_MSG; i++)
-		{
-			if(syndrome & 0x200)	//chk msbit of syndrome for error state
-			{	//is possible bit error at current position
-				if(0 == (syndrome & 0x1F) ) //bottom 5 bits == 0 tell it is correctable
-				{	// Correct i-th bit
-					m_InBitStream ^= correctmask;
-					correctedbits++;
-					syndrome <<= 1;		//shift syndrome to next msb
-				}
-				else
-				{
-					syndrome <<= 1;	//shift syndrome to next msb
-					syndrome ^= CRC_POLY;	//recalculate new syndrome if bottom 5 bits not zero
-				}							//and syndrome msb bit was a one
-			}
-			else
-			{	//no error at this bit position so just shift to next position
-				syndrome <<= 1;	//shift syndrome to next msb
-			}
-			correctmask >>= 1;	//advance correctable bit position
-		}
-		syndrome &= 0x3FF;	//isolate syndrome bits if non-zero then still an error
-	}
-	return syndrome;
-}
-
-/////////////////////////////////////////////////////////////////////////////////
-// Get next group data from RDS data queue.
-// Returns zero if queue is empty or null pointer passed or data has not changed
-/////////////////////////////////////////////////////////////////////////////////
-bool CWFmDemod::GetNextRdsGroupData(tRDS_GROUPS* pGroupData)
-{
-	if( (m_RdsQHead == m_RdsQTail) || (NULL == pGroupData) )
-	{
-		return false;
-	}
-	pGroupData->BlockA = m_RdsGroupQueue[m_RdsQTail].BlockA;
-	pGroupData->BlockB = m_RdsGroupQueue[m_RdsQTail].BlockB;
-	pGroupData->BlockC = m_RdsGroupQueue[m_RdsQTail].BlockC;
-	pGroupData->BlockD = m_RdsGroupQueue[m_RdsQTail++].BlockD;
-	if(m_RdsQTail >= RDS_Q_SIZE )
-		m_RdsQTail = 0;
-	if( (m_LastRdsGroup.BlockA != pGroupData->BlockA) ||
-		(m_LastRdsGroup.BlockB != pGroupData->BlockB) ||
-		(m_LastRdsGroup.BlockC != pGroupData->BlockC) ||
-		(m_LastRdsGroup.BlockD != pGroupData->BlockD) )
-	{
-		m_LastRdsGroup = *pGroupData;
-		return true;
-	}
-	else
-        return false;
+	OnePoleLowPass(InLength, m_DeemphasisAlpha, 2.0, Ave, InBuf, OutBuf);
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -865,3 +567,5 @@ TYPEREAL angle;
 	}
 	return angle;
 }
+
+} // namespace FMDSP_NAMESPACE
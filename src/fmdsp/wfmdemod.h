@@ -38,13 +38,36 @@
 #include "datatypes.h"
 #include "fir.h"
 #include "iir.h"
+#include "discriminator.h"
 #include "downconvert.h"
-#include "rbdsconstants.h"
+#include "rdsdemod.h"
+#include <functional>
+
+namespace FMDSP_NAMESPACE {
 
 
 #define PHZBUF_SIZE 16384
+#define PILOT_TABLE_SIZE 1024	//length of the pilot PLL NCO sine table, must be a power of 2
+#define SIDE_FLUSH_TIME 0.02	//seconds of silence run through the side audio chain after the pilot is lost
+
+#define WFM_AUDIO_ASTOP 60.0		//audio low pass filter stopband attenuation
+#define WFM_AUDIO_FPASS 15000.0		//audio low pass filter passband edge
+#define WFM_AUDIO_FSTOP 21000.0		//audio low pass filter stopband edge
+#define WFM_FUSED_FSTOP 19000.0		//stopband edge for a low pass filter that also replaces the 19KHz pilot notch
 
-#define RDS_Q_SIZE 100
+//receives the complex composite signal for RDS processing outside of the demodulator
+typedef std::function<void(int InLength, const TYPECPX* pData)> tCompositeSink;
+
+//post demod audio filters for one real channel
+typedef struct _ac
+{
+	CDecimateBy2* pDecBy2A;
+	CDecimateBy2* pDecBy2B;
+	CDecimateBy2* pDecBy2C;
+	CFir LPFilter;
+	CIir NotchFilter;
+	TYPEREAL DeemphasisAve;
+}tAudioChain;
 
 class CWFmDemod
 {
@@ -57,41 +80,45 @@ public:
 	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
 	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
 	TYPEREAL GetDemodRate(){return m_OutRate;}
-
-	bool GetNextRdsGroupData(tRDS_GROUPS* pGroupData);
+	bool SetDiscriminator(int Type);	//DISC_ATAN2 or DISC_POLYATAN2, returns false for DISC_POLAR
+
+	//when a sink is set the composite signal is handed to it instead of the built in RDS demodulator
+	void SetCompositeSink(tCompositeSink const& Sink){m_CompositeSink = Sink;}
+	TYPEREAL GetCompositeRate(){return m_SampleRate;}
+	//when disabled the composite signal is not processed for RDS at all
+	void SetRdsEnabled(bool Enabled){m_RdsEnabled = Enabled;}
+	//when disabled the audio is not low pass filtered or pilot notched, the caller must
+	//do it, typically with a low pass filter from WFM_AUDIO_FPASS to WFM_FUSED_FSTOP
+	void SetAudioFilterEnabled(bool Enabled){m_AudioFilterEnabled = Enabled;}
+
+	bool GetNextRdsGroupData(tRDS_GROUPS* pGroupData){return m_RdsDemod.GetNextRdsGroupData(pGroupData);}
 	int GetStereoLock(int* pPilotLock);
 
 private:
+	void InitAudioChain(tAudioChain& Chain);
+	void DeleteAudioChain(tAudioChain& Chain);
+	int ProcessAudioChain(tAudioChain& Chain, int InLength, TYPEREAL* pData);
+	void ProcessComposite(int InLength);
 	void InitDeemphasis( TYPEREAL Time, TYPEREAL SampleRate);	//create De-emphasis LP filter
-	void ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf);
-	void ProcessDeemphasisFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
+	void ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf, TYPEREAL& Ave);
 	void InitPilotPll( TYPEREAL SampleRate );
 	bool ProcessPilotPll( int InLength, TYPECPX* pInData );
-	void InitRds( TYPEREAL SampleRate );
-	void ProcessRdsPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData );
+	inline void PilotNcoSinCos(TYPEREAL Phase, TYPEREAL* pSin, TYPEREAL* pCos);
 	inline TYPEREAL arctan2(TYPEREAL y, TYPEREAL x);
 
-	void ProcessNewRdsBit(int bit);
-	quint32 CheckBlock(quint32 BlockOffset, int UseFec);
-
 	TYPEREAL m_SampleRate;
 	TYPEREAL m_OutRate;
 	TYPEREAL m_RawFm[PHZBUF_SIZE];
 	TYPECPX m_CpxRawFm[PHZBUF_SIZE];
-	CDecimateBy2* m_pDecBy2A;
-	CDecimateBy2* m_pDecBy2B;
-	CDecimateBy2* m_pDecBy2C;
+	tAudioChain m_MidChain;		//L+R audio
+	tAudioChain m_SideChain;	//L-R audio, only run while the pilot is locked
+	int m_SideFlush;			//samples left to flush through the side chain after losing the pilot
 
-	TYPECPX m_D0;		//complex delay line variables
-	TYPECPX m_D1;
+	CFmDiscriminator m_Discriminator;
 
-	TYPEREAL m_DeemphasisAveRe;
-	TYPEREAL m_DeemphasisAveIm;
 	TYPEREAL m_DeemphasisAlpha;
 
 	CIir m_MonoLPFilter;
-	CFir m_LPFilter;
-	CIir m_NotchFilter;
 	CIir m_PilotBPFilter;
 	CFir m_HilbertFilter;
 
@@ -105,41 +132,18 @@ private:
 	TYPEREAL m_PilotPllBeta;
 	TYPEREAL m_PhaseErrorMagAve;
 	TYPEREAL m_PhaseErrorMagAlpha;
-	TYPEREAL m_PilotPhase[PHZBUF_SIZE];
+	TYPEREAL m_Pilot38[PHZBUF_SIZE];	//recovered 38KHz stereo subcarrier
 	TYPEREAL m_PilotPhaseAdjust;
-
-	TYPEREAL m_RdsNcoPhase;		//variables for RDS PLL
-	TYPEREAL m_RdsNcoFreq;
-	TYPEREAL m_RdsNcoLLimit;
-	TYPEREAL m_RdsNcoHLimit;
-	TYPEREAL m_RdsPllAlpha;
-	TYPEREAL m_RdsPllBeta;
-
-	TYPECPX m_RdsRaw[PHZBUF_SIZE];	//variables for RDS processing
-	TYPEREAL m_RdsMag[PHZBUF_SIZE];
-	TYPEREAL m_RdsData[PHZBUF_SIZE];
-	TYPEREAL m_RdsMatchCoef[PHZBUF_SIZE];
-	TYPEREAL m_RdsLastSync;
-	TYPEREAL m_RdsLastSyncSlope;
-	TYPEREAL m_RdsLastData;
-	int m_MatchCoefLength;
-	CDownConvert m_RdsDownConvert;
-	CFir m_RdsBPFilter;
-	CFir m_RdsMatchedFilter;
-	CIir m_RdsBitSyncFilter;
-	TYPEREAL m_RdsOutputRate;
-	int m_RdsLastBit;
-	tRDS_GROUPS m_RdsGroupQueue[RDS_Q_SIZE];
-	int m_RdsQHead;
-	int m_RdsQTail;
-	tRDS_GROUPS m_LastRdsGroup;
-	quint32 m_InBitStream;	//input shift register for incoming raw data
-	int m_CurrentBlock;
-	int m_CurrentBitPosition;
-	int m_DecodeState;
-	int m_BGroupOffset;
-	int m_BlockErrors;
-	quint16 m_BlockData[4];
+	TYPEREAL m_Pilot38AdjustSin;		//sin and cos of twice the pilot phase adjustment
+	TYPEREAL m_Pilot38AdjustCos;
+	TYPEREAL m_PilotSinTable[PILOT_TABLE_SIZE];
+
+	bool m_RdsEnabled;
+	bool m_AudioFilterEnabled;
+	CRdsDemod m_RdsDemod;
+	tCompositeSink m_CompositeSink;
 };
 
+} // namespace FMDSP_NAMESPACE
+
 #endif // WFMDEMOD_H
@@ -29,6 +29,7 @@
 
 #include "align.h"
 #include "fmdsp/fft.h"
+#include "fmdsp/iqconvert.h"
 
 #pragma warning(push, 4)
 
@@ -210,7 +211,7 @@ void fmmeter::start(TYPEREAL maxdb, TYPEREAL mindb, size_t height, size_t width)
 	// Define and launch the I/Q signal meter thread
 	m_worker = std::thread([&](TYPEREAL maxdb, TYPEREAL mindb, size_t height, size_t width) -> void {
 
-		CFft			fft;				// Fast fourier transform instance
+		FMDSP_NAMESPACE::CFft	fft;				// Fast fourier transform instance
 
 		// The FFT size (number of bins) needs to be a power of two equal to or larger
 		// than the output width; start at 512 and increase until we find that
@@ -254,21 +255,7 @@ void fmmeter::start(TYPEREAL maxdb, TYPEREAL mindb, size_t height, size_t width)
 				if((++iterations % m_onstatusrate) == 0) {
 					
 					// Convert the raw 8-bit I/Q samples into scaled complex I/Q samples
-					for(size_t index = 0; index < numsamples; index++) {
-
-						// The demodulator expects the I/Q samples in the range of -32767.0 through +32767.0
-						// (32767.0 / 127.5) = 256.9960784313725
-						samples[index] = {
-
-						#ifdef FMDSP_USE_DOUBLE_PRECISION
-							(static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5) * 256.9960784313725,		// I
-							(static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5) * 256.9960784313725,	// Q
-						#else
-							(static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5f) * 256.9960784313725f,		// I
-							(static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5f) * 256.9960784313725f,	// Q
-						#endif
-						};
-					}
+					FMDSP_NAMESPACE::ConvertIQ8(static_cast<int>(numsamples), &buffer[0], &samples[0]);
 
 					// Put the I/Q samples into the fast fourier transform instance (numsamples is aligned to fftsize)
 					size_t index = 0;
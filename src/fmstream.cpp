@@ -32,9 +32,26 @@
 
 #pragma warning(push, 4)
 
+namespace FMDSP_NAMESPACE {
+
+// fmstream::COMPOSITE_BLOCK_SIZE
+//
+// Number of composite samples in each block passed to the RDS thread
+size_t const fmstream::COMPOSITE_BLOCK_SIZE = 4096;
+
+// fmstream::MAX_COMPOSITE_QUEUE
+//
+// Maximum number of queued composite sample blocks for the RDS thread
+size_t const fmstream::MAX_COMPOSITE_QUEUE = 64;		// ~0.65sec at 400KHz
+
+// fmstream::MAX_NATIVE_SAMPLERATE
+//
+// Maximum native demodulator output sample rate to report as the PCM sample rate
+uint32_t const fmstream::MAX_NATIVE_SAMPLERATE = 192000;
+
 // fmstream::MAX_SAMPLE_QUEUE
 //
-// Maximum number of queued sample sets from the device
+// Maximum number of queued sample blocks from the device
 size_t const fmstream::MAX_SAMPLE_QUEUE = 200;		// ~2sec
 
 // fmstream::STREAM_ID_AUDIO
@@ -59,7 +76,7 @@ int const fmstream::STREAM_ID_UECP = 2;
 
 fmstream::fmstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops, 
 	struct channelprops const& channelprops, struct fmprops const& fmprops) :
-	m_device(std::move(device)), m_decoderds(fmprops.decoderds), m_rdsdecoder(fmprops.isrbds),
+	m_device(std::move(device)), m_decoderds(fmprops.decoderds), m_forcemono(fmprops.forcemono || fmprops.fixedpoint), m_rdsdecoder(fmprops.isrbds),
 	m_muxname(generate_mux_name(channelprops)), m_pcmsamplerate(fmprops.outputrate), 
 	m_pcmgain(MPOW(10.0, (fmprops.outputgain / 10.0)))
 {
@@ -67,9 +84,9 @@ fmstream::fmstream(std::unique_ptr<rtldevice> device, struct tunerprops const& t
 	if((tunerprops.samplerate < 900001) || (tunerprops.samplerate > 3200000))
 		throw string_exception(__func__, ": Tuner device sample rate must be in the range of 900001Hz to 3200000Hz");
 
-	// The only allowable output sample rates for this stream are 44100Hz and 48000Hz
-	if((m_pcmsamplerate != 44100) && (m_pcmsamplerate != 48000))
-		throw string_exception(__func__, ": DSP output sample rate must be set to either 44.1KHz or 48.0KHz");
+	// The only allowable output sample rates for this stream are 44100Hz, 48000Hz or zero for the native rate
+	if((m_pcmsamplerate != 0) && (m_pcmsamplerate != 44100) && (m_pcmsamplerate != 48000))
+		throw string_exception(__func__, ": DSP output sample rate must be set to either 44.1KHz, 48.0KHz or native");
 
 	// Initialize the RTL-SDR device instance
 	m_device->set_frequency_correction(tunerprops.freqcorrection);
@@ -85,21 +102,135 @@ fmstream::fmstream(std::unique_ptr<rtldevice> device, struct tunerprops const& t
 	demodinfo.SquelchValue = -160;
 	demodinfo.WfmDownsampleQuality = static_cast<enum DownsampleQuality>(fmprops.downsamplequality);
 
-	// Initialize the wideband FM demodulator
-	m_demodulator = std::unique_ptr<CDemodulator>(new CDemodulator());
-	m_demodulator->SetUSFmVersion(fmprops.isrbds);
-	m_demodulator->SetInputSampleRate(static_cast<TYPEREAL>(samplerate));
-	m_demodulator->SetDemod(DEMOD_WFM, demodinfo);
-	m_demodulator->SetDemodFreq(static_cast<TYPEREAL>(frequency - channelprops.frequency));
+	// Initialize the wideband FM demodulator; the fixed point demodulator only produces mono audio
+	if(fmprops.fixedpoint) {
+
+		m_fixeddemod = std::unique_ptr<CFixedDemodulator>(new CFixedDemodulator());
+		m_fixeddemod->SetSampleRate(static_cast<TYPEREAL>(samplerate), demodinfo.WfmDownsampleQuality, fmprops.isrbds);
+		m_fixeddemod->SetDemodFreq(static_cast<TYPEREAL>(frequency - channelprops.frequency));
+	}
+
+	else {
+
+		m_demodulator = std::unique_ptr<CDemodulator>(new CDemodulator());
+		m_demodulator->SetUSFmVersion(fmprops.isrbds);
+		m_demodulator->SetInputSampleRate(static_cast<TYPEREAL>(samplerate));
+		m_demodulator->SetDemod(DEMOD_WFM, demodinfo);
+		m_demodulator->SetDemodFreq(static_cast<TYPEREAL>(frequency - channelprops.frequency));
+	}
+
+	int const inbuflimit = (m_fixeddemod) ? m_fixeddemod->GetInputBufferLimit() : m_demodulator->GetInputBufferLimit();
 
-	// Initialize the output resampler
-	m_resampler = std::unique_ptr<CFractResampler>(new CFractResampler());
-	m_resampler->Init(m_demodulator->GetInputBufferLimit());
+	// A PCM output sample rate of zero selects the native demodulator output rate, native rates
+	// that aren't whole numbers or are too high to be played back fall back to 48KHz
+	TYPEREAL const demodrate = (m_fixeddemod) ? m_fixeddemod->GetOutputRate() : m_demodulator->GetOutputRate();
+	if(m_pcmsamplerate == 0) {
+
+		uint32_t const nativerate = static_cast<uint32_t>(demodrate);
+		m_pcmsamplerate = ((static_cast<TYPEREAL>(nativerate) == demodrate) && (nativerate <= MAX_NATIVE_SAMPLERATE)) ? nativerate : 48000;
+	}
+
+	// The fixed point resampler always does the audio low-pass and pilot notch filtering, the
+	// fixed point demodulator has no audio filter of its own
+	if(m_fixeddemod) {
+
+		m_fixedresampler = std::unique_ptr<CFixedResampler>(new CFixedResampler());
+		if(!m_fixedresampler->InitLowPass(demodrate, static_cast<TYPEREAL>(m_pcmsamplerate), WFM_AUDIO_ASTOP, WFM_AUDIO_FPASS, WFM_FUSED_FSTOP))
+			throw string_exception(__func__, ": Fixed point DSP does not support the tuner device sample rate");
+	}
+
+	else {
+
+		// Initialize the output resampler
+		m_polyresampler = std::unique_ptr<CPolyResampler>(new CPolyResampler());
+
+		// When the output rate matches the demodulator rate the resampler only converts the samples
+		if(static_cast<TYPEREAL>(m_pcmsamplerate) == demodrate) m_polyresampler->Init(demodrate, demodrate);
+
+		// Otherwise the rational polyphase resampler also does the audio low-pass and pilot notch filtering
+		else if(m_polyresampler->InitLowPass(demodrate, static_cast<TYPEREAL>(m_pcmsamplerate), WFM_AUDIO_ASTOP, 
+			WFM_AUDIO_FPASS, WFM_FUSED_FSTOP)) m_demodulator->SetAudioFilterEnabled(false);
+
+		// The fractional resampler is only used when the rates don't reduce to a ratio the rational
+		// polyphase resampler can handle
+		else {
+
+			m_polyresampler.reset();
+			m_resampler = std::unique_ptr<CFractResampler>(new CFractResampler());
+			m_resampler->Init(inbuflimit);
+		}
+	}
+
+	// Preallocate the ring of raw I/Q sample blocks, the I/Q samples from the device
+	// come in as a pair of 8 bit unsigned integers per sample
+	m_blocks = std::unique_ptr<blockring<uint8_t>>(new blockring<uint8_t>(MAX_SAMPLE_QUEUE, inbuflimit * 2));
+
+	// Preallocate the buffer required to receive the demodulated samples, mono audio is
+	// produced by the real-valued demodulator path that skips the stereo decoding
+	if(m_fixeddemod) m_fixedsamples = std::unique_ptr<qint16[]>(new qint16[inbuflimit]);
+	else if(m_forcemono) m_monosamples = std::unique_ptr<TYPEREAL[]>(new TYPEREAL[inbuflimit]);
+	else m_samples = std::unique_ptr<TYPECPX[]>(new TYPECPX[inbuflimit]);
+
+	// If RDS decoding has been disabled, bypass the entire RDS signal chain
+	if(m_demodulator) m_demodulator->SetRdsEnabled(m_decoderds);
+
+	// Initialize the RDS demodulator and the ring of composite sample blocks that feeds it
+	if(m_decoderds) {
+
+		m_rdsdemod = std::unique_ptr<CRdsDemod>(new CRdsDemod());
+		m_rdsdemod->SetSampleRate((m_fixeddemod) ? m_fixeddemod->GetCompositeRate() : m_demodulator->GetCompositeRate());
+		m_composite = std::unique_ptr<blockring<TYPECPX>>(new blockring<TYPECPX>(MAX_COMPOSITE_QUEUE, COMPOSITE_BLOCK_SIZE));
+
+		// The composite signal is handed off to the RDS thread rather than being demodulated
+		// inline with the audio.  If there are no free blocks left in the ring the RDS thread
+		// isn't keeping up; the ring flags this as an overrun and the samples are discarded
+		if(m_demodulator) m_demodulator->SetCompositeSink([this](int length, TYPECPX const* samples) -> void {
+
+			while(length > 0) {
+
+				TYPECPX* block = m_composite->acquire();
+				if(block == nullptr) return;
+
+				size_t count = std::min(static_cast<size_t>(length), COMPOSITE_BLOCK_SIZE);
+				memcpy(block, samples, count * sizeof(TYPECPX));
+				m_composite->commit(count);
+
+				samples += count;
+				length -= static_cast<int>(count);
+			}
+		});
+
+		// The fixed point composite signal is real rather than the analytic signal produced by the
+		// floating point demodulator, which has twice the amplitude at the positive frequencies
+		else m_fixeddemod->SetCompositeSink([this](int length, qint16 const* samples) -> void {
+
+			TYPEREAL const scale = 2.0 * CFixedDemodulator::GetCompositeScale();
+			while(length > 0) {
+
+				TYPECPX* block = m_composite->acquire();
+				if(block == nullptr) return;
+
+				size_t count = std::min(static_cast<size_t>(length), COMPOSITE_BLOCK_SIZE);
+				for(size_t index = 0; index < count; index++) {
+
+					block[index].re = samples[index] * scale;
+					block[index].im = 0;
+				}
+				m_composite->commit(count);
+
+				samples += count;
+				length -= static_cast<int>(count);
+			}
+		});
+	}
 
 	// Adjust the device gain as specified by the channel properties
 	m_device->set_automatic_gain_control(channelprops.autogain);
 	if(channelprops.autogain == false) m_device->set_gain(channelprops.manualgain);
 
+	// Create a worker thread on which to perform the RDS demodulation and decoding
+	if(m_decoderds) m_rdsworker = std::thread(&fmstream::rdstransfer, this);
+
 	// Create a worker thread on which to perform the transfer operations
 	scalar_condition<bool> started{ false };
 	m_worker = std::thread(&fmstream::transfer, this, std::ref(started));
@@ -143,6 +274,10 @@ void fmstream::close(void)
 	if(m_device) m_device->cancel_async();		// Cancel any async read operations
 	if(m_worker.joinable()) m_worker.join();	// Wait for thread
 	m_device.reset();							// Release RTL-SDR device
+
+	m_rdsstopped.store(true);							// Signal RDS thread to stop
+	if(m_composite) m_composite->notify();				// Unblock the RDS thread
+	if(m_rdsworker.joinable()) m_rdsworker.join();		// Wait for RDS thread
 }
 
 //---------------------------------------------------------------------------
@@ -163,6 +298,24 @@ std::unique_ptr<fmstream> fmstream::create(std::unique_ptr<rtldevice> device, st
 	return std::unique_ptr<fmstream>(new fmstream(std::move(device), tunerprops, channelprops, fmprops));
 }
 
+//---------------------------------------------------------------------------
+// create_fmstream
+//
+// Creates a new fmstream instance for this DSP precision
+//
+// Arguments:
+//
+//	device			- RTL-SDR device instance
+//	tunerprops		- Tunder device properties
+//	channelprops	- Channel properties
+//	fmprops			- FM digital signal processor properties
+
+std::unique_ptr<pvrstream> create_fmstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops,
+	struct channelprops const& channelprops, struct fmprops const& fmprops)
+{
+	return fmstream::create(std::move(device), tunerprops, channelprops, fmprops);
+}
+
 //---------------------------------------------------------------------------
 // fmstream::demuxabort
 //
@@ -200,31 +353,35 @@ void fmstream::demuxflush(void)
 
 DEMUX_PACKET* fmstream::demuxread(std::function<DEMUX_PACKET*(int)> const& allocator)
 {
-	// If there is an RDS UECP packet available, handle it before demodulating more audio
+	// If the RDS thread stopped because of an exception, re-throw it the same way as an
+	// exception on the transfer thread
+	if((m_rdsstopped.load() == true) && (m_rdsworker_exception)) std::rethrow_exception(m_rdsworker_exception);
+
+	// If there is an RDS UECP packet available, handle it before demodulating more audio.
+	// When RDS decoding is disabled the RDS signal chain doesn't run at all, so there's
+	// never anything for the decoder to produce
 	uecp_data_packet uecp_packet;
-	if(m_rdsdecoder.pop_uecp_data_packet(uecp_packet) && (!uecp_packet.empty())) {
+	std::unique_lock<std::mutex> rdslock(m_rdslock);
+	bool haveuecp = (m_decoderds) && m_rdsdecoder.pop_uecp_data_packet(uecp_packet);
+	rdslock.unlock();
 
-		// The user may have opted to disable RDS.  The packet from the decoder still
-		// needs to be popped from the queue, but don't do anything with it ...
-		if(m_decoderds) {
+	if(haveuecp && (!uecp_packet.empty())) {
 
-			// Allocate and initialize the UECP demultiplexer packet
-			int packetsize = static_cast<int>(uecp_packet.size());
-			DEMUX_PACKET* packet = allocator(packetsize);
-			if(packet == nullptr) return nullptr;
+		// Allocate and initialize the UECP demultiplexer packet
+		int packetsize = static_cast<int>(uecp_packet.size());
+		DEMUX_PACKET* packet = allocator(packetsize);
+		if(packet == nullptr) return nullptr;
 
-			packet->iStreamId = STREAM_ID_UECP;
-			packet->iSize = packetsize;
+		packet->iStreamId = STREAM_ID_UECP;
+		packet->iSize = packetsize;
 
-			// Copy the UECP data into the demultiplexer packet and return it
-			memcpy(packet->pData, uecp_packet.data(), uecp_packet.size());
-			return packet;
-		}
+		// Copy the UECP data into the demultiplexer packet and return it
+		memcpy(packet->pData, uecp_packet.data(), uecp_packet.size());
+		return packet;
 	}
 
-	// Wait for there to be a packet of samples available for processing
-	std::unique_lock<std::mutex> lock(m_queuelock);
-	m_cv.wait(lock, [&]() -> bool { return ((m_queue.size() > 0) || m_stopped.load() == true); });
+	// Wait for there to be a block of samples available for processing
+	m_blocks->wait([&]() -> bool { return m_stopped.load() == true; });
 
 	// If the worker thread was stopped, check for and re-throw any exception that occurred,
 	// otherwise assume it was stopped normally and return an empty demultiplexer packet
@@ -234,13 +391,20 @@ DEMUX_PACKET* fmstream::demuxread(std::function<DEMUX_PACKET*(int)> const& alloc
 		else return allocator(0);
 	}
 
-	// Pop off the topmost packet of samples from the queue<> and release the lock
-	std::unique_ptr<TYPECPX[]> samples(std::move(m_queue.front()));
-	m_queue.pop();
-	lock.unlock();
+	// If the ring overran, the samples aren't being processed quickly enough to keep up
+	// with the rate; discard the backlog of samples in favor of a resync packet
+	bool resync = m_blocks->overrun();
+	if(resync) m_blocks->clear();
+
+	// Access the topmost block of samples from the ring; it remains owned by this thread
+	// until it has been released back to the writer with pop()
+	size_t length = 0;
+	uint8_t const* block = (resync) ? nullptr : m_blocks->front(length);
 
-	// If the packet of samples is null, the writer has indicated there was a problem
-	if(!samples) {
+	// If the block of samples is empty, the writer has indicated there was a problem
+	if((resync) || (length == 0)) {
+
+		if(!resync) m_blocks->pop();
 
 		m_dts = STREAM_TIME_BASE;			// Reset the current decode time stamp
 
@@ -251,28 +415,49 @@ DEMUX_PACKET* fmstream::demuxread(std::function<DEMUX_PACKET*(int)> const& alloc
 		return packet;				// Return the generated packet
 	}
 
-	// Process the I/Q data, the original samples buffer can be reused/overwritten as it's processed
-	int audiopackets = m_demodulator->ProcessData(m_demodulator->GetInputBufferLimit(), samples.get(), samples.get());
+	// Process the raw I/Q data directly from the block, the demodulator handles the
+	// conversion into floating-point samples as part of down converting them
+	int audiopackets = (m_fixeddemod) ? m_fixeddemod->ProcessData(m_fixeddemod->GetInputBufferLimit(), block, m_fixedsamples.get()) :
+		(m_forcemono) ? m_demodulator->ProcessData(m_demodulator->GetInputBufferLimit(), block, m_monosamples.get()) :
+		m_demodulator->ProcessData(m_demodulator->GetInputBufferLimit(), block, m_samples.get());
 
-	// Process any RDS group data that was collected during demodulation
-	tRDS_GROUPS rdsgroup = {};
-	while(m_demodulator->GetNextRdsGroupData(&rdsgroup)) m_rdsdecoder.decode_rdsgroup(rdsgroup);
+	// Release the block of samples back to the ring
+	m_blocks->pop();
 
 	// Determine the size of the demultiplexer packet data and allocate it
-	int packetsize = audiopackets * sizeof(TYPESTEREO16);
+	int const samplesize = (m_forcemono) ? sizeof(TYPEMONO16) : sizeof(TYPESTEREO16);
+	int packetsize = ((m_fixedresampler) ? m_fixedresampler->GetMaxOutputLength(audiopackets) : 
+		(m_polyresampler) ? m_polyresampler->GetMaxOutputLength(audiopackets) : audiopackets) * samplesize;
 	DEMUX_PACKET* packet = allocator(packetsize);
 	if(packet == nullptr) return nullptr;
 
-	// Resample the audio data directly into the allocated packet buffer
-	audiopackets = m_resampler->Resample(audiopackets, (m_demodulator->GetOutputRate() / m_pcmsamplerate),
-		samples.get(), reinterpret_cast<TYPESTEREO16*>(packet->pData), m_pcmgain);
+	// Resample the audio data directly into the allocated packet buffer, the fixed point samples are
+	// scaled to the levels of the floating point demodulator along with the output gain
+	if(m_fixedresampler) {
+
+		audiopackets = m_fixedresampler->Resample(audiopackets, m_fixedsamples.get(), reinterpret_cast<TYPEMONO16*>(packet->pData), 
+			m_pcmgain * CFixedDemodulator::GetOutputScale());
+	}
+
+	else if(m_polyresampler) {
+
+		audiopackets = (m_forcemono) ? m_polyresampler->Resample(audiopackets, m_monosamples.get(), reinterpret_cast<TYPEMONO16*>(packet->pData), m_pcmgain) :
+			m_polyresampler->Resample(audiopackets, m_samples.get(), reinterpret_cast<TYPESTEREO16*>(packet->pData), m_pcmgain);
+	}
+
+	else {
+
+		TYPEREAL const rate = m_demodulator->GetOutputRate() / m_pcmsamplerate;
+		audiopackets = (m_forcemono) ? m_resampler->Resample(audiopackets, rate, m_monosamples.get(), reinterpret_cast<TYPEMONO16*>(packet->pData), m_pcmgain) :
+			m_resampler->Resample(audiopackets, rate, m_samples.get(), reinterpret_cast<TYPESTEREO16*>(packet->pData), m_pcmgain);
+	}
 
 	// Calculate the proper duration for the packet
 	double duration = (audiopackets / static_cast<double>(m_pcmsamplerate)) * STREAM_TIME_BASE;
 
 	// Set up the demultiplexer packet with the proper size, duration and dts
 	packet->iStreamId = STREAM_ID_AUDIO;
-	packet->iSize = audiopackets * sizeof(TYPESTEREO16);
+	packet->iSize = audiopackets * samplesize;
 	packet->duration = duration;
 	packet->dts = packet->pts = m_dts;
 
@@ -325,7 +510,7 @@ void fmstream::enumproperties(std::function<void(struct streamprops const& props
 	streamprops audio = {};
 	audio.codec = "pcm_s16le";
 	audio.pid = STREAM_ID_AUDIO;
-	audio.channels = 2;
+	audio.channels = (m_forcemono) ? 1 : 2;
 	audio.samplerate = static_cast<int>(m_pcmsamplerate);
 	audio.bitspersample = 16;
 	callback(audio);
@@ -385,6 +570,7 @@ long long fmstream::length(void) const
 std::string fmstream::muxname(void) const
 {
 	// If the callsign for the station is known, use that with an -FM suffix, otherwise use the default
+	std::unique_lock<std::mutex> lock(m_rdslock);
 	return (m_rdsdecoder.has_rbds_callsign()) ? m_rdsdecoder.get_rbds_callsign() : m_muxname;
 }
 
@@ -474,7 +660,8 @@ void fmstream::signalquality(int& quality, int& snr) const
 	TYPEREAL demodquality = 0;
 	TYPEREAL demodsnr = 0;
 
-	m_demodulator->GetSignalLevels(demodquality, demodsnr);
+	if(m_fixeddemod) m_fixeddemod->GetSignalLevels(demodquality, demodsnr);
+	else m_demodulator->GetSignalLevels(demodquality, demodsnr);
 
 	// For wideband FM, adjust the range such that 80% is nominal for
 	// signal quality and 60% is nominal for signal-to-noise; this 
@@ -483,6 +670,54 @@ void fmstream::signalquality(int& quality, int& snr) const
 	snr = std::max(0, std::min(100, static_cast<int>(100.0 * (demodsnr / 0.60))));
 }
 
+//---------------------------------------------------------------------------
+// fmstream::rdstransfer (private)
+//
+// Worker thread procedure used to demodulate and decode the RDS data
+//
+// Arguments:
+//
+//	NONE
+
+void fmstream::rdstransfer(void)
+{
+	assert(m_rdsdemod);
+	assert(m_composite);
+
+	try {
+
+		while(true) {
+
+			// Wait for there to be a block of composite samples available for processing
+			m_composite->wait([&]() -> bool { return m_rdsstopped.load() == true; });
+			if(m_rdsstopped.load() == true) break;
+
+			// If the ring overran some composite samples were discarded; there is no need to
+			// resynchronize anything here, the RDS demodulator will reacquire the bit stream
+			m_composite->overrun();
+
+			// Demodulate the topmost block of composite samples and release it back to the ring
+			size_t length = 0;
+			TYPECPX const* block = m_composite->front(length);
+			m_rdsdemod->ProcessData(static_cast<int>(length), block);
+			m_composite->pop();
+
+			// Process any RDS group data that was collected during demodulation
+			tRDS_GROUPS rdsgroup = {};
+			std::unique_lock<std::mutex> lock(m_rdslock);
+			while(m_rdsdemod->GetNextRdsGroupData(&rdsgroup)) m_rdsdecoder.decode_rdsgroup(rdsgroup);
+		}
+	}
+
+	// Keep the exception for demuxread() to re-throw, flag the thread as stopped after
+	// it has been set so the reader sees it
+	catch(...) {
+
+		m_rdsworker_exception = std::current_exception();
+		m_rdsstopped.store(true);
+	}
+}
+
 //---------------------------------------------------------------------------
 // fmstream::transfer (private)
 //
@@ -494,54 +729,35 @@ void fmstream::signalquality(int& quality, int& snr) const
 
 void fmstream::transfer(scalar_condition<bool>& started)
 {
-	assert(m_demodulator);
+	assert(m_blocks);
 	assert(m_device);
 
-	// The I/Q samples from the device come in as a pair of 8 bit unsigned integers
-	size_t const readsize = m_demodulator->GetInputBufferLimit() * 2;
+	// The I/Q samples from the device come in as a pair of 8 bit unsigned integers, each
+	// block holds the number of samples the demodulator processes at a time
+	size_t const readsize = m_blocks->blocksize();
 
 	// read_callback_func (local)
 	//
 	// Asynchronous read callback function for the RTL-SDR device
 	auto read_callback_func = [&](uint8_t const* buffer, size_t count) -> void {
 
-		std::unique_ptr<TYPECPX[]> samples;			// Array of I/Q samples to return
+		// Acquire the next free block from the ring.  If there are no free blocks left, the samples
+		// aren't being processed quickly enough to keep up with the rate; the ring flags this as an
+		// overrun that will be handled by the reader, this set of samples is discarded
+		uint8_t* block = m_blocks->acquire();
+		if(block == nullptr) return;
 
-		// If the proper amount of data was returned by the callback, convert it into
-		// the floating-point I/Q sample data for the demodulator to process
+		// If the proper amount of data was returned by the callback, copy it into the block,
+		// otherwise commit an empty block to indicate to the reader that there was a problem
+		size_t length = 0;
 		if(count == readsize) {
 
-			samples = std::unique_ptr<TYPECPX[]>(new TYPECPX[readsize]);
-			for(int index = 0; index < m_demodulator->GetInputBufferLimit(); index++) {
-
-				// The demodulator expects the I/Q samples in the range of -32767.0 through +32767.0
-				// (32767.0 / 127.5) = 256.9960784313725
-				samples[index] = {
-
-				#ifdef FMDSP_USE_DOUBLE_PRECISION
-					(static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5) * 256.9960784313725,		// I
-					(static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5) * 256.9960784313725,	// Q
-				#else
-					(static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5f) * 256.9960784313725f,		// I
-					(static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5f) * 256.9960784313725f,	// Q
-				#endif
-				};
-			}
-		}
-
-		// Push the converted samples into the queue<> for processing.  If there is insufficient space
-		// left in the queue<>, the samples aren't being processed quickly enough to keep up with the rate
-		std::unique_lock<std::mutex> lock(m_queuelock);
-		if(m_queue.size() < MAX_SAMPLE_QUEUE) m_queue.push(std::move(samples));
-		else {
-
-			m_queue = sample_queue_t();							// Replace the queue<>
-			m_queue.push(nullptr);								// Push a resync packet (null)
-			if(samples) m_queue.push(std::move(samples));		// Push samples
+			memcpy(block, buffer, count);
+			length = count;
 		}
 
-		// Notify any threads waiting on the lock that the queue<> has been updated
-		m_cv.notify_all();
+		// Commit the block into the ring, this only wakes the reader if it's waiting for it
+		m_blocks->commit(length);
 	};
 
 	// Begin streaming from the device and inform the caller that the thread is running
@@ -553,9 +769,11 @@ void fmstream::transfer(scalar_condition<bool>& started)
 	catch(...) { m_worker_exception = std::current_exception(); }
 
 	m_stopped.store(true);					// Thread is stopped
-	m_cv.notify_all();						// Unblock any waiters
+	m_blocks->notify();						// Unblock any waiters
 }
 
 //---------------------------------------------------------------------------
 
+} // namespace FMDSP_NAMESPACE
+
 #pragma warning(pop)
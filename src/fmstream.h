@@ -25,15 +25,18 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 
 #include "fmdsp/demodulator.h"
+#include "fmdsp/fixeddemod.h"
+#include "fmdsp/fixedresampler.h"
 #include "fmdsp/fractresampler.h"
+#include "fmdsp/polyresampler.h"
+#include "fmdsp/rdsdemod.h"
 
+#include "blockring.h"
 #include "props.h"
 #include "pvrstream.h"
 #include "rdsdecoder.h"
@@ -42,6 +45,8 @@
 
 #pragma warning(push, 4)
 
+namespace FMDSP_NAMESPACE {
+
 //---------------------------------------------------------------------------
 // Class fmstream
 //
@@ -149,9 +154,24 @@ private:
 	fmstream(fmstream const&) = delete;
 	fmstream& operator=(fmstream const&) = delete;
 
+	// COMPOSITE_BLOCK_SIZE
+	//
+	// Number of composite samples in each block passed to the RDS thread
+	static size_t const COMPOSITE_BLOCK_SIZE;
+
+	// MAX_COMPOSITE_QUEUE
+	//
+	// Maximum number of queued composite sample blocks for the RDS thread
+	static size_t const MAX_COMPOSITE_QUEUE;
+
+	// MAX_NATIVE_SAMPLERATE
+	//
+	// Maximum native demodulator output sample rate to report as the PCM sample rate
+	static uint32_t const MAX_NATIVE_SAMPLERATE;
+
 	// MAX_SAMPLE_QUEUE
 	//
-	// Maximum number of queued sample sets from device
+	// Maximum number of queued sample blocks from device
 	static size_t const MAX_SAMPLE_QUEUE;
 
 	// STREAM_ID_AUDIO
@@ -169,19 +189,6 @@ private:
 	fmstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops, 
 		struct channelprops const& channelprops, struct fmprops const& fmprops);
 
-	//-----------------------------------------------------------------------
-	// Private Type Declarations
-
-	// sample_queue_item_t
-	//
-	// Defines the type of a single sample_queue_t entry
-	using sample_queue_item_t = std::unique_ptr<TYPECPX[]>;
-
-	// sample_queue_t
-	//
-	// Defines the type of the input sample queue
-	using sample_queue_t = std::queue<sample_queue_item_t>;
-
 	//-----------------------------------------------------------------------
 	// Private Member Functions
 
@@ -190,6 +197,11 @@ private:
 	// Generates the mux name to associate with the stream
 	std::string generate_mux_name(struct channelprops const& channelprops) const;
 
+	// rdstransfer
+	//
+	// Worker thread procedure used to demodulate and decode the RDS data
+	void rdstransfer(void);
+
 	// transfer
 	//
 	// Worker thread procedure used to transfer data into the ring buffer
@@ -201,27 +213,65 @@ private:
 	std::unique_ptr<rtldevice>			m_device;					// RTL-SDR device instance
 	std::unique_ptr<CDemodulator>		m_demodulator;				// CuteSDR demodulator instance
 	std::unique_ptr<CFractResampler>	m_resampler;				// CuteSDR resampler instance
+	std::unique_ptr<CPolyResampler>		m_polyresampler;			// Rational resampler instance
+	std::unique_ptr<CFixedDemodulator>	m_fixeddemod;				// Fixed point demodulator instance
+	std::unique_ptr<CFixedResampler>	m_fixedresampler;			// Fixed point resampler instance
 	bool const							m_decoderds;				// Flag to send decoded RDS data
+	bool const							m_forcemono;				// Flag to produce mono audio
 	rdsdecoder							m_rdsdecoder;				// RDS decoder instance
+	mutable std::mutex					m_rdslock;					// RDS decoder synchronization object
 
 	std::string	const					m_muxname;					// Default mux name for the stream
-	uint32_t const						m_pcmsamplerate;			// Output sample rate
+	uint32_t							m_pcmsamplerate;			// Output sample rate
 	TYPEREAL const						m_pcmgain;					// Output gain
 	double								m_dts{ STREAM_TIME_BASE };	// Current decode time stamp
 
 	// STREAM CONTROL
 	//
-	sample_queue_t						m_queue;					// queue<> of prepared samples
-	mutable std::mutex					m_queuelock;				// Synchronization object
-	std::condition_variable				m_cv;						// Transfer event condvar
+	std::unique_ptr<blockring<uint8_t>>	m_blocks;					// Ring of raw I/Q sample blocks
+	std::unique_ptr<TYPECPX[]>			m_samples;					// Demodulated samples
+	std::unique_ptr<TYPEREAL[]>			m_monosamples;				// Demodulated mono samples
+	std::unique_ptr<qint16[]>			m_fixedsamples;				// Fixed point demodulated samples
 	std::thread							m_worker;					// Data transfer thread
 	std::exception_ptr					m_worker_exception;			// Exception on worker thread
 	scalar_condition<bool>				m_stop{ false };			// Condition to stop data transfer
 	std::atomic<bool>					m_stopped{ false };			// Data transfer stopped flag
+
+	// RDS CONTROL
+	//
+	std::unique_ptr<CRdsDemod>			m_rdsdemod;					// CuteSDR RDS demodulator instance
+	std::unique_ptr<blockring<TYPECPX>>	m_composite;				// Ring of composite sample blocks
+	std::thread							m_rdsworker;				// RDS demodulation thread
+	std::exception_ptr					m_rdsworker_exception;		// Exception on RDS thread
+	std::atomic<bool>					m_rdsstopped{ false };		// RDS demodulation stopped flag
 };
 
 //-----------------------------------------------------------------------------
 
+} // namespace FMDSP_NAMESPACE
+
+//---------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//---------------------------------------------------------------------------
+
+// create_fmstream
+//
+// Creates a new fmstream instance; fmstream is compiled once for each DSP precision
+// (see dspsingle.cpp and dspdouble.cpp) and the caller selects which one to use
+namespace fmdsp_single {
+
+	std::unique_ptr<pvrstream> create_fmstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops,
+		struct channelprops const& channelprops, struct fmprops const& fmprops);
+};
+
+namespace fmdsp_double {
+
+	std::unique_ptr<pvrstream> create_fmstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops,
+		struct channelprops const& channelprops, struct fmprops const& fmprops);
+};
+
+//---------------------------------------------------------------------------
+
 #pragma warning(pop)
 
 #endif	// __FMSTREAM_H_
@@ -59,9 +59,12 @@ struct fmprops {
 
 	bool			decoderds;			// Flag if RDS should be decoded or not
 	bool			isrbds;				// Flag if region is RBDS (North America)
+	bool			forcemono;			// Flag if mono audio should be produced
 	int				downsamplequality;	// Downsample quality setting
 	uint32_t		outputrate;			// Output sample rate in Hertz
 	float			outputgain;			// Output gain in Decibels
+	bool			doubleprecision;	// Flag if double precision DSP should be used
+	bool			fixedpoint;			// Flag if fixed point DSP should be used
 };
 
 // streamprops
@@ -92,6 +95,7 @@ struct wxprops {
 
 	uint32_t		outputrate;			// Output sample rate in Hertz
 	float			outputgain;			// Output gain in Decibels
+	bool			doubleprecision;	// Flag if double precision DSP should be used
 };
 
 // get_channel_type (inline)
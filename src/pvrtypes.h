@@ -66,6 +66,17 @@ enum downsample_quality {
 	maximum = 2,			// Optimize for quality
 };
 
+// dsp_precision
+//
+// Defines the digital signal processor precision
+enum dsp_precision {
+
+	platformdefault = 0,	// Default precision for the platform
+	singleprecision = 1,	// Single precision (32-bit) floating point
+	doubleprecision = 2,	// Double precision (64-bit) floating point
+	fixedpoint = 3,			// Fixed point (16-bit) integer
+};
+
 // rds_standard
 //
 // Defines the Radio Data System (RDS) standard
@@ -106,6 +117,11 @@ struct settings {
 	// Frequency correction calibration value for the device
 	int device_frequency_correction;
 
+	// device_dsp_precision
+	//
+	// Precision for the digital signal processor
+	enum dsp_precision device_dsp_precision;
+
 	// device_connection_tcp_port
 	//
 	// The port number of the rtl_tcp host to connect to
@@ -126,6 +142,11 @@ struct settings {
 	// Specifies the Radio Data System (RDS) standard
 	enum rds_standard fmradio_rds_standard;
 
+	// fmradio_force_mono
+	//
+	// Forces the FM DSP to produce mono audio
+	bool fmradio_force_mono;
+
 	// fmradio_downsample_quality
 	//
 	// Specifies the FM DSP downsample quality factor
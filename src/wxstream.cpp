@@ -32,9 +32,16 @@
 
 #pragma warning(push, 4)
 
+namespace FMDSP_NAMESPACE {
+
+// wxstream::MAX_NATIVE_SAMPLERATE
+//
+// Maximum native demodulator output sample rate to report as the PCM sample rate
+uint32_t const wxstream::MAX_NATIVE_SAMPLERATE = 192000;
+
 // wxstream::MAX_SAMPLE_QUEUE
 //
-// Maximum number of queued sample sets from the device
+// Maximum number of queued sample blocks from the device
 size_t const wxstream::MAX_SAMPLE_QUEUE = 200;		// ~2sec
 
 // wxstream::STREAM_ID_AUDIO
@@ -61,9 +68,9 @@ wxstream::wxstream(std::unique_ptr<rtldevice> device, struct tunerprops const& t
 	if((tunerprops.samplerate < 900001) || (tunerprops.samplerate > 3200000))
 		throw string_exception(__func__, ": Tuner device sample rate must be in the range of 900001Hz to 3200000Hz");
 
-	// The only allowable output sample rates for this stream are 44100Hz and 48000Hz
-	if((m_pcmsamplerate != 44100) && (m_pcmsamplerate != 48000))
-		throw string_exception(__func__, ": DSP output sample rate must be set to either 44.1KHz or 48.0KHz");
+	// The only allowable output sample rates for this stream are 44100Hz, 48000Hz or zero for the native rate
+	if((m_pcmsamplerate != 0) && (m_pcmsamplerate != 44100) && (m_pcmsamplerate != 48000))
+		throw string_exception(__func__, ": DSP output sample rate must be set to either 44.1KHz, 48.0KHz or native");
 
 	// Initialize the RTL-SDR device instance
 	m_device->set_frequency_correction(tunerprops.freqcorrection);
@@ -85,9 +92,33 @@ wxstream::wxstream(std::unique_ptr<rtldevice> device, struct tunerprops const& t
 	m_demodulator->SetDemod(DEMOD_FM, demodinfo);
 	m_demodulator->SetDemodFreq(static_cast<TYPEREAL>(frequency - channelprops.frequency));
 
-	// Initialize the output resampler
-	m_resampler = std::unique_ptr<CFractResampler>(new CFractResampler());
-	m_resampler->Init(m_demodulator->GetInputBufferLimit());
+	// A PCM output sample rate of zero selects the native demodulator output rate, native rates
+	// that aren't whole numbers or are too high to be played back fall back to 48KHz
+	TYPEREAL const demodrate = m_demodulator->GetOutputRate();
+	if(m_pcmsamplerate == 0) {
+
+		uint32_t const nativerate = static_cast<uint32_t>(demodrate);
+		m_pcmsamplerate = ((static_cast<TYPEREAL>(nativerate) == demodrate) && (nativerate <= MAX_NATIVE_SAMPLERATE)) ? nativerate : 48000;
+	}
+
+	// Initialize the output resampler, when the output rate matches the demodulator rate the
+	// polyphase resampler only converts the samples. The fractional resampler is only used when
+	// the rates don't reduce to a ratio the rational polyphase resampler can handle
+	m_polyresampler = std::unique_ptr<CPolyResampler>(new CPolyResampler());
+	if(!m_polyresampler->Init(demodrate, static_cast<TYPEREAL>(m_pcmsamplerate))) {
+
+		m_polyresampler.reset();
+		m_resampler = std::unique_ptr<CFractResampler>(new CFractResampler());
+		m_resampler->Init(m_demodulator->GetInputBufferLimit());
+	}
+
+	// Preallocate the ring of raw I/Q sample blocks, the I/Q samples from the device
+	// come in as a pair of 8 bit unsigned integers per sample
+	m_blocks = std::unique_ptr<blockring<uint8_t>>(new blockring<uint8_t>(MAX_SAMPLE_QUEUE, 
+		m_demodulator->GetInputBufferLimit() * 2));
+
+	// Preallocate the buffer required to receive the demodulated samples
+	m_outsamples = std::unique_ptr<TYPEREAL[]>(new TYPEREAL[m_demodulator->GetInputBufferLimit()]);
 
 	// Adjust the device gain as specified by the channel properties
 	m_device->set_automatic_gain_control(channelprops.autogain);
@@ -156,6 +187,24 @@ std::unique_ptr<wxstream> wxstream::create(std::unique_ptr<rtldevice> device, st
 	return std::unique_ptr<wxstream>(new wxstream(std::move(device), tunerprops, channelprops, wxprops));
 }
 
+//---------------------------------------------------------------------------
+// create_wxstream
+//
+// Creates a new wxstream instance for this DSP precision
+//
+// Arguments:
+//
+//	device			- RTL-SDR device instance
+//	tunerprops		- Tunder device properties
+//	channelprops	- Channel properties
+//	wxprops			- Weather Radio digital signal processor properties
+
+std::unique_ptr<pvrstream> create_wxstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops,
+	struct channelprops const& channelprops, struct wxprops const& wxprops)
+{
+	return wxstream::create(std::move(device), tunerprops, channelprops, wxprops);
+}
+
 //---------------------------------------------------------------------------
 // wxstream::demuxabort
 //
@@ -193,9 +242,8 @@ void wxstream::demuxflush(void)
 
 DEMUX_PACKET* wxstream::demuxread(std::function<DEMUX_PACKET*(int)> const& allocator)
 {
-	// Wait for there to be a packet of samples available for processing
-	std::unique_lock<std::mutex> lock(m_queuelock);
-	m_cv.wait(lock, [&]() -> bool { return ((m_queue.size() > 0) || m_stopped.load() == true); });
+	// Wait for there to be a block of samples available for processing
+	m_blocks->wait([&]() -> bool { return m_stopped.load() == true; });
 
 	// If the worker thread was stopped, check for and re-throw any exception that occurred,
 	// otherwise assume it was stopped normally and return an empty demultiplexer packet
@@ -205,13 +253,20 @@ DEMUX_PACKET* wxstream::demuxread(std::function<DEMUX_PACKET*(int)> const& alloc
 		else return allocator(0);
 	}
 
-	// Pop off the topmost packet of samples from the queue<> and release the lock
-	std::unique_ptr<TYPECPX[]> insamples(std::move(m_queue.front()));
-	m_queue.pop();
-	lock.unlock();
+	// If the ring overran, the samples aren't being processed quickly enough to keep up
+	// with the rate; discard the backlog of samples in favor of a resync packet
+	bool resync = m_blocks->overrun();
+	if(resync) m_blocks->clear();
 
-	// If the packet of samples is null, the writer has indicated there was a problem
-	if(!insamples) {
+	// Access the topmost block of samples from the ring; it remains owned by this thread
+	// until it has been released back to the writer with pop()
+	size_t length = 0;
+	uint8_t const* block = (resync) ? nullptr : m_blocks->front(length);
+
+	// If the block of samples is empty, the writer has indicated there was a problem
+	if((resync) || (length == 0)) {
+
+		if(!resync) m_blocks->pop();
 
 		m_dts = STREAM_TIME_BASE;			// Reset the current decode time stamp
 
@@ -222,18 +277,23 @@ DEMUX_PACKET* wxstream::demuxread(std::function<DEMUX_PACKET*(int)> const& alloc
 		return packet;				// Return the generated packet
 	}
 
-	// Process the I/Q data
-	std::unique_ptr<TYPEREAL[]> outsamples(new TYPEREAL[m_demodulator->GetInputBufferLimit()]);
-	int audiopackets = m_demodulator->ProcessData(m_demodulator->GetInputBufferLimit(), insamples.get(), outsamples.get());
+	// Process the raw I/Q data directly from the block, the demodulator handles the
+	// conversion into floating-point samples as part of down converting them
+	int audiopackets = m_demodulator->ProcessData(m_demodulator->GetInputBufferLimit(), block, m_outsamples.get());
+
+	// Release the block of samples back to the ring
+	m_blocks->pop();
 
 	// Determine the size of the demultiplexer packet data and allocate it
-	int packetsize = audiopackets * sizeof(TYPEMONO16);
+	int packetsize = ((m_polyresampler) ? m_polyresampler->GetMaxOutputLength(audiopackets) : audiopackets) * sizeof(TYPEMONO16);
 	DEMUX_PACKET* packet = allocator(packetsize);
 	if(packet == nullptr) return nullptr;
 
 	// Resample the audio data directly into the allocated packet buffer
-	audiopackets = m_resampler->Resample(audiopackets, (m_demodulator->GetOutputRate() / m_pcmsamplerate),
-		outsamples.get(), reinterpret_cast<TYPEMONO16*>(packet->pData), m_pcmgain);
+	if(m_polyresampler) audiopackets = m_polyresampler->Resample(audiopackets, m_outsamples.get(), 
+		reinterpret_cast<TYPEMONO16*>(packet->pData), m_pcmgain);
+	else audiopackets = m_resampler->Resample(audiopackets, (m_demodulator->GetOutputRate() / m_pcmsamplerate),
+		m_outsamples.get(), reinterpret_cast<TYPEMONO16*>(packet->pData), m_pcmgain);
 
 	// Calculate the proper duration for the packet
 	double duration = (audiopackets / static_cast<double>(m_pcmsamplerate)) * STREAM_TIME_BASE;
@@ -469,43 +529,23 @@ void wxstream::transfer(scalar_condition<bool>& started)
 	// Asynchronous read callback function for the RTL-SDR device
 	auto read_callback_func = [&](uint8_t const* buffer, size_t count) -> void {
 
-		std::unique_ptr<TYPECPX[]> samples;			// Array of I/Q samples to return
+		// Acquire the next free block from the ring.  If there are no free blocks left, the samples
+		// aren't being processed quickly enough to keep up with the rate; the ring flags this as an
+		// overrun that will be handled by the reader, this set of samples is discarded
+		uint8_t* block = m_blocks->acquire();
+		if(block == nullptr) return;
 
-		// If the proper amount of data was returned by the callback, convert it into
-		// the floating-point I/Q sample data for the demodulator to process
+		// If the proper amount of data was returned by the callback, copy it into the block,
+		// otherwise commit an empty block to indicate to the reader that there was a problem
+		size_t length = 0;
 		if(count == readsize) {
 
-			samples = std::unique_ptr<TYPECPX[]>(new TYPECPX[readsize]);
-			for(int index = 0; index < m_demodulator->GetInputBufferLimit(); index++) {
-
-				// The demodulator expects the I/Q samples in the range of -32767.0 through +32767.0
-				// (32767.0 / 127.5) = 256.9960784313725
-				samples[index] = {
-
-				#ifdef FMDSP_USE_DOUBLE_PRECISION
-					(static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5) * 256.9960784313725,		// I
-					(static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5) * 256.9960784313725,	// Q
-				#else
-					(static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5f) * 256.9960784313725f,		// I
-					(static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5f) * 256.9960784313725f,	// Q
-				#endif
-				};
-			}
+			memcpy(block, buffer, count);
+			length = count;
 		}
 
-		// Push the converted samples into the queue<> for processing.  If there is insufficient space
-		// left in the queue<>, the samples aren't being processed quickly enough to keep up with the rate
-		std::unique_lock<std::mutex> lock(m_queuelock);
-		if(m_queue.size() < MAX_SAMPLE_QUEUE) m_queue.push(std::move(samples));
-		else {
-
-			m_queue = sample_queue_t();							// Replace the queue<>
-			m_queue.push(nullptr);								// Push a resync packet (null)
-			if(samples) m_queue.push(std::move(samples));		// Push samples
-		}
-
-		// Notify any threads waiting on the lock that the queue<> has been updated
-		m_cv.notify_all();
+		// Commit the block into the ring, this only wakes the reader if it's waiting for it
+		m_blocks->commit(length);
 	};
 
 	// Begin streaming from the device and inform the caller that the thread is running
@@ -517,9 +557,11 @@ void wxstream::transfer(scalar_condition<bool>& started)
 	catch(...) { m_worker_exception = std::current_exception(); }
 
 	m_stopped.store(true);					// Thread is stopped
-	m_cv.notify_all();						// Unblock any waiters
+	m_blocks->notify();						// Unblock any waiters
 }
 
 //---------------------------------------------------------------------------
 
+} // namespace FMDSP_NAMESPACE
+
 #pragma warning(pop)
@@ -25,15 +25,14 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <thread>
 
 #include "fmdsp/demodulator.h"
 #include "fmdsp/fractresampler.h"
+#include "fmdsp/polyresampler.h"
 
+#include "blockring.h"
 #include "props.h"
 #include "pvrstream.h"
 #include "rtldevice.h"
@@ -41,6 +40,8 @@
 
 #pragma warning(push, 4)
 
+namespace FMDSP_NAMESPACE {
+
 //---------------------------------------------------------------------------
 // Class wxstream
 //
@@ -148,9 +149,14 @@ private:
 	wxstream(wxstream const&) = delete;
 	wxstream& operator=(wxstream const&) = delete;
 
+	// MAX_NATIVE_SAMPLERATE
+	//
+	// Maximum native demodulator output sample rate to report as the PCM sample rate
+	static uint32_t const MAX_NATIVE_SAMPLERATE;
+
 	// MAX_SAMPLE_QUEUE
 	//
-	// Maximum number of queued sample sets from device
+	// Maximum number of queued sample blocks from device
 	static size_t const MAX_SAMPLE_QUEUE;
 
 	// STREAM_ID_AUDIO
@@ -163,19 +169,6 @@ private:
 	wxstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops,
 		struct channelprops const& channelprops, struct wxprops const& wxprops);
 
-	//-----------------------------------------------------------------------
-	// Private Type Declarations
-
-	// sample_queue_item_t
-	//
-	// Defines the type of a single sample_queue_t entry
-	using sample_queue_item_t = std::unique_ptr<TYPECPX[]>;
-
-	// sample_queue_t
-	//
-	// Defines the type of the input sample queue
-	using sample_queue_t = std::queue<sample_queue_item_t>;
-
 	//-----------------------------------------------------------------------
 	// Private Member Functions
 
@@ -195,17 +188,17 @@ private:
 	std::unique_ptr<rtldevice>			m_device;					// RTL-SDR device instance
 	std::unique_ptr<CDemodulator>		m_demodulator;				// CuteSDR demodulator instance
 	std::unique_ptr<CFractResampler>	m_resampler;				// CuteSDR resampler instance
+	std::unique_ptr<CPolyResampler>		m_polyresampler;			// Rational resampler instance
 
 	std::string	const					m_muxname;					// Generated mux name
-	uint32_t const						m_pcmsamplerate;			// Output sample rate
+	uint32_t							m_pcmsamplerate;			// Output sample rate
 	TYPEREAL const						m_pcmgain;					// Output gain
 	double								m_dts{ STREAM_TIME_BASE };	// Current decode time stamp
 
 	// STREAM CONTROL
 	//
-	sample_queue_t						m_queue;					// queue<> of prepared samples
-	mutable std::mutex					m_queuelock;				// Synchronization object
-	std::condition_variable				m_cv;						// Transfer event condvar
+	std::unique_ptr<blockring<uint8_t>>	m_blocks;					// Ring of raw I/Q sample blocks
+	std::unique_ptr<TYPEREAL[]>			m_outsamples;				// Demodulated samples
 	std::thread							m_worker;					// Data transfer thread
 	std::exception_ptr					m_worker_exception;			// Exception on worker thread
 	scalar_condition<bool>				m_stop{ false };			// Condition to stop data transfer
@@ -214,6 +207,30 @@ private:
 
 //-----------------------------------------------------------------------------
 
+} // namespace FMDSP_NAMESPACE
+
+//---------------------------------------------------------------------------
+// FUNCTION PROTOTYPES
+//---------------------------------------------------------------------------
+
+// create_wxstream
+//
+// Creates a new wxstream instance; wxstream is compiled once for each DSP precision
+// (see dspsingle.cpp and dspdouble.cpp) and the caller selects which one to use
+namespace fmdsp_single {
+
+	std::unique_ptr<pvrstream> create_wxstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops,
+		struct channelprops const& channelprops, struct wxprops const& wxprops);
+};
+
+namespace fmdsp_double {
+
+	std::unique_ptr<pvrstream> create_wxstream(std::unique_ptr<rtldevice> device, struct tunerprops const& tunerprops,
+		struct channelprops const& channelprops, struct wxprops const& wxprops);
+};
+
+//---------------------------------------------------------------------------
+
 #pragma warning(pop)
 
 #endif	// __WXSTREAM_H_
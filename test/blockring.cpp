@@ -0,0 +1,276 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+// Tests the blockring sample pipeline of fmstream
+//
+// The transfer thread, the demultiplexer and the RDS thread are run the way fmstream
+// runs them on a generated signal and the heap allocations made by all of the threads
+// are counted; once the pipeline has reached steady state there must not be any.  The
+// parking handshake between commit() and wait() is exercised separately
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include "blockring.h"
+#include "fmdsp/demodulator.h"
+#include "fmdsp/dispatch.h"
+#include "fmdsp/polyresampler.h"
+#include "fmdsp/rdsdemod.h"
+#include "testsignal.h"
+
+using namespace FMDSP_NAMESPACE;
+
+// Heap allocation counter, every allocation made by the process goes through the
+// replacement operator new below
+static std::atomic<size_t> g_allocations{ 0 };
+
+void* operator new(size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	void* ptr = malloc((size == 0) ? 1 : size);
+	if(ptr == nullptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+// Pipeline parameters, taken from fmstream
+static size_t const MAX_SAMPLE_QUEUE = 200;
+static size_t const MAX_COMPOSITE_QUEUE = 64;
+static size_t const COMPOSITE_BLOCK_SIZE = 4096;
+static int const PCM_SAMPLERATE = 48000;
+
+// Number of blocks processed before and after the allocation count is sampled
+static int const WARMUP_BLOCKS = 50;
+static int const TEST_BLOCKS = 500;
+
+// Number of blocks passed one at a time through the ring and the number of seconds
+// after which a consumer that hasn't taken the next block is considered lost
+static int const HANDSHAKE_BLOCKS = 200000;
+static int const HANDSHAKE_TIMEOUT = 60;
+
+//---------------------------------------------------------------------------
+// test_steady_state_allocations
+//
+// Verifies that the pipeline doesn't allocate from the heap in steady state
+
+static bool test_steady_state_allocations(void)
+{
+	double const samplerate = 1600000.0;
+	std::vector<uint8_t> const iq = generate_wfm(samplerate, 1.0);
+
+	tDemodInfo demodinfo = {};
+	demodinfo.HiCutmax = 100000;
+	demodinfo.HiCut = 100000;
+	demodinfo.LowCut = -100000;
+	demodinfo.SquelchValue = -160;
+	demodinfo.WfmDownsampleQuality = DownsampleQuality::High;
+
+	CDemodulator demodulator;
+	demodulator.SetUSFmVersion(true);
+	demodulator.SetInputSampleRate(samplerate);
+	demodulator.SetDemod(DEMOD_WFM, demodinfo);
+	demodulator.SetDemodFreq(samplerate / 4.0);
+
+	CPolyResampler resampler;
+	resampler.InitLowPass(demodulator.GetOutputRate(), PCM_SAMPLERATE, WFM_AUDIO_ASTOP, WFM_AUDIO_FPASS, WFM_FUSED_FSTOP);
+	demodulator.SetAudioFilterEnabled(false);
+
+	int const inbuflimit = demodulator.GetInputBufferLimit();
+	size_t const blocksize = static_cast<size_t>(inbuflimit) * 2;
+
+	blockring<uint8_t> blocks(MAX_SAMPLE_QUEUE, blocksize);
+	blockring<TYPECPX> composite(MAX_COMPOSITE_QUEUE, COMPOSITE_BLOCK_SIZE);
+	std::unique_ptr<TYPECPX[]> samples(new TYPECPX[inbuflimit]);
+	std::unique_ptr<TYPESTEREO16[]> packet(new TYPESTEREO16[resampler.GetMaxOutputLength(inbuflimit)]);
+
+	CRdsDemod rdsdemod;
+	rdsdemod.SetSampleRate(demodulator.GetCompositeRate());
+	demodulator.SetRdsEnabled(true);
+	demodulator.SetCompositeSink([&](int length, TYPECPX const* samples) -> void {
+
+		while(length > 0) {
+
+			TYPECPX* block = composite.acquire();
+			if(block == nullptr) return;
+
+			size_t count = std::min(static_cast<size_t>(length), COMPOSITE_BLOCK_SIZE);
+			memcpy(block, samples, count * sizeof(TYPECPX));
+			composite.commit(count);
+
+			samples += count;
+			length -= static_cast<int>(count);
+		}
+	});
+
+	std::atomic<bool> stopped{ false };
+
+	// Transfer thread; unlike the device callback this waits for a free block rather than
+	// discarding the samples so that every block reaches the demultiplexer
+	std::thread transfer([&]() -> void {
+
+		size_t offset = 0;
+		while(stopped.load() == false) {
+
+			uint8_t* block = blocks.acquire();
+			if(block == nullptr) { std::this_thread::yield(); continue; }
+
+			if(offset + blocksize > iq.size()) offset = 0;
+			memcpy(block, &iq[offset], blocksize);
+			offset += blocksize;
+
+			blocks.commit(blocksize);
+		}
+	});
+
+	// RDS thread
+	std::atomic<bool> rdsstopped{ false };
+	std::thread rds([&]() -> void {
+
+		while(true) {
+
+			composite.wait([&]() -> bool { return rdsstopped.load() == true; });
+			if(rdsstopped.load() == true) break;
+
+			composite.overrun();
+
+			size_t length = 0;
+			TYPECPX const* block = composite.front(length);
+			rdsdemod.ProcessData(static_cast<int>(length), block);
+			composite.pop();
+
+			tRDS_GROUPS rdsgroup = {};
+			while(rdsdemod.GetNextRdsGroupData(&rdsgroup)) {}
+		}
+	});
+
+	// Demultiplexer
+	size_t before = 0;
+	for(int index = 0; index < WARMUP_BLOCKS + TEST_BLOCKS; index++) {
+
+		if(index == WARMUP_BLOCKS) before = g_allocations.load();
+
+		// The transfer thread doesn't discard samples when the ring is full, so the overrun
+		// flag it leaves behind doesn't need to be handled here
+		blocks.wait([]() -> bool { return false; });
+
+		size_t length = 0;
+		uint8_t const* block = blocks.front(length);
+		int audiopackets = demodulator.ProcessData(inbuflimit, block, samples.get());
+		blocks.pop();
+
+		resampler.Resample(audiopackets, samples.get(), packet.get(), 1.0);
+	}
+	size_t const after = g_allocations.load();
+
+	stopped.store(true);
+	transfer.join();
+	rdsstopped.store(true);
+	composite.notify();
+	rds.join();
+
+	// The pipeline setup has to have gone through the counter or it isn't counting anything
+	printf("setup allocations: %zu, steady state allocations: %zu in %d blocks\n", before, after - before, TEST_BLOCKS);
+	return (before > 0) && (after == before);
+}
+
+//---------------------------------------------------------------------------
+// test_parking_handshake
+//
+// Passes single blocks between a producer and a consumer so that the consumer parks
+// itself in wait() for nearly every block; a lost wakeup leaves it parked for good
+
+static bool test_parking_handshake(void)
+{
+	blockring<uint8_t> ring(4, 64);
+	std::atomic<int> consumed{ 0 };
+
+	std::thread consumer([&]() -> void {
+
+		for(int index = 0; index < HANDSHAKE_BLOCKS; index++) {
+
+			ring.wait([]() -> bool { return false; });
+
+			size_t length = 0;
+			ring.front(length);
+			ring.pop();
+			consumed.store(index + 1, std::memory_order_release);
+		}
+	});
+
+	// The producer only commits the next block after the previous one was consumed, if
+	// the consumer stops making progress it will never be woken up again
+	auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(HANDSHAKE_TIMEOUT);
+	for(int index = 0; index < HANDSHAKE_BLOCKS; index++) {
+
+		ring.acquire();
+		ring.commit(1);
+
+		while(consumed.load(std::memory_order_acquire) <= index) {
+
+			if(std::chrono::steady_clock::now() > deadline) {
+
+				printf("consumer was not woken up for block %d\n", index);
+				fflush(stdout);
+				_Exit(EXIT_FAILURE);		// The consumer thread can't be joined
+			}
+
+			std::this_thread::yield();
+		}
+	}
+
+	consumer.join();
+
+	printf("handshake blocks: %d\n", HANDSHAKE_BLOCKS);
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// main
+//
+// Test entry point
+
+int main(int, char**)
+{
+	BindDspKernels(ProbeSimdLevel(), tDspKernelCallback());
+
+	bool passed = test_steady_state_allocations();
+	passed = test_parking_handshake() && passed;
+
+	printf("%s\n", (passed) ? "PASSED" : "FAILED");
+	return (passed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//---------------------------------------------------------------------------
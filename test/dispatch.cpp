@@ -0,0 +1,396 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+// Tests the runtime DSP kernel dispatch
+//
+// The signal chains of the streams are run with every kernel binding the CPU supports
+// and compared to the scalar kernels. The vector kernels sum in a different order, so
+// the floating point outputs are only required to match within a tolerance; the 16 bit
+// PCM samples may differ by one LSB where that changes the rounding, and the fixed point
+// chain must match exactly. The block discriminator of the narrow band FM demodulator is
+// also compared to the PLL it replaces, which must produce the same audio
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fmdsp/demodulator.h"
+#include "fmdsp/discriminator.h"
+#include "fmdsp/dispatch.h"
+#include "fmdsp/downconvert.h"
+#include "fmdsp/fixeddemod.h"
+#include "fmdsp/fmdemod.h"
+#include "fmdsp/fixedresampler.h"
+#include "fmdsp/polyresampler.h"
+#include "fmdsp/wfmdemod.h"
+#include "testsignal.h"
+
+using namespace FMDSP_NAMESPACE;
+
+// Input sample rate and output sample rate of the chains
+static double const SAMPLERATE = 1600000.0;
+static int const PCM_SAMPLERATE = 48000;
+
+// Largest error of the floating point outputs relative to the scalar kernels, in dB of
+// the output power. The measured errors are about -140dB in single precision and -310dB
+// in double precision
+#ifdef FMDSP_USE_DOUBLE_PRECISION
+static double const MAX_ERROR = -280.0;
+#else
+static double const MAX_ERROR = -120.0;
+#endif
+
+// Smallest correlation and largest level difference in dB of the discriminator and PLL
+// audio, and the seconds of audio skipped while the PLL locks and the filters settle
+static double const MIN_DEMOD_CORRELATION = 0.99;
+static double const MAX_DEMOD_LEVEL = 1.0;
+static double const DEMOD_SETTLE_TIME = 0.1;
+
+// Instruction sets the kernels are implemented for, other than scalar
+static enum SimdLevel const LEVELS[] = { SIMD_SSE2, SIMD_AVX2, SIMD_NEON };
+
+// chainoutput
+//
+// Floating point and PCM output of a signal chain
+struct chainoutput {
+
+	std::vector<double>		samples;		// Floating point samples
+	std::vector<int>		pcm;			// PCM or fixed point samples
+};
+
+//---------------------------------------------------------------------------
+// run_wfm
+//
+// Runs the wide band FM chain of fmstream, in stereo or mono with the audio filtering
+// done by the output resampler
+
+static chainoutput run_wfm(std::vector<uint8_t> const& iq, double offset, bool stereo)
+{
+	tDemodInfo demodinfo = {};
+	demodinfo.HiCutmax = 100000;
+	demodinfo.HiCut = 100000;
+	demodinfo.LowCut = -100000;
+	demodinfo.SquelchValue = -160;
+	demodinfo.WfmDownsampleQuality = DownsampleQuality::High;
+
+	CDemodulator demodulator;
+	demodulator.SetUSFmVersion(true);
+	demodulator.SetInputSampleRate(SAMPLERATE);
+	demodulator.SetDemod(DEMOD_WFM, demodinfo);
+	demodulator.SetDemodFreq((SAMPLERATE / 4.0) + offset);
+
+	CPolyResampler resampler;
+	resampler.InitLowPass(demodulator.GetOutputRate(), PCM_SAMPLERATE, WFM_AUDIO_ASTOP, WFM_AUDIO_FPASS, WFM_FUSED_FSTOP);
+	demodulator.SetAudioFilterEnabled(false);
+
+	int const inbuflimit = demodulator.GetInputBufferLimit();
+	std::vector<TYPECPX> samples(inbuflimit);
+	std::vector<TYPEREAL> monosamples(inbuflimit);
+	std::vector<TYPESTEREO16> pcm(resampler.GetMaxOutputLength(inbuflimit));
+	chainoutput output;
+
+	for(size_t index = 0; index + inbuflimit <= iq.size() / 2; index += inbuflimit) {
+
+		if(stereo) {
+
+			int count = demodulator.ProcessData(inbuflimit, &iq[index * 2], samples.data());
+			for(int sample = 0; sample < count; sample++) {
+
+				output.samples.push_back(samples[sample].re);
+				output.samples.push_back(samples[sample].im);
+			}
+
+			count = resampler.Resample(count, samples.data(), pcm.data(), 1.0);
+			for(int sample = 0; sample < count; sample++) {
+
+				output.pcm.push_back(pcm[sample].re);
+				output.pcm.push_back(pcm[sample].im);
+			}
+		}
+
+		else {
+
+			int count = demodulator.ProcessData(inbuflimit, &iq[index * 2], monosamples.data());
+			output.samples.insert(output.samples.end(), monosamples.begin(), monosamples.begin() + count);
+
+			count = resampler.Resample(count, monosamples.data(), reinterpret_cast<TYPEMONO16*>(pcm.data()), 1.0);
+			TYPEMONO16 const* mono = reinterpret_cast<TYPEMONO16*>(pcm.data());
+			output.pcm.insert(output.pcm.end(), mono, mono + count);
+		}
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------
+// run_nbfm
+//
+// Runs the narrow band FM chain of wxstream
+
+static chainoutput run_nbfm(std::vector<uint8_t> const& iq)
+{
+	tDemodInfo demodinfo = {};
+	demodinfo.HiCutmax = 100000;
+	demodinfo.HiCut = 5000;
+	demodinfo.LowCut = -5000;
+	demodinfo.SquelchValue = -160;
+
+	CDemodulator demodulator;
+	demodulator.SetInputSampleRate(SAMPLERATE);
+	demodulator.SetDemod(DEMOD_FM, demodinfo);
+	demodulator.SetDemodFreq(SAMPLERATE / 4.0);
+
+	CPolyResampler resampler;
+	resampler.Init(demodulator.GetOutputRate(), PCM_SAMPLERATE);
+
+	int const inbuflimit = demodulator.GetInputBufferLimit();
+	std::vector<TYPEREAL> samples(inbuflimit);
+	std::vector<TYPEMONO16> pcm(resampler.GetMaxOutputLength(inbuflimit));
+	chainoutput output;
+
+	for(size_t index = 0; index + inbuflimit <= iq.size() / 2; index += inbuflimit) {
+
+		int count = demodulator.ProcessData(inbuflimit, &iq[index * 2], samples.data());
+		output.samples.insert(output.samples.end(), samples.begin(), samples.begin() + count);
+
+		count = resampler.Resample(count, samples.data(), pcm.data(), 1.0);
+		output.pcm.insert(output.pcm.end(), pcm.begin(), pcm.begin() + count);
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------
+// run_fixed
+//
+// Runs the fixed point wide band FM chain of fmstream
+
+static chainoutput run_fixed(std::vector<uint8_t> const& iq)
+{
+	CFixedDemodulator demodulator;
+	demodulator.SetSampleRate(SAMPLERATE, DownsampleQuality::High, true);
+	demodulator.SetDemodFreq(SAMPLERATE / 4.0);
+
+	CFixedResampler resampler;
+	resampler.InitLowPass(demodulator.GetOutputRate(), PCM_SAMPLERATE, WFM_AUDIO_ASTOP, WFM_AUDIO_FPASS, WFM_FUSED_FSTOP);
+
+	int const inbuflimit = demodulator.GetInputBufferLimit();
+	std::vector<qint16> samples(inbuflimit);
+	std::vector<TYPEMONO16> pcm(resampler.GetMaxOutputLength(inbuflimit));
+	chainoutput output;
+
+	for(size_t index = 0; index + inbuflimit <= iq.size() / 2; index += inbuflimit) {
+
+		int count = demodulator.ProcessData(inbuflimit, &iq[index * 2], samples.data());
+		output.pcm.insert(output.pcm.end(), samples.begin(), samples.begin() + count);
+
+		count = resampler.Resample(count, samples.data(), pcm.data(), CFixedDemodulator::GetOutputScale());
+		output.pcm.insert(output.pcm.end(), pcm.begin(), pcm.begin() + count);
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------
+// run_polar
+//
+// Runs the polar discriminator, which none of the stream chains use, over the
+// converted raw samples
+
+static chainoutput run_polar(std::vector<uint8_t> const& iq)
+{
+	CFmDiscriminator discriminator(DISC_POLAR);
+
+	size_t const blocksize = 4096;
+	std::vector<TYPECPX> samples(blocksize);
+	std::vector<TYPEREAL> demodulated(blocksize);
+	chainoutput output;
+
+	for(size_t index = 0; index + blocksize <= iq.size() / 2; index += blocksize) {
+
+		for(size_t sample = 0; sample < blocksize; sample++) {
+
+			samples[sample].re = (iq[(index + sample) * 2] - 127.5) / 127.5;
+			samples[sample].im = (iq[(index + sample) * 2 + 1] - 127.5) / 127.5;
+		}
+
+		discriminator.ProcessData(static_cast<int>(blocksize), samples.data(), 1.0, demodulated.data());
+		output.samples.insert(output.samples.end(), demodulated.begin(), demodulated.end());
+	}
+
+	return output;
+}
+
+//---------------------------------------------------------------------------
+// compare
+//
+// Compares the output of a chain with the output of the scalar kernels
+
+static bool compare(char const* chain, chainoutput const& output, chainoutput const& reference, bool exact)
+{
+	if((output.samples.size() != reference.samples.size()) || (output.pcm.size() != reference.pcm.size())) {
+
+		printf("  %-28s length mismatch FAILED\n", chain);
+		return false;
+	}
+
+	double error = 0.0, power = 0.0;
+	for(size_t index = 0; index < reference.samples.size(); index++) {
+
+		double const difference = output.samples[index] - reference.samples[index];
+		error += difference * difference;
+		power += reference.samples[index] * reference.samples[index];
+	}
+
+	int maxpcm = 0;
+	for(size_t index = 0; index < reference.pcm.size(); index++)
+		maxpcm = std::max(maxpcm, abs(output.pcm[index] - reference.pcm[index]));
+
+	double const errordb = (error == 0.0) ? -HUGE_VAL : 10.0 * log10(error / power);
+	bool const passed = (exact) ? ((error == 0.0) && (maxpcm == 0)) : ((errordb <= MAX_ERROR) && (maxpcm <= 1));
+
+	printf("  %-28s error %8.1f dB, PCM %d LSB %s\n", chain, errordb, maxpcm, (passed) ? "passed" : "FAILED");
+	return passed;
+}
+
+//---------------------------------------------------------------------------
+// is_supported
+//
+// Determines if the running CPU supports an instruction set
+
+static bool is_supported(enum SimdLevel level)
+{
+	enum SimdLevel const probed = ProbeSimdLevel();
+	return (level == probed) || ((level == SIMD_SSE2) && (probed == SIMD_AVX2));
+}
+
+//---------------------------------------------------------------------------
+// test_bindings
+//
+// Compares the signal chains run with each supported binding to the scalar kernels
+
+static bool test_bindings(void)
+{
+	std::vector<uint8_t> const wfm = generate_wfm(SAMPLERATE, 0.5);
+	std::vector<uint8_t> const nbfm = generate_wfm(SAMPLERATE, 0.5, 5000.0);
+
+	BindDspKernels(SIMD_SCALAR, tDspKernelCallback());
+	chainoutput const wfmstereo = run_wfm(wfm, 0.0, true);
+	chainoutput const wfmoffset = run_wfm(wfm, 10000.0, false);
+	chainoutput const nbfmchain = run_nbfm(nbfm);
+	chainoutput const fixedchain = run_fixed(wfm);
+	chainoutput const polar = run_polar(nbfm);
+
+	bool passed = true;
+	int tested = 0;
+
+	for(enum SimdLevel level : LEVELS) {
+
+		if(!is_supported(level)) continue;
+
+		BindDspKernels(level, tDspKernelCallback());
+		printf("%s:\n", GetSimdLevelName(level));
+		tested++;
+
+		passed = compare("WFM stereo", run_wfm(wfm, 0.0, true), wfmstereo, false) && passed;
+		passed = compare("WFM mono, off-center NCO", run_wfm(wfm, 10000.0, false), wfmoffset, false) && passed;
+		passed = compare("NBFM", run_nbfm(nbfm), nbfmchain, false) && passed;
+		passed = compare("fixed point WFM", run_fixed(wfm), fixedchain, true) && passed;
+		passed = compare("polar discriminator", run_polar(nbfm), polar, false) && passed;
+	}
+
+	if(tested == 0) printf("no vector instruction set supported, nothing to compare\n");
+	return passed;
+}
+
+//---------------------------------------------------------------------------
+// run_fmdemod
+//
+// Runs the narrow band FM demodulator of the specified type over the down converted
+// samples
+
+static std::vector<TYPEREAL> run_fmdemod(int type, double samplerate, std::vector<TYPECPX> const& samples)
+{
+	CFmDemod demodulator(samplerate);
+	demodulator.SetDemodType(type);
+	demodulator.SetSquelch(-160);
+
+	std::vector<TYPECPX> input(samples);
+	std::vector<TYPEREAL> output(samples.size());
+	demodulator.ProcessData(static_cast<int>(input.size()), 5000.0, input.data(), output.data());
+
+	return output;
+}
+
+//---------------------------------------------------------------------------
+// test_demod_types
+//
+// Compares the audio of the narrow band FM block discriminator and PLL, a sign or
+// level error in either one would not show up comparing the kernel bindings
+
+static bool test_demod_types(void)
+{
+	std::vector<uint8_t> const nbfm = generate_wfm(SAMPLERATE, 0.5, 5000.0);
+
+	CDownConvert downconvert;
+	double const samplerate = downconvert.SetDataRate(SAMPLERATE, 100000);
+	downconvert.SetFrequency(SAMPLERATE / 4.0);
+
+	std::vector<TYPECPX> samples(nbfm.size() / 2);
+	int const count = downconvert.ProcessData(static_cast<int>(samples.size()), nbfm.data(), samples.data());
+	samples.resize(count);
+
+	std::vector<TYPEREAL> const discriminator = run_fmdemod(FMDEMOD_DISCRIMINATOR, samplerate, samples);
+	std::vector<TYPEREAL> const pll = run_fmdemod(FMDEMOD_PLL, samplerate, samples);
+
+	double dd = 0.0, pp = 0.0, dp = 0.0;
+	for(size_t index = static_cast<size_t>(DEMOD_SETTLE_TIME * samplerate); index < samples.size(); index++) {
+
+		dd += static_cast<double>(discriminator[index]) * discriminator[index];
+		pp += static_cast<double>(pll[index]) * pll[index];
+		dp += static_cast<double>(discriminator[index]) * pll[index];
+	}
+
+	double const correlation = dp / sqrt(dd * pp);
+	double const level = 10.0 * log10(dd / pp);
+	bool const passed = (correlation >= MIN_DEMOD_CORRELATION) && (fabs(level) <= MAX_DEMOD_LEVEL);
+
+	printf("NBFM discriminator vs PLL: correlation %.4f, level %+.2f dB %s\n", correlation, level, (passed) ? "passed" : "FAILED");
+	return passed;
+}
+
+//---------------------------------------------------------------------------
+// main
+//
+// Test entry point
+
+int main(int, char**)
+{
+	printf("%s, tolerance %.0f dB\n", precision_name<TYPEREAL>(), MAX_ERROR);
+
+	bool passed = test_bindings();
+	passed = test_demod_types() && passed;
+
+	printf("%s\n", (passed) ? "PASSED" : "FAILED");
+	return (passed) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+// Benchmarks the down converter decimation chain
+//
+// Times CDownConvert::ProcessData() for the wide band FM quality presets and the narrow
+// band (wxstream) chain, from raw 8 bit I/Q samples as the streams use it and from
+// complex samples, in nanoseconds per input sample
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fmdsp/dispatch.h"
+#include "fmdsp/downconvert.h"
+#include "testsignal.h"
+
+using namespace FMDSP_NAMESPACE;
+
+// Samples passed to each ProcessData() call, a multiple of every chain's decimation
+static int const BLOCK_SIZE = 16384;
+
+// Number of runs, the fastest one is reported
+static int const RUNS = 7;
+
+static struct
+{
+	char const*					name;
+	double						samplerate;
+	bool						wfm;
+	enum DownsampleQuality		quality;
+	double						maxbandwidth;
+
+} const CHAINS[] = {
+
+	{ "WFM low", 1024000.0, true, DownsampleQuality::Low, 100000.0 },
+	{ "WFM medium", 2400000.0, true, DownsampleQuality::Medium, 100000.0 },
+	{ "WFM high", 1600000.0, true, DownsampleQuality::High, 100000.0 },
+	{ "WFM high", 2400000.0, true, DownsampleQuality::High, 100000.0 },
+	{ "WFM high", 3200000.0, true, DownsampleQuality::High, 100000.0 },
+	{ "NBFM", 1600000.0, false, DownsampleQuality::High, 100000.0 },
+	{ "NBFM", 2400000.0, false, DownsampleQuality::High, 100000.0 },
+};
+
+int main(int, char**)
+{
+	char const* simdlevel = InitDspKernels(tDspKernelCallback());
+	printf("%s, %s kernels, best of %d runs, ns per input sample\n", precision_name<TYPEREAL>(), simdlevel, RUNS);
+	printf("  %-12s %8s %8s %10s %10s\n", "chain", "MS/s", "out kS/s", "raw I/Q", "complex");
+
+	for(auto const& chain : CHAINS) {
+
+		std::vector<uint8_t> const iq = generate_wfm(chain.samplerate, 1.0);
+		int const count = static_cast<int>(iq.size() / 2 / BLOCK_SIZE) * BLOCK_SIZE;
+
+		std::vector<TYPECPX> samples(count);
+		for(int index = 0; index < count; index++) {
+
+			samples[index].re = (iq[index * 2] - 127.5) / 127.5;
+			samples[index].im = (iq[index * 2 + 1] - 127.5) / 127.5;
+		}
+		std::vector<TYPECPX> out(BLOCK_SIZE);
+
+		CDownConvert downconvert;
+		downconvert.SetQuality(chain.quality);
+		double const outrate = (chain.wfm) ? downconvert.SetWfmDataRate(chain.samplerate, chain.maxbandwidth) :
+			downconvert.SetDataRate(chain.samplerate, chain.maxbandwidth);
+		downconvert.SetFrequency(chain.samplerate / 4.0);
+
+		double const raw = best_of(RUNS, [&]() -> void {
+
+			for(int index = 0; index < count; index += BLOCK_SIZE)
+				downconvert.ProcessData(BLOCK_SIZE, &iq[index * 2], out.data());
+		});
+
+		// The raw and complex inputs should not be mixed on the same instance
+		CDownConvert cpxdownconvert;
+		cpxdownconvert.SetQuality(chain.quality);
+		if(chain.wfm) cpxdownconvert.SetWfmDataRate(chain.samplerate, chain.maxbandwidth);
+		else cpxdownconvert.SetDataRate(chain.samplerate, chain.maxbandwidth);
+		cpxdownconvert.SetFrequency(chain.samplerate / 4.0);
+
+		double const complex = best_of(RUNS, [&]() -> void {
+
+			for(int index = 0; index < count; index += BLOCK_SIZE)
+				cpxdownconvert.ProcessData(BLOCK_SIZE, &samples[index], out.data());
+		});
+
+		printf("  %-12s %8.3f %8.1f %10.2f %10.2f\n", chain.name, chain.samplerate / 1e6, outrate / 1e3, raw / count, complex / count);
+	}
+
+	return EXIT_SUCCESS;
+}
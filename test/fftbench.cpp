@@ -0,0 +1,161 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+// Benchmarks the FFT used for fast convolution
+//
+// Times CFft::FwdFFT() and CFft::RevFFT() with every kernel binding the CPU supports, as
+// the average of one forward and one reverse transform in microseconds. Each pair starts
+// from a copy of the input, as fast convolution does. The accuracy of the forward transform
+// is measured against a long double DFT as signal to error ratio
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmdsp/dispatch.h"
+#include "fmdsp/fft.h"
+#include "testsignal.h"
+
+using namespace FMDSP_NAMESPACE;
+
+// Transforms timed per run, per direction
+static int const TRANSFORMS = 200;
+
+// Number of runs, the fastest one is reported
+static int const RUNS = 5;
+
+// Instruction sets the kernels are implemented for
+static enum SimdLevel const LEVELS[] = { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2, SIMD_NEON };
+
+//---------------------------------------------------------------------------
+// generate_input
+//
+// Generates uniformly distributed complex samples
+
+static std::vector<TYPECPX> generate_input(int size)
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+	std::vector<TYPECPX> input(size);
+
+	for(TYPECPX& sample : input) {
+
+		sample.re = static_cast<TYPEREAL>(uniform(rng));
+		sample.im = static_cast<TYPEREAL>(uniform(rng));
+	}
+
+	return input;
+}
+
+//---------------------------------------------------------------------------
+// accuracy
+//
+// Compares the forward transform to a long double DFT with the same exp(+j) sign and
+// no scaling, returns the signal to error ratio in dB
+
+static double accuracy(std::vector<TYPECPX> const& input, std::vector<TYPECPX> const& output)
+{
+	size_t const size = input.size();
+	long double const pi = 3.141592653589793238462643383279502884L;
+
+	std::vector<long double> costable(size), sintable(size);
+	for(size_t index = 0; index < size; index++) {
+
+		costable[index] = cosl(2.0L * pi * index / size);
+		sintable[index] = sinl(2.0L * pi * index / size);
+	}
+
+	long double signal = 0.0L, error = 0.0L;
+	for(size_t bin = 0; bin < size; bin++) {
+
+		long double re = 0.0L, im = 0.0L;
+		for(size_t index = 0, phase = 0; index < size; index++, phase = (phase + bin) % size) {
+
+			re += (input[index].re * costable[phase]) - (input[index].im * sintable[phase]);
+			im += (input[index].re * sintable[phase]) + (input[index].im * costable[phase]);
+		}
+
+		long double const dre = output[bin].re - re;
+		long double const dim = output[bin].im - im;
+		signal += (re * re) + (im * im);
+		error += (dre * dre) + (dim * dim);
+	}
+
+	return static_cast<double>(10.0L * log10l(signal / error));
+}
+
+//---------------------------------------------------------------------------
+// is_supported
+//
+// Determines if the running CPU supports an instruction set
+
+static bool is_supported(enum SimdLevel level)
+{
+	enum SimdLevel const probed = ProbeSimdLevel();
+	return (level == SIMD_SCALAR) || (level == probed) || ((level == SIMD_SSE2) && (probed == SIMD_AVX2));
+}
+
+int main(int, char**)
+{
+	printf("%s, best of %d runs, us per transform, accuracy in dB\n", precision_name<TYPEREAL>(), RUNS);
+	printf("  %6s", "N");
+	for(enum SimdLevel level : LEVELS) if(is_supported(level)) printf(" %8s", GetSimdLevelName(level));
+	printf(" %9s\n", "accuracy");
+
+	for(int size = MIN_FFT_SIZE; size <= 16384; size *= 2) {
+
+		std::vector<TYPECPX> const input = generate_input(size);
+		std::vector<TYPECPX> buffer(size);
+
+		CFft fft;
+		fft.SetFFTParams(size, false, 0.0, 1.0);
+
+		printf("  %6d", size);
+
+		for(enum SimdLevel level : LEVELS) {
+
+			if(!is_supported(level)) continue;
+			BindDspKernels(level, tDspKernelCallback());
+
+			double const ns = best_of(RUNS, [&]() -> void {
+
+				for(int transform = 0; transform < TRANSFORMS; transform++) {
+
+					memcpy(buffer.data(), input.data(), size * sizeof(TYPECPX));
+					fft.FwdFFT(buffer.data());
+					fft.RevFFT(buffer.data());
+				}
+			});
+
+			printf(" %8.2f", ns / (TRANSFORMS * 2) / 1000.0);
+		}
+
+		// The accuracy is measured with the best binding
+		InitDspKernels(tDspKernelCallback());
+		memcpy(buffer.data(), input.data(), size * sizeof(TYPECPX));
+		fft.FwdFFT(buffer.data());
+
+		printf(" %9.1f\n", accuracy(input, buffer));
+	}
+
+	return EXIT_SUCCESS;
+}
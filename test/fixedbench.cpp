@@ -0,0 +1,177 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+// Compares the fixed point and floating point mono wide band FM paths
+//
+// Runs both paths as fmstream sets them up, from raw 8 bit I/Q samples to 48KHz mono PCM
+// without RDS, and reports the time per input sample, the SINAD of the 1KHz test tone and
+// the output level of the fixed point path relative to the floating point path
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fmdsp/demodulator.h"
+#include "fmdsp/dispatch.h"
+#include "fmdsp/fixeddemod.h"
+#include "fmdsp/fixedresampler.h"
+#include "fmdsp/polyresampler.h"
+#include "fmdsp/wfmdemod.h"
+#include "testsignal.h"
+
+using namespace FMDSP_NAMESPACE;
+
+// Output sample rate
+static int const PCM_SAMPLERATE = 48000;
+
+// Seconds of output skipped before the SINAD and level are measured
+static double const SETTLE_TIME = 0.2;
+
+// Number of runs, the fastest one is reported
+static int const RUNS = 5;
+
+// Input sample rates
+static double const SAMPLERATES[] = { 1000000.0, 1600000.0, 2048000.0, 2400000.0 };
+
+//---------------------------------------------------------------------------
+// rms
+//
+// Calculates the RMS level of the samples after the settling time
+
+static double rms(std::vector<TYPEMONO16> const& samples, size_t count)
+{
+	size_t const start = static_cast<size_t>(SETTLE_TIME * PCM_SAMPLERATE);
+	double sum = 0.0;
+	for(size_t index = start; index < count; index++) sum += static_cast<double>(samples[index]) * samples[index];
+
+	return sqrt(sum / (count - start));
+}
+
+//---------------------------------------------------------------------------
+// run_float
+//
+// Runs the floating point path over the raw samples, returns the number of PCM samples
+
+static size_t run_float(double samplerate, std::vector<uint8_t> const& iq, std::vector<TYPEMONO16>& pcm, double& ns)
+{
+	tDemodInfo demodinfo = {};
+	demodinfo.HiCutmax = 100000;
+	demodinfo.HiCut = 100000;
+	demodinfo.LowCut = -100000;
+	demodinfo.SquelchValue = -160;
+	demodinfo.WfmDownsampleQuality = DownsampleQuality::High;
+
+	size_t length = 0;
+
+	ns = best_of(RUNS, [&]() -> void {
+
+		CDemodulator demodulator;
+		demodulator.SetUSFmVersion(true);
+		demodulator.SetInputSampleRate(samplerate);
+		demodulator.SetDemod(DEMOD_WFM, demodinfo);
+		demodulator.SetDemodFreq(samplerate / 4.0);
+		demodulator.SetRdsEnabled(false);
+
+		CPolyResampler resampler;
+		if(!resampler.InitLowPass(demodulator.GetOutputRate(), PCM_SAMPLERATE, WFM_AUDIO_ASTOP, WFM_AUDIO_FPASS, WFM_FUSED_FSTOP)) {
+
+			fprintf(stderr, "CPolyResampler::InitLowPass() failed\n");
+			exit(EXIT_FAILURE);
+		}
+		demodulator.SetAudioFilterEnabled(false);
+
+		int const inbuflimit = demodulator.GetInputBufferLimit();
+		std::vector<TYPEREAL> samples(inbuflimit);
+
+		length = 0;
+		for(size_t index = 0; index + inbuflimit <= iq.size() / 2; index += inbuflimit) {
+
+			int const count = demodulator.ProcessData(inbuflimit, &iq[index * 2], samples.data());
+			length += resampler.Resample(count, samples.data(), &pcm[length], 1.0);
+		}
+	});
+
+	return length;
+}
+
+//---------------------------------------------------------------------------
+// run_fixed
+//
+// Runs the fixed point path over the raw samples, returns the number of PCM samples
+
+static size_t run_fixed(double samplerate, std::vector<uint8_t> const& iq, std::vector<TYPEMONO16>& pcm, double& ns)
+{
+	size_t length = 0;
+
+	ns = best_of(RUNS, [&]() -> void {
+
+		CFixedDemodulator demodulator;
+		demodulator.SetSampleRate(samplerate, DownsampleQuality::High, true);
+		demodulator.SetDemodFreq(samplerate / 4.0);
+
+		CFixedResampler resampler;
+		if(!resampler.InitLowPass(demodulator.GetOutputRate(), PCM_SAMPLERATE, WFM_AUDIO_ASTOP, WFM_AUDIO_FPASS, WFM_FUSED_FSTOP)) {
+
+			fprintf(stderr, "CFixedResampler::InitLowPass() failed\n");
+			exit(EXIT_FAILURE);
+		}
+
+		int const inbuflimit = demodulator.GetInputBufferLimit();
+		std::vector<qint16> samples(inbuflimit);
+
+		length = 0;
+		for(size_t index = 0; index + inbuflimit <= iq.size() / 2; index += inbuflimit) {
+
+			int const count = demodulator.ProcessData(inbuflimit, &iq[index * 2], samples.data());
+			length += resampler.Resample(count, samples.data(), &pcm[length], CFixedDemodulator::GetOutputScale());
+		}
+	});
+
+	return length;
+}
+
+int main(int, char**)
+{
+	char const* simdlevel = InitDspKernels(tDspKernelCallback());
+	printf("%s, %s kernels, mono, best of %d runs\n", precision_name<TYPEREAL>(), simdlevel, RUNS);
+	printf("  %8s %16s %16s %18s\n", "MS/s", "float ns/SINAD", "fixed ns/SINAD", "fixed/float level");
+
+	for(double samplerate : SAMPLERATES) {
+
+		std::vector<uint8_t> const iq = generate_wfm(samplerate, 1.0);
+		std::vector<TYPEMONO16> floatpcm(PCM_SAMPLERATE * 2);
+		std::vector<TYPEMONO16> fixedpcm(PCM_SAMPLERATE * 2);
+
+		double floatns = 0.0, fixedns = 0.0;
+		size_t const floatlength = run_float(samplerate, iq, floatpcm, floatns);
+		size_t const fixedlength = run_fixed(samplerate, iq, fixedpcm, fixedns);
+
+		size_t const start = static_cast<size_t>(SETTLE_TIME * PCM_SAMPLERATE);
+		double const floatsinad = sinad(&floatpcm[start], floatlength - start, 1000.0, PCM_SAMPLERATE);
+		double const fixedsinad = sinad(&fixedpcm[start], fixedlength - start, 1000.0, PCM_SAMPLERATE);
+		double const samples = static_cast<double>(iq.size() / 2);
+
+		printf("  %8.3f %7.2f %5.1f dB %7.2f %5.1f dB %18.4f\n", samplerate / 1e6, floatns / samples, floatsinad,
+			fixedns / samples, fixedsinad, rms(fixedpcm, fixedlength) / rms(floatpcm, floatlength));
+	}
+
+	return EXIT_SUCCESS;
+}
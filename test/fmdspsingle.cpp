@@ -0,0 +1,44 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+// Single precision build of the fmdsp library for the tests and benchmarks, the
+// same way src/dspsingle.cpp builds it for the add-on but without the streams
+#undef FMDSP_USE_DOUBLE_PRECISION
+
+#include "fmdsp/demodulator.cpp"
+#include "fmdsp/discriminator.cpp"
+#include "fmdsp/dispatch.cpp"
+#include "fmdsp/downconvert.cpp"
+#include "fmdsp/fastfir.cpp"
+#include "fmdsp/fft.cpp"
+#include "fmdsp/fir.cpp"
+#include "fmdsp/firkernel.cpp"
+#include "fmdsp/fixeddemod.cpp"
+#include "fmdsp/fixedresampler.cpp"
+#include "fmdsp/fmdemod.cpp"
+#include "fmdsp/fractresampler.cpp"
+#include "fmdsp/halfband.cpp"
+#include "fmdsp/iir.cpp"
+#include "fmdsp/iqconvert.cpp"
+#include "fmdsp/polyresampler.cpp"
+#include "fmdsp/rdsdemod.cpp"
+#include "fmdsp/wfmdemod.cpp"
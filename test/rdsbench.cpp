@@ -0,0 +1,139 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+// Benchmarks the cost of RDS in the wide band FM demodulator
+//
+// Times the stereo CDemodulator configured as fmstream does with the RDS chain run inline
+// on the demodulator thread, with the composite signal handed off to a sink (fmstream's RDS
+// thread, timed separately) and with RDS disabled, in nanoseconds per composite sample
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmdsp/demodulator.h"
+#include "fmdsp/dispatch.h"
+#include "fmdsp/rdsdemod.h"
+#include "testsignal.h"
+
+using namespace FMDSP_NAMESPACE;
+
+// Composite samples passed to each CRdsDemod::ProcessData() call, as fmstream's ring blocks
+static int const COMPOSITE_BLOCK_SIZE = 4096;
+
+// Number of runs, the fastest one is reported
+static int const RUNS = 5;
+
+// Input sample rates, the composite rates are 250, 300, 400 and 300 KHz
+static double const SAMPLERATES[] = { 1000000.0, 1200000.0, 1600000.0, 2400000.0 };
+
+enum class rdsmode { inline_rds, handed_off, disabled };
+
+//---------------------------------------------------------------------------
+// bench_demodulator
+//
+// Times the demodulator in the specified RDS mode, the composite signal handed off to
+// the sink is stored in composite, which must be large enough for all of it
+
+static double bench_demodulator(double samplerate, std::vector<uint8_t> const& iq, enum rdsmode mode,
+	std::vector<TYPECPX>& composite, size_t& compositelength, double& compositerate)
+{
+	tDemodInfo demodinfo = {};
+	demodinfo.HiCutmax = 100000;
+	demodinfo.HiCut = 100000;
+	demodinfo.LowCut = -100000;
+	demodinfo.SquelchValue = -160;
+	demodinfo.WfmDownsampleQuality = DownsampleQuality::High;
+
+	CDemodulator demodulator;
+	demodulator.SetUSFmVersion(true);
+	demodulator.SetInputSampleRate(samplerate);
+	demodulator.SetDemod(DEMOD_WFM, demodinfo);
+	demodulator.SetDemodFreq(samplerate / 4.0);
+	demodulator.SetRdsEnabled(mode != rdsmode::disabled);
+	if(mode == rdsmode::handed_off) demodulator.SetCompositeSink([&](int length, TYPECPX const* samples) -> void {
+
+		memcpy(&composite[compositelength], samples, length * sizeof(TYPECPX));
+		compositelength += length;
+	});
+
+	compositerate = demodulator.GetCompositeRate();
+
+	int const inbuflimit = demodulator.GetInputBufferLimit();
+	int const count = static_cast<int>(iq.size() / 2 / inbuflimit) * inbuflimit;
+	std::vector<TYPECPX> out(inbuflimit);
+
+	return best_of(RUNS, [&]() -> void {
+
+		compositelength = 0;
+		for(int index = 0; index < count; index += inbuflimit)
+			demodulator.ProcessData(inbuflimit, &iq[index * 2], out.data());
+	});
+}
+
+//---------------------------------------------------------------------------
+// bench_rdsdemod
+//
+// Times the RDS demodulator over the composite signal handed off by the demodulator
+
+static double bench_rdsdemod(std::vector<TYPECPX> const& composite, size_t compositelength, double compositerate)
+{
+	CRdsDemod rdsdemod;
+	rdsdemod.SetSampleRate(compositerate);
+
+	return best_of(RUNS, [&]() -> void {
+
+		tRDS_GROUPS group;
+		for(size_t index = 0; index < compositelength; index += COMPOSITE_BLOCK_SIZE) {
+
+			int const length = static_cast<int>(std::min(compositelength - index, static_cast<size_t>(COMPOSITE_BLOCK_SIZE)));
+			rdsdemod.ProcessData(length, &composite[index]);
+			while(rdsdemod.GetNextRdsGroupData(&group)) {}
+		}
+	});
+}
+
+int main(int, char**)
+{
+	char const* simdlevel = InitDspKernels(tDspKernelCallback());
+	printf("%s, %s kernels, stereo, best of %d runs, ns per composite sample\n", precision_name<TYPEREAL>(), simdlevel, RUNS);
+	printf("  %8s %8s %10s %10s %10s %10s\n", "MS/s", "kS/s", "inline", "handed off", "RDS thread", "RDS off");
+
+	for(double samplerate : SAMPLERATES) {
+
+		std::vector<uint8_t> const iq = generate_wfm(samplerate, 1.0);
+		std::vector<TYPECPX> composite(iq.size() / 2);
+		size_t compositelength = 0;
+		double compositerate = 0.0;
+
+		double const inlinerds = bench_demodulator(samplerate, iq, rdsmode::inline_rds, composite, compositelength, compositerate);
+		double const disabled = bench_demodulator(samplerate, iq, rdsmode::disabled, composite, compositelength, compositerate);
+		double const handedoff = bench_demodulator(samplerate, iq, rdsmode::handed_off, composite, compositelength, compositerate);
+		double const rdsthread = bench_rdsdemod(composite, compositelength, compositerate);
+
+		double const samples = static_cast<double>(compositelength);
+		printf("  %8.3f %8.1f %10.2f %10.2f %10.2f %10.2f\n", samplerate / 1e6, compositerate / 1e3, inlinerds / samples,
+			handedoff / samples, rdsthread / samples, disabled / samples);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#ifndef __TESTSIGNAL_H_
+#define __TESTSIGNAL_H_
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdint.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Signal generation and measurement helpers shared by the tests and benchmarks
+
+// generate_wfm
+//
+// Generates raw 8 bit I/Q samples, as delivered by an RTL-SDR device, of a carrier at
+// -samplerate/4 frequency modulated by a 1KHz tone with the specified deviation and white
+// noise at the specified carrier to noise ratio. fmstream tunes the device samplerate/4
+// above the channel, so the station is received at -samplerate/4 and the demodulator
+// frequency is set to +samplerate/4
+inline std::vector<uint8_t> generate_wfm(double samplerate, double seconds, double deviation = 50000.0, double cnr = 40.0)
+{
+	size_t const count = static_cast<size_t>(samplerate * seconds);
+	std::vector<uint8_t> iq(count * 2);
+
+	std::mt19937 rng(1);
+	std::normal_distribution<double> gaussian(0.0, 1.0);
+	double const noise = 0.5 * pow(10.0, -cnr / 20.0) / sqrt(2.0);
+	double phase = 0.0;
+
+	for(size_t index = 0; index < count; index++) {
+
+		double const tone = sin(2.0 * M_PI * 1000.0 * index / samplerate);
+		phase = fmod(phase + 2.0 * M_PI * ((samplerate / -4.0) + (deviation * tone)) / samplerate, 2.0 * M_PI);
+
+		double const i = 0.5 * cos(phase) + noise * gaussian(rng);
+		double const q = 0.5 * sin(phase) + noise * gaussian(rng);
+		iq[index * 2] = static_cast<uint8_t>(std::max(0.0, std::min(255.0, floor(127.5 + 127.5 * i + 0.5))));
+		iq[index * 2 + 1] = static_cast<uint8_t>(std::max(0.0, std::min(255.0, floor(127.5 + 127.5 * q + 0.5))));
+	}
+
+	return iq;
+}
+
+// sinad
+//
+// Measures the signal to noise and distortion ratio in dB of a tone in a set of samples,
+// the tone is fitted with least squares after the DC offset has been removed and
+// everything else counts as noise
+template <typename _type>
+double sinad(_type const* samples, size_t count, double frequency, double samplerate)
+{
+	double ss = 0, cc = 0, sc = 0, xs = 0, xc = 0, xx = 0, sum = 0;
+
+	for(size_t index = 0; index < count; index++) sum += static_cast<double>(samples[index]);
+	double const mean = sum / count;
+
+	for(size_t index = 0; index < count; index++) {
+
+		double const s = sin(2.0 * M_PI * frequency * index / samplerate);
+		double const c = cos(2.0 * M_PI * frequency * index / samplerate);
+		double const x = static_cast<double>(samples[index]) - mean;
+
+		ss += s * s; cc += c * c; sc += s * c;
+		xs += x * s; xc += x * c; xx += x * x;
+	}
+
+	double const det = (ss * cc) - (sc * sc);
+	double const a = ((xs * cc) - (xc * sc)) / det;
+	double const b = ((xc * ss) - (xs * sc)) / det;
+	double const signal = (a * xs) + (b * xc);
+	double const residual = xx - signal;
+
+	return 10.0 * log10(signal / residual);
+}
+
+// elapsed_ns
+//
+// Gets the number of nanoseconds since a steady clock time point
+inline double elapsed_ns(std::chrono::steady_clock::time_point const& start)
+{
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// best_of
+//
+// Runs a function a number of times and gets the shortest run time in nanoseconds
+template <typename _function>
+double best_of(int runs, _function function)
+{
+	double best = HUGE_VAL;
+
+	for(int run = 0; run < runs; run++) {
+
+		auto const start = std::chrono::steady_clock::now();
+		function();
+		best = std::min(best, elapsed_ns(start));
+	}
+
+	return best;
+}
+
+// precision_name
+//
+// Gets the name of the precision the fmdsp library was built with
+template <typename _real>
+char const* precision_name(void)
+{
+	return (sizeof(_real) == sizeof(float)) ? "single precision" : "double precision";
+}
+
+//-----------------------------------------------------------------------------
+
+#endif	// __TESTSIGNAL_H_
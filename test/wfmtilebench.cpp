@@ -0,0 +1,194 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2021 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+// Benchmarks tiled execution of the wide band FM demodulator
+//
+// CDemodulator hands CWFmDemod the down converted samples of about 10ms of input at a
+// time and every stage runs over the whole block before the next one starts. The tiled
+// alternative runs the whole chain over a few hundred samples at a time so the
+// intermediate buffers stay in the L1 cache. CWFmDemod keeps the state of every stage
+// between calls, so calling it once per tile is the same as the tiled mode it used to
+// had. Both are timed in nanoseconds per composite sample, with RDS run inline.
+//
+// The mono output does not depend on the tile size. The stereo demodulator decides once
+// per call whether the pilot is locked, so with small tiles the side chain can switch in
+// or out at a different sample; the largest error of a tiled output relative to the
+// block output is reported
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmdsp/downconvert.h"
+#include "fmdsp/dispatch.h"
+#include "fmdsp/wfmdemod.h"
+#include "testsignal.h"
+
+using namespace FMDSP_NAMESPACE;
+
+// Number of runs, the fastest one is reported
+static int const RUNS = 5;
+
+// Input sample rates
+static double const SAMPLERATES[] = { 1000000.0, 1600000.0, 2400000.0, 3200000.0 };
+
+// Composite samples per CWFmDemod::ProcessData() call in the tiled runs, zero is one
+// call per block as CDemodulator makes them
+static int const TILE_SIZES[] = { 0, 512, 2048 };
+
+//---------------------------------------------------------------------------
+// downconvert
+//
+// Down converts the raw samples to the composite rate in the blocks CDemodulator
+// uses, returns the composite samples and the length of each block
+
+static std::vector<TYPECPX> downconvert(double samplerate, std::vector<uint8_t> const& iq, std::vector<int>& blocks,
+	double& compositerate)
+{
+	CDownConvert downconvert;
+	downconvert.SetQuality(DownsampleQuality::High);
+	compositerate = downconvert.SetWfmDataRate(samplerate, 100000);
+	downconvert.SetFrequency(samplerate / 4.0);
+
+	// Same block size as CDemodulator, about 10ms and a multiple of 256
+	int const inbuflimit = static_cast<int>(samplerate / 100.0) & 0xFFFFFF00;
+	std::vector<TYPECPX> composite(iq.size() / 2);
+	size_t length = 0;
+
+	for(size_t index = 0; index + inbuflimit <= iq.size() / 2; index += inbuflimit) {
+
+		int const count = downconvert.ProcessData(inbuflimit, &iq[index * 2], &composite[length]);
+		blocks.push_back(count);
+		length += count;
+	}
+
+	composite.resize(length);
+	return composite;
+}
+
+//---------------------------------------------------------------------------
+// bench_wfmdemod
+//
+// Times the demodulator over the composite samples, a block at a time or in tiles. The
+// demodulator filters its input in place, so each block is copied first in both cases
+
+template <typename _output>
+static double bench_wfmdemod(double compositerate, std::vector<TYPECPX> const& composite, std::vector<int> const& blocks,
+	int tilesize, std::vector<_output>& output)
+{
+	int const maxblock = *std::max_element(blocks.begin(), blocks.end());
+	std::vector<TYPECPX> block(maxblock);
+	size_t length = 0;
+
+	double const ns = best_of(RUNS, [&]() -> void {
+
+		CWFmDemod demodulator(compositerate);
+		demodulator.SetSampleRate(compositerate, true);
+		demodulator.SetAudioFilterEnabled(false);
+
+		size_t position = 0;
+		length = 0;
+		for(int count : blocks) {
+
+			memcpy(block.data(), &composite[position], count * sizeof(TYPECPX));
+			position += count;
+
+			int const tile = (tilesize == 0) ? count : tilesize;
+			for(int index = 0; index < count; index += tile)
+				length += demodulator.ProcessData(std::min(tile, count - index), &block[index], &output[length]);
+		}
+
+	});
+
+	output.resize(length);
+	return ns;
+}
+
+//---------------------------------------------------------------------------
+// output_error
+//
+// Gets the error of the tiled output relative to the output of whole blocks in dB,
+// -inf when they are bit identical
+
+template <typename _output>
+static double output_error(std::vector<_output> const& output, std::vector<_output> const& reference)
+{
+	if(output.size() != reference.size()) return HUGE_VAL;
+
+	TYPEREAL const* samples = reinterpret_cast<TYPEREAL const*>(output.data());
+	TYPEREAL const* expected = reinterpret_cast<TYPEREAL const*>(reference.data());
+	size_t const count = output.size() * sizeof(_output) / sizeof(TYPEREAL);
+
+	double error = 0.0, power = 0.0;
+	for(size_t index = 0; index < count; index++) {
+
+		double const difference = samples[index] - expected[index];
+		error += difference * difference;
+		power += static_cast<double>(expected[index]) * expected[index];
+	}
+
+	return (error == 0.0) ? -HUGE_VAL : 10.0 * log10(error / power);
+}
+
+int main(int, char**)
+{
+	char const* simdlevel = InitDspKernels(tDspKernelCallback());
+	printf("%s, %s kernels, best of %d runs, ns per composite sample\n", precision_name<TYPEREAL>(), simdlevel, RUNS);
+	printf("  %8s %8s %8s %8s %8s %8s %8s %8s %11s\n", "MS/s", "kS/s", "stereo", "tile 512", "2048", "mono", "tile 512",
+		"2048", "max error");
+
+	for(double samplerate : SAMPLERATES) {
+
+		std::vector<uint8_t> const iq = generate_wfm(samplerate, 1.0);
+		std::vector<int> blocks;
+		double compositerate = 0.0;
+		std::vector<TYPECPX> const composite = downconvert(samplerate, iq, blocks, compositerate);
+		double const samples = static_cast<double>(composite.size());
+
+		printf("  %8.3f %8.1f", samplerate / 1e6, compositerate / 1e3);
+
+		double maxerror = -HUGE_VAL;
+		std::vector<TYPECPX> stereoreference;
+		for(int tilesize : TILE_SIZES) {
+
+			std::vector<TYPECPX> stereo(composite.size());
+			printf(" %8.2f", bench_wfmdemod(compositerate, composite, blocks, tilesize, stereo) / samples);
+
+			if(tilesize == 0) stereoreference = stereo;
+			else maxerror = std::max(maxerror, output_error(stereo, stereoreference));
+		}
+
+		std::vector<TYPEREAL> monoreference;
+		for(int tilesize : TILE_SIZES) {
+
+			std::vector<TYPEREAL> mono(composite.size());
+			printf(" %8.2f", bench_wfmdemod(compositerate, composite, blocks, tilesize, mono) / samples);
+
+			if(tilesize == 0) monoreference = mono;
+			else maxerror = std::max(maxerror, output_error(mono, monoreference));
+		}
+
+		printf(" %8.1f dB\n", maxerror);
+	}
+
+	return EXIT_SUCCESS;
+}